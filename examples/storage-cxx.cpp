@@ -458,7 +458,6 @@ int  main(int argc, char *argv[])
 	Sq::DbMethod *db;
 	Sq::Storage  *storage;
 	Company      *company;
-	User         *user;
 
 	check_standard_layout();
 
@@ -467,6 +466,7 @@ int  main(int argc, char *argv[])
 
 	config_sqlite.folder    = ".";    // "/tmp"
 	config_sqlite.extension = "db";
+	config_sqlite.stmt_cache_size = 0;    // 0 = default size of prepared statement cache
 
 	db = new Sq::DbSqlite(&config_sqlite);
 
@@ -538,20 +538,20 @@ int  main(int argc, char *argv[])
 	delete company;
 
 	// --- add rows to users table
-	user = new User();
+	// call Sq::Storage.insertAll() to insert multiple rows in a transaction.
+	std::vector<User> users(2);
 
-	user->id = 1;
-	user->name = (char*)"Bob";
-	user->company_id = 1;
-	storage->insert(user);
+	users[0].id = 1;
+	users[0].name = (char*)"Bob";
+	users[0].company_id = 1;
 
-	user->id = 2;
-	user->name = (char*)"Tom";
-	user->company_id = 2;
-	storage->insert(user);
+	users[1].id = 2;
+	users[1].name = (char*)"Tom";
+	users[1].company_id = 2;
 
-	user->name = NULL;
-	delete user;
+	int64_t idRange[2];
+	storage->insertAll(users, idRange);
+	std::cout << "insertAll(): id = " << idRange[0] << " ~ " << idRange[1] << std::endl;
 
 	// --- get data from database
 	company = storage->get<Company>(1);
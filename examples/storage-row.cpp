@@ -367,6 +367,7 @@ int  main(int argc, char *argv[])
 
 	config_sqlite.folder    = ".";    // "/tmp"
 	config_sqlite.extension = "db";
+	config_sqlite.stmt_cache_size = 0;    // 0 = default size of prepared statement cache
 
 	db = new Sq::DbSqlite(&config_sqlite);
 
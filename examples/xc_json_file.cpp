@@ -15,9 +15,9 @@
 #include <sqxclib.h>
 #include <SqxcFile.h>    // SqxcFile in sqxcsupport library
 
-/*	Sqxc chain data flow for SqxcJsonc Writer
+/*	Sqxc chain data flow for SqxcJson Writer
 
-	output ---------> SqxcJsonc Writer ---------> SqxcFile Writer
+	output ---------> SqxcJson Writer  ---------> SqxcFile Writer
 	     SQXC_TYPE_XXXX              SQXC_TYPE_STR
  */
 
@@ -26,10 +26,10 @@ void json_file_writer_cpp()
 {
 	Sq::Xc            *xc;
 	Sq::XcFileWriter  *xcfile;
-	Sq::XcJsoncWriter *xcjson;
+	Sq::XcJsonWriter  *xcjson;
 
 	xcfile = new Sq::XcFileWriter();
-	xcjson = new Sq::XcJsoncWriter();
+	xcjson = new Sq::XcJsonWriter();
 	xcfile->insert(xcjson);
 
 	// specify output filename
@@ -74,12 +74,15 @@ void json_file_writer_c(void)
 {
 	Sqxc       *xc;
 	SqxcFile   *xcfile;
-	SqxcJsonc  *xcjson;
+	SqxcJsonWriter *xcjson;
 
-	xcjson = (SqxcJsonc*) sqxc_new(SQXC_INFO_JSONC_WRITER);
+	xcjson = (SqxcJsonWriter*) sqxc_new(SQXC_INFO_JSON_WRITER);
 	xcfile = (SqxcFile*)  sqxc_new(SQXC_INFO_FILE_WRITER);
 	sqxc_insert((Sqxc*)xcfile, (Sqxc*)xcjson, -1);
 
+	// send JSON string to SqxcFile when its length >= 4096. This is useful for big container.
+	xcjson->flush_size = 4096;
+
 	// specify output filename
 	xcfile->filename = "xc_json_file_c.json";
 
@@ -117,10 +120,10 @@ void json_file_writer_c(void)
 	sqxc_free_chain((Sqxc*)xcfile);
 }
 
-/*	Sqxc chain data flow for SqxcJsonc Parser
+/*	Sqxc chain data flow for SqxcJson Parser
 
-	input ---------> SqxcJsonc Parser ---------> SqxcValue
-	    SQXC_TYPE_STR               SQXC_TYPE_XXXX
+	SqxcFile Reader ---------> SqxcJson Parser  ---------> SqxcValue
+	              SQXC_TYPE_STR                SQXC_TYPE_XXXX
  */
 
 // Defines structure to parse file written by json_file_writer_c()
@@ -151,21 +154,16 @@ static const SqType        typeJsonTest = SQ_TYPE_INITIALIZER(JsonTest, JsonTest
 // read and parse JSON file by using C language
 void json_file_parser_c(void)
 {
-	Sqxc       *xc;
 	SqxcValue  *xcvalue;
-	SqxcJsonc  *xcjson;
+	SqxcFile   *xcfile;
+	SqxcJsonParser *xcjson;
 	JsonTest   *instance;
-	FILE       *file;
-	char       *buf;
-	int         count;
 
-	// open input file
-	file = fopen("xc_json_file_c.json", "r");
-	if (file == NULL)
-		return;
-
-	xcjson  = (SqxcJsonc*) sqxc_new(SQXC_INFO_JSONC_PARSER);
 	xcvalue = (SqxcValue*) sqxc_new(SQXC_INFO_VALUE);
+	xcfile  = (SqxcFile*)  sqxc_new(SQXC_INFO_FILE_READER);
+	xcjson  = (SqxcJsonParser*) sqxc_new(SQXC_INFO_JSON_PARSER);
+	// SqxcFile Reader sends file to the next element (SqxcJson Parser)
+	sqxc_insert((Sqxc*)xcvalue, (Sqxc*)xcfile, -1);
 	sqxc_insert((Sqxc*)xcvalue, (Sqxc*)xcjson, -1);
 
 	// setup SqxcValue
@@ -173,41 +171,30 @@ void json_file_parser_c(void)
 	xcvalue->element   = SQ_TYPE_JSON_TEST;
 	xcvalue->instance  = NULL;
 
+	// specify input filename
+	xcfile->filename = "xc_json_file_c.json";
+
 	// --- Sqxc chain ready to work ---
 	sqxc_ready((Sqxc*)xcvalue, NULL);
 
 	// Because arguments in xcvalue never used in sqxc chain,
 	// I use xcvalue as arguments source here.
-	xc = (Sqxc*)xcvalue;
-
-	// read file data and send them to SqxcJsonc Parser
-	buf = (char*)malloc(4096);
-	xc->name = NULL;
-	xc->type = SQXC_TYPE_STR;
-	xc->value.str = buf;
-	for (;;) {
-		count = fread(buf, 1, 4096-1, file);
-		buf[count] = 0;
-		sqxc_send_to((Sqxc*)xcjson, xc);
-		if (count < 4096-1)
-			break;
-	}
-	free(buf);
+	// SqxcFile Reader reads file in blocks and sends them to SqxcJson Parser piece by piece.
+	xcvalue->name = NULL;
+	sqxc_send_to((Sqxc*)xcfile, (Sqxc*)xcvalue);
 
 	// --- Sqxc chain finish work ---
 	sqxc_finish((Sqxc*)xcvalue, NULL);
 
 	// get instance of SQ_TYPE_JSON_TEST
 	instance = (JsonTest*)xcvalue->instance;
-	printf("id = %d, name = %s\n", instance->id, instance->name);
+	if (xcvalue->code == SQCODE_OK)
+		printf("id = %d, name = %s\n", instance->id, instance->name);
 	free(instance->name);
 	free(instance);
 
-	// free xcvalue and xcjson in Sqxc chain
+	// free xcvalue, xcfile, and xcjson in Sqxc chain
 	sqxc_free_chain((Sqxc*)xcvalue);
-
-	// close input file
-	fclose(file);
 }
 
 int main(void)
@@ -0,0 +1,146 @@
+/*
+ *   Copyright (C) 2023 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ * sqxclib is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <SqArena.h>
+
+// alignment of memory that allocated from SqArena
+#define SQ_ARENA_ALIGN            (sizeof(void*) * 2)
+#define SQ_ARENA_ALIGN_SIZE(size) (((size) + SQ_ARENA_ALIGN - 1) & ~(SQ_ARENA_ALIGN - 1))
+
+struct SqArenaBlock
+{
+	SqArenaBlock  *prev;
+	size_t         size;          // size of data
+};
+
+#define SQ_ARENA_BLOCK_HEADER     SQ_ARENA_ALIGN_SIZE(sizeof(SqArenaBlock))
+#define SQ_ARENA_BLOCK_DATA(blk)  ((char*)(blk) + SQ_ARENA_BLOCK_HEADER)
+
+SqArena *sq_arena_new(size_t block_size)
+{
+	SqArena *arena;
+
+	arena = malloc(sizeof(SqArena));
+	sq_arena_init(arena, block_size);
+	return arena;
+}
+
+void  sq_arena_free(SqArena *arena)
+{
+	sq_arena_final(arena);
+	free(arena);
+}
+
+void  sq_arena_init(SqArena *arena, size_t block_size)
+{
+	if (block_size == 0)
+		block_size = SQ_ARENA_BLOCK_SIZE_DEFAULT;
+	arena->block_size = SQ_ARENA_ALIGN_SIZE(block_size);
+	arena->block = NULL;
+	arena->cur = NULL;
+	arena->end = NULL;
+}
+
+void  sq_arena_final(SqArena *arena)
+{
+	SqArenaBlock *block;
+
+	while ((block = arena->block) != NULL) {
+		arena->block = block->prev;
+		free(block);
+	}
+	arena->cur = NULL;
+	arena->end = NULL;
+}
+
+void *sq_arena_alloc(SqArena *arena, size_t size)
+{
+	SqArenaBlock *block;
+	char         *mem;
+
+	size = SQ_ARENA_ALIGN_SIZE(size);
+	if (size <= (size_t)(arena->end - arena->cur)) {
+		mem = arena->cur;
+		arena->cur += size;
+		return mem;
+	}
+
+	// large memory has it's own block. It is linked behind current block, current block can still be used.
+	if (size > arena->block_size / 2 && arena->block) {
+		block = malloc(SQ_ARENA_BLOCK_HEADER + size);
+		if (block == NULL)
+			return NULL;
+		block->size = size;
+		block->prev = arena->block->prev;
+		arena->block->prev = block;
+		return SQ_ARENA_BLOCK_DATA(block);
+	}
+
+	// add new block
+	block = malloc(SQ_ARENA_BLOCK_HEADER + ((size > arena->block_size) ? size : arena->block_size));
+	if (block == NULL)
+		return NULL;
+	block->size = (size > arena->block_size) ? size : arena->block_size;
+	block->prev = arena->block;
+	arena->block = block;
+	mem = SQ_ARENA_BLOCK_DATA(block);
+	arena->cur = mem + size;
+	arena->end = mem + block->size;
+	return mem;
+}
+
+void *sq_arena_calloc(SqArena *arena, size_t size)
+{
+	void *mem;
+
+	mem = sq_arena_alloc(arena, size);
+	if (mem == NULL)
+		return NULL;
+	return memset(mem, 0, size);
+}
+
+char *sq_arena_strdup(SqArena *arena, const char *str)
+{
+	return sq_arena_strndup(arena, str, strlen(str));
+}
+
+char *sq_arena_strndup(SqArena *arena, const char *str, size_t length)
+{
+	char *mem;
+
+	mem = sq_arena_alloc(arena, length + 1);
+	if (mem == NULL)
+		return NULL;
+	memcpy(mem, str, length);
+	mem[length] = 0;
+	return mem;
+}
+
+void  sq_arena_clear(SqArena *arena)
+{
+	SqArenaBlock *block;
+
+	if (arena->block == NULL)
+		return;
+	// keep the first block
+	while ((block = arena->block)->prev != NULL) {
+		arena->block = block->prev;
+		free(block);
+	}
+	arena->cur = SQ_ARENA_BLOCK_DATA(block);
+	arena->end = arena->cur + block->size;
+}
@@ -0,0 +1,183 @@
+/*
+ *   Copyright (C) 2023 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ * sqxclib is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+
+#ifndef SQ_ARENA_H
+#define SQ_ARENA_H
+
+#include <stddef.h>    // size_t
+
+#if defined(__cplusplus) && (__cplusplus >= 201703L) && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#include <new>         // std::bad_alloc
+#define SQ_ARENA_HAVE_MEMORY_RESOURCE    1
+#endif
+#endif
+
+/*	SqArena - bump allocator. Memory is allocated from a few large blocks and
+	          all of them are released at once by sq_arena_clear() or sq_arena_final().
+	          Memory that allocated from SqArena can NOT be freed individually.
+ */
+
+// ----------------------------------------------------------------------------
+// C/C++ common declarations: declare type, structure, macro, enumeration.
+
+typedef struct SqArena         SqArena;
+typedef struct SqArenaBlock    SqArenaBlock;    // defined in SqArena.c
+
+// default size of block
+#define SQ_ARENA_BLOCK_SIZE_DEFAULT    (64 * 1024)
+
+// ----------------------------------------------------------------------------
+// C declarations: declare C data, function, and others.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// if 'block_size' == 0, apply SQ_ARENA_BLOCK_SIZE_DEFAULT
+SqArena *sq_arena_new(size_t block_size);
+void     sq_arena_free(SqArena *arena);
+
+void     sq_arena_init(SqArena *arena, size_t block_size);
+void     sq_arena_final(SqArena *arena);
+
+// allocate memory that is aligned for any built-in type. return NULL if malloc() failed.
+void    *sq_arena_alloc(SqArena *arena, size_t size);
+// allocate zero-initialized memory. return NULL if malloc() failed.
+void    *sq_arena_calloc(SqArena *arena, size_t size);
+
+// return NULL if malloc() failed.
+char    *sq_arena_strdup(SqArena *arena, const char *str);
+char    *sq_arena_strndup(SqArena *arena, const char *str, size_t length);
+
+// release all memory that allocated from 'arena'. It keeps the first block for reuse.
+void     sq_arena_clear(SqArena *arena);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+// ----------------------------------------------------------------------------
+// C++ declarations: declare C++ data, function, method, and others.
+
+#ifdef __cplusplus
+
+namespace Sq {
+
+/*	ArenaMethod is used by SqArena and it's children.
+
+	It's derived struct/class must be C++11 standard-layout and has SqArena members.
+ */
+struct ArenaMethod {
+	void  *alloc(size_t size);
+	void  *calloc(size_t size);
+	char  *strdup(const char *str);
+	char  *strndup(const char *str, size_t length);
+	void   clear();
+};
+
+};  // namespace Sq
+
+#endif  // __cplusplus
+
+// ----------------------------------------------------------------------------
+// C/C++ common definitions: define structure
+
+#ifdef __cplusplus
+struct SqArena : Sq::ArenaMethod      // <-- 1. inherit C++ member function(method)
+#else
+struct SqArena
+#endif
+{
+	SqArenaBlock  *block;         // current block. Blocks are linked by SqArenaBlock.prev
+	char          *cur;           // free space of current block
+	char          *end;           // end of current block
+	size_t         block_size;
+};
+
+// ----------------------------------------------------------------------------
+// C++ definitions: define C++ data, function, method, and others.
+
+#ifdef __cplusplus
+
+namespace Sq {
+
+/* define ArenaMethod functions. */
+
+inline void  *ArenaMethod::alloc(size_t size) {
+	return sq_arena_alloc((SqArena*)this, size);
+}
+inline void  *ArenaMethod::calloc(size_t size) {
+	return sq_arena_calloc((SqArena*)this, size);
+}
+inline char  *ArenaMethod::strdup(const char *str) {
+	return sq_arena_strdup((SqArena*)this, str);
+}
+inline char  *ArenaMethod::strndup(const char *str, size_t length) {
+	return sq_arena_strndup((SqArena*)this, str, length);
+}
+inline void   ArenaMethod::clear() {
+	sq_arena_clear((SqArena*)this);
+}
+
+/* All derived struct/class must be C++11 standard-layout. */
+struct Arena : SqArena {
+	// constructor
+	Arena(size_t block_size = 0) {
+		sq_arena_init(this, block_size);
+	}
+	// destructor
+	~Arena() {
+		sq_arena_final(this);
+	}
+};
+
+#ifdef SQ_ARENA_HAVE_MEMORY_RESOURCE
+/*	ArenaResource - std::pmr::memory_resource that allocates memory from SqArena.
+	                deallocate() does nothing, memory is released by SqArena.
+
+	e.g. std::pmr::vector<int>  vec(&resource);
+ */
+class ArenaResource : public std::pmr::memory_resource {
+public:
+	ArenaResource(SqArena *arena) : arena(arena) {}
+
+	SqArena *getArena() const { return arena; }
+
+protected:
+	void *do_allocate(size_t bytes, size_t alignment) override {
+		// SqArena aligns memory to sizeof(void*) * 2
+		size_t  extra = (alignment <= sizeof(void*) * 2) ? 0 : alignment;
+		char   *mem = (char*)sq_arena_alloc(arena, bytes + extra);
+		if (mem == NULL)
+			throw std::bad_alloc();
+		size_t  misalign = (size_t)mem % alignment;
+		return (misalign) ? mem + alignment - misalign : mem;
+	}
+	void  do_deallocate(void *, size_t, size_t) override {
+	}
+	bool  do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+		return this == &other;
+	}
+
+	SqArena *arena;
+};
+#endif  // SQ_ARENA_HAVE_MEMORY_RESOURCE
+
+};  // namespace Sq
+
+#endif  // __cplusplus
+
+#endif  // SQ_ARENA_H
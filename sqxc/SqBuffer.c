@@ -14,6 +14,7 @@
 
 #include <SqConfig.h>
 #include <SqBuffer.h>
+#include <SqUtil.h>      // sq_int64_to_str(), sq_double_to_str(), sq_time_to_str()
 
 #define SQ_BUFFER_SIZE_DEFAULT    SQ_CONFIG_BUFFER_SIZE_DEAULT
 
@@ -53,6 +54,45 @@ char *sq_buffer_alloc_at(SqBuffer *buf, int position, int count)
 	return buf->mem + position;
 }
 
+// ----------------------------------------------------------------------------
+// write number and time. String is converted in space that allocated from tail of buffer.
+
+int   sq_buffer_write_int64(SqBuffer *buf, int64_t value)
+{
+	int  length;
+
+	length = sq_int64_to_str(sq_buffer_alloc(buf, SQ_NUMBER_STRING_SIZE), value);
+	buf->writed -= SQ_NUMBER_STRING_SIZE - length;
+	return length;
+}
+
+int   sq_buffer_write_uint64(SqBuffer *buf, uint64_t value)
+{
+	int  length;
+
+	length = sq_uint64_to_str(sq_buffer_alloc(buf, SQ_NUMBER_STRING_SIZE), value);
+	buf->writed -= SQ_NUMBER_STRING_SIZE - length;
+	return length;
+}
+
+int   sq_buffer_write_double(SqBuffer *buf, double value)
+{
+	int  length;
+
+	length = sq_double_to_str(sq_buffer_alloc(buf, SQ_NUMBER_STRING_SIZE), value);
+	buf->writed -= SQ_NUMBER_STRING_SIZE - length;
+	return length;
+}
+
+int   sq_buffer_write_time(SqBuffer *buf, time_t value, int format_type)
+{
+	int  length;
+
+	length = sq_time_to_str(sq_buffer_alloc(buf, SQ_TIME_STRING_SIZE), value, format_type);
+	buf->writed -= SQ_TIME_STRING_SIZE - length;
+	return length;
+}
+
 // ----------------------------------------------------------------------------
 // If C compiler doesn't support C99 inline function.
 
@@ -20,6 +20,8 @@
 #endif
 #include <stdlib.h>    // calloc(), realloc()
 #include <string.h>    // memcpy(), strcpy(), strlen()
+#include <stdint.h>    // int64_t, uint64_t
+#include <time.h>      // time_t
 
 // ----------------------------------------------------------------------------
 // C/C++ common declarations: declare type, structure, macro, enumeration.
@@ -119,6 +121,14 @@ void *sq_buffer_resize(SqBuffer *buf, int size);
 // It reserve space in tail of buffer for NULL-terminated
 char *sq_buffer_alloc_at(SqBuffer *buf, int position, int count);
 
+// write number in tail of buffer without calling snprintf() twice. return length of number string.
+int   sq_buffer_write_int64(SqBuffer *buf, int64_t value);
+int   sq_buffer_write_uint64(SqBuffer *buf, uint64_t value);
+int   sq_buffer_write_double(SqBuffer *buf, double value);
+
+// write time string in tail of buffer. 'format_type' is the same as sq_time_to_string().
+int   sq_buffer_write_time(SqBuffer *buf, time_t value, int format_type);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
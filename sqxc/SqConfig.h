@@ -109,6 +109,19 @@
  */
 #define SQ_CONFIG_QUERY_USE_OLD_CONDITION          0
 
+/* Number of freed chunks that each thread caches for every size class of global SqSlab.
+   Chunks in thread-local cache are not shared with other threads and are not returned
+   to global SqSlab when thread exits. Set it to 0 to disable thread-local cache.
+   Affected source : SqSlab (SqType that has SQB_TYPE_SLAB)
+ */
+#define SQ_CONFIG_SLAB_THREAD_CACHE                0
+
+/* Use SSE2/AVX2 to find characters that need escape in SQL and JSON string.
+   AVX2 is detected at runtime. Disable it if your compiler doesn't support SIMD intrinsics.
+   Affected source : SqUtil (SqxcSql, SqxcJson)
+ */
+#define SQ_CONFIG_STRING_SIMD                      1
+
 // ----------------------------------------------------------------------------
 // Default length (size)
 
@@ -124,6 +137,9 @@
 /* SqBuffer.c - SQ_BUFFER_SIZE_DEFAULT */
 #define SQ_CONFIG_BUFFER_SIZE_DEAULT             128
 
+/* SqdbSqlite.c - number of prepared statements cached by each SQLite connection */
+#define SQ_CONFIG_SQLITE_STMT_CACHE_SIZE_DEFAULT   32
+
 /* SqxcSql.c */
 #define SQ_CONFIG_SQXC_SQL_BUFFER_SIZE_DEAULT    256
 
@@ -50,11 +50,21 @@ extern "C" {
 #define SQCODE_OPEN_FAILED           (51  + SQCODE_ERROR)
 #define SQCODE_EXEC_ERROR            (52  + SQCODE_ERROR)
 #define SQCODE_NO_DATA               (53  + SQCODE_ERROR)    // if the result set is empty.
+#define SQCODE_TIMEOUT               (54  + SQCODE_ERROR)    // wait or execution is timed out.
+#define SQCODE_CANCELED              (55  + SQCODE_ERROR)    // execution is interrupted by sqdb_interrupt().
 
 // JSON
 #define SQCODE_JSON_CONTINUE         (61  + SQCODE_STATUS)
 #define SQCODE_JSON_ERROR            (62  + SQCODE_ERROR)
 
+// MessagePack
+#define SQCODE_MSGPACK_CONTINUE      (63  + SQCODE_STATUS)
+#define SQCODE_MSGPACK_ERROR         (64  + SQCODE_ERROR)
+
+// CSV
+#define SQCODE_CSV_CONTINUE          (65  + SQCODE_STATUS)
+#define SQCODE_CSV_ERROR             (66  + SQCODE_ERROR)
+
 // deprecated
 #define SQCODE_DB_VERSION_0          SQCODE_DB_SCHEMA_VERSION_0
 #define SQCODE_DB_VERSION_MISMATCH   SQCODE_DB_WRONG_MIGRATIONS
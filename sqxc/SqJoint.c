@@ -123,6 +123,7 @@ static int  sq_type_joint_parse(void *instance, const SqType *type, Sqxc *src)
 	SqxcValue  *xc_value = (SqxcValue*)src->dest;
 	SqxcNested *nested;
 	SqBuffer   *buf;
+	SqxcValueBinding *binding;
 	union {
 		void   **addr;
 		SqEntry *entry;
@@ -177,26 +178,40 @@ static int  sq_type_joint_parse(void *instance, const SqType *type, Sqxc *src)
 	}
 	 */
 
-	// get table name from "table.column" string
-	temp.dot = strchr(src->name, '.');
-	if (type->n_entry == 1 && temp.dot == NULL) {
-		// There is only 1 table in SqTypeJoint and no table name in 'src->name'
-		p.addr = (void**)type->entry;
-		temp.len = 0;
+	// Rows of result set use binding instead of searching table.
+	binding = sqxc_value_get_binding(xc_value, src, type);
+	if (binding) {
+		p.addr = binding->addr;
+		temp.len = binding->data;
 	}
 	else {
-		// There are multiple tables in SqTypeJoint
-		if (temp.dot == NULL || temp.dot == src->name)
-			return (src->code = SQCODE_ENTRY_NOT_FOUND);
-		temp.len = (int)(temp.dot - src->name);
-		// use SqxcValue.buf to find entry
-		buf = sqxc_get_buffer(xc_value);
-		buf->writed = 0;
-		strncpy(sq_buffer_alloc(buf, temp.len*2), src->name, temp.len);   // alloc(buf, (temp.len+1)*2)
-		buf->mem[temp.len] = 0;    // null-terminated
-		temp.len++;                // + '.'
-		// find table by it's name in SqTypeRow.entry
-		p.addr = sq_type_find_entry(type, buf->mem, NULL);
+		// get table name from "table.column" string
+		temp.dot = strchr(src->name, '.');
+		if (type->n_entry == 1 && temp.dot == NULL) {
+			// There is only 1 table in SqTypeJoint and no table name in 'src->name'
+			p.addr = (void**)type->entry;
+			temp.len = 0;
+		}
+		else if (temp.dot == NULL || temp.dot == src->name) {
+			// There are multiple tables in SqTypeJoint, but no table name in 'src->name'
+			p.addr = NULL;
+			temp.len = 0;
+		}
+		else {
+			// There are multiple tables in SqTypeJoint
+			temp.len = (int)(temp.dot - src->name);
+			// use SqxcValue.buf to find entry
+			buf = sqxc_get_buffer(xc_value);
+			buf->writed = 0;
+			strncpy(sq_buffer_alloc(buf, temp.len*2), src->name, temp.len);   // alloc(buf, (temp.len+1)*2)
+			buf->mem[temp.len] = 0;    // null-terminated
+			temp.len++;                // + '.'
+			// find table by it's name in SqTypeRow.entry
+			p.addr = sq_type_find_entry(type, buf->mem, NULL);
+		}
+		binding = sqxc_value_add_binding(xc_value, src, type, p.addr);
+		if (binding)
+			binding->data = temp.len;
 	}
 
 	if (p.addr) {
@@ -23,6 +23,7 @@
 
 #include <SqConfig.h>
 #include <SqQuery.h>
+#include <SqUtil.h>       // sq_int64_to_str()
 
 #ifdef _MSC_VER
 #define strdup       _strdup
@@ -657,7 +658,6 @@ void *sq_query_limit(SqQuery *query, int64_t count)
 	} limit;
 	union {
 		SqQueryNode *node;
-		int          len;
 	} temp;
 
 	limit.node = sq_query_node_find(nested->parent, SQN_LIMIT, &temp.node);
@@ -672,9 +672,8 @@ void *sq_query_limit(SqQuery *query, int64_t count)
 		limit.count = limit.node->children;
 		limit.count->type = SQN_VALUE;
 	}
-	temp.len = snprintf(NULL, 0, "%"PRId64, count) + 1;
-	limit.count->value = malloc(temp.len);
-	snprintf(limit.count->value, temp.len, "%"PRId64, count);
+	limit.count->value = malloc(SQ_NUMBER_STRING_SIZE);
+	sq_int64_to_str(limit.count->value, count);
 
 	return limit.count;
 }
@@ -685,7 +684,6 @@ void sq_query_offset(SqQuery *query, int64_t index)
 	union {
 		SqQueryNode *node;
 		SqQueryNode *count;
-		int          len;
 	} limit;
 	union {
 		SqQueryNode *node;
@@ -712,9 +710,8 @@ void sq_query_offset(SqQuery *query, int64_t index)
 		offset.index->type = SQN_VALUE;
 	}
 
-	limit.len = snprintf(NULL, 0, "%"PRId64, index) + 1;
-	offset.index->value = malloc(limit.len);
-	snprintf(offset.index->value, limit.len, "%"PRId64, index);
+	offset.index->value = malloc(SQ_NUMBER_STRING_SIZE);
+	sq_int64_to_str(offset.index->value, index);
 }
 
 void sq_query_delete(SqQuery *query)
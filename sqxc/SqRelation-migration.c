@@ -157,6 +157,7 @@ SqColumn *sq_table_replace_column(SqTable *table, SqColumn *old_column, SqColumn
 
 	for (end = type->entry + type->n_entry, cur = type->entry;  cur < end;  cur++) {
 		if (*(SqColumn**)cur == old_column) {
+			sq_type_clear_hash(type);
 			*(SqColumn**)cur  = new_column;
 			sq_column_free(old_column);
 			break;
@@ -181,6 +182,8 @@ int   sq_table_include(SqTable *table, SqTable *table_src, SqSchema *schema)
 		table->type = sq_type_copy_static(NULL, table->type, (SqDestroyFunc)sq_column_free);
 	if ((table->type->bit_field & SQB_TYPE_SORTED) == 0)
 		sq_type_sort_entry((SqType*)table->type);
+	// columns will be changed in place. sq_table_complete() rebuilds hash table.
+	sq_type_clear_hash((SqType*)table->type);
 
 	reentries = sq_type_get_ptr_array(table->type);
 	reentries_src = sq_type_get_ptr_array(table_src->type);
@@ -421,7 +424,8 @@ void   sq_table_complete(SqTable *table, bool no_need_to_sync)
 		}
 		if (has_null)
 			sq_reentries_remove_null(reentries, 0);
-		// sort columns by name
+		// sort columns by name and rebuild hash table
+		sq_type_clear_hash((SqType*)table->type);
 		sq_type_sort_entry((SqType*)table->type);
 	}
 }
@@ -479,6 +483,8 @@ int   sq_schema_include(SqSchema *schema, SqSchema *schema_src)
 		sq_schema_create_relation(schema);
 	if ((schema->type->bit_field & SQB_TYPE_SORTED) == 0)
 		sq_type_sort_entry((SqType*)schema->type);
+	// tables will be changed in place. sq_schema_complete() rebuilds hash table.
+	sq_type_clear_hash((SqType*)schema->type);
 
 	for (index = 0;  index < reentries_src->length;  index++) {
 		table_src = (SqTable*)reentries_src->data[index];
@@ -776,6 +782,9 @@ void    sq_schema_complete(SqSchema *schema, bool no_need_to_sync)
 	}
 	if (has_null)
 		sq_reentries_remove_null(entries, 0);
+	// rebuild hash table
+	sq_type_clear_hash((SqType*)schema->type);
+	sq_type_sort_entry((SqType*)schema->type);
 
 	if (no_need_to_sync) {
 		sq_relation_free(schema->relation);
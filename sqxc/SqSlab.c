@@ -0,0 +1,187 @@
+/*
+ *   Copyright (C) 2023 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ * sqxclib is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include <stdlib.h>
+
+#include <SqSlab.h>
+#include <SqThread.h>     // SQ_THREAD_LOCAL
+
+#if defined(_MSC_VER)
+#include <windows.h>    // InterlockedExchange
+#endif
+
+#define SQ_SLAB_ALIGN_SIZE(size)  (((size) + SQ_SLAB_ALIGN - 1) & ~(SQ_SLAB_ALIGN - 1))
+
+struct SqSlabBlock
+{
+	SqSlabBlock  *prev;
+};
+
+#define SQ_SLAB_BLOCK_HEADER      SQ_SLAB_ALIGN_SIZE(sizeof(SqSlabBlock))
+#define SQ_SLAB_BLOCK_DATA(blk)   ((char*)(blk) + SQ_SLAB_BLOCK_HEADER)
+
+// ----------------------------------------------------------------------------
+// spinlock. It only protects a few pointer operations.
+
+#if SQ_CONFIG_HAVE_THREAD
+#if defined(_MSC_VER)
+#define sq_slab_lock(slab)      while (InterlockedExchange(&(slab)->lock, 1))  YieldProcessor()
+#define sq_slab_unlock(slab)    InterlockedExchange(&(slab)->lock, 0)
+#else
+#define sq_slab_lock(slab)      while (__atomic_exchange_n(&(slab)->lock, 1, __ATOMIC_ACQUIRE))
+#define sq_slab_unlock(slab)    __atomic_store_n(&(slab)->lock, 0, __ATOMIC_RELEASE)
+#endif
+#else
+#define sq_slab_lock(slab)
+#define sq_slab_unlock(slab)
+#endif  // SQ_CONFIG_HAVE_THREAD
+
+// ----------------------------------------------------------------------------
+// SqSlab
+
+void  sq_slab_init(SqSlab *slab, size_t chunk_size, size_t block_size)
+{
+	if (block_size == 0)
+		block_size = SQ_SLAB_BLOCK_SIZE_DEFAULT;
+	// chunk must be able to store pointer of free list
+	if (chunk_size < sizeof(void*))
+		chunk_size = sizeof(void*);
+	slab->chunk_size = SQ_SLAB_ALIGN_SIZE(chunk_size);
+	slab->block_size = (block_size > slab->chunk_size) ? block_size : slab->chunk_size;
+	slab->block = NULL;
+	slab->freed = NULL;
+	slab->cur = NULL;
+	slab->end = NULL;
+	slab->lock = 0;
+}
+
+void  sq_slab_final(SqSlab *slab)
+{
+	SqSlabBlock *block;
+
+	while ((block = slab->block) != NULL) {
+		slab->block = block->prev;
+		free(block);
+	}
+	slab->freed = NULL;
+	slab->cur = NULL;
+	slab->end = NULL;
+}
+
+void *sq_slab_alloc(SqSlab *slab)
+{
+	SqSlabBlock *block;
+	char        *chunk;
+
+	sq_slab_lock(slab);
+	// reuse freed chunk
+	if (slab->freed) {
+		chunk = slab->freed;
+		slab->freed = *(void**)chunk;
+		sq_slab_unlock(slab);
+		return chunk;
+	}
+	// add new block if current block is full
+	if (slab->chunk_size > (size_t)(slab->end - slab->cur)) {
+		block = malloc(SQ_SLAB_BLOCK_HEADER + slab->block_size);
+		if (block == NULL) {
+			sq_slab_unlock(slab);
+			return NULL;
+		}
+		block->prev = slab->block;
+		slab->block = block;
+		slab->cur = SQ_SLAB_BLOCK_DATA(block);
+		slab->end = slab->cur + slab->block_size;
+	}
+	chunk = slab->cur;
+	slab->cur += slab->chunk_size;
+	sq_slab_unlock(slab);
+	return chunk;
+}
+
+void  sq_slab_free(SqSlab *slab, void *chunk)
+{
+	sq_slab_lock(slab);
+	*(void**)chunk = slab->freed;
+	slab->freed = chunk;
+	sq_slab_unlock(slab);
+}
+
+// ----------------------------------------------------------------------------
+// global SqSlab for each size class
+
+#define SQ_SLAB_CLASS(n)     SQ_SLAB_INITIALIZER((n) * SQ_SLAB_ALIGN)
+#define SQ_SLAB_CLASS4(n)    SQ_SLAB_CLASS(n),   SQ_SLAB_CLASS(n+1), SQ_SLAB_CLASS(n+2), SQ_SLAB_CLASS(n+3)
+#define SQ_SLAB_CLASS16(n)   SQ_SLAB_CLASS4(n),  SQ_SLAB_CLASS4(n+4), SQ_SLAB_CLASS4(n+8), SQ_SLAB_CLASS4(n+12)
+
+static SqSlab  sq_slab_global[SQ_SLAB_N_CLASS] = {
+	SQ_SLAB_CLASS16(1),
+	SQ_SLAB_CLASS16(17),
+};
+
+#if SQ_CONFIG_HAVE_THREAD && SQ_CONFIG_SLAB_THREAD_CACHE > 0
+/* thread-local cache for global SqSlab.
+   Chunks in cache are NOT returned to global SqSlab when thread exits.
+ */
+
+typedef struct SqSlabCache    SqSlabCache;
+
+struct SqSlabCache
+{
+	void   *freed;
+	int     length;
+};
+
+static SQ_THREAD_LOCAL SqSlabCache  sq_slab_cache[SQ_SLAB_N_CLASS];
+#endif  // SQ_CONFIG_HAVE_THREAD && SQ_CONFIG_SLAB_THREAD_CACHE
+
+void *sq_slab_alloc_size(size_t size)
+{
+	int  index;
+
+	if (size == 0 || size > SQ_SLAB_SIZE_MAX)
+		return NULL;
+	index = (int)((size - 1) / SQ_SLAB_ALIGN);
+
+#if SQ_CONFIG_HAVE_THREAD && SQ_CONFIG_SLAB_THREAD_CACHE > 0
+	SqSlabCache *cache = sq_slab_cache + index;
+	void        *chunk = cache->freed;
+	if (chunk) {
+		cache->freed = *(void**)chunk;
+		cache->length--;
+		return chunk;
+	}
+#endif
+	return sq_slab_alloc(sq_slab_global + index);
+}
+
+void  sq_slab_free_size(void *chunk, size_t size)
+{
+	int  index;
+
+	if (chunk == NULL)
+		return;
+	index = (int)((size - 1) / SQ_SLAB_ALIGN);
+
+#if SQ_CONFIG_HAVE_THREAD && SQ_CONFIG_SLAB_THREAD_CACHE > 0
+	SqSlabCache *cache = sq_slab_cache + index;
+	if (cache->length < SQ_CONFIG_SLAB_THREAD_CACHE) {
+		*(void**)chunk = cache->freed;
+		cache->freed = chunk;
+		cache->length++;
+		return;
+	}
+#endif
+	sq_slab_free(sq_slab_global + index, chunk);
+}
@@ -0,0 +1,90 @@
+/*
+ *   Copyright (C) 2023 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ * sqxclib is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+
+#ifndef SQ_SLAB_H
+#define SQ_SLAB_H
+
+#include <stddef.h>    // size_t
+
+#include <SqConfig.h>
+
+/*	SqSlab - pool of fixed-size chunks. Chunks are carved from large blocks and
+	         freed chunks are kept in free list for reuse.
+	         Blocks are released only by sq_slab_final().
+
+	sqxclib has a set of global SqSlab (one for each size class). They are used by
+	sq_type_init_instance() and sq_type_final_instance() if SqType has SQB_TYPE_SLAB.
+ */
+
+// ----------------------------------------------------------------------------
+// C/C++ common declarations: declare type, structure, macro, enumeration.
+
+typedef struct SqSlab         SqSlab;
+typedef struct SqSlabBlock    SqSlabBlock;    // defined in SqSlab.c
+
+// size of chunk is aligned to SQ_SLAB_ALIGN
+#define SQ_SLAB_ALIGN                 (sizeof(void*) * 2)
+// size of block
+#define SQ_SLAB_BLOCK_SIZE_DEFAULT    (16 * 1024)
+
+// global SqSlab can allocate chunk that size <= SQ_SLAB_SIZE_MAX
+#define SQ_SLAB_N_CLASS               32
+#define SQ_SLAB_SIZE_MAX              (SQ_SLAB_N_CLASS * SQ_SLAB_ALIGN)
+
+// ----------------------------------------------------------------------------
+// C declarations: declare C data, function, and others.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// if 'block_size' == 0, apply SQ_SLAB_BLOCK_SIZE_DEFAULT
+void   sq_slab_init(SqSlab *slab, size_t chunk_size, size_t block_size);
+void   sq_slab_final(SqSlab *slab);
+
+// allocate a chunk (not zero-initialized)
+void  *sq_slab_alloc(SqSlab *slab);
+// return a chunk to 'slab'
+void   sq_slab_free(SqSlab *slab, void *chunk);
+
+/* global SqSlab */
+
+// allocate chunk from global SqSlab. Return NULL if 'size' > SQ_SLAB_SIZE_MAX
+void  *sq_slab_alloc_size(size_t size);
+// return chunk to global SqSlab. 'size' must be the same as sq_slab_alloc_size()
+void   sq_slab_free_size(void *chunk, size_t size);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+// ----------------------------------------------------------------------------
+// C/C++ common definitions: define structure
+
+struct SqSlab
+{
+	SqSlabBlock  *block;         // Blocks are linked by SqSlabBlock.prev
+	void         *freed;         // free list. Each chunk stores next chunk in it's first pointer.
+	char         *cur;           // unused space of current block
+	char         *end;           // end of current block
+	size_t        chunk_size;
+	size_t        block_size;
+	long          lock;          // spinlock, used if SQ_CONFIG_HAVE_THREAD is enabled
+};
+
+// initializer for static SqSlab. 'chunk_size' must be aligned to SQ_SLAB_ALIGN
+#define SQ_SLAB_INITIALIZER(chunk_size)    \
+		{NULL, NULL, NULL, NULL, chunk_size, SQ_SLAB_BLOCK_SIZE_DEFAULT, 0}
+
+#endif  // SQ_SLAB_H
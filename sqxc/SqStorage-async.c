@@ -0,0 +1,251 @@
+/*
+ *   Copyright (C) 2023 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ * sqxclib is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+#include <stdlib.h>
+#include <string.h>     // strdup()
+
+#include <SqError.h>
+#include <SqStorage.h>
+
+typedef struct SqStorageAsync    SqStorageAsync;
+
+/* SqStorageAsync - arguments and result of asynchronous CRUD function */
+struct SqStorageAsync
+{
+	// which function to run
+	enum {
+		SQ_STORAGE_ASYNC_GET,
+		SQ_STORAGE_ASYNC_GET_ALL,
+		SQ_STORAGE_ASYNC_QUERY,
+		SQ_STORAGE_ASYNC_INSERT,
+		SQ_STORAGE_ASYNC_UPDATE,
+		SQ_STORAGE_ASYNC_REMOVE,
+		SQ_STORAGE_ASYNC_REMOVE_ALL,
+	} kind;
+
+	char         *table_name;
+	const SqType *table_type;
+	const SqType *container_type;
+	char         *sql_where_having;
+	SqQuery      *query;
+	void         *instance;
+	int64_t       id;
+
+	SqStorageResultFunc  callback;
+	void                *data;
+};
+
+static void           sq_storage_run_crud(SqStorage *storage, void *async);
+static int            sq_storage_queue_crud(SqStorage *storage, SqStorageAsync *async);
+static SqStorageAsync *sq_storage_async_new(const char *table_name, const SqType *table_type,
+                                            SqStorageResultFunc callback, void *data);
+
+// ------------------------------------
+// asynchronous CRUD functions
+
+int   sq_storage_get_async(SqStorage    *storage,
+                           const char   *table_name,
+                           const SqType *table_type,
+                           int64_t       id,
+                           SqStorageResultFunc callback,
+                           void         *data)
+{
+	SqStorageAsync *async;
+
+	async = sq_storage_async_new(table_name, table_type, callback, data);
+	async->kind = SQ_STORAGE_ASYNC_GET;
+	async->id = id;
+	return sq_storage_queue_crud(storage, async);
+}
+
+int   sq_storage_get_all_async(SqStorage    *storage,
+                               const char   *table_name,
+                               const SqType *table_type,
+                               const SqType *container_type,
+                               const char   *sql_where_having,
+                               SqStorageResultFunc callback,
+                               void         *data)
+{
+	SqStorageAsync *async;
+
+	async = sq_storage_async_new(table_name, table_type, callback, data);
+	async->kind = SQ_STORAGE_ASYNC_GET_ALL;
+	async->container_type = container_type;
+	async->sql_where_having = (sql_where_having) ? strdup(sql_where_having) : NULL;
+	return sq_storage_queue_crud(storage, async);
+}
+
+int   sq_storage_query_async(SqStorage    *storage,
+                             SqQuery      *query,
+                             const SqType *table_type,
+                             const SqType *container_type,
+                             SqStorageResultFunc callback,
+                             void         *data)
+{
+	SqStorageAsync *async;
+
+	async = sq_storage_async_new(NULL, table_type, callback, data);
+	async->kind = SQ_STORAGE_ASYNC_QUERY;
+	async->container_type = container_type;
+	async->query = query;
+	return sq_storage_queue_crud(storage, async);
+}
+
+int   sq_storage_insert_async(SqStorage    *storage,
+                              const char   *table_name,
+                              const SqType *table_type,
+                              void         *instance,
+                              SqStorageResultFunc callback,
+                              void         *data)
+{
+	SqStorageAsync *async;
+
+	async = sq_storage_async_new(table_name, table_type, callback, data);
+	async->kind = SQ_STORAGE_ASYNC_INSERT;
+	async->instance = instance;
+	return sq_storage_queue_crud(storage, async);
+}
+
+int   sq_storage_update_async(SqStorage    *storage,
+                              const char   *table_name,
+                              const SqType *table_type,
+                              void         *instance,
+                              SqStorageResultFunc callback,
+                              void         *data)
+{
+	SqStorageAsync *async;
+
+	async = sq_storage_async_new(table_name, table_type, callback, data);
+	async->kind = SQ_STORAGE_ASYNC_UPDATE;
+	async->instance = instance;
+	return sq_storage_queue_crud(storage, async);
+}
+
+int   sq_storage_remove_async(SqStorage    *storage,
+                              const char   *table_name,
+                              const SqType *table_type,
+                              int64_t       id,
+                              SqStorageResultFunc callback,
+                              void         *data)
+{
+	SqStorageAsync *async;
+
+	async = sq_storage_async_new(table_name, table_type, callback, data);
+	async->kind = SQ_STORAGE_ASYNC_REMOVE;
+	async->id = id;
+	return sq_storage_queue_crud(storage, async);
+}
+
+int   sq_storage_remove_all_async(SqStorage    *storage,
+                                  const char   *table_name,
+                                  const char   *sql_where_having,
+                                  SqStorageResultFunc callback,
+                                  void         *data)
+{
+	SqStorageAsync *async;
+
+	async = sq_storage_async_new(table_name, NULL, callback, data);
+	async->kind = SQ_STORAGE_ASYNC_REMOVE_ALL;
+	async->sql_where_having = (sql_where_having) ? strdup(sql_where_having) : NULL;
+	return sq_storage_queue_crud(storage, async);
+}
+
+// ----------------------------------------------------------------------------
+// static function
+
+// SqStorageWorkFunc
+static void sq_storage_run_crud(SqStorage *storage, void *async_ptr)
+{
+	SqStorageAsync  *async = async_ptr;
+	SqStorageResult  result = {SQCODE_OK, NULL, 0};
+
+	switch (async->kind) {
+	case SQ_STORAGE_ASYNC_GET:
+		result.instance = sq_storage_get(storage, async->table_name, async->table_type, async->id);
+		if (result.instance == NULL)
+			result.code = SQCODE_NO_DATA;
+		break;
+
+	case SQ_STORAGE_ASYNC_GET_ALL:
+		result.instance = sq_storage_get_all(storage, async->table_name, async->table_type,
+		                                     async->container_type, async->sql_where_having);
+		if (result.instance == NULL)
+			result.code = SQCODE_ERROR;
+		break;
+
+	case SQ_STORAGE_ASYNC_QUERY:
+		result.instance = sq_storage_query(storage, async->query, async->table_type, async->container_type);
+		if (result.instance == NULL)
+			result.code = SQCODE_ERROR;
+		break;
+
+	case SQ_STORAGE_ASYNC_INSERT:
+		result.value = sq_storage_insert(storage, async->table_name, async->table_type, async->instance);
+		result.instance = async->instance;
+		if (result.value <= 0)
+			result.code = SQCODE_EXEC_ERROR;
+		break;
+
+	case SQ_STORAGE_ASYNC_UPDATE:
+		result.value = sq_storage_update(storage, async->table_name, async->table_type, async->instance);
+		result.instance = async->instance;
+		if (result.value < 0)
+			result.code = SQCODE_EXEC_ERROR;
+		break;
+
+	case SQ_STORAGE_ASYNC_REMOVE:
+		sq_storage_remove(storage, async->table_name, async->table_type, async->id);
+		break;
+
+	case SQ_STORAGE_ASYNC_REMOVE_ALL:
+		sq_storage_remove_all(storage, async->table_name, async->sql_where_having);
+		break;
+	}
+
+	if (async->callback)
+		async->callback(&result, async->data);
+
+	free(async->table_name);
+	free(async->sql_where_having);
+	free(async);
+}
+
+static int  sq_storage_queue_crud(SqStorage *storage, SqStorageAsync *async)
+{
+	int  code;
+
+	code = sq_storage_run_async(storage, sq_storage_run_crud, async);
+	if (code != SQCODE_OK) {
+		free(async->table_name);
+		free(async->sql_where_having);
+		free(async);
+	}
+	return code;
+}
+
+static SqStorageAsync *sq_storage_async_new(const char *table_name, const SqType *table_type,
+                                            SqStorageResultFunc callback, void *data)
+{
+	SqStorageAsync *async;
+
+	async = calloc(1, sizeof(SqStorageAsync));
+	async->table_name = (table_name) ? strdup(table_name) : NULL;
+	async->table_type = table_type;
+	async->callback = callback;
+	async->data = data;
+	return async;
+}
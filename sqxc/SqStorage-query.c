@@ -73,28 +73,39 @@ void *sq_storage_query(SqStorage    *storage,
                        const SqType *table_type,
                        const SqType *container_type)
 {
+	Sqdb       *db;
 	Sqxc       *xcvalue;
+	Sqxc       *xcsql;
 	void       *instance;
 
 	if (container_type == NULL)
 		container_type = storage->container_default;
+
+	// SqStorage.joint_default is also protected by lock of 'db' in thread-safe mode
+	db = sq_storage_lock_db(storage);
+	if (db == NULL)
+		return NULL;
 	if (table_type == NULL) {
 		table_type = sq_storage_setup_query(storage, query, storage->joint_default);
-		if (table_type == NULL)
+		if (table_type == NULL) {
+			sq_storage_unlock_db(storage);
 			return NULL;
+		}
 	}
 
 	// destination of input
-	xcvalue = (Sqxc*) storage->xc_input;
+	sq_storage_acquire_xc(storage, &xcvalue, &xcsql);
 	sqxc_value_element(xcvalue)   = table_type;
 	sqxc_value_container(xcvalue) = container_type;
 	sqxc_value_instance(xcvalue)  = NULL;
 
 	// execute SQL statement and get result
 	sqxc_ready(xcvalue, NULL);
-	sqdb_exec(storage->db, sq_query_c(query), xcvalue, NULL);
+	sqdb_exec(db, sq_query_c(query), xcvalue, NULL);
+	sq_storage_unlock_db(storage);
 	sqxc_finish(xcvalue, NULL);
 	instance = sqxc_value_instance(xcvalue);
+	sq_storage_release_xc(storage, xcvalue, xcsql);
 
 	return instance;
 }
@@ -25,8 +25,10 @@
 #include <SqStorage.h>
 #include <SqxcSql.h>
 #include <SqxcValue.h>
-#if SQ_CONFIG_HAVE_JSONC
-#include <SqxcJsonc.h>
+#include <SqxcJson.h>
+#if SQ_CONFIG_HAVE_THREAD
+#include <SqThread.h>
+#include <SqdbPool.h>
 #endif
 
 #ifdef _MSC_VER
@@ -40,7 +42,134 @@
 
 #define SCHEMA_INITIAL_VERSION       0
 
+/* SqStorageCursor - get result row by row */
+struct SqStorageCursor
+{
+	SqStorage    *storage;
+	Sqdb         *db;          // database that is locked by cursor
+	void         *cursor;      // returned by sqdb_cursor_open()
+	Sqxc         *xc;          // SqxcValue chain that is used only by this cursor
+	const SqType *type;        // type of row
+	void         *instance;    // row data. It is reused by every row.
+	SqTypeJoint  *joint;       // it is created if query has joined multi-table and 'table_type' is NULL
+};
+
+/* SqStorageOutput - instance of SqTypeOutput_.
+   SqxcValue parses rows by SqTypeOutput_, it sends them to output Sqxc chain instead of creating instances.
+ */
+typedef struct SqStorageOutput  SqStorageOutput;
+
+struct SqStorageOutput
+{
+	Sqxc         *xc;          // current element of output Sqxc chain
+	const SqType *type;        // type of row. It is used to decide type of columns and can be NULL.
+};
+
+/* SqStorageImport - insert JSON array of objects by multi-row INSERT statements in a transaction.
+   SqxcValue parses JSON by SqTypeImport_. Fields of row are kept until the end of row,
+   then they are sent to SqxcSql in order of columns.
+ */
+typedef struct SqStorageImportField  SqStorageImportField;
+
+struct SqStorageImportField
+{
+	uint16_t      type;        // SqxcType
+	int           column;      // index of column in table type. -1 if field is in object/array of column.
+	int           name;        // offset of name in SqStorageImport.strs. -1 if field doesn't have name.
+	int           str;         // offset of string in SqStorageImport.strs if 'type' is SQXC_TYPE_STR.
+	SqValue       value;
+	const SqType *value_type;  // type of converted 'value'. NULL if 'value' isn't converted.
+};
+
+struct SqStorageImport
+{
+	SqStorage    *storage;
+	Sqxc         *xc;          // SqxcValue + SqxcJsonParser chain that is used only by import
+	Sqxc         *xcsql;       // SqxcSql + SqxcJsonWriter chain that is used only by import
+	const SqType *type;        // type of table
+	int           code;        // the first error. SqxcJsonParser doesn't stop if destination returns error.
+	int           depth;       // 1 = in top level array, 2 = in row, -1 = top level array is completed.
+
+	// fields of current row
+	SqArray       fields;      // element type is SqStorageImportField
+	SqBuffer      strs;        // names and strings of fields
+	int          *slots;       // index of field for each column, -1 if column isn't in current row.
+	char         *used;        // columns in the first row. All rows must have the same columns.
+	int           n_rows;
+};
+
+#if SQ_CONFIG_HAVE_THREAD
+typedef struct SqStorageLock    SqStorageLock;
+typedef struct SqStorageWork    SqStorageWork;
+typedef struct SqStorageWorkers SqStorageWorkers;
+
+/* SqStorageLock - database that is locked by thread */
+struct SqStorageLock
+{
+	SqThreadData  owner;
+	Sqdb         *db;
+	int           count;      // database can be locked recursively by 'owner'
+};
+
+/* SqStorageThread - data for thread-safe mode */
+struct SqStorageThread
+{
+	// serialize access to SqStorage.db if 'pool' is NULL
+	SqMutex       db_mutex;
+	// threads get their connections from 'pool' if it is not NULL
+	SqdbPool     *pool;
+
+	// protect 'locks', 'xc_pool' and SqStorage.tables
+	SqMutex       mutex;
+	// databases that are locked by threads. element type is SqStorageLock
+	SqArray       locks;
+	// pool of Sqxc chains. Each pair is { xc_input, xc_output }
+	SqPtrArray    xc_pool;
+
+	// worker threads that run asynchronous functions. It is NULL if workers are not started.
+	SqStorageWorkers *workers;
+};
+
+/* SqStorageWork - element of work queue */
+struct SqStorageWork
+{
+	SqStorageWorkFunc  func;
+	void              *data;
+};
+
+/* SqStorageWorkers - worker threads that run queued work */
+struct SqStorageWorkers
+{
+	SqStorage  *storage;
+	SqThread   *threads;
+	int         n_threads;
+	bool        stopping;
+
+	// FIFO queue. Elements before 'queue_head' have been taken by workers.
+	SqArray     queue;        // element type is SqStorageWork
+	int         queue_head;
+
+	SqMutex     mutex;
+	SqCond      cond;         // signaled when work is queued or workers are stopping
+};
+
+
+static SqStorageLock *sq_storage_find_lock(SqStorageThread *thread, SqThreadData owner);
+static SqThreadResult sq_storage_worker(void *workers);
+#endif  // SQ_CONFIG_HAVE_THREAD
+
+static void sq_storage_new_xc(Sqxc **xc_input, Sqxc **xc_output);
+static void sq_storage_update_xc(SqStorage    *storage,
+                                 const char   *table_name,
+                                 const SqType *table_type,
+                                 void         *instance,
+                                 Sqxc         *xc_input,
+                                 Sqxc         *xc_output);
+
 static int  print_where_column(const SqColumn *column, void *instance, SqBuffer *buf, const char quote[2]);
+static SqStorageCursor *sq_storage_cursor_new(SqStorage *storage, const char *sql, const SqType *table_type);
+static int  sq_storage_exec_xc(SqStorage *storage, const char *sql, const SqType *table_type, Sqxc *xc_output);
+static const SqType SqTypeImport_;
 static int  sqxc_sql_set_columns(SqxcSql      *xcsql,
                                  const SqType *table_type,
                                  const char   *sql_where_having,
@@ -62,18 +191,14 @@ void  sq_storage_init(SqStorage *storage, Sqdb *db)
 	storage->joint_default     = sq_type_joint_new();
 	storage->container_default = SQ_TYPE_PTR_ARRAY;
 
-	storage->xc_input  = sqxc_new(SQXC_INFO_VALUE);
-	storage->xc_output = sqxc_new(SQXC_INFO_SQL);
-
-#if SQ_CONFIG_HAVE_JSONC
-	// append JSON parser/writer to tail of list
-	sqxc_insert(storage->xc_input,  sqxc_new(SQXC_INFO_JSONC_PARSER), -1);
-	sqxc_insert(storage->xc_output, sqxc_new(SQXC_INFO_JSONC_WRITER), -1);
-#endif
+	sq_storage_new_xc(&storage->xc_input, &storage->xc_output);
+	storage->thread = NULL;
 }
 
 void  sq_storage_final(SqStorage *storage)
 {
+	sq_storage_set_thread_safe(storage, false);
+
 	sq_schema_free(storage->schema);
 	sq_ptr_array_final(&storage->tables);
 
@@ -109,16 +234,322 @@ int   sq_storage_close(SqStorage *storage)
 
 int   sq_storage_migrate(SqStorage *storage, SqSchema *schema)
 {
+	// migration always uses 'storage->db' and must be done before 'storage' is shared between threads.
 	return sqdb_migrate(storage->db, storage->schema, schema);
 }
 
+// ------------------------------------
+// thread-safe mode
+
+int   sq_storage_set_thread_safe(SqStorage *storage, bool thread_safe)
+{
+#if SQ_CONFIG_HAVE_THREAD
+	SqStorageThread *thread = storage->thread;
+	int  index;
+
+	if (thread_safe) {
+		if (thread == NULL) {
+			thread = malloc(sizeof(SqStorageThread));
+			sq_mutex_init(&thread->db_mutex);
+			sq_mutex_init(&thread->mutex);
+			thread->pool = NULL;
+			sq_array_init(&thread->locks, sizeof(SqStorageLock), 8);
+			sq_ptr_array_init(&thread->xc_pool, 8, NULL);
+			thread->workers = NULL;
+			storage->thread = thread;
+		}
+	}
+	else if (thread) {
+		sq_storage_stop_workers(storage);
+		for (index = 0;  index < thread->xc_pool.length;  index++)
+			sqxc_free_chain(thread->xc_pool.data[index]);
+		sq_ptr_array_final(&thread->xc_pool);
+		sq_array_final(&thread->locks);
+		sq_mutex_clear(&thread->db_mutex);
+		sq_mutex_clear(&thread->mutex);
+		free(thread);
+		storage->thread = NULL;
+	}
+	return SQCODE_OK;
+#else
+	return (thread_safe) ? SQCODE_NOT_SUPPORT : SQCODE_OK;
+#endif  // SQ_CONFIG_HAVE_THREAD
+}
+
+int   sq_storage_set_pool(SqStorage *storage, SqdbPool *pool)
+{
+#if SQ_CONFIG_HAVE_THREAD
+	if (pool)
+		sq_storage_set_thread_safe(storage, true);
+	if (storage->thread)
+		storage->thread->pool = pool;
+	return SQCODE_OK;
+#else
+	return (pool) ? SQCODE_NOT_SUPPORT : SQCODE_OK;
+#endif  // SQ_CONFIG_HAVE_THREAD
+}
+
+// ------------------------------------
+// worker threads
+
+int   sq_storage_start_workers(SqStorage *storage, int n_workers)
+{
+#if SQ_CONFIG_HAVE_THREAD
+	SqStorageWorkers *workers;
+	int  index;
+
+	if (n_workers <= 0)
+		return SQCODE_ERROR;
+	// Each worker holds its own connection from SqdbPool.
+	// Without enough connections, workers are serialized or blocked.
+	if (storage->thread == NULL || storage->thread->pool == NULL)
+		return SQCODE_NOT_SUPPORT;
+	if (sqdb_pool_max_size(storage->thread->pool) < n_workers)
+		return SQCODE_ERROR;
+	if (storage->thread->workers)
+		return SQCODE_OK;
+
+	workers = malloc(sizeof(SqStorageWorkers));
+	workers->storage = storage;
+	workers->threads = malloc(sizeof(SqThread) * n_workers);
+	workers->n_threads = 0;
+	workers->stopping = false;
+	sq_array_init(&workers->queue, sizeof(SqStorageWork), 16);
+	workers->queue_head = 0;
+	sq_mutex_init(&workers->mutex);
+	sq_cond_init(&workers->cond);
+	storage->thread->workers = workers;
+
+	for (index = 0;  index < n_workers;  index++) {
+		if (sq_thread_create(&workers->threads[index], sq_storage_worker, workers) != SQ_THREAD_OK)
+			break;
+		workers->n_threads++;
+	}
+	if (workers->n_threads == 0) {
+		sq_storage_stop_workers(storage);
+		return SQCODE_ERROR;
+	}
+	return SQCODE_OK;
+#else
+	return SQCODE_NOT_SUPPORT;
+#endif  // SQ_CONFIG_HAVE_THREAD
+}
+
+int   sq_storage_stop_workers(SqStorage *storage)
+{
+#if SQ_CONFIG_HAVE_THREAD
+	SqStorageWorkers *workers;
+	int  index;
+
+	if (storage->thread == NULL || storage->thread->workers == NULL)
+		return SQCODE_OK;
+	workers = storage->thread->workers;
+
+	// workers exit after all queued work is done
+	sq_mutex_lock(&workers->mutex);
+	workers->stopping = true;
+	sq_cond_broadcast(&workers->cond);
+	sq_mutex_unlock(&workers->mutex);
+	for (index = 0;  index < workers->n_threads;  index++)
+		sq_thread_join(&workers->threads[index]);
+
+	storage->thread->workers = NULL;
+	free(workers->threads);
+	sq_array_final(&workers->queue);
+	sq_mutex_clear(&workers->mutex);
+	sq_cond_clear(&workers->cond);
+	free(workers);
+#endif  // SQ_CONFIG_HAVE_THREAD
+	return SQCODE_OK;
+}
+
+int   sq_storage_run_async(SqStorage *storage, SqStorageWorkFunc func, void *data)
+{
+#if SQ_CONFIG_HAVE_THREAD
+	SqStorageWorkers *workers;
+	SqStorageWork    *work;
+
+	if (storage->thread == NULL || storage->thread->workers == NULL)
+		return SQCODE_NOT_SUPPORT;
+	workers = storage->thread->workers;
+
+	sq_mutex_lock(&workers->mutex);
+	if (workers->stopping) {
+		sq_mutex_unlock(&workers->mutex);
+		return SQCODE_NOT_SUPPORT;
+	}
+	work = sq_array_alloc(&workers->queue, 1);
+	work->func = func;
+	work->data = data;
+	sq_cond_signal(&workers->cond);
+	sq_mutex_unlock(&workers->mutex);
+	return SQCODE_OK;
+#else
+	return SQCODE_NOT_SUPPORT;
+#endif  // SQ_CONFIG_HAVE_THREAD
+}
+
+void  sq_storage_acquire_xc(SqStorage *storage, Sqxc **xc_input, Sqxc **xc_output)
+{
+#if SQ_CONFIG_HAVE_THREAD
+	SqStorageThread *thread = storage->thread;
+
+	if (thread) {
+		sq_mutex_lock(&thread->mutex);
+		if (thread->xc_pool.length >= 2) {
+			thread->xc_pool.length -= 2;
+			*xc_input  = thread->xc_pool.data[thread->xc_pool.length];
+			*xc_output = thread->xc_pool.data[thread->xc_pool.length + 1];
+			sq_mutex_unlock(&thread->mutex);
+		}
+		else {
+			sq_mutex_unlock(&thread->mutex);
+			sq_storage_new_xc(xc_input, xc_output);
+		}
+		return;
+	}
+#endif  // SQ_CONFIG_HAVE_THREAD
+	*xc_input  = storage->xc_input;
+	*xc_output = storage->xc_output;
+}
+
+void  sq_storage_release_xc(SqStorage *storage, Sqxc *xc_input, Sqxc *xc_output)
+{
+#if SQ_CONFIG_HAVE_THREAD
+	SqStorageThread *thread = storage->thread;
+
+	if (thread) {
+		sq_mutex_lock(&thread->mutex);
+		sq_ptr_array_push(&thread->xc_pool, xc_input);
+		sq_ptr_array_push(&thread->xc_pool, xc_output);
+		sq_mutex_unlock(&thread->mutex);
+	}
+#endif  // SQ_CONFIG_HAVE_THREAD
+}
+
+Sqdb *sq_storage_lock_db(SqStorage *storage)
+{
+#if SQ_CONFIG_HAVE_THREAD
+	SqStorageThread *thread = storage->thread;
+	SqStorageLock   *lock;
+	SqThreadData     self;
+	Sqdb            *db;
+
+	if (thread) {
+		self = sq_thread_self();
+		sq_mutex_lock(&thread->mutex);
+		lock = sq_storage_find_lock(thread, self);
+		if (lock) {
+			// current thread has locked database
+			lock->count++;
+			sq_mutex_unlock(&thread->mutex);
+			return lock->db;
+		}
+		sq_mutex_unlock(&thread->mutex);
+
+		if (thread->pool)
+			db = sqdb_pool_acquire(thread->pool);
+		else {
+			sq_mutex_lock(&thread->db_mutex);
+			db = storage->db;
+		}
+		if (db == NULL)
+			return NULL;
+
+		sq_mutex_lock(&thread->mutex);
+		lock = sq_array_alloc(&thread->locks, 1);
+		lock->owner = self;
+		lock->db    = db;
+		lock->count = 1;
+		sq_mutex_unlock(&thread->mutex);
+		return db;
+	}
+#endif  // SQ_CONFIG_HAVE_THREAD
+	return storage->db;
+}
+
+void  sq_storage_unlock_db(SqStorage *storage)
+{
+#if SQ_CONFIG_HAVE_THREAD
+	SqStorageThread *thread = storage->thread;
+	SqStorageLock   *lock;
+	Sqdb            *db;
+
+	if (thread) {
+		sq_mutex_lock(&thread->mutex);
+		lock = sq_storage_find_lock(thread, sq_thread_self());
+		if (lock == NULL || --lock->count > 0) {
+			sq_mutex_unlock(&thread->mutex);
+			return;
+		}
+		db = lock->db;
+		SQ_ARRAY_STEAL_ADDR(&thread->locks, SqStorageLock, lock, 1);
+		sq_mutex_unlock(&thread->mutex);
+
+		if (thread->pool)
+			sqdb_pool_release(thread->pool, db);
+		else
+			sq_mutex_unlock(&thread->db_mutex);
+	}
+#endif  // SQ_CONFIG_HAVE_THREAD
+}
+
+int   sq_storage_begin_trans(SqStorage *storage)
+{
+	Sqdb *db;
+	int   code;
+
+	db = sq_storage_lock_db(storage);
+	if (db == NULL)
+		return SQCODE_TIMEOUT;
+	code = sqdb_exec(db, "BEGIN", NULL, NULL);
+	if (code != SQCODE_OK)
+		sq_storage_unlock_db(storage);
+	return code;
+}
+
+int   sq_storage_commit_trans(SqStorage *storage)
+{
+	Sqdb *db;
+	int   code;
+
+	// get database that is locked by sq_storage_begin_trans()
+	db = sq_storage_lock_db(storage);
+	if (db == NULL)
+		return SQCODE_TIMEOUT;
+	code = sqdb_exec(db, "COMMIT", NULL, NULL);
+	sq_storage_unlock_db(storage);
+	sq_storage_unlock_db(storage);
+	return code;
+}
+
+int   sq_storage_rollback_trans(SqStorage *storage)
+{
+	Sqdb *db;
+	int   code;
+
+	// get database that is locked by sq_storage_begin_trans()
+	db = sq_storage_lock_db(storage);
+	if (db == NULL)
+		return SQCODE_TIMEOUT;
+	code = sqdb_exec(db, "ROLLBACK", NULL, NULL);
+	sq_storage_unlock_db(storage);
+	sq_storage_unlock_db(storage);
+	return code;
+}
+
+// ------------------------------------
+// CRUD functions
+
 void *sq_storage_get(SqStorage    *storage,
                      const char   *table_name,
                      const SqType *table_type,
                      int64_t       id)
 {
 	SqBuffer *buf;
+	Sqdb     *db;
 	Sqxc     *xcvalue;
+	Sqxc     *xcsql;
 	union {
 		SqColumn *column;
 		SqTable  *table;
@@ -136,7 +567,7 @@ void *sq_storage_get(SqStorage    *storage,
 	}
 
 	// destination of input
-	xcvalue = storage->xc_input;
+	sq_storage_acquire_xc(storage, &xcvalue, &xcsql);
 	sqxc_value_element(xcvalue)   = table_type;
 	sqxc_value_container(xcvalue) = NULL;
 	sqxc_value_instance(xcvalue)  = NULL;
@@ -150,16 +581,18 @@ void *sq_storage_get(SqStorage    *storage,
 	print_where_column(temp.column, &id, buf, storage->db->info->quote.identifier);
 
 	sqxc_ready(xcvalue, NULL);
-	temp.code = sqdb_exec(storage->db, buf->mem, xcvalue, NULL);
+	db = sq_storage_lock_db(storage);
+	temp.code = (db) ? sqdb_exec(db, buf->mem, xcvalue, NULL) : SQCODE_TIMEOUT;
+	sq_storage_unlock_db(storage);
 	sqxc_finish(xcvalue, NULL);
 	if (temp.code != SQCODE_OK) {
-		storage->xc_input->code = temp.code;
-		sq_type_final_instance(table_type, sqxc_value_instance(xcvalue), false);
-		free(sqxc_value_instance(xcvalue));
+		xcvalue->code = temp.code;
+		// instance may be allocated by slab if table_type has SQB_TYPE_SLAB
+		sq_type_final_instance(table_type, &sqxc_value_instance(xcvalue), true);
 		sqxc_value_instance(xcvalue) = NULL;
-		return NULL;
 	}
 	temp.instance = sqxc_value_instance(xcvalue);
+	sq_storage_release_xc(storage, xcvalue, xcsql);
 	return temp.instance;
 }
 
@@ -169,7 +602,20 @@ void *sq_storage_get_all(SqStorage    *storage,
                          const SqType *container_type,
                          const char   *sql_where_having)
 {
+	return sq_storage_get_all_arena(storage, table_name, table_type,
+	                                container_type, sql_where_having, NULL);
+}
+
+void *sq_storage_get_all_arena(SqStorage    *storage,
+                               const char   *table_name,
+                               const SqType *table_type,
+                               const SqType *container_type,
+                               const char   *sql_where_having,
+                               SqArena      *arena)
+{
+	Sqdb     *db;
 	Sqxc     *xcvalue;
+	Sqxc     *xcsql;
 	union {
 		SqBuffer *buf;
 		SqTable  *table;
@@ -185,12 +631,15 @@ void *sq_storage_get_all(SqStorage    *storage,
 	}
 	if (container_type == NULL)
 		container_type = (SqType*)storage->container_default;
+	if (arena && sq_type_can_use_arena(table_type) == false)
+		return NULL;
 
 	// destination of input
-	xcvalue = (Sqxc*) storage->xc_input;
+	sq_storage_acquire_xc(storage, &xcvalue, &xcsql);
 	sqxc_value_element(xcvalue)   = table_type;
 	sqxc_value_container(xcvalue) = container_type;
 	sqxc_value_instance(xcvalue)  = NULL;
+	sqxc_value_arena(xcvalue)     = arena;
 
 	// SQL statement
 	temp.buf = sqxc_get_buffer(xcvalue);
@@ -202,9 +651,14 @@ void *sq_storage_get_all(SqStorage    *storage,
 		sq_buffer_write(temp.buf, sql_where_having);
 
 	sqxc_ready(xcvalue, NULL);
-	sqdb_exec(storage->db, temp.buf->mem, xcvalue, NULL);
+	db = sq_storage_lock_db(storage);
+	if (db)
+		sqdb_exec(db, temp.buf->mem, xcvalue, NULL);
+	sq_storage_unlock_db(storage);
 	sqxc_finish(xcvalue, NULL);
 	temp.instance = sqxc_value_instance(xcvalue);
+	sqxc_value_arena(xcvalue) = NULL;
+	sq_storage_release_xc(storage, xcvalue, xcsql);
 	return temp.instance;
 }
 
@@ -213,9 +667,12 @@ int64_t sq_storage_insert(SqStorage    *storage,
                           const SqType *table_type,
                           void         *instance)
 {
+	Sqdb      *db;
+	Sqxc      *xcvalue;
+	Sqxc      *xcsql;
 	union {
 		SqTable   *table;
-		Sqxc      *xcsql;
+		int64_t    id;
 	} temp;
 
 	if (table_type == NULL) {
@@ -226,17 +683,216 @@ int64_t sq_storage_insert(SqStorage    *storage,
 		table_type = temp.table->type;
 	}
 
+	db = sq_storage_lock_db(storage);
+	if (db == NULL)
+		return 0;
+
 	// destination of output
-	temp.xcsql = storage->xc_output;
-	sqxc_sql_set_db(temp.xcsql, storage->db);
-	sqxc_ctrl(temp.xcsql, SQXC_SQL_CTRL_INSERT, (void*)table_name);
+	sq_storage_acquire_xc(storage, &xcvalue, &xcsql);
+	sqxc_sql_set_db(xcsql, db);
+	sqxc_ctrl(xcsql, SQXC_SQL_CTRL_INSERT, (void*)table_name);
 
-	sqxc_ready(temp.xcsql, NULL);
-	table_type->write(instance, table_type, temp.xcsql);
-	sqxc_finish(temp.xcsql, NULL);
+	sqxc_ready(xcsql, NULL);
+	table_type->write(instance, table_type, xcsql);
+	sqxc_finish(xcsql, NULL);
+	sq_storage_unlock_db(storage);
 
 	// return the last inserted row id
-	return sqxc_sql_id(temp.xcsql);
+	temp.id = sqxc_sql_id(xcsql);
+	sq_storage_release_xc(storage, xcvalue, xcsql);
+	return temp.id;
+}
+
+int64_t sq_storage_insert_all(SqStorage    *storage,
+                              const char   *table_name,
+                              const SqType *table_type,
+                              void         *container,
+                              const SqType *container_type,
+                              int64_t      *id_range)
+{
+	SqType     type_temp;
+	Sqdb      *db;
+	Sqxc      *xcvalue;
+	Sqxc      *xcsql;
+	SqTable   *table;
+	int64_t    changes;
+	int        code;
+
+	if (table_type == NULL) {
+		// find SqTable by table_name
+		table = sq_schema_find(storage->schema, table_name);
+		if (table == NULL)
+			return -1;
+		table_type = table->type;
+	}
+	if (container_type == NULL)
+		container_type = (SqType*)storage->container_default;
+	// If container type doesn't have element type, use 'table_type' as element type.
+	if (container_type->n_entry != -1 || container_type->entry == NULL) {
+		type_temp = *container_type;
+		type_temp.entry = (SqEntry**)table_type;
+		type_temp.n_entry = -1;    // SqType.entry isn't freed if SqType.n_entry == -1
+		container_type = &type_temp;
+	}
+
+	// sq_storage_begin_trans() locks 'db' until transaction is committed or rolled back.
+	if (sq_storage_begin_trans(storage) != SQCODE_OK)
+		return -1;
+	// get database that is locked by sq_storage_begin_trans()
+	db = sq_storage_lock_db(storage);
+	sq_storage_unlock_db(storage);
+
+	// destination of output
+	sq_storage_acquire_xc(storage, &xcvalue, &xcsql);
+	sqxc_sql_set_db(xcsql, db);
+	sqxc_ctrl(xcsql, SQXC_SQL_CTRL_INSERT, (void*)table_name);
+
+	sqxc_ready(xcsql, NULL);
+	xcsql->name = NULL;
+	code = container_type->write(container, container_type, xcsql)->code;
+	if (sqxc_finish(xcsql, NULL) != SQCODE_OK)
+		code = SQCODE_EXEC_ERROR;
+
+	if (code != SQCODE_OK)
+		sq_storage_rollback_trans(storage);
+	else
+		code = sq_storage_commit_trans(storage);
+
+	if (code == SQCODE_OK) {
+		if (id_range) {
+			id_range[0] = sqxc_sql_id_first(xcsql);
+			id_range[1] = sqxc_sql_id(xcsql);
+		}
+		// number of inserted rows
+		changes = sqxc_sql_changes(xcsql);
+	}
+	else
+		changes = -1;
+	sq_storage_release_xc(storage, xcvalue, xcsql);
+	return changes;
+}
+
+int64_t sq_storage_insert_json(SqStorage    *storage,
+                               const char   *table_name,
+                               const SqType *table_type,
+                               const char   *json)
+{
+	SqStorageImport *import;
+
+	import = sq_storage_import_new(storage, table_name, table_type);
+	if (import == NULL)
+		return -1;
+	sq_storage_import_json(import, json);
+	return sq_storage_import_end(import);
+}
+
+SqStorageImport *sq_storage_import_new(SqStorage    *storage,
+                                       const char   *table_name,
+                                       const SqType *table_type)
+{
+	SqStorageImport *import;
+	SqTable   *table;
+	Sqdb      *db;
+
+	if (table_type == NULL) {
+		// find SqTable by table_name
+		table = sq_schema_find(storage->schema, table_name);
+		if (table == NULL)
+			return NULL;
+		table_type = table->type;
+	}
+
+	// sq_storage_begin_trans() locks 'db' until transaction is committed or rolled back.
+	if (sq_storage_begin_trans(storage) != SQCODE_OK)
+		return NULL;
+	// get database that is locked by sq_storage_begin_trans()
+	db = sq_storage_lock_db(storage);
+	sq_storage_unlock_db(storage);
+
+	import = malloc(sizeof(SqStorageImport));
+	import->storage = storage;
+	import->type    = table_type;
+	import->code    = SQCODE_OK;
+	import->depth   = 0;
+	import->n_rows  = 0;
+	sq_array_init(&import->fields, sizeof(SqStorageImportField), 16);
+	sq_buffer_init(&import->strs);
+	import->slots = malloc(sizeof(int) * (table_type->n_entry + 1));
+	import->used  = malloc(table_type->n_entry + 1);
+
+	// import uses its Sqxc chains because user may call other functions between pieces of JSON.
+	// destination of input. It uses 'import' as instance, so it doesn't create instance.
+	import->xc = sqxc_new(SQXC_INFO_VALUE);
+	sqxc_insert(import->xc, sqxc_new(SQXC_INFO_JSON_PARSER), -1);
+	sqxc_value_element(import->xc)   = &SqTypeImport_;
+	sqxc_value_container(import->xc) = NULL;
+	sqxc_value_instance(import->xc)  = import;
+	// destination of output
+	import->xcsql = sqxc_new(SQXC_INFO_SQL);
+	sqxc_insert(import->xcsql, sqxc_new(SQXC_INFO_JSON_WRITER), -1);
+	sqxc_sql_set_db(import->xcsql, db);
+	sqxc_ctrl(import->xcsql, SQXC_SQL_CTRL_INSERT, (void*)table_name);
+
+	sqxc_ready(import->xcsql, NULL);
+	sqxc_ready(import->xc, NULL);
+	return import;
+}
+
+int   sq_storage_import_json(SqStorageImport *import, const char *json)
+{
+	Sqxc  *xc = import->xc;
+	int    code;
+
+	if (import->code != SQCODE_OK)
+		return import->code;
+
+	xc->type = SQXC_TYPE_STR;
+	xc->name = NULL;
+	xc->value.str = (char*)json;
+	code = sqxc_send_to(sqxc_find(xc, SQXC_INFO_JSON_PARSER), xc);
+	// error occurred while inserting rows
+	if (import->code != SQCODE_OK)
+		return import->code;
+	if (code == SQCODE_JSON_ERROR)
+		import->code = code;
+	return code;
+}
+
+int64_t sq_storage_import_end(SqStorageImport *import)
+{
+	SqStorage *storage = import->storage;
+	int64_t    changes;
+	int        code;
+
+	code = import->code;
+	// top level array must be completed
+	if (code == SQCODE_OK && import->depth != -1)
+		code = SQCODE_TYPE_END_ERROR;
+
+	sqxc_finish(import->xc, NULL);
+	// execute remaining rows
+	if (sqxc_finish(import->xcsql, NULL) != SQCODE_OK)
+		code = SQCODE_EXEC_ERROR;
+
+	if (code != SQCODE_OK)
+		sq_storage_rollback_trans(storage);
+	else
+		code = sq_storage_commit_trans(storage);
+
+	if (code == SQCODE_OK)
+		changes = sqxc_sql_changes(import->xcsql);
+	else
+		changes = -1;
+
+	sqxc_value_instance(import->xc) = NULL;
+	sqxc_free_chain(import->xc);
+	sqxc_free_chain(import->xcsql);
+	sq_array_final(&import->fields);
+	sq_buffer_final(&import->strs);
+	free(import->slots);
+	free(import->used);
+	free(import);
+	return changes;
 }
 
 int   sq_storage_update(SqStorage    *storage,
@@ -244,43 +900,25 @@ int   sq_storage_update(SqStorage    *storage,
                         const SqType *table_type,
                         void         *instance)
 {
+	Sqxc      *xcvalue;
 	Sqxc      *xcsql;
-	SqBuffer  *buf;
-	union {
-		SqTable   *table;
-		SqColumn  *column;
-	} temp;
+	SqTable   *table;
+	int64_t    changes;
 
 	if (table_type == NULL) {
 		// find SqTable by table_name
-		temp.table = sq_schema_find(storage->schema, table_name);
-		if (temp.table == NULL)
+		table = sq_schema_find(storage->schema, table_name);
+		if (table == NULL)
 			return 0;
-		table_type = temp.table->type;
+		table_type = table->type;
 	}
 
-	// destination of output
-	xcsql = storage->xc_output;
-	sqxc_sql_set_db(xcsql, storage->db);
-	if (sqxc_sql_condition(xcsql) == NULL) {
-		temp.column = sq_table_get_primary(NULL, table_type);
-		// SQL statement. Because input buffer doesn't use here, I use it temporary.
-		buf = sqxc_get_buffer(storage->xc_input);
-		buf->writed = 0;
-		print_where_column(temp.column, (char*)instance + temp.column->offset,
-		             buf, storage->db->info->quote.identifier);
-		sqxc_sql_condition(xcsql) = buf->mem;
-	}
-	sqxc_ctrl(xcsql, SQXC_SQL_CTRL_UPDATE, table_name);
-
-	sqxc_ready(xcsql, NULL);
-	table_type->write(instance, table_type, xcsql);
-	sqxc_finish(xcsql, NULL);
-	// free WHERE condition
-//	sqxc_sql_condition(temp.xcsql) = NULL;    // this has been done in sqxc_finish()
-
-	// return number of rows changed
-	return (int)sqxc_sql_changes(xcsql);
+	sq_storage_acquire_xc(storage, &xcvalue, &xcsql);
+	sq_storage_update_xc(storage, table_name, table_type, instance, xcvalue, xcsql);
+	// number of rows changed
+	changes = sqxc_sql_changes(xcsql);
+	sq_storage_release_xc(storage, xcvalue, xcsql);
+	return (int)changes;
 }
 
 int64_t sq_storage_update_all(SqStorage    *storage,
@@ -291,28 +929,30 @@ int64_t sq_storage_update_all(SqStorage    *storage,
                               ...)
 {
 	va_list  arg_list;
-	union {
-		SqTable  *table;
-		SqxcSql  *xcsql;
-	} temp;
+	Sqxc    *xcvalue;
+	Sqxc    *xcsql;
+	SqTable *table;
+	int64_t  changes;
 
 	if (table_type == NULL) {
 		// find SqTable by table_name
-		temp.table = sq_schema_find(storage->schema, table_name);
-		if (temp.table == NULL)
+		table = sq_schema_find(storage->schema, table_name);
+		if (table == NULL)
 			return 0;
-		table_type = temp.table->type;
+		table_type = table->type;
 	}
 
 	// set SqxcSql's variable for UPDATE command
-	temp.xcsql = (SqxcSql*)storage->xc_output;
+	sq_storage_acquire_xc(storage, &xcvalue, &xcsql);
 	va_start(arg_list, sql_where_having);
-	sqxc_sql_set_columns(temp.xcsql, table_type, sql_where_having, arg_list);
+	sqxc_sql_set_columns((SqxcSql*)xcsql, table_type, sql_where_having, arg_list);
 	va_end(arg_list);
 
-	sq_storage_update(storage, table_name, table_type, instance);
-	// return number of rows changed
-	return temp.xcsql->changes;
+	sq_storage_update_xc(storage, table_name, table_type, instance, xcvalue, xcsql);
+	// number of rows changed
+	changes = sqxc_sql_changes(xcsql);
+	sq_storage_release_xc(storage, xcvalue, xcsql);
+	return changes;
 }
 
 #if SQ_CONFIG_HAS_STORAGE_UPDATE_FIELD
@@ -325,28 +965,30 @@ int64_t sq_storage_update_field(SqStorage    *storage,
                                 ...)
 {
 	va_list  arg_list;
-	union {
-		SqTable  *table;
-		SqxcSql  *xcsql;
-	} temp;
+	Sqxc    *xcvalue;
+	Sqxc    *xcsql;
+	SqTable *table;
+	int64_t  changes;
 
 	if (table_type == NULL) {
 		// find SqTable by table_name
-		temp.table = sq_schema_find(storage->schema, table_name);
-		if (temp.table == NULL)
+		table = sq_schema_find(storage->schema, table_name);
+		if (table == NULL)
 			return 0;
-		table_type = temp.table->type;
+		table_type = table->type;
 	}
 
 	// set SqxcSql's variable for UPDATE command
-	temp.xcsql = (SqxcSql*)storage->xc_output;
+	sq_storage_acquire_xc(storage, &xcvalue, &xcsql);
 	va_start(arg_list, sql_where_having);
-	sqxc_sql_set_fields(temp.xcsql, table_type, sql_where_having, arg_list);
+	sqxc_sql_set_fields((SqxcSql*)xcsql, table_type, sql_where_having, arg_list);
 	va_end(arg_list);
 
-	sq_storage_update(storage, table_name, table_type, instance);
-	// return number of rows changed
-	return temp.xcsql->changes;
+	sq_storage_update_xc(storage, table_name, table_type, instance, xcvalue, xcsql);
+	// number of rows changed
+	changes = sqxc_sql_changes(xcsql);
+	sq_storage_release_xc(storage, xcvalue, xcsql);
+	return changes;
 }
 #endif  // SQ_CONFIG_HAS_STORAGE_UPDATE_FIELD
 
@@ -356,6 +998,9 @@ void  sq_storage_remove(SqStorage    *storage,
                         int64_t       id)
 {
 	SqBuffer  *buf;
+	Sqdb      *db;
+	Sqxc      *xcvalue;
+	Sqxc      *xcsql;
 	union {
 		SqTable   *table;
 		SqColumn  *column;
@@ -370,11 +1015,16 @@ void  sq_storage_remove(SqStorage    *storage,
 
 	temp.column = table_type ? sq_table_get_primary(NULL, table_type) : NULL;
 
-	buf = sqxc_get_buffer(storage->xc_output);
+	sq_storage_acquire_xc(storage, &xcvalue, &xcsql);
+	buf = sqxc_get_buffer(xcsql);
 	buf->writed = 0;
 	sqdb_sql_from(storage->db, buf, table_name, true);
 	print_where_column(temp.column, &id, buf, storage->db->info->quote.identifier);
-	sqdb_exec(storage->db, buf->mem, NULL, NULL);
+	db = sq_storage_lock_db(storage);
+	if (db)
+		sqdb_exec(db, buf->mem, NULL, NULL);
+	sq_storage_unlock_db(storage);
+	sq_storage_release_xc(storage, xcvalue, xcsql);
 }
 
 void  sq_storage_remove_all(SqStorage    *storage,
@@ -382,13 +1032,183 @@ void  sq_storage_remove_all(SqStorage    *storage,
                             const char   *sql_where_having)
 {
 	SqBuffer  *buf;
+	Sqdb      *db;
+	Sqxc      *xcvalue;
+	Sqxc      *xcsql;
 
-	buf = sqxc_get_buffer(storage->xc_output);
+	sq_storage_acquire_xc(storage, &xcvalue, &xcsql);
+	buf = sqxc_get_buffer(xcsql);
 	buf->writed = 0;
 	sqdb_sql_from(storage->db, buf, table_name, true);
 	if (sql_where_having)
 		sq_buffer_write(buf, sql_where_having);
-	sqdb_exec(storage->db, buf->mem, NULL, NULL);
+	db = sq_storage_lock_db(storage);
+	if (db)
+		sqdb_exec(db, buf->mem, NULL, NULL);
+	sq_storage_unlock_db(storage);
+	sq_storage_release_xc(storage, xcvalue, xcsql);
+}
+
+// ------------------------------------
+// cursor
+
+SqStorageCursor *sq_storage_get_all_cursor(SqStorage    *storage,
+                                           const char   *table_name,
+                                           const SqType *table_type,
+                                           const char   *sql_where_having)
+{
+	SqStorageCursor *cursor;
+	SqBuffer  buf;
+	SqTable  *table;
+
+	if (table_type == NULL) {
+		// find SqTable by table_name
+		table = sq_schema_find(storage->schema, table_name);
+		if (table == NULL)
+			return NULL;
+		table_type = table->type;
+	}
+
+	// SQL statement
+	sq_buffer_init(&buf);
+	sqdb_sql_from(storage->db, &buf, table_name, false);
+	// SQL WHERE ... HAVING ...
+	if (sql_where_having)
+		sq_buffer_write(&buf, sql_where_having);
+	sq_buffer_write_c(&buf, 0);
+
+	cursor = sq_storage_cursor_new(storage, buf.mem, table_type);
+	sq_buffer_final(&buf);
+	return cursor;
+}
+
+SqStorageCursor *sq_storage_query_cursor(SqStorage    *storage,
+                                         SqQuery      *query,
+                                         const SqType *table_type)
+{
+	SqStorageCursor *cursor;
+	SqTypeJoint     *joint = NULL;
+
+	if (table_type == NULL) {
+		// cursor has its own SqTypeJoint because SqStorage.joint_default may be changed by other queries.
+		joint = sq_type_joint_new();
+		table_type = sq_storage_setup_query(storage, query, joint);
+		if (table_type == NULL) {
+			sq_type_joint_free(joint);
+			return NULL;
+		}
+		if (table_type != (SqType*)joint) {
+			sq_type_joint_free(joint);
+			joint = NULL;
+		}
+	}
+
+	cursor = sq_storage_cursor_new(storage, sq_query_c(query), table_type);
+	if (cursor)
+		cursor->joint = joint;
+	else if (joint)
+		sq_type_joint_free(joint);
+	return cursor;
+}
+
+void *sq_storage_cursor_next(SqStorageCursor *cursor)
+{
+	const SqType *type = cursor->type;
+	int   code;
+
+	if (cursor->cursor == NULL)
+		return NULL;
+
+	if (cursor->instance == NULL)
+		cursor->instance = sq_type_init_instance(type, &cursor->instance, true);
+	else {
+		// reuse instance for next row
+		sq_type_final_instance(type, cursor->instance, false);
+		memset(cursor->instance, 0, type->size);
+		sq_type_init_instance(type, cursor->instance, false);
+	}
+
+	sqxc_value_instance(cursor->xc) = cursor->instance;
+	sqxc_ready(cursor->xc, NULL);
+	code = sqdb_cursor_step(cursor->db, cursor->cursor, cursor->xc);
+	sqxc_finish(cursor->xc, NULL);
+	if (code != SQCODE_OK) {
+		// no more row or error occurred. Release cursor of database early.
+		sqdb_cursor_close(cursor->db, cursor->cursor);
+		cursor->cursor = NULL;
+		return NULL;
+	}
+	return cursor->instance;
+}
+
+void  sq_storage_cursor_free(SqStorageCursor *cursor)
+{
+	if (cursor->cursor)
+		sqdb_cursor_close(cursor->db, cursor->cursor);
+	sq_storage_unlock_db(cursor->storage);
+
+	if (cursor->instance)
+		sq_type_final_instance(cursor->type, &cursor->instance, true);
+	if (cursor->joint)
+		sq_type_joint_free(cursor->joint);
+	sqxc_free_chain(cursor->xc);
+	free(cursor);
+}
+
+// ------------------------------------
+// output
+
+int   sq_storage_get_all_xc(SqStorage    *storage,
+                            const char   *table_name,
+                            const SqType *table_type,
+                            const char   *sql_where_having,
+                            Sqxc         *xc_output)
+{
+	SqBuffer  buf;
+	SqTable  *table;
+	int       code;
+
+	if (table_type == NULL) {
+		// find SqTable by table_name
+		table = sq_schema_find(storage->schema, table_name);
+		if (table == NULL)
+			return SQCODE_ENTRY_NOT_FOUND;
+		table_type = table->type;
+	}
+
+	// SQL statement
+	sq_buffer_init(&buf);
+	sqdb_sql_from(storage->db, &buf, table_name, false);
+	// SQL WHERE ... HAVING ...
+	if (sql_where_having)
+		sq_buffer_write(&buf, sql_where_having);
+	sq_buffer_write_c(&buf, 0);
+
+	code = sq_storage_exec_xc(storage, buf.mem, table_type, xc_output);
+	sq_buffer_final(&buf);
+	return code;
+}
+
+int   sq_storage_query_xc(SqStorage    *storage,
+                          SqQuery      *query,
+                          const SqType *table_type,
+                          Sqxc         *xc_output)
+{
+	SqTypeJoint *joint;
+	int          code;
+
+	if (table_type == NULL) {
+		// SqStorage.joint_default may be changed by other queries. Use temporary SqTypeJoint here.
+		joint = sq_type_joint_new();
+		table_type = sq_storage_setup_query(storage, query, joint);
+		// columns of joined multi-table are sent in type that database product returns.
+		if (table_type == (SqType*)joint)
+			table_type = NULL;
+		code = sq_storage_exec_xc(storage, sq_query_c(query), table_type, xc_output);
+		sq_type_joint_free(joint);
+		return code;
+	}
+	return sq_storage_exec_xc(storage, sq_query_c(query), table_type, xc_output);
 }
 
 // ------------------------------------
@@ -400,6 +1220,10 @@ SqTable  *sq_storage_find_by_type(SqStorage *storage, const char *type_name)
 	SqTable   **table_addr;
 	int         count;
 
+#if SQ_CONFIG_HAVE_THREAD
+	if (storage->thread)
+		sq_mutex_lock(&storage->thread->mutex);
+#endif
 	type_tables = &storage->tables;
 	schema_tables = sq_type_get_ptr_array(storage->schema->type);
 	// if version is not the same
@@ -415,6 +1239,10 @@ SqTable  *sq_storage_find_by_type(SqStorage *storage, const char *type_name)
 	// search storage->tables by SqTable.type.name
 	table_addr = (SqTable**)sq_ptr_array_search(type_tables,
 	                                type_name, sq_entry_cmp_str__type_name);
+#if SQ_CONFIG_HAVE_THREAD
+	if (storage->thread)
+		sq_mutex_unlock(&storage->thread->mutex);
+#endif
 	if (table_addr)
 		return *table_addr;
 	return NULL;
@@ -423,6 +1251,423 @@ SqTable  *sq_storage_find_by_type(SqStorage *storage, const char *type_name)
 // ----------------------------------------------------------------------------
 // static function
 
+// create cursor that holds lock of database until it is freed
+static SqStorageCursor *sq_storage_cursor_new(SqStorage *storage, const char *sql, const SqType *table_type)
+{
+	SqStorageCursor *cursor;
+	Sqdb  *db;
+	void  *dbcursor = NULL;
+
+	db = sq_storage_lock_db(storage);
+	if (db && sqdb_has_cursor(db))
+		dbcursor = sqdb_cursor_open(db, sql, NULL, 0);
+	if (dbcursor == NULL) {
+		sq_storage_unlock_db(storage);
+		return NULL;
+	}
+
+	cursor = malloc(sizeof(SqStorageCursor));
+	cursor->storage  = storage;
+	cursor->db       = db;
+	cursor->cursor   = dbcursor;
+	cursor->type     = table_type;
+	cursor->instance = NULL;
+	cursor->joint    = NULL;
+	// cursor uses its Sqxc chain because user may call other functions between steps.
+	cursor->xc = sqxc_new(SQXC_INFO_VALUE);
+	sqxc_insert(cursor->xc, sqxc_new(SQXC_INFO_JSON_PARSER), -1);
+	sqxc_value_element(cursor->xc)   = table_type;
+	sqxc_value_container(cursor->xc) = NULL;
+	sqxc_value_instance(cursor->xc)  = NULL;
+	return cursor;
+}
+
+// SqTypeParseFunc of SqTypeOutput_. SqxcValue calls it for all data because it never pushes SqxcNested.
+static int  sq_type_output_parse(void *instance, const SqType *type, Sqxc *src)
+{
+	SqStorageOutput *output = instance;
+	SqEntry   **addr;
+	SqEntry    *entry = NULL;
+	Sqxc       *xc = output->xc;
+	SqValue     value;
+
+	switch (src->type) {
+	case SQXC_TYPE_ARRAY:
+	case SQXC_TYPE_ARRAY_END:
+	case SQXC_TYPE_OBJECT:
+	case SQXC_TYPE_OBJECT_END:
+		xc->type = src->type;
+		xc->name = NULL;
+		xc->entry = NULL;
+		xc->value.pointer = NULL;
+		output->xc = sqxc_send(xc);
+		return (src->code = output->xc->code);
+
+	default:
+		break;
+	}
+
+	// column of row. find entry by column name (use binding of SqxcValue).
+	if (output->type) {
+		addr = (SqEntry**)sqxc_value_find_entry((SqxcValue*)src->dest, src, output->type);
+		if (addr)
+			entry = *addr;
+	}
+	xc->name = src->name;
+	xc->entry = entry;
+
+	// convert column to type of entry. string is sent directly because it doesn't need conversion.
+	type = (entry) ? entry->type : NULL;
+	if (type && SQ_TYPE_IS_BUILTIN(type) && type != SQ_TYPE_STR && type != SQ_TYPE_CHAR &&
+	    src->type != SQXC_TYPE_NULL && type->parse(&value, type, src) == SQCODE_OK)
+	{
+		output->xc = type->write(&value, type, xc);
+	}
+	else {
+		xc->type = src->type;
+		xc->value = src->value;
+		output->xc = sqxc_send(xc);
+	}
+	return (src->code = output->xc->code);
+}
+
+static const SqType SqTypeOutput_ =
+{
+	sizeof(SqStorageOutput),
+	NULL,
+	NULL,
+	sq_type_output_parse,
+	NULL,
+};
+
+// send array, object, or end of them to SqxcSql of import
+static int  sq_storage_import_send(SqStorageImport *import, int type)
+{
+	Sqxc  *xc = import->xcsql;
+
+	xc->type = type;
+	xc->name = NULL;
+	xc->entry = NULL;
+	xc->value.pointer = NULL;
+	return sqxc_send(xc)->code;
+}
+
+// send fields of current row to SqxcSql in order of columns
+static int  sq_storage_import_row(SqStorageImport *import)
+{
+	SqStorageImportField *field;
+	SqStorageImportField *end;
+	SqEntry  *entry;
+	Sqxc     *xc;
+	int       index;
+
+	// the first row decides columns of INSERT statement
+	for (index = 0;  index < import->type->n_entry;  index++) {
+		if (import->n_rows == 0)
+			import->used[index] = (import->slots[index] != -1);
+		else if (import->used[index] != (import->slots[index] != -1))
+			return SQCODE_TYPE_NOT_MATCH;
+	}
+
+	if (sq_storage_import_send(import, SQXC_TYPE_OBJECT) != SQCODE_OK)
+		return SQCODE_EXEC_ERROR;
+	xc  = import->xcsql;
+	end = sq_array_end(&import->fields, SqStorageImportField);
+	for (index = 0;  index < import->type->n_entry;  index++) {
+		if (import->slots[index] == -1)
+			continue;
+		field = sq_array_addr(&import->fields, SqStorageImportField, import->slots[index]);
+		entry = import->type->entry[index];
+		// field of column, object/array of column is followed by its members.
+		do {
+			if (field->column == -1) {
+				xc->name  = (field->name == -1) ? NULL : import->strs.mem + field->name;
+				xc->entry = NULL;
+			}
+			else {
+				xc->name  = entry->name;
+				xc->entry = entry;
+			}
+			if (field->value_type)
+				xc = field->value_type->write(&field->value, field->value_type, xc);
+			else {
+				xc->type  = field->type;
+				xc->value = field->value;
+				if (field->type == SQXC_TYPE_STR)
+					xc->value.str = import->strs.mem + field->str;
+				xc = sqxc_send(xc);
+			}
+			if (xc->code != SQCODE_OK)
+				return xc->code;
+		} while (++field < end && field->column == -1);
+	}
+	if (sq_storage_import_send(import, SQXC_TYPE_OBJECT_END) != SQCODE_OK)
+		return SQCODE_TYPE_NOT_MATCH;
+
+	import->n_rows++;
+	return SQCODE_OK;
+}
+
+// SqTypeParseFunc of SqTypeImport_. SqxcValue calls it for all data because it never pushes SqxcNested.
+static int  sq_type_import_parse(void *instance, const SqType *type, Sqxc *src)
+{
+	SqStorageImport      *import = instance;
+	SqStorageImportField *field;
+	SqEntry             **addr;
+	SqEntry              *entry;
+	int                   column = -1;
+
+	// SqxcJsonParser doesn't stop if error occurred. Skip the rest of JSON.
+	if (import->code != SQCODE_OK)
+		return (src->code = import->code);
+
+	switch (import->depth) {
+	case 0:
+		// top level must be array
+		if (src->type != SQXC_TYPE_ARRAY)
+			return (src->code = import->code = SQCODE_TYPE_NOT_MATCH);
+		import->depth++;
+		import->code = sq_storage_import_send(import, SQXC_TYPE_ARRAY);
+		return (src->code = import->code);
+
+	case 1:
+		// element of top level array must be object (row)
+		if (src->type == SQXC_TYPE_ARRAY_END) {
+			import->depth = -1;
+			import->code = sq_storage_import_send(import, SQXC_TYPE_ARRAY_END);
+		}
+		else if (src->type == SQXC_TYPE_OBJECT) {
+			import->depth++;
+			import->fields.length = 0;
+			import->strs.writed = 0;
+			for (column = 0;  column < import->type->n_entry;  column++)
+				import->slots[column] = -1;
+		}
+		else
+			import->code = SQCODE_TYPE_NOT_MATCH;
+		return (src->code = import->code);
+
+	case 2:
+		// end of row
+		if (src->type == SQXC_TYPE_OBJECT_END) {
+			import->depth--;
+			import->code = sq_storage_import_row(import);
+			return (src->code = import->code);
+		}
+		// field of row must be column of table
+		addr = (SqEntry**)sq_type_find_entry(import->type, src->name, NULL);
+		if (addr == NULL || SQ_TYPE_IS_FAKE((*addr)->type)) {
+#ifndef NDEBUG
+			fprintf(stderr, "SqStorage: column '%s' is not found in table.\n", src->name);
+#endif
+			return (src->code = import->code = SQCODE_ENTRY_NOT_FOUND);
+		}
+		entry  = *addr;
+		column = (int)(addr - import->type->entry);
+		import->slots[column] = import->fields.length;
+		break;
+
+	case -1:
+		// data after top level array
+		return (src->code = import->code = SQCODE_TYPE_NOT_MATCH);
+
+	default:
+		// member of object/array in column
+		break;
+	}
+
+	if (src->type & SQXC_TYPE_END)
+		import->depth--;
+	else if (src->type & SQXC_TYPE_NESTED)
+		import->depth++;
+
+	field = sq_array_alloc(&import->fields, 1);
+	field->type   = src->type;
+	field->column = column;
+	field->name   = -1;
+	field->value_type = NULL;
+	field->value.int64 = 0;
+	if (column == -1 && src->name) {
+		field->name = import->strs.writed;
+		sq_buffer_write(&import->strs, src->name);
+		import->strs.writed++;    // keep null-terminated
+	}
+
+	switch (src->type) {
+	case SQXC_TYPE_NULL:
+		field->value.pointer = NULL;
+		return (src->code = SQCODE_OK);
+
+	case SQXC_TYPE_STR:
+		field->str = import->strs.writed;
+		sq_buffer_write(&import->strs, (src->value.str) ? src->value.str : "");
+		import->strs.writed++;    // keep null-terminated
+		break;
+
+	default:
+		field->value = src->value;
+		break;
+	}
+	if (column == -1)
+		return (src->code = SQCODE_OK);
+
+	// convert field to type of column. string is kept because it doesn't need conversion.
+	type = entry->type;
+	if (SQ_TYPE_IS_BUILTIN(type)) {
+		if (src->type & SQXC_TYPE_NESTED)
+			return (src->code = import->code = SQCODE_TYPE_NOT_MATCH);
+		if (type == SQ_TYPE_STR || type == SQ_TYPE_CHAR) {
+			if (src->type != SQXC_TYPE_STR)
+				return (src->code = import->code = SQCODE_TYPE_NOT_MATCH);
+		}
+		else if (type->parse(&field->value, type, src) == SQCODE_OK)
+			field->value_type = type;
+		else
+			return (src->code = import->code = SQCODE_TYPE_NOT_MATCH);
+	}
+	return (src->code = SQCODE_OK);
+}
+
+static const SqType SqTypeImport_ =
+{
+	sizeof(SqStorageImport),
+	NULL,
+	NULL,
+	sq_type_import_parse,
+	NULL,
+};
+
+// execute 'sql' and send rows to 'xc_output' by SqTypeOutput_
+static int  sq_storage_exec_xc(SqStorage *storage, const char *sql, const SqType *table_type, Sqxc *xc_output)
+{
+	SqStorageOutput  output;
+	Sqdb  *db;
+	Sqxc  *xcvalue;
+	Sqxc  *xcsql;
+	int    code;
+
+	output.xc   = xc_output;
+	output.type = table_type;
+
+	// destination of input. It uses 'output' as instance, so it doesn't create instance.
+	sq_storage_acquire_xc(storage, &xcvalue, &xcsql);
+	sqxc_value_element(xcvalue)   = &SqTypeOutput_;
+	sqxc_value_container(xcvalue) = &SqTypeOutput_;
+	sqxc_value_instance(xcvalue)  = &output;
+
+	sqxc_ready(xc_output, NULL);
+	sqxc_ready(xcvalue, NULL);
+	db = sq_storage_lock_db(storage);
+	code = (db) ? sqdb_exec(db, sql, xcvalue, NULL) : SQCODE_TIMEOUT;
+	sq_storage_unlock_db(storage);
+	sqxc_finish(xcvalue, NULL);
+	sqxc_finish(xc_output, NULL);
+
+	sqxc_value_instance(xcvalue) = NULL;
+	sq_storage_release_xc(storage, xcvalue, xcsql);
+	return code;
+}
+
+#if SQ_CONFIG_HAVE_THREAD
+static SqStorageLock *sq_storage_find_lock(SqStorageThread *thread, SqThreadData owner)
+{
+	SqStorageLock *lock;
+	SqStorageLock *end;
+
+	lock = sq_array_begin(&thread->locks, SqStorageLock);
+	end  = sq_array_end(&thread->locks, SqStorageLock);
+	for (;  lock < end;  lock++) {
+		if (lock->owner == owner)
+			return lock;
+	}
+	return NULL;
+}
+
+static SqThreadResult sq_storage_worker(void *workers_ptr)
+{
+	SqStorageWorkers *workers = workers_ptr;
+	SqStorage        *storage = workers->storage;
+	SqStorageWork     work;
+	Sqdb             *db;
+
+	// Each worker holds its own connection from SqdbPool.
+	// CRUD functions lock database recursively in this thread and use the same connection.
+	db = sq_storage_lock_db(storage);
+
+	sq_mutex_lock(&workers->mutex);
+	for (;;) {
+		while (workers->queue_head == workers->queue.length && workers->stopping == false)
+			sq_cond_wait(&workers->cond, &workers->mutex);
+		// queue is empty and workers are stopping
+		if (workers->queue_head == workers->queue.length)
+			break;
+
+		work = *sq_array_addr(&workers->queue, SqStorageWork, workers->queue_head++);
+		if (workers->queue_head == workers->queue.length)
+			workers->queue_head = workers->queue.length = 0;
+		sq_mutex_unlock(&workers->mutex);
+		work.func(storage, work.data);
+		sq_mutex_lock(&workers->mutex);
+	}
+	sq_mutex_unlock(&workers->mutex);
+
+	if (db)
+		sq_storage_unlock_db(storage);
+	return SQ_THREAD_RESULT;
+}
+#endif  // SQ_CONFIG_HAVE_THREAD
+
+static void sq_storage_new_xc(Sqxc **xc_input, Sqxc **xc_output)
+{
+	*xc_input  = sqxc_new(SQXC_INFO_VALUE);
+	*xc_output = sqxc_new(SQXC_INFO_SQL);
+
+	// append JSON parser/writer to tail of list
+	sqxc_insert(*xc_input,  sqxc_new(SQXC_INFO_JSON_PARSER), -1);
+	sqxc_insert(*xc_output, sqxc_new(SQXC_INFO_JSON_WRITER), -1);
+}
+
+// 'xc_input' and 'xc_output' are Sqxc chains that acquired by sq_storage_acquire_xc()
+static void sq_storage_update_xc(SqStorage    *storage,
+                                 const char   *table_name,
+                                 const SqType *table_type,
+                                 void         *instance,
+                                 Sqxc         *xc_input,
+                                 Sqxc         *xc_output)
+{
+	SqBuffer  *buf;
+	SqColumn  *column;
+	Sqdb      *db;
+
+	db = sq_storage_lock_db(storage);
+	if (db == NULL) {
+		// reset SqxcSql's variable for UPDATE command
+		sqxc_ready(xc_output, NULL);
+		sqxc_finish(xc_output, NULL);
+		return;
+	}
+
+	// destination of output
+	sqxc_sql_set_db(xc_output, db);
+	if (sqxc_sql_condition(xc_output) == NULL) {
+		column = sq_table_get_primary(NULL, table_type);
+		// SQL statement. Because input buffer doesn't use here, I use it temporary.
+		buf = sqxc_get_buffer(xc_input);
+		buf->writed = 0;
+		print_where_column(column, (char*)instance + column->offset,
+		             buf, storage->db->info->quote.identifier);
+		sqxc_sql_condition(xc_output) = buf->mem;
+	}
+	sqxc_ctrl(xc_output, SQXC_SQL_CTRL_UPDATE, table_name);
+
+	sqxc_ready(xc_output, NULL);
+	table_type->write(instance, table_type, xc_output);
+	sqxc_finish(xc_output, NULL);
+	sq_storage_unlock_db(storage);
+	// free WHERE condition
+//	sqxc_sql_condition(xc_output) = NULL;    // this has been done in sqxc_finish()
+}
+
 static void sqxc_sql_init_columns(SqxcSql *xcsql, const char *sql_where_having)
 {
 	// set SqxcSql's variable for UPDATE command
@@ -534,94 +1779,41 @@ static int  print_where_column(const SqColumn *column, void *instance, SqBuffer
 	// integer
 	switch(SQ_TYPE_BUILTIN_INDEX(type)) {
 	case SQ_TYPE_INT_INDEX:
-		temp.len = snprintf(NULL, 0, "%c%s%c=%d",
-				quote[0], name, quote[1], *(int*)instance);
-		snprintf(sq_buffer_alloc(buf, temp.len), temp.len+1, "%c%s%c=%d",
-				quote[0], name, quote[1], *(int*)instance);
-		break;
-
 	case SQ_TYPE_UINT_INDEX:
-		temp.len = snprintf(NULL, 0, "%c%s%c=%u",
-				quote[0], name, quote[1], *(unsigned int*)instance);
-		snprintf(sq_buffer_alloc(buf, temp.len), temp.len+1, "%c%s%c=%u",
-				quote[0], name, quote[1], *(unsigned int*)instance);
-		break;
-
 	case SQ_TYPE_INT64_INDEX:
-#if defined (_MSC_VER)  // || defined (__MINGW32__) || defined (__MINGW64__)
-		temp.len = snprintf(NULL, 0, "%c%s%c=%I64d",
-				quote[0], name, quote[1], *(int64_t*)instance);
-		snprintf(sq_buffer_alloc(buf, temp.len), temp.len+1, "%c%s%c=%I64d",
-				quote[0], name, quote[1], *(int64_t*)instance);
-#elif defined(__WORDSIZE) && (__WORDSIZE == 64) && !defined(__APPLE__)
-		temp.len = snprintf(NULL, 0, "%c%s%c=%ld",
-				quote[0], name, quote[1], *(int64_t*)instance);
-		snprintf(sq_buffer_alloc(buf, temp.len), temp.len+1, "%c%s%c=%ld",
-				quote[0], name, quote[1], *(int64_t*)instance);
-#elif defined(__GNUC__)
-		temp.len = snprintf(NULL, 0, "%c%s%c=%lld",
-				quote[0], name, quote[1], *(int64_t*)instance);
-		snprintf(sq_buffer_alloc(buf, temp.len), temp.len+1, "%c%s%c=%lld",
-				quote[0], name, quote[1], *(int64_t*)instance);
-#else // C99
-		temp.len = snprintf(NULL, 0, "%c%s%c=%" PRId64,
-				quote[0], name, quote[1], *(int64_t*)instance);
-		snprintf(sq_buffer_alloc(buf, temp.len), temp.len+1, "%c%s%c=%" PRId64,
-				quote[0], name, quote[1], *(int64_t*)instance);
-#endif
-		break;
-
 	case SQ_TYPE_UINT64_INDEX:
-#if defined (_MSC_VER)  // || defined (__MINGW32__) || defined (__MINGW64__)
-		temp.len = snprintf(NULL, 0, "%c%s%c=%I64u",
-				quote[0], name, quote[1], *(uint64_t*)instance);
-		snprintf(sq_buffer_alloc(buf, temp.len), temp.len+1, "%c%s%c=%I64u",
-				quote[0], name, quote[1], *(uint64_t*)instance);
-#elif defined(__WORDSIZE) && (__WORDSIZE == 64) && !defined(__APPLE__)
-		temp.len = snprintf(NULL, 0, "%c%s%c=%lu",
-				quote[0], name, quote[1], *(uint64_t*)instance);
-		snprintf(sq_buffer_alloc(buf, temp.len), temp.len+1, "%c%s%c=%lu",
-				quote[0], name, quote[1], *(uint64_t*)instance);
-#elif defined(__GNUC__)
-		temp.len = snprintf(NULL, 0, "%c%s%c=%llu",
-				quote[0], name, quote[1], *(uint64_t*)instance);
-		snprintf(sq_buffer_alloc(buf, temp.len), temp.len+1, "%c%s%c=%llu",
-				quote[0], name, quote[1], *(uint64_t*)instance);
-#else // C99
-		temp.len = snprintf(NULL, 0, "%c%s%c=%" PRIu64,
-				quote[0], name, quote[1], *(uint64_t*)instance);
-		snprintf(sq_buffer_alloc(buf, temp.len), temp.len+1, "%c%s%c=%" PRIu64,
-				quote[0], name, quote[1], *(uint64_t*)instance);
-#endif
 		break;
 
 	default:
 		return 0;
 	}
 
-	return temp.len;
-}
+	temp.len = (int)strlen(name);
+	sq_buffer_write_c(buf, quote[0]);
+	sq_buffer_write_n(buf, name, temp.len);
+	sq_buffer_write_c(buf, quote[1]);
+	sq_buffer_write_c(buf, '=');
+	temp.len += 3;
 
+	switch(SQ_TYPE_BUILTIN_INDEX(type)) {
+	case SQ_TYPE_INT_INDEX:
+		temp.len += sq_buffer_write_int64(buf, *(int*)instance);
+		break;
 
-// ----------------------------------------------------------------------------
-// If C compiler doesn't support C99 inline functions
-
-#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L)
-// C99 or C++ inline functions has defined in SqStorage.h
+	case SQ_TYPE_UINT_INDEX:
+		temp.len += sq_buffer_write_uint64(buf, *(unsigned int*)instance);
+		break;
 
-#else   // __STDC_VERSION__
-// define functions here if compiler does NOT support inline function.
+	case SQ_TYPE_INT64_INDEX:
+		temp.len += sq_buffer_write_int64(buf, *(int64_t*)instance);
+		break;
 
-int  sq_storage_begin_trans(SqStorage *storage) {
-	return SQ_STORAGE_BEGIN_TRANS(storage);
-}
+	case SQ_TYPE_UINT64_INDEX:
+		temp.len += sq_buffer_write_uint64(buf, *(uint64_t*)instance);
+		break;
+	}
 
-int  sq_storage_commit_trans(SqStorage *storage) {
-	return SQ_STORAGE_COMMIT_TRANS(storage);
+	return temp.len;
 }
 
-int  sq_storage_rollback_trans(SqStorage *storage) {
-	return SQ_STORAGE_ROLLBACK_TRANS(storage);
-}
 
-#endif  // __STDC_VERSION
@@ -23,23 +23,27 @@
 #include <SqQuery.h>
 #ifdef __cplusplus
 #include <SqType-stl-cpp.h>
+#if SQ_CONFIG_HAVE_THREAD
+#include <future>       // std::future, std::packaged_task
+#include <stdexcept>    // std::runtime_error
+#include <string>
+#endif
 #endif
 
 // ----------------------------------------------------------------------------
 // C/C++ common declarations: declare type, structure, macro, enumeration.
 
 typedef struct SqStorage         SqStorage;
+typedef struct SqStorageThread   SqStorageThread;    // defined in SqStorage.c
+typedef struct SqStorageCursor   SqStorageCursor;    // defined in SqStorage.c
+typedef struct SqStorageImport   SqStorageImport;    // defined in SqStorage.c
+typedef struct SqStorageResult   SqStorageResult;
+typedef struct SqdbPool          SqdbPool;           // defined in SqdbPool.c
 
-/* macro for maintaining C/C++ inline functions easily */
-
-// int   sq_storage_begin_trans(SqStorage *storage);
-#define  SQ_STORAGE_BEGIN_TRANS(storage)     (storage)->db->info->exec((storage)->db, "BEGIN", NULL, NULL);
-
-// int   sq_storage_commit_trans(SqStorage *storage);
-#define  SQ_STORAGE_COMMIT_TRANS(storage)    (storage)->db->info->exec((storage)->db, "COMMIT", NULL, NULL);
-
-// int   sq_storage_rollback_trans(SqStorage *storage);
-#define  SQ_STORAGE_ROLLBACK_TRANS(storage)  (storage)->db->info->exec((storage)->db, "ROLLBACK", NULL, NULL);
+// work that is queued by sq_storage_run_async(). It runs in worker thread.
+typedef void (*SqStorageWorkFunc)(SqStorage *storage, void *data);
+// callback of asynchronous CRUD functions. It runs in worker thread.
+typedef void (*SqStorageResultFunc)(SqStorageResult *result, void *data);
 
 // ----------------------------------------------------------------------------
 // C declarations: declare C data, function, and others.
@@ -62,6 +66,37 @@ int   sq_storage_close(SqStorage *storage);
 // synchronize storage->schema to database if 'schema' == NULL (Mainly used by SQLite)
 int   sq_storage_migrate(SqStorage *storage, SqSchema *schema);
 
+/* ------------------------------------
+	thread-safe mode:
+	1. Each thread uses its Sqxc chains that are taken from pool of SqStorage.
+	2. Access to 'db' is serialized. A transaction holds the lock until it is committed or rolled back.
+	   If SqdbPool is set, each thread uses its connection that is taken from SqdbPool instead.
+	3. sq_storage_migrate() must be done before 'storage' is shared between threads.
+ */
+
+// enable or disable thread-safe mode. Don't call it while other threads are using 'storage'.
+// return SQCODE_NOT_SUPPORT if sqxclib is built without thread support.
+int   sq_storage_set_thread_safe(SqStorage *storage, bool thread_safe);
+
+// run CRUD functions with connections in 'pool'. It enables thread-safe mode if 'pool' is not NULL.
+// 'storage->db' is still used by sq_storage_migrate(). 'pool' must be opened with the same database.
+int   sq_storage_set_pool(SqStorage *storage, SqdbPool *pool);
+
+// get Sqxc chains for current thread. They must be released by sq_storage_release_xc().
+// If thread-safe mode is disabled, they are 'storage->xc_input' and 'storage->xc_output'.
+void  sq_storage_acquire_xc(SqStorage *storage, Sqxc **xc_input, Sqxc **xc_output);
+void  sq_storage_release_xc(SqStorage *storage, Sqxc  *xc_input, Sqxc  *xc_output);
+
+// lock/unlock database in thread-safe mode. They can be called recursively in the same thread.
+// sq_storage_lock_db() returns database that is used by current thread, or NULL if wait of SqdbPool is timed out.
+Sqdb *sq_storage_lock_db(SqStorage *storage);
+void  sq_storage_unlock_db(SqStorage *storage);
+
+// transaction. sq_storage_begin_trans() locks 'db' until transaction is committed or rolled back.
+int   sq_storage_begin_trans(SqStorage *storage);
+int   sq_storage_commit_trans(SqStorage *storage);
+int   sq_storage_rollback_trans(SqStorage *storage);
+
 /* ------------------------------------
 	CRUD functions:
 	1. If 'table_type' is NULL, SqStorage will try to find 'table_type' in its schema.
@@ -79,12 +114,52 @@ void *sq_storage_get_all(SqStorage    *storage,
                          const SqType *container_type,
                          const char   *sql_where_having);
 
+// get all rows. Elements, their pointer members and strings are allocated from 'arena'.
+// Container is allocated by malloc(). User must free container and clear (or free) 'arena', but not elements.
+// It returns NULL if element can NOT be allocated from SqArena. see sq_type_can_use_arena()
+void *sq_storage_get_all_arena(SqStorage    *storage,
+                               const char   *table_name,
+                               const SqType *table_type,
+                               const SqType *container_type,
+                               const char   *sql_where_having,
+                               SqArena      *arena);
+
+// get all rows and send them to output Sqxc chain 'xc_output' (e.g. SqxcJsonWriter) without creating instances.
+// 'table_type' is used only to decide name and type of columns. Rows are sent as array of objects.
+// It calls sqxc_ready() and sqxc_finish() of 'xc_output'. It returns SQCODE_NO_DATA if the result set is empty.
+int   sq_storage_get_all_xc(SqStorage    *storage,
+                            const char   *table_name,
+                            const SqType *table_type,
+                            const char   *sql_where_having,
+                            Sqxc         *xc_output);
+
 // return inserted row id if primary key has auto increment attribute.
 int64_t sq_storage_insert(SqStorage    *storage,
                           const char   *table_name,
                           const SqType *table_type,
                           void         *instance);
 
+// insert all elements of 'container' in a transaction.
+// Rows will be split into multiple INSERT statements if they exceed limits of database (SqdbInfo.limit).
+// If 'container_type' is NULL, SqStorage use 'container_default'.
+// If 'id_range' is not NULL, the first and the last inserted row id will be stored in id_range[0] and id_range[1].
+// Don't call this function in a transaction because it begins and commits (or rollbacks) its own transaction.
+// return number of inserted rows, or -1 if error occurred.
+int64_t sq_storage_insert_all(SqStorage    *storage,
+                              const char   *table_name,
+                              const SqType *table_type,
+                              void         *container,
+                              const SqType *container_type,
+                              int64_t      *id_range);
+
+// insert top level JSON array of objects in a transaction. Each object is a row and its members are columns.
+// It is the same as calling sq_storage_import_new(), sq_storage_import_json(), and sq_storage_import_end().
+// return number of inserted rows, or -1 if error occurred.
+int64_t sq_storage_insert_json(SqStorage    *storage,
+                               const char   *table_name,
+                               const SqType *table_type,
+                               const char   *json);
+
 // return number of rows changed.
 int   sq_storage_update(SqStorage    *storage,
                         const char   *table_name,
@@ -167,6 +242,152 @@ void *sq_storage_query(SqStorage    *storage,
                        const SqType *table_type,
                        const SqType *container_type);
 
+/* sq_storage_query_xc() execute 'query' and send result to output Sqxc chain 'xc_output' without creating instances.
+
+   If 'table_type' is NULL and 'query' has only 1 table, it uses type of table to decide type of columns.
+   If 'query' has joined multi-table, columns are sent in type that database product returns.
+   It returns SQCODE_NO_DATA if the result set is empty.
+ */
+int   sq_storage_query_xc(SqStorage    *storage,
+                          SqQuery      *query,
+                          const SqType *table_type,
+                          Sqxc         *xc_output);
+
+/* ------------------------------------
+	cursor:
+	Cursor gets result row by row instead of creating container. It reuses one instance for all rows,
+	so memory usage doesn't grow with size of result.
+	1. Instance that returned by sq_storage_cursor_next() is overwritten by next call and freed by sq_storage_cursor_free().
+	2. Cursor locks database until it is freed. It must be freed in the thread that created it.
+	3. SQLite can run other statements while cursor is in use. PostgreSQL and MySQL can't use the same connection
+	   until cursor is freed.
+	All functions that create cursor return NULL if error occurred or database product doesn't support cursor.
+ */
+
+// parameter 'sql_where_having' is SQL statement that exclude "SELECT * FROM table_name"
+SqStorageCursor *sq_storage_get_all_cursor(SqStorage    *storage,
+                                           const char   *table_name,
+                                           const SqType *table_type,
+                                           const char   *sql_where_having);
+
+// If 'table_type' is NULL, it use type of table or SqTypeJoint (if 'query' has joined multi-table) to create row data.
+SqStorageCursor *sq_storage_query_cursor(SqStorage    *storage,
+                                         SqQuery      *query,
+                                         const SqType *table_type);
+
+// return instance of next row, or NULL if no more row or error occurred.
+void *sq_storage_cursor_next(SqStorageCursor *cursor);
+void  sq_storage_cursor_free(SqStorageCursor *cursor);
+
+/* ------------------------------------
+	import:
+	Import parses top level JSON array of objects and inserts rows by multi-row INSERT statements.
+	It doesn't create instances, memory usage doesn't grow with size of JSON.
+	1. JSON can be sent in several pieces. Each object is a row, names of members must be columns of table.
+	   Values are converted to type of columns. All rows must have the same columns.
+	   Object or array in row is written as JSON text.
+	2. Rows will be split into multiple INSERT statements if they exceed limits of database (SqdbInfo.limit).
+	3. Import runs in its transaction. It locks database until it is ended and must be ended in the thread that created it.
+	   Don't create import in a transaction.
+ */
+
+// If 'table_type' is NULL, it uses type of table that found by 'table_name'.
+// return NULL if table is not found or transaction can't begin.
+SqStorageImport *sq_storage_import_new(SqStorage    *storage,
+                                       const char   *table_name,
+                                       const SqType *table_type);
+
+// send piece of JSON.
+// return SQCODE_JSON_CONTINUE if JSON is incomplete, SQCODE_OK if it is completed, or error code.
+// After error occurred, import ignores the rest of JSON and sq_storage_import_end() rolls back transaction.
+int   sq_storage_import_json(SqStorageImport *import, const char *json);
+
+// commit (or rollback if error occurred) transaction and free 'import'.
+// return number of inserted rows, or -1 if error occurred.
+int64_t sq_storage_import_end(SqStorageImport *import);
+
+/* ------------------------------------
+	asynchronous functions:
+	Work is queued and run by worker threads.
+	1. Each worker takes its Sqxc chains from pool of SqStorage.
+	2. Each worker holds its connection from SqdbPool until workers are stopped.
+	   SqdbPool must be set by sq_storage_set_pool() before workers are started,
+	   and its 'max_size' must not be less than number of workers.
+	   Other threads wait for connection if all connections are held by workers.
+	3. Work and callback run in worker thread. Don't free 'storage' before workers are stopped.
+	Functions that queue work return SQCODE_NOT_SUPPORT if workers are not started
+	or sqxclib is built without thread support.
+ */
+
+// start 'n_workers' worker threads.
+// return SQCODE_NOT_SUPPORT if SqdbPool is not set, SQCODE_ERROR if 'max_size' of SqdbPool < 'n_workers'.
+int   sq_storage_start_workers(SqStorage *storage, int n_workers);
+// run all queued work and stop worker threads. It is called by sq_storage_set_thread_safe(storage, false).
+int   sq_storage_stop_workers(SqStorage *storage);
+
+// queue work that will be run by worker thread.
+int   sq_storage_run_async(SqStorage *storage, SqStorageWorkFunc func, void *data);
+
+/*	asynchronous CRUD functions:
+	They have the same arguments as synchronous CRUD functions. 'callback' gets result in worker thread.
+	'table_name' and 'sql_where_having' are copied, but 'instance' and 'query' must be alive until 'callback' is called.
+	'callback' can be NULL.
+ */
+
+// SqStorageResult.instance is result of sq_storage_get(). User must free it.
+int   sq_storage_get_async(SqStorage    *storage,
+                           const char   *table_name,
+                           const SqType *table_type,
+                           int64_t       id,
+                           SqStorageResultFunc callback,
+                           void         *data);
+
+// SqStorageResult.instance is result of sq_storage_get_all(). User must free it.
+int   sq_storage_get_all_async(SqStorage    *storage,
+                               const char   *table_name,
+                               const SqType *table_type,
+                               const SqType *container_type,
+                               const char   *sql_where_having,
+                               SqStorageResultFunc callback,
+                               void         *data);
+
+// SqStorageResult.instance is result of sq_storage_query(). User must free it.
+int   sq_storage_query_async(SqStorage    *storage,
+                             SqQuery      *query,
+                             const SqType *table_type,
+                             const SqType *container_type,
+                             SqStorageResultFunc callback,
+                             void         *data);
+
+// SqStorageResult.value is result of sq_storage_insert(). SqStorageResult.instance is 'instance'.
+int   sq_storage_insert_async(SqStorage    *storage,
+                              const char   *table_name,
+                              const SqType *table_type,
+                              void         *instance,
+                              SqStorageResultFunc callback,
+                              void         *data);
+
+// SqStorageResult.value is result of sq_storage_update(). SqStorageResult.instance is 'instance'.
+int   sq_storage_update_async(SqStorage    *storage,
+                              const char   *table_name,
+                              const SqType *table_type,
+                              void         *instance,
+                              SqStorageResultFunc callback,
+                              void         *data);
+
+int   sq_storage_remove_async(SqStorage    *storage,
+                              const char   *table_name,
+                              const SqType *table_type,
+                              int64_t       id,
+                              SqStorageResultFunc callback,
+                              void         *data);
+
+int   sq_storage_remove_all_async(SqStorage    *storage,
+                                  const char   *table_name,
+                                  const char   *sql_where_having,
+                                  SqStorageResultFunc callback,
+                                  void         *data);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -178,6 +399,72 @@ void *sq_storage_query(SqStorage    *storage,
 
 namespace Sq {
 
+/*	Cursor is C++ wrapper of SqStorageCursor. It frees SqStorageCursor when it is destroyed.
+
+	Sq::Cursor<Company> cursor = storage->cursor<Company>("WHERE age > 20");
+	for (Company &company : cursor)
+		std::cout << company.name << std::endl;
+ */
+template <class Type>
+class Cursor
+{
+public:
+	class iterator
+	{
+	public:
+		iterator(SqStorageCursor *cursor, Type *instance) : cursor(cursor), instance(instance) {}
+
+		Type &operator*() const { return *instance; }
+		Type *operator->() const { return instance; }
+		iterator &operator++() {
+			instance = (Type*)sq_storage_cursor_next(cursor);
+			return *this;
+		}
+		bool operator==(const iterator &other) const { return instance == other.instance; }
+		bool operator!=(const iterator &other) const { return instance != other.instance; }
+
+	protected:
+		SqStorageCursor *cursor;
+		Type            *instance;
+	};
+
+	Cursor(SqStorageCursor *cursor = NULL) : cursor(cursor) {}
+	Cursor(Cursor &&other) : cursor(other.cursor) { other.cursor = NULL; }
+	Cursor(const Cursor &other) = delete;
+	~Cursor() {
+		if (cursor)
+			sq_storage_cursor_free(cursor);
+	}
+
+	Cursor &operator=(Cursor &&other) {
+		if (this != &other) {
+			if (cursor)
+				sq_storage_cursor_free(cursor);
+			cursor = other.cursor;
+			other.cursor = NULL;
+		}
+		return *this;
+	}
+	Cursor &operator=(const Cursor &other) = delete;
+
+	// return false if error occurred or database product doesn't support cursor.
+	explicit operator bool() const { return cursor != NULL; }
+
+	// return instance of next row, or NULL if no more row.
+	Type *next() {
+		return (cursor) ? (Type*)sq_storage_cursor_next(cursor) : NULL;
+	}
+
+	// range-based for loop. Cursor can be iterated only once.
+	iterator begin() { return iterator(cursor, next()); }
+	iterator end()   { return iterator(cursor, NULL); }
+
+	SqStorageCursor *data() { return cursor; }
+
+protected:
+	SqStorageCursor *cursor;
+};
+
 /*	StorageMethod is used by SqStorage and it's children.
 
 	It's derived struct/class must be C++11 standard-layout and has SqStorage members.
@@ -195,6 +482,9 @@ struct StorageMethod
 
 	int   migrate(SqSchema *schema);
 
+	int   setThreadSafe(bool threadSafe = true);
+	int   setPool(SqdbPool *pool);
+
 	// get<StructType>(id)
 	template <class StructType>
 	StructType *get(int64_t id);
@@ -229,6 +519,12 @@ struct StorageMethod
 	// getAll() with tableName + tableType
 	void *getAll(const char *tableName, const SqType *tableType, const SqType *containerType, const char *sqlWhereHaving = NULL);
 	void *getAll(const char *tableName, const SqType *tableType, const SqType *containerType, const QueryProxy &qproxy);
+	// getAll() with SqArena
+	void *getAll(SqArena *arena, const char *tableName, const SqType *tableType, const SqType *containerType, const char *sqlWhereHaving = NULL);
+	// getAll() with output Sqxc chain
+	template <class StructType>
+	int   getAllXc(Sqxc *xcOutput, const char *sqlWhereHaving = NULL);
+	int   getAllXc(Sqxc *xcOutput, const char *tableName, const SqType *tableType, const char *sqlWhereHaving = NULL);
 
 	Sq::Type *setupQuery(Sq::QueryMethod &query, Sq::TypeJointMethod *jointType);
 	Sq::Type *setupQuery(Sq::QueryMethod *query, Sq::TypeJointMethod *jointType);
@@ -256,6 +552,20 @@ struct StorageMethod
 	void *query(Sq::QueryMethod &query, const SqType *tableType, const SqType *containerType);
 	void *query(Sq::QueryProxy &qproxy, const SqType *tableType, const SqType *containerType);
 	void *query(Sq::QueryMethod *query, const SqType *tableType, const SqType *containerType);
+	// query() with output Sqxc chain
+	int   queryXc(Sq::QueryMethod &query, Sqxc *xcOutput, const SqType *tableType = NULL);
+	int   queryXc(Sq::QueryMethod *query, Sqxc *xcOutput, const SqType *tableType = NULL);
+
+	// cursor<StructType>()
+	template <class StructType>
+	Sq::Cursor<StructType> cursor(const char *sqlWhereHaving = NULL);
+	template <class StructType>
+	Sq::Cursor<StructType> cursor(const QueryProxy &qproxy);
+	// cursor<StructType>(query)
+	template <class StructType>
+	Sq::Cursor<StructType> cursor(Sq::QueryMethod &query, const SqType *tableType = NULL);
+	template <class StructType>
+	Sq::Cursor<StructType> cursor(Sq::QueryMethod *query, const SqType *tableType = NULL);
 
 	// insert(struct_reference);
 	template <class StructType>
@@ -270,6 +580,22 @@ struct StorageMethod
 	int64_t  insert(const char *tableName, void *instance);
 	int64_t  insert(const char *tableName, const SqType *tableType, void *instance);
 
+	// insertAll(container_reference)
+	template <class StlContainer>
+	int64_t  insertAll(StlContainer &container, int64_t *idRange = NULL);
+	// insertAll(container_pointer)
+	template <class StlContainer>
+	int64_t  insertAll(StlContainer *container, int64_t *idRange = NULL);
+	// insertAll() without template
+	int64_t  insertAll(const char *tableName, void *container, const SqType *containerType = NULL, int64_t *idRange = NULL);
+	int64_t  insertAll(const char *tableName, const SqType *tableType, void *container, const SqType *containerType, int64_t *idRange = NULL);
+	// insertJson<StructType>(json)
+	template <class StructType>
+	int64_t  insertJson(const char *json);
+	// insertJson() without template
+	int64_t  insertJson(const char *tableName, const char *json);
+	int64_t  insertJson(const char *tableName, const SqType *tableType, const char *json);
+
 	// update(struct_reference)
 	template <class StructType>
 	int   update(StructType &instance);
@@ -351,6 +677,35 @@ struct StorageMethod
 	void  removeAll(const char *tableName, const char *sqlWhereHaving = NULL);
 	void  removeAll(const char *tableName, const QueryProxy &qproxy);
 
+#if SQ_CONFIG_HAVE_THREAD
+	int   startWorkers(int nWorkers);
+	int   stopWorkers();
+
+	// runAsync(function) runs 'function(SqStorage*)' in worker thread and returns std::future of its result.
+	// If workers are not started, 'function' is not run and std::future throws std::runtime_error.
+	template <class Function>
+	auto  runAsync(Function func) -> std::future<decltype(func((SqStorage*)NULL))>;
+
+	// getAsync<StructType>(id)
+	template <class StructType>
+	std::future<StructType*>    getAsync(int64_t id);
+	// getAllAsync<std::vector<StructType>>()
+	template <class StlContainer>
+	std::future<StlContainer*>  getAllAsync(const char *sqlWhereHaving = NULL);
+	// queryAsync<std::vector<StructType>>(query). 'query' must be alive until result is ready.
+	template <class StlContainer>
+	std::future<StlContainer*>  queryAsync(Sq::QueryMethod &query);
+	// insertAsync(struct_reference). 'instance' must be alive until result is ready.
+	template <class StructType>
+	std::future<int64_t>        insertAsync(StructType &instance);
+	// updateAsync(struct_reference). 'instance' must be alive until result is ready.
+	template <class StructType>
+	std::future<int>            updateAsync(StructType &instance);
+	// removeAsync<StructType>(id)
+	template <class StructType>
+	std::future<void>           removeAsync(int64_t id);
+#endif  // SQ_CONFIG_HAVE_THREAD
+
 	int   beginTrans();
 	int   commitTrans();
 	int   rollbackTrans();
@@ -363,14 +718,23 @@ struct StorageMethod
 // ----------------------------------------------------------------------------
 // C/C++ common definitions: define structure
 
+/*	SqStorageResult - result of asynchronous CRUD function
+ */
+struct SqStorageResult
+{
+	int      code;        // SQCODE_OK if no error
+	void    *instance;    // instance that is returned or used by CRUD function
+	int64_t  value;       // inserted id or number of updated rows
+};
+
 /*	SqStorage
 	  SqStorage access database. It using Sqxc to convert data between C language and Sqdb interface.
 
 	Notes about multithreading:
 	1. 'schema', 'tables', 'tables_version' must be shared between threads.
-	   use readers-writer lock to access these data member.
+	   'tables' and 'tables_version' are protected by lock in thread-safe mode.
 	2. 'xc_input', 'xc_output' is NOT shared between threads.
-	   each thread has its Sqxc chain ('xc_input' and 'xc_output').
+	   In thread-safe mode, each thread takes its Sqxc chains from pool in 'thread'.
  */
 
 #define SQ_STORAGE_MEMBERS               \
@@ -381,7 +745,8 @@ struct StorageMethod
 	Sqxc      *xc_input;                 \
 	Sqxc      *xc_output;                \
 	SqTypeJoint    *joint_default;       \
-	const SqType   *container_default
+	const SqType   *container_default;   \
+	SqStorageThread *thread
 
 #ifdef __cplusplus
 struct SqStorage : Sq::StorageMethod         // <-- 1. inherit C++ member function(method)
@@ -404,52 +769,12 @@ struct SqStorage
 
 	SqTypeJoint    *joint_default;
 	const SqType   *container_default;
+
+	// data for thread-safe mode. It is NULL if thread-safe mode is disabled.
+	SqStorageThread *thread;
  */
 };
 
-// ----------------------------------------------------------------------------
-// C/C++ common definitions: define global inline function
-
-#if (defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L)) || defined(__cplusplus)
-// define inline functions here if compiler supports inline function.
-
-#ifdef __cplusplus  // C++
-inline
-#else               // C99
-static inline
-#endif
-int      sq_storage_begin_trans(SqStorage *storage) {
-	return SQ_STORAGE_BEGIN_TRANS(storage);
-}
-
-#ifdef __cplusplus  // C++
-inline
-#else               // C99
-static inline
-#endif
-int      sq_storage_commit_trans(SqStorage *storage) {
-	return SQ_STORAGE_COMMIT_TRANS(storage);
-}
-
-#ifdef __cplusplus  // C++
-inline
-#else               // C99
-static inline
-#endif
-int      sq_storage_rollback_trans(SqStorage *storage) {
-	return SQ_STORAGE_ROLLBACK_TRANS(storage);
-}
-
-#else   // __STDC_VERSION__ || __cplusplus
-// declare functions here if compiler does NOT support inline function.
-
-// C functions
-int      sq_storage_begin_trans(SqStorage *storage);
-int      sq_storage_commit_trans(SqStorage *storage);
-int      sq_storage_rollback_trans(SqStorage *storage);
-
-#endif  // __STDC_VERSION__ || __cplusplus
-
 // ----------------------------------------------------------------------------
 // C++ definitions: define C++ data, function, method, and others.
 
@@ -467,7 +792,13 @@ inline int   StorageMethod::close(void) {
 }
 
 inline int   StorageMethod::migrate(SqSchema *schema) {
-	return sqdb_migrate(((SqStorage*)this)->db, ((SqStorage*)this)->schema, schema);
+	return sq_storage_migrate((SqStorage*)this, schema);
+}
+inline int   StorageMethod::setThreadSafe(bool threadSafe) {
+	return sq_storage_set_thread_safe((SqStorage*)this, threadSafe);
+}
+inline int   StorageMethod::setPool(SqdbPool *pool) {
+	return sq_storage_set_pool((SqStorage*)this, pool);
 }
 
 template <class StructType>
@@ -559,6 +890,20 @@ inline void *StorageMethod::getAll(const char *tableName, const SqType *tableTyp
 inline void *StorageMethod::getAll(const char *tableName, const SqType *tableType, const SqType *containerType, const QueryProxy &qproxy) {
 	return sq_storage_get_all((SqStorage*)this, tableName, tableType, containerType, ((QueryProxy&)qproxy).c());
 }
+inline void *StorageMethod::getAll(SqArena *arena, const char *tableName, const SqType *tableType, const SqType *containerType, const char *sqlWhereHaving) {
+	return sq_storage_get_all_arena((SqStorage*)this, tableName, tableType, containerType, sqlWhereHaving, arena);
+}
+
+template <class StructType>
+inline int   StorageMethod::getAllXc(Sqxc *xcOutput, const char *sqlWhereHaving) {
+	SqTable *table = sq_storage_find_by_type((SqStorage*)this, typeid(StructType).name());
+	if (table == NULL)
+		return SQCODE_ENTRY_NOT_FOUND;
+	return sq_storage_get_all_xc((SqStorage*)this, table->name, table->type, sqlWhereHaving, xcOutput);
+}
+inline int   StorageMethod::getAllXc(Sqxc *xcOutput, const char *tableName, const SqType *tableType, const char *sqlWhereHaving) {
+	return sq_storage_get_all_xc((SqStorage*)this, tableName, tableType, sqlWhereHaving, xcOutput);
+}
 
 inline Sq::Type *StorageMethod::setupQuery(Sq::QueryMethod &query, Sq::TypeJointMethod *jointType) {
 	return (Sq::Type*)sq_storage_setup_query((SqStorage*)this, (SqQuery*)&query, (SqTypeJoint*)jointType);
@@ -570,12 +915,16 @@ inline Sq::Type *StorageMethod::setupQuery(Sq::QueryMethod *query, Sq::TypeJoint
 template <class StlContainer>
 inline StlContainer *StorageMethod::query(Sq::QueryMethod &query) {
 	void    *instance  = NULL;
-	SqType  *tableType = sq_storage_setup_query((SqStorage*)this, (SqQuery*)&query, ((SqStorage*)this)->joint_default);
+	SqType  *tableType;
+	// SqStorage.joint_default is protected by lock of 'db' in thread-safe mode
+	sq_storage_lock_db((SqStorage*)this);
+	tableType = sq_storage_setup_query((SqStorage*)this, (SqQuery*)&query, ((SqStorage*)this)->joint_default);
 	if (tableType) {
 		Sq::TypeStl<StlContainer> *containerType = new Sq::TypeStl<StlContainer>(tableType);
 		instance = sq_storage_query((SqStorage*)this, (SqQuery*)&query, tableType, containerType);
 		delete containerType;
 	}
+	sq_storage_unlock_db((SqStorage*)this);
 	return (StlContainer*)instance;
 }
 template <class StlContainer>
@@ -585,12 +934,16 @@ inline StlContainer *StorageMethod::query(Sq::QueryProxy &qproxy) {
 template <class StlContainer>
 inline StlContainer *StorageMethod::query(Sq::QueryMethod *query) {
 	void    *instance  = NULL;
-	SqType  *tableType = sq_storage_setup_query((SqStorage*)this, (SqQuery*)query, ((SqStorage*)this)->joint_default);
+	SqType  *tableType;
+	// SqStorage.joint_default is protected by lock of 'db' in thread-safe mode
+	sq_storage_lock_db((SqStorage*)this);
+	tableType = sq_storage_setup_query((SqStorage*)this, (SqQuery*)query, ((SqStorage*)this)->joint_default);
 	if (tableType) {
 		Sq::TypeStl<StlContainer> *containerType = new Sq::TypeStl<StlContainer>(tableType);
 		instance = sq_storage_query((SqStorage*)this, (SqQuery*)query, tableType, containerType);
 		delete containerType;
 	}
+	sq_storage_unlock_db((SqStorage*)this);
 	return (StlContainer*)instance;
 }
 template <class StlContainer>
@@ -631,6 +984,32 @@ inline void *StorageMethod::query(Sq::QueryProxy &qproxy, const SqType *tableTyp
 inline void *StorageMethod::query(Sq::QueryMethod *query, const SqType *tableType, const SqType *containerType) {
 	return sq_storage_query((SqStorage*)this, (SqQuery*)query, tableType, containerType);
 }
+inline int   StorageMethod::queryXc(Sq::QueryMethod &query, Sqxc *xcOutput, const SqType *tableType) {
+	return sq_storage_query_xc((SqStorage*)this, (SqQuery*)&query, tableType, xcOutput);
+}
+inline int   StorageMethod::queryXc(Sq::QueryMethod *query, Sqxc *xcOutput, const SqType *tableType) {
+	return sq_storage_query_xc((SqStorage*)this, (SqQuery*)query, tableType, xcOutput);
+}
+
+template <class StructType>
+inline Sq::Cursor<StructType> StorageMethod::cursor(const char *sqlWhereHaving) {
+	SqTable *table = sq_storage_find_by_type((SqStorage*)this, typeid(StructType).name());
+	if (table == NULL)
+		return Sq::Cursor<StructType>();
+	return Sq::Cursor<StructType>(sq_storage_get_all_cursor((SqStorage*)this, table->name, table->type, sqlWhereHaving));
+}
+template <class StructType>
+inline Sq::Cursor<StructType> StorageMethod::cursor(const QueryProxy &qproxy) {
+	return cursor<StructType>(((QueryProxy&)qproxy).c());
+}
+template <class StructType>
+inline Sq::Cursor<StructType> StorageMethod::cursor(Sq::QueryMethod &query, const SqType *tableType) {
+	return Sq::Cursor<StructType>(sq_storage_query_cursor((SqStorage*)this, (SqQuery*)&query, tableType));
+}
+template <class StructType>
+inline Sq::Cursor<StructType> StorageMethod::cursor(Sq::QueryMethod *query, const SqType *tableType) {
+	return Sq::Cursor<StructType>(sq_storage_query_cursor((SqStorage*)this, (SqQuery*)query, tableType));
+}
 
 template <class StructType>
 inline int64_t  StorageMethod::insert(StructType &instance) {
@@ -660,6 +1039,40 @@ inline int64_t  StorageMethod::insert(const char *tableName, const SqType *table
 	return sq_storage_insert((SqStorage*)this, tableName, tableType, instance);
 }
 
+template <class StlContainer>
+inline int64_t  StorageMethod::insertAll(StlContainer &container, int64_t *idRange) {
+	SqTable *table = sq_storage_find_by_type((SqStorage*)this,
+			typeid(typename std::remove_reference< typename std::remove_pointer<typename StlContainer::value_type>::type >::type).name());
+	if (table == NULL)
+		return -1;
+	Sq::TypeStl<StlContainer> containerType(table->type);
+	return sq_storage_insert_all((SqStorage*)this, table->name, table->type, &container, &containerType, idRange);
+}
+template <class StlContainer>
+inline int64_t  StorageMethod::insertAll(StlContainer *container, int64_t *idRange) {
+	return insertAll<StlContainer>(*container, idRange);
+}
+inline int64_t  StorageMethod::insertAll(const char *tableName, void *container, const SqType *containerType, int64_t *idRange) {
+	return sq_storage_insert_all((SqStorage*)this, tableName, NULL, container, containerType, idRange);
+}
+inline int64_t  StorageMethod::insertAll(const char *tableName, const SqType *tableType, void *container, const SqType *containerType, int64_t *idRange) {
+	return sq_storage_insert_all((SqStorage*)this, tableName, tableType, container, containerType, idRange);
+}
+
+template <class StructType>
+inline int64_t  StorageMethod::insertJson(const char *json) {
+	SqTable *table = sq_storage_find_by_type((SqStorage*)this, typeid(StructType).name());
+	if (table == NULL)
+		return -1;
+	return sq_storage_insert_json((SqStorage*)this, table->name, table->type, json);
+}
+inline int64_t  StorageMethod::insertJson(const char *tableName, const char *json) {
+	return sq_storage_insert_json((SqStorage*)this, tableName, NULL, json);
+}
+inline int64_t  StorageMethod::insertJson(const char *tableName, const SqType *tableType, const char *json) {
+	return sq_storage_insert_json((SqStorage*)this, tableName, tableType, json);
+}
+
 template <class StructType>
 inline int  StorageMethod::update(StructType &instance) {
 	SqTable *table = sq_storage_find_by_type((SqStorage*)this, typeid(StructType).name());
@@ -830,14 +1243,84 @@ inline void StorageMethod::removeAll(const char *tableName, const QueryProxy &qp
 	sq_storage_remove_all((SqStorage*)this, tableName, ((QueryProxy&)qproxy).c());
 }
 
+#if SQ_CONFIG_HAVE_THREAD
+inline int  StorageMethod::startWorkers(int nWorkers) {
+	return sq_storage_start_workers((SqStorage*)this, nWorkers);
+}
+inline int  StorageMethod::stopWorkers() {
+	return sq_storage_stop_workers((SqStorage*)this);
+}
+
+template <class Function>
+inline auto StorageMethod::runAsync(Function func) -> std::future<decltype(func((SqStorage*)NULL))> {
+	typedef std::packaged_task<decltype(func((SqStorage*)NULL))(SqStorage*)>  Task;
+	Task *task = new Task(func);
+	auto  future = task->get_future();
+	SqStorageWorkFunc  runTask = [](SqStorage *storage, void *data) {
+		(*(Task*)data)(storage);
+		delete (Task*)data;
+	};
+
+	if (sq_storage_run_async((SqStorage*)this, runTask, task) != SQCODE_OK) {
+		std::promise<decltype(func((SqStorage*)NULL))>  promise;
+		delete task;
+		promise.set_exception(std::make_exception_ptr(std::runtime_error("sq_storage_run_async() failed")));
+		return promise.get_future();
+	}
+	return future;
+}
+
+template <class StructType>
+inline std::future<StructType*>    StorageMethod::getAsync(int64_t id) {
+	return runAsync([id](SqStorage *storage) {
+		return storage->get<StructType>(id);
+	});
+}
+template <class StlContainer>
+inline std::future<StlContainer*>  StorageMethod::getAllAsync(const char *sqlWhereHaving) {
+	bool        hasWhere = (sqlWhereHaving != NULL);
+	std::string where = (hasWhere) ? sqlWhereHaving : "";
+	return runAsync([hasWhere, where](SqStorage *storage) {
+		return storage->getAll<StlContainer>(hasWhere ? where.c_str() : NULL);
+	});
+}
+template <class StlContainer>
+inline std::future<StlContainer*>  StorageMethod::queryAsync(Sq::QueryMethod &query) {
+	Sq::QueryMethod *queryPtr = &query;
+	return runAsync([queryPtr](SqStorage *storage) {
+		return storage->query<StlContainer>(queryPtr);
+	});
+}
+template <class StructType>
+inline std::future<int64_t>        StorageMethod::insertAsync(StructType &instance) {
+	StructType *instancePtr = &instance;
+	return runAsync([instancePtr](SqStorage *storage) {
+		return storage->insert<StructType>(instancePtr);
+	});
+}
+template <class StructType>
+inline std::future<int>            StorageMethod::updateAsync(StructType &instance) {
+	StructType *instancePtr = &instance;
+	return runAsync([instancePtr](SqStorage *storage) {
+		return storage->update<StructType>(instancePtr);
+	});
+}
+template <class StructType>
+inline std::future<void>           StorageMethod::removeAsync(int64_t id) {
+	return runAsync([id](SqStorage *storage) {
+		storage->remove<StructType>(id);
+	});
+}
+#endif  // SQ_CONFIG_HAVE_THREAD
+
 inline int  StorageMethod::beginTrans() {
-	return SQ_STORAGE_BEGIN_TRANS((SqStorage*)this);
+	return sq_storage_begin_trans((SqStorage*)this);
 }
 inline int  StorageMethod::commitTrans() {
-	return SQ_STORAGE_COMMIT_TRANS((SqStorage*)this);
+	return sq_storage_commit_trans((SqStorage*)this);
 }
 inline int  StorageMethod::rollbackTrans() {
-	return SQ_STORAGE_ROLLBACK_TRANS((SqStorage*)this);
+	return sq_storage_rollback_trans((SqStorage*)this);
 }
 
 /* All derived struct/class must be C++11 standard-layout. */
@@ -133,4 +133,57 @@ void  sq_rwlock_writer_unlock(SqRwlock *rwlock)
 	ReleaseSRWLockExclusive(rwlock->data);
 }
 
+/* ------ condition variable ------ */
+void  sq_cond_init(SqCond *cond)
+{
+	cond->data = malloc(sizeof(CONDITION_VARIABLE));
+	InitializeConditionVariable(cond->data);
+}
+
+void  sq_cond_clear(SqCond *cond)
+{
+	free(cond->data);
+}
+
+void  sq_cond_wait(SqCond *cond, SqMutex *mutex)
+{
+	SleepConditionVariableCS(cond->data, mutex->data, INFINITE);
+}
+
+int   sq_cond_timedwait(SqCond *cond, SqMutex *mutex, int milliseconds)
+{
+	if (SleepConditionVariableCS(cond->data, mutex->data, milliseconds) == FALSE)
+		return ETIMEDOUT;
+	return SQ_THREAD_OK;
+}
+
+void  sq_cond_signal(SqCond *cond)
+{
+	WakeConditionVariable(cond->data);
+}
+
+void  sq_cond_broadcast(SqCond *cond)
+{
+	WakeAllConditionVariable(cond->data);
+}
+
+#elif SQ_CONFIG_HAVE_THREAD
+/* ------ pthread ------ */
+
+#include <time.h>       // clock_gettime()
+
+int   sq_cond_timedwait(SqCond *cond, SqMutex *mutex, int milliseconds)
+{
+	struct timespec  abstime;
+
+	clock_gettime(CLOCK_REALTIME, &abstime);
+	abstime.tv_sec  += milliseconds / 1000;
+	abstime.tv_nsec += (long)(milliseconds % 1000) * 1000000;
+	if (abstime.tv_nsec >= 1000000000) {
+		abstime.tv_sec++;
+		abstime.tv_nsec -= 1000000000;
+	}
+	return pthread_cond_timedwait(&cond->data, &mutex->data, &abstime);
+}
+
 #endif  // _WIN32 || _WIN64
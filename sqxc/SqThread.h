@@ -16,6 +16,18 @@
 #define SQ_THREAD_H
 
 #include <SqConfig.h>
+
+// storage-class specifier of thread-local variable
+#if SQ_CONFIG_HAVE_THREAD == 0
+#define SQ_THREAD_LOCAL
+#elif defined(__cplusplus) && (__cplusplus >= 201103L)
+#define SQ_THREAD_LOCAL    thread_local
+#elif defined(_MSC_VER)
+#define SQ_THREAD_LOCAL    __declspec(thread)
+#else
+#define SQ_THREAD_LOCAL    __thread
+#endif
+
 #if SQ_CONFIG_HAVE_THREAD || defined(_WIN32) || defined(_WIN64)
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -30,6 +42,7 @@
 typedef struct SqThread    SqThread;
 typedef struct SqMutex     SqMutex;
 typedef struct SqRwlock    SqRwlock;
+typedef struct SqCond      SqCond;
 
 // ----------------------------------------------------------------------------
 // C declarations: declare C data, function, and others.
@@ -45,6 +58,7 @@ typedef unsigned              SqThreadResult;
 typedef uintptr_t             SqThreadData;
 typedef LPCRITICAL_SECTION    SqMutexData;
 typedef PSRWLOCK              SqRwlockData;
+typedef PCONDITION_VARIABLE   SqCondData;
 
 // This function must return SQ_THREAD_RESULT
 typedef SqThreadResult (*SqThreadFunc)(void*);
@@ -76,6 +90,13 @@ int   sq_rwlock_writer_trylock(SqRwlock *rwlock);
 void  sq_rwlock_writer_lock(SqRwlock *rwlock);
 void  sq_rwlock_writer_unlock(SqRwlock *rwlock);
 
+/* ------ condition variable ------ */
+void  sq_cond_init(SqCond *cond);
+void  sq_cond_clear(SqCond *cond);
+void  sq_cond_wait(SqCond *cond, SqMutex *mutex);
+void  sq_cond_signal(SqCond *cond);
+void  sq_cond_broadcast(SqCond *cond);
+
 #else
 /* ------ pthread ------ */
 
@@ -83,6 +104,7 @@ typedef void*               SqThreadResult;
 typedef pthread_t           SqThreadData;
 typedef pthread_mutex_t     SqMutexData;
 typedef pthread_rwlock_t    SqRwlockData;
+typedef pthread_cond_t      SqCondData;
 
 // This function must return SQ_THREAD_RESULT
 typedef SqThreadResult (*SqThreadFunc)(void*);
@@ -93,8 +115,8 @@ typedef SqThreadResult (*SqThreadFunc)(void*);
 /* ------ thread ------ */
 // sq_thread_create() and sq_thread_join() return SQ_THREAD_OK if successful
 // int  sq_thread_create(SqThread *thread, SqThreadFunc func, void *data);
-#define sq_thread_create(thread, func, data)    \
-		pthread_create(&(thread)->data, NULL, func, data)
+#define sq_thread_create(thread, func, arg)    \
+		pthread_create(&(thread)->data, NULL, func, arg)
 
 // int  sq_thread_join(SqThread *thread);
 #define sq_thread_join(thread)    \
@@ -148,8 +170,28 @@ typedef SqThreadResult (*SqThreadFunc)(void*);
 // void sq_rwlock_writer_unlock(SqRwlock *rwlock);
 #define sq_rwlock_writer_unlock(rwlock)    pthread_rwlock_unlock(&(rwlock)->data)
 
+/* ------ condition variable ------ */
+// void sq_cond_init(SqCond *cond);
+#define sq_cond_init(cond)              pthread_cond_init(&(cond)->data, NULL)
+
+// void sq_cond_clear(SqCond *cond);
+#define sq_cond_clear(cond)             pthread_cond_destroy(&(cond)->data)
+
+// void sq_cond_wait(SqCond *cond, SqMutex *mutex);
+#define sq_cond_wait(cond, mutex)       pthread_cond_wait(&(cond)->data, &(mutex)->data)
+
+// void sq_cond_signal(SqCond *cond);
+#define sq_cond_signal(cond)            pthread_cond_signal(&(cond)->data)
+
+// void sq_cond_broadcast(SqCond *cond);
+#define sq_cond_broadcast(cond)         pthread_cond_broadcast(&(cond)->data)
+
 #endif   // _WIN32 || _WIN64
 
+// sq_cond_timedwait() waits at most 'milliseconds'.
+// It returns SQ_THREAD_OK if 'cond' is signaled, returns ETIMEDOUT if time is out.
+int   sq_cond_timedwait(SqCond *cond, SqMutex *mutex, int milliseconds);
+
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -222,9 +264,6 @@ struct SqMutex
 		this->data = rvalue;
 		return *this;
 	}
-	bool operator==(SqMutexData rvalue) {
-		return (this->data == rvalue);
-	}
 #endif  // __cplusplus
 };
 
@@ -266,8 +305,35 @@ struct SqRwlock
 		this->data = rvalue;
 		return *this;
 	}
-	bool operator==(SqRwlockData rvalue) {
-		return (this->data == rvalue);
+#endif  // __cplusplus
+};
+
+/* ------ SqCond ------ */
+struct SqCond
+{
+	SqCondData    data;
+
+#ifdef __cplusplus
+	// C++11 standard-layout
+
+	SqCond() {
+		sq_cond_init(this);
+	}
+	~SqCond() {
+		sq_cond_clear(this);
+	}
+
+	void  wait(SqMutex *mutex) {
+		sq_cond_wait(this, mutex);
+	}
+	int   timedwait(SqMutex *mutex, int milliseconds) {
+		return sq_cond_timedwait(this, mutex, milliseconds);
+	}
+	void  signal(void) {
+		sq_cond_signal(this);
+	}
+	void  broadcast(void) {
+		sq_cond_broadcast(this);
 	}
 #endif  // __cplusplus
 };
@@ -283,6 +349,7 @@ namespace Sq {
 typedef struct SqThread    Thread;
 typedef struct SqMutex     Mutex;
 typedef struct SqRwlock    Rwlock;
+typedef struct SqCond      Cond;
 
 }  // namespace Sq
 
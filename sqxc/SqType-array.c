@@ -140,8 +140,13 @@ static int  sq_type_array_parse(void *array, const SqType *type, Sqxc *src)
 	 */
 
 	element = sq_array_alloc(array, 1);
-	element = sq_type_init_instance(element_type, element,
-	        (type->final == sq_type_ptr_array_final) ? true : false);
+	element = sq_type_init_instance_arena(element_type, element,
+	        (type->final == sq_type_ptr_array_final) ? true : false, xc_value->arena);
+	// failed to allocate element
+	if (element == NULL) {
+		sq_array_length(array)--;
+		return (src->code = SQCODE_ERROR);
+	}
 	src->name = NULL;    // set "name" before calling parse()
 	src->code = element_type->parse(element, element_type, src);
 	return src->code;
@@ -21,6 +21,7 @@
 #include <string.h>   // strdup()
 
 #include <SqUtil.h>   // sq_time_to_string(), sq_time_from_string()
+#include <SqConfig.h>
 #include <SqError.h>
 #include <SqPtrArray.h>
 #include <SqType.h>
@@ -50,6 +51,10 @@ int  sq_type_bool_parse(void *instance, const SqType *entrytype, Sqxc *src)
 		*(bool*)instance = (src->value.integer) ? true : false;
 		break;
 
+	case SQXC_TYPE_INT64:
+		*(bool*)instance = (src->value.int64) ? true : false;
+		break;
+
 	case SQXC_TYPE_STR:
 		if (src->value.str) {
 			ch = src->value.str[0]; 
@@ -95,6 +100,14 @@ int  sq_type_int_parse(void *instance, const SqType *entrytype, Sqxc *src)
 		*(int*)instance = src->value.boolean;
 		break;
 
+	case SQXC_TYPE_INT64:
+		*(int*)instance = (int)src->value.int64;
+		break;
+
+	case SQXC_TYPE_DOUBLE:
+		*(int*)instance = (int)src->value.double_;
+		break;
+
 	case SQXC_TYPE_STR:
 		if (src->value.str)
 			*(int*)instance = strtol(src->value.str, NULL, 10);
@@ -135,6 +148,10 @@ int  sq_type_uint_parse(void *instance, const SqType *entrytype, Sqxc *src)
 		*(unsigned int*)instance = src->value.boolean;
 		break;
 
+	case SQXC_TYPE_INT64:
+		*(unsigned int*)instance = (unsigned int)src->value.int64;
+		break;
+
 	case SQXC_TYPE_STR:
 		if (src->value.str)
 			*(unsigned int*)instance = strtoul(src->value.str, NULL, 10);
@@ -175,6 +192,10 @@ int  sq_type_intptr_parse(void *instance, const SqType *entrytype, Sqxc *src)
 		*(intptr_t*)instance = src->value.boolean;
 		break;
 
+	case SQXC_TYPE_INT64:
+		*(intptr_t*)instance = (intptr_t)src->value.int64;
+		break;
+
 	case SQXC_TYPE_STR:
 		if (src->value.str)
 			*(intptr_t*)instance = strtol(src->value.str, NULL, 10);
@@ -215,6 +236,10 @@ int  sq_type_int64_parse(void *instance, const SqType *entrytype, Sqxc *src)
 		*(int64_t*)instance = src->value.int64;
 		break;
 
+	case SQXC_TYPE_DOUBLE:
+		*(int64_t*)instance = (int64_t)src->value.double_;
+		break;
+
 	case SQXC_TYPE_STR:
 		if (src->value.str)
 			*(int64_t*)instance = strtoll(src->value.str, NULL, 10);
@@ -252,6 +277,7 @@ int  sq_type_uint64_parse(void *instance, const SqType *entrytype, Sqxc *src)
 		break;
 
 	case SQXC_TYPE_UINT64:
+	case SQXC_TYPE_INT64:
 		*(uint64_t*)instance = src->value.int64;
 		break;
 
@@ -291,6 +317,10 @@ int  sq_type_double_parse(void *instance, const SqType *entrytype, Sqxc *src)
 		*(double*)instance = src->value.integer;
 		break;
 
+	case SQXC_TYPE_INT64:
+		*(double*)instance = (double)src->value.int64;
+		break;
+
 	case SQXC_TYPE_DOUBLE:
 		*(double*)instance = src->value.double_;
 		break;
@@ -378,6 +408,8 @@ void sq_type_str_final(void *instance, const SqType *entrytype)
 
 int  sq_type_str_parse(void *instance, const SqType *entrytype, Sqxc *src)
 {
+	SqArena *arena;
+
 	switch (src->type) {
 	/* TODO: convert to string
 	case SQXC_TYPE_INT:
@@ -393,10 +425,12 @@ int  sq_type_str_parse(void *instance, const SqType *entrytype, Sqxc *src)
 			free(*(char**)instance);
 		*/
 
-		if (src->value.str)
-			*(char**)instance = strdup(src->value.str);
-		else
+		if (src->value.str == NULL)
 			*(char**)instance = NULL;
+		else if ((arena = sqxc_value_src_arena(src)) != NULL)
+			*(char**)instance = sq_arena_strdup(arena, src->value.str);
+		else
+			*(char**)instance = strdup(src->value.str);
 		break;
 
 	default:
@@ -487,8 +521,8 @@ int  sq_type_object_parse(void *instance, const SqType *type, Sqxc *src)
 	}
 	 */
 
-	// parse entries in type
-	p.addr = sq_type_find_entry(type, src->name, NULL);
+	// parse entries in type. Rows of result set use binding instead of searching entry.
+	p.addr = sqxc_value_find_entry(xc_value, src, type);
 	if (p.addr) {
 		p.entry = *p.addr;
 		type = p.entry->type;
@@ -501,8 +535,11 @@ int  sq_type_object_parse(void *instance, const SqType *type, Sqxc *src)
 			if (*(void**)instance)
 				instance = *(void**)instance;
 			// allocate & initialize instance if source is not NULL
-			else if (src->type != SQXC_TYPE_NULL)
-				instance = sq_type_init_instance(type, instance, true);
+			else if (src->type != SQXC_TYPE_NULL) {
+				instance = sq_type_init_instance_arena(type, instance, true, xc_value->arena);
+				if (instance == NULL)
+					return (src->code = SQCODE_ERROR);
+			}
 			else
 				return (src->code = SQCODE_OK);
 		}
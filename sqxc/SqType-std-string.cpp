@@ -51,7 +51,7 @@ static void sq_type_std_string_final(void *instance, const SqType *type)
 
 static int  sq_type_std_string_parse(void *instance, const SqType *type, Sqxc *src)
 {
-	if (src->type == SQXC_TYPE_STR) {
+	if (src->type == SQXC_TYPE_STR || src->type == SQXC_TYPE_NULL) {
 		if (src->value.str)
 			((std::string*)instance)->assign(src->value.str);
 		else
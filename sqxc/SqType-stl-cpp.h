@@ -31,7 +31,21 @@ namespace Sq {
 // SqType for C++ STL containers
 template<class Container>
 struct TypeStl : SqType {
+#ifdef SQ_ARENA_HAVE_MEMORY_RESOURCE
+	// memory resource of std::pmr container. It is ignored if container doesn't use polymorphic allocator.
+	std::pmr::memory_resource *resource;
+#endif
+
 	static void  cxxInit(void *instance, const SqType *type) {
+#ifdef SQ_ARENA_HAVE_MEMORY_RESOURCE
+		if constexpr (std::uses_allocator<Container, std::pmr::memory_resource*>::value) {
+			std::pmr::memory_resource *resource = ((TypeStl*)type)->resource;
+			if (resource) {
+				new (&(*(Container*)instance)) Container(typename Container::allocator_type(resource));
+				return;
+			}
+		}
+#endif
 		new (&(*(Container*)instance)) Container();
 	}
 	static void  cxxFinal(void *instance, const SqType *type) {
@@ -91,9 +105,14 @@ struct TypeStl : SqType {
 
 		((Container*)instance)->emplace_back(typename Container::value_type());
 		element = (void*) std::addressof(((Container*)instance)->back());
-		element = sq_type_init_instance(element_type, element,
+		element = sq_type_init_instance_arena(element_type, element,
 				std::is_pointer<typename Container::value_type>::value ||
-				std::is_reference<typename Container::value_type>::value);
+				std::is_reference<typename Container::value_type>::value, xc_value->arena);
+		// failed to allocate element
+		if (element == NULL) {
+			((Container*)instance)->pop_back();
+			return (src->code = SQCODE_ERROR);
+		}
 		src->name = NULL;    // set "name" before calling parse()
 		src->code = element_type->parse(element, element_type, src);
 		return src->code;
@@ -141,6 +160,10 @@ struct TypeStl : SqType {
 		this->name  = NULL;
 		this->n_entry = -1;                       // SqType.entry isn't freed if SqType.n_entry == -1
 		this->entry = (SqEntry**)element_type;    // TypeStl use SqType.entry to store element type
+		this->entry_hash = NULL;
+#ifdef SQ_ARENA_HAVE_MEMORY_RESOURCE
+		this->resource = NULL;
+#endif
 #if SQ_TYPE_STL_ENABLE_DYNAMIC == 1
 		// reset SqType.bit_field if it has not been set by operator new()
 		if (this->bit_field != SQB_TYPE_DYNAMIC)
@@ -150,7 +173,13 @@ struct TypeStl : SqType {
 #endif
 	}
 
-#if SQ_TYPE_STL_ENABLE_DYNAMIC == 1
+#ifdef SQ_ARENA_HAVE_MEMORY_RESOURCE
+	// container that is created by this type allocates memory from 'resource'. e.g. Sq::ArenaResource
+	TypeStl(const SqType *element_type, std::pmr::memory_resource *resource) : TypeStl(element_type) {
+		this->resource = resource;
+	}
+#endif
+
 	~TypeStl() {
 		/*
 		// The destructor of the base class was originally called here.
@@ -158,8 +187,11 @@ struct TypeStl : SqType {
 		if (this->bit_field & SQB_TYPE_DYNAMIC)
 			sq_type_final_self(this);
 		 */
+		// hash table of entry names may be built by sq_type_sort_entry()
+		free(this->entry_hash);
 	}
 
+#if SQ_TYPE_STL_ENABLE_DYNAMIC == 1
 	// for dynamic allocated Sq::TypeStl
 	void *operator new(size_t size) {
 		void *instance = malloc(size);
@@ -12,15 +12,32 @@
  * See the Mulan PSL v2 for more details.
  */
 
+#include <ctype.h>      // tolower()
+#include <stdlib.h>
 #include <string.h>
 
 #include <SqConfig.h>
 #include <SqPtrArray.h>
+#include <SqSlab.h>
 #include <SqType.h>
 #include <SqEntry.h>
 
 #define SQ_TYPE_N_ENTRY_DEFAULT    SQ_CONFIG_TYPE_N_ENTRY_DEFAULT
 
+/*	SqTypeHash - open addressing hash table of entry names.
+	             SqType.entry and SqType.n_entry are stored to detect that SqType.entry has been changed.
+ */
+struct SqTypeHash
+{
+	SqEntry      **entry;      // SqType.entry when hash table was built
+	int            n_entry;    // SqType.n_entry when hash table was built
+	unsigned int   mask;       // number of slots - 1
+	int            slots[1];   // index of entry + 1. 0 is empty slot.
+};
+
+static void          sq_type_build_hash(SqType *type);
+static void        **sq_type_find_hash(const SqType *type, const char *name);
+
 #ifdef _MSC_VER
 #define strcasecmp   _stricmp
 #define strncasecmp  _strnicmp
@@ -54,6 +71,7 @@ SqType  *sq_type_copy_static(SqType *type_dest, const SqType *static_type_src, S
 		type_dest = malloc(sizeof(SqType));
 	memcpy(type_dest, static_type_src, sizeof(SqType));
 	type_dest->bit_field |= SQB_TYPE_DYNAMIC;
+	type_dest->entry_hash = NULL;
 	// alloc & copy pointer array of SqEntry
 	sq_ptr_array_init(sq_type_get_ptr_array(type_dest), static_type_src->n_entry, entry_free_func);
 	type_dest->n_entry = static_type_src->n_entry;
@@ -75,6 +93,7 @@ void  sq_type_init_self(SqType *type, int prealloc_size, SqDestroyFunc entry_des
 	type->name  = NULL;
 	type->bit_field  = SQB_TYPE_DYNAMIC;
 	type->on_destroy = NULL;
+	type->entry_hash = NULL;
 
 	if (prealloc_size == -1) {
 		// SqType.entry isn't freed if SqType.n_entry == -1
@@ -91,6 +110,7 @@ void  sq_type_init_self(SqType *type, int prealloc_size, SqDestroyFunc entry_des
 
 void  sq_type_final_self(SqType *type)
 {
+	sq_type_clear_hash(type);
 	free(type->name);
 	// SqType.entry isn't freed if SqType.n_entry == -1
 	if (type->n_entry != -1)
@@ -98,14 +118,31 @@ void  sq_type_final_self(SqType *type)
 }
 
 void *sq_type_init_instance(const SqType *type, void *instance, int is_pointer)
+{
+	return sq_type_init_instance_arena(type, instance, is_pointer, NULL);
+}
+
+void *sq_type_init_instance_arena(const SqType *type, void *instance, int is_pointer, SqArena *arena)
 {
 	SqTypeFunc  init = type->init;
 	SqPtrArray *array;
 
 	// This instance pointer to pointer
 	if (is_pointer) {
-		if (type->size > 0)
-			*(void**)instance = calloc(1, type->size);
+		if (type->size > 0) {
+			if (arena)
+				*(void**)instance = sq_arena_calloc(arena, type->size);
+			else if (type->bit_field & SQB_TYPE_SLAB && type->size <= SQ_SLAB_SIZE_MAX) {
+				*(void**)instance = sq_slab_alloc_size(type->size);
+				if (*(void**)instance)
+					memset(*(void**)instance, 0, type->size);
+			}
+			else
+				*(void**)instance = calloc(1, type->size);
+			// failed to allocate instance
+			if (*(void**)instance == NULL)
+				return NULL;
+		}
 		instance = *(void**)instance;
 	}
 
@@ -119,18 +156,43 @@ void *sq_type_init_instance(const SqType *type, void *instance, int is_pointer)
 			SqEntry *entry = *element_addr;
 			type = entry->type;
 			if (SQ_TYPE_NOT_BUILTIN(type)) {
-				sq_type_init_instance(type,
+				sq_type_init_instance_arena(type,
 						(char*)instance + entry->offset,
-						entry->bit_field & SQB_POINTER);
+						entry->bit_field & SQB_POINTER, arena);
 			}
 		}
 	}
 	return instance;
 }
 
+static bool sq_type_can_use_arena_depth(const SqType *type, int depth)
+{
+	SqEntry *entry;
+
+	if (SQ_TYPE_IS_BUILTIN(type))
+		return true;
+	// limit depth of nested (or recursive) type
+	if (depth > 16)
+		return false;
+	if (type->init || type->final || type->parse != sq_type_object_parse)
+		return false;
+	for (int index = 0;  index < type->n_entry;  index++) {
+		entry = type->entry[index];
+		if (sq_type_can_use_arena_depth(entry->type, depth + 1) == false)
+			return false;
+	}
+	return true;
+}
+
+bool  sq_type_can_use_arena(const SqType *type)
+{
+	return sq_type_can_use_arena_depth(type, 0);
+}
+
 void  sq_type_final_instance(const SqType *type, void *instance, int is_pointer)
 {
-	SqTypeFunc  final = type->final;
+	const SqType *type_self = type;
+	SqTypeFunc    final = type->final;
 	SqPtrArray *array;
 
 	// This instance pointer to pointer
@@ -158,14 +220,19 @@ void  sq_type_final_instance(const SqType *type, void *instance, int is_pointer)
 	}
 
 	// free memory if this instance is C pointer
-	if (is_pointer)
-		free(instance);
+	if (is_pointer) {
+		if (type_self->bit_field & SQB_TYPE_SLAB && type_self->size <= SQ_SLAB_SIZE_MAX)
+			sq_slab_free_size(instance, type_self->size);
+		else
+			free(instance);
+	}
 }
 
 void  sq_type_clear_entry(SqType *type)
 {
 	// SqType.entry isn't freed if SqType.n_entry == -1
 	if (type->bit_field & SQB_TYPE_DYNAMIC && type->n_entry > 0) {
+		sq_type_clear_hash(type);
 		sq_ptr_array_erase(sq_type_get_ptr_array(type), 0, type->n_entry);
 		type->size = 0;
 	}
@@ -180,6 +247,7 @@ void  sq_type_add_entry(SqType *type, const SqEntry *entry, int n_entry, size_t
 		if (sizeof_entry == 0)
 			sizeof_entry = sizeof(SqEntry);
 		type->bit_field &= ~SQB_TYPE_SORTED;
+		sq_type_clear_hash(type);
 		array = sq_type_get_ptr_array(type);
 		entry_addr = sq_ptr_array_alloc(array, n_entry);
 		for (;  n_entry;  n_entry--, entry_addr++) {
@@ -196,6 +264,7 @@ void  sq_type_add_entry_ptrs(SqType *type, const SqEntry **entry_ptrs, int n_ent
 
 	if (type->bit_field & SQB_TYPE_DYNAMIC) {
 		type->bit_field &= ~SQB_TYPE_SORTED;
+		sq_type_clear_hash(type);
 		array = sq_type_get_ptr_array(type);
 		SQ_PTR_ARRAY_APPEND(array, entry_ptrs, n_entry_ptrs);
 		for (int index = 0;  index < n_entry_ptrs;  index++, entry_ptrs++)
@@ -206,6 +275,7 @@ void  sq_type_add_entry_ptrs(SqType *type, const SqEntry **entry_ptrs, int n_ent
 void  sq_type_erase_entry_addr(SqType *type, SqEntry **inner_entry_addr, int count)
 {
 	if ((type)->bit_field & SQB_TYPE_DYNAMIC) {
+		sq_type_clear_hash(type);
 		sq_type_decide_size(type, *inner_entry_addr, true);
 		sq_ptr_array_erase(sq_type_get_ptr_array(type),
 				(int)(inner_entry_addr - type->entry), count);
@@ -215,6 +285,7 @@ void  sq_type_erase_entry_addr(SqType *type, SqEntry **inner_entry_addr, int cou
 void  sq_type_steal_entry_addr(SqType *type, SqEntry **inner_entry_addr, int count)
 {
 	if ((type)->bit_field & SQB_TYPE_DYNAMIC) {
+		sq_type_clear_hash(type);
 		sq_type_decide_size(type, *inner_entry_addr, true);
 		SQ_PTR_ARRAY_STEAL_ADDR(&(type)->entry, inner_entry_addr, count);
 	}
@@ -229,8 +300,16 @@ void **sq_type_find_entry(const SqType *type, const void *key, SqCompareFunc com
 	if (compareFunc == NULL)
 		compareFunc = sq_entry_cmp_str__name;
 
-	if (type->bit_field & SQB_TYPE_SORTED && compareFunc == sq_entry_cmp_str__name)
+	if (type->bit_field & SQB_TYPE_SORTED && compareFunc == sq_entry_cmp_str__name) {
+		// use hash table if SqType.entry has not been changed after building it.
+		if (type->entry_hash &&
+		    type->entry_hash->entry   == type->entry &&
+		    type->entry_hash->n_entry == type->n_entry)
+		{
+			return sq_type_find_hash(type, key);
+		}
 		return sq_ptr_array_search(array, key, compareFunc);
+	}
 	else
 		return sq_ptr_array_find(array, key, compareFunc);
 }
@@ -239,11 +318,14 @@ void  sq_type_sort_entry(SqType *type)
 {
 	SqPtrArray *array = (SqPtrArray*)&type->entry;
 
-	if ( type->bit_field & SQB_TYPE_DYNAMIC &&
-	    (type->bit_field & SQB_TYPE_SORTED) == 0 )
-	{
-		type->bit_field |= SQB_TYPE_SORTED;
-		sq_ptr_array_sort(array, sq_entry_cmp_name);
+	if (type->bit_field & SQB_TYPE_DYNAMIC) {
+		if ((type->bit_field & SQB_TYPE_SORTED) == 0) {
+			type->bit_field |= SQB_TYPE_SORTED;
+			sq_ptr_array_sort(array, sq_entry_cmp_name);
+			sq_type_clear_hash(type);
+		}
+		if (type->entry_hash == NULL && type->n_entry > 0)
+			sq_type_build_hash(type);
 	}
 }
 
@@ -309,6 +391,70 @@ void  sq_type_set_str_addr(SqType *type, char **str_addr, const char *str_src)
 	}
 }
 
+// ----------------------------------------------------------------------------
+// SqTypeHash
+
+static unsigned int  sq_type_hash_name(const char *name)
+{
+	unsigned int  hash = 2166136261u;    // FNV-1a
+
+	for (;  *name;  name++) {
+#if SQ_CONFIG_ENTRY_NAME_CASE_SENSITIVE
+		hash ^= (unsigned char)*name;
+#else
+		hash ^= (unsigned char)tolower((unsigned char)*name);
+#endif
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static void  sq_type_build_hash(SqType *type)
+{
+	SqTypeHash   *hash;
+	SqEntry      *entry;
+	unsigned int  n_slots;
+	unsigned int  slot;
+
+	// keep load factor <= 0.5
+	for (n_slots = 8;  n_slots < (unsigned int)type->n_entry * 2;  n_slots *= 2)
+		;
+	hash = calloc(1, sizeof(SqTypeHash) + sizeof(int) * (n_slots - 1));
+	hash->entry   = type->entry;
+	hash->n_entry = type->n_entry;
+	hash->mask    = n_slots - 1;
+
+	for (int index = 0;  index < type->n_entry;  index++) {
+		entry = type->entry[index];
+		slot  = sq_type_hash_name((entry && entry->name) ? entry->name : "") & hash->mask;
+		while (hash->slots[slot])
+			slot = (slot + 1) & hash->mask;
+		hash->slots[slot] = index + 1;
+	}
+	type->entry_hash = hash;
+}
+
+void  sq_type_clear_hash(SqType *type)
+{
+	free(type->entry_hash);
+	type->entry_hash = NULL;
+}
+
+static void **sq_type_find_hash(const SqType *type, const char *name)
+{
+	SqTypeHash   *hash = type->entry_hash;
+	unsigned int  slot;
+	int           index;
+
+	slot = sq_type_hash_name(name) & hash->mask;
+	while ((index = hash->slots[slot]) != 0) {
+		if (sq_entry_cmp_str__name(name, type->entry + index - 1) == 0)
+			return (void**)(type->entry + index - 1);
+		slot = (slot + 1) & hash->mask;
+	}
+	return NULL;
+}
+
 // ----------------------------------------------------------------------------
 // If C compiler doesn't support C99 inline functions
 
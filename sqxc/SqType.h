@@ -29,6 +29,7 @@
 #endif
 
 #include <SqPtrArray.h>
+#include <SqArena.h>
 #include <SqEntry.h>       // typedef struct SqType
 #include <Sqxc.h>
 
@@ -36,6 +37,7 @@
 // C/C++ common declarations: declare type, structure, macro, enumeration.
 
 //typedef struct SqType        SqType;
+typedef struct SqTypeHash    SqTypeHash;    // defined in SqType.c
 
 typedef void  (*SqTypeFunc)(void *instance, const SqType *type);
 typedef int   (*SqTypeParseFunc)(void *instance, const SqType *type, Sqxc *xc_src);
@@ -68,6 +70,7 @@ typedef Sqxc *(*SqTypeWriteFunc)(void *instance, const SqType *type, Sqxc *xc_de
 	sizeof(EntryPtrArray) / sizeof(SqEntry*),                      \
 	bit_value,                                                     \
 	NULL,                                                          \
+	NULL,                                                          \
 }
 
 #define SQ_TYPE_INITIALIZER_FULL(StructType, EntryPtrArray, bit_value, init_func, final_func) \
@@ -82,13 +85,15 @@ typedef Sqxc *(*SqTypeWriteFunc)(void *instance, const SqType *type, Sqxc *xc_de
 	sizeof(EntryPtrArray) / sizeof(SqEntry*),                      \
 	bit_value,                                                     \
 	NULL,                                                          \
+	NULL,                                                          \
 }
 
 /* SqType::bit_field - SQB_TYPE_xxxx */
 #define SQB_TYPE_DYNAMIC                  (1<<0)    // equal SQB_DYNAMIC, for internal use only
 #define SQB_TYPE_SORTED                   (1<<1)
 #define SQB_TYPE_PARSE_UNKNOWN            (1<<2)
-#define SQB_TYPE_RESERVE_BEG              (1<<3)
+#define SQB_TYPE_SLAB                     (1<<3)    // allocate instance from global SqSlab. Don't free() it.
+#define SQB_TYPE_RESERVE_BEG              (1<<4)
 #define SQB_TYPE_RESERVE_END              (1<<7)
 
 /* macro for accessing variable of SqType */
@@ -119,9 +124,19 @@ void     sq_type_init_self(SqType *type, int prealloc_size, SqDestroyFunc entry_
 void     sq_type_final_self(SqType *type);
 
 // initialize/finalize instance
+// If 'is_pointer' is true, instance is allocated and it returns NULL if allocation failed.
+// Instance of SQB_TYPE_SLAB type is allocated from global SqSlab, it must be released by
+// sq_type_final_instance() or sq_slab_free_size(), not free().
 void    *sq_type_init_instance(const SqType *type, void *instance, int is_pointer);
 void     sq_type_final_instance(const SqType *type, void *instance, int is_pointer);
 
+// initialize instance. If 'arena' is not NULL, instance (and it's pointer members) are allocated from 'arena'.
+void    *sq_type_init_instance_arena(const SqType *type, void *instance, int is_pointer, SqArena *arena);
+
+// return true if instance of 'type' can be allocated from SqArena and it needn't be finalized.
+// It must be parsed by sq_type_object_parse() or built-in type, it and it's members have no init() and final().
+bool     sq_type_can_use_arena(const SqType *type);
+
 // clear entry from SqEntry array in dynamic SqType.
 void     sq_type_clear_entry(SqType *type);
 
@@ -139,15 +154,19 @@ void     sq_type_erase_entry_addr(SqType *type, SqEntry **inner_entry_addr, int
 void     sq_type_steal_entry_addr(SqType *type, SqEntry **inner_entry_addr, int count);
 
 // find SqEntry in SqType.entry.
-// If 'compareFunc' is NULL and SqType.entry is sorted, it will use binary search to find entry by name.
+// If 'compareFunc' is NULL and SqType.entry is sorted, it will use hash table (or binary search) to find entry by name.
 void   **sq_type_find_entry(const SqType *type, const void *key, SqCompareFunc compareFunc);
 
 //void **sq_type_find_entry_addr(const SqType *type, const void *key, SqCompareFunc compareFunc);
 #define  sq_type_find_entry_addr    sq_type_find_entry
 
-// sort SqType.entry by name if SqType is dynamic.
+// sort SqType.entry by name and build hash table of entry names if SqType is dynamic.
 void     sq_type_sort_entry(SqType *type);
 
+// free hash table of entry names.
+// Call it after changing SqType.entry or names of entries directly. sq_type_sort_entry() will rebuild it.
+void     sq_type_clear_hash(SqType *type);
+
 // calculate instance size for dynamic structured data type.
 // if you add 'inner_entry' to SqType, pass argument 'entry_removed' = false.
 // if you remove 'inner_entry' from SqType, pass argument 'entry_removed' = true.
@@ -220,7 +239,8 @@ struct Type;
 	SqEntry         **entry;      \
 	int               n_entry;    \
 	unsigned int      bit_field;  \
-	SqDestroyFunc     on_destroy
+	SqDestroyFunc     on_destroy; \
+	SqTypeHash       *entry_hash
 
 struct SqType
 {
@@ -253,6 +273,10 @@ struct SqType
 	// This for derived or custom SqType.
 	// Instance of SqType will be passed to SqType.on_destroy
 	SqDestroyFunc  on_destroy;     // destroy notifier for SqType. It can be NULL.
+
+	// hash table of entry names. It is built by sq_type_sort_entry() if SqType is dynamic.
+	// sq_type_add_entry(), sq_type_erase_entry_addr() and sq_type_clear_hash() will free it.
+	SqTypeHash    *entry_hash;     // It must be NULL in constant SqType.
  */
 
 #ifdef __cplusplus
@@ -431,9 +455,9 @@ enum {
 		( (type)> SQ_TYPE_INTEGER_END || (type)< SQ_TYPE_INTEGER_BEG )
 
 #define SQ_TYPE_IS_ARITHMETIC(type)     \
-		( (type)<=SQ_TYPE_BUILTIN_END && (type)>=SQ_TYPE_ARITHMETIC_BEG )
+		( (type)<=SQ_TYPE_ARITHMETIC_END && (type)>=SQ_TYPE_ARITHMETIC_BEG )
 #define SQ_TYPE_NOT_ARITHMETIC(type)    \
-		( (type)> SQ_TYPE_BUILTIN_END || (type)< SQ_TYPE_ARITHMETIC_BEG )
+		( (type)> SQ_TYPE_ARITHMETIC_END || (type)< SQ_TYPE_ARITHMETIC_BEG )
 
 #define SQ_TYPE_IS_BUILTIN(type)     \
 		( (type)<=SQ_TYPE_BUILTIN_END && (type)>=SQ_TYPE_BUILTIN_BEG )
@@ -15,12 +15,15 @@
 #ifdef _MSC_VER
 #define _CRT_SECURE_NO_WARNINGS
 #endif
-#include <stdio.h>    // sscanf()
+#include <stdio.h>    // snprintf()
 #include <stddef.h>
 #include <stdlib.h>   // malloc()
+#include <stdint.h>   // uintptr_t
 #include <string.h>
 
+#include <SqConfig.h> // SQ_CONFIG_STRING_SIMD
 #include <SqUtil.h>
+#include <SqThread.h> // SQ_THREAD_LOCAL
 
 #ifdef _MSC_VER
 #define snprintf     _snprintf
@@ -45,168 +48,696 @@
 	HH:MM:SS.SSS
 	now                           // 
 	DDDDDDDDDD                    // Julian day number expressed as a floating point value.
+
+	ISO-8601 time zone suffix "Z", "+HH:MM", "+HHMM", or "+HH" can follow the time.
+	"now" and Julian day number are not supported.
+ */
+
+/*	days_from_civil() and civil_from_days() convert between proleptic Gregorian
+	calendar date and days since 1970-01-01. They don't use any global state.
+ */
+static int64_t sq_days_from_civil(int64_t year, int month, int day)
+{
+	int64_t   era;
+	unsigned  yoe, doy, doe;
+
+	year -= (month <= 2);
+	era = (year >= 0 ? year : year - 399) / 400;
+	yoe = (unsigned)(year - era * 400);
+	doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + (int64_t)doe - 719468;
+}
+
+static void sq_civil_from_days(int64_t days, int64_t *year, int *month, int *day)
+{
+	int64_t   era;
+	unsigned  yoe, doy, doe, mp;
+
+	days += 719468;
+	era = (days >= 0 ? days : days - 146096) / 146097;
+	doe = (unsigned)(days - era * 146097);
+	yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	mp  = (5 * doy + 2) / 153;
+	*day   = doy - (153 * mp + 2) / 5 + 1;
+	*month = (mp < 10) ? mp + 3 : mp - 9;
+	*year  = (int64_t)yoe + era * 400 + (*month <= 2);
+}
+
+/*	UTC offset of local time is cached in thread-local table.
+	Offset can only change at boundary of SQ_TIME_CACHE_INTERVAL seconds.
+	Program must not change time zone (TZ) after it converted time.
  */
+#define SQ_TIME_CACHE_SIZE        128
+#define SQ_TIME_CACHE_INTERVAL    900
+
+typedef struct SqTimeCache    SqTimeCache;
 
-static int sq_tm_hms(struct tm *timeinfo, const char *timestr)
+struct SqTimeCache
 {
-	int  hour, minute, second = 0;
-	int  result;
+	int64_t  key;        // (utc / SQ_TIME_CACHE_INTERVAL) + 1, 0 means empty
+	int      offset;     // local time - utc
+};
+
+static SQ_THREAD_LOCAL SqTimeCache  sq_time_cache[SQ_TIME_CACHE_SIZE];
 
-	result = sscanf(timestr, "%d:%d:%d", &hour, &minute, &second);
-	if (result < 2)
+static int  sq_time_local_offset(int64_t utc)
+{
+	SqTimeCache *cache;
+	struct tm    timeinfo;
+	time_t       timeraw;
+	int64_t      key;
+
+	key = utc / SQ_TIME_CACHE_INTERVAL - (utc % SQ_TIME_CACHE_INTERVAL < 0);
+	cache = sq_time_cache + (uint64_t)key % SQ_TIME_CACHE_SIZE;
+	if (cache->key == key + 1)
+		return cache->offset;
+
+	timeraw = (time_t)utc;
+#if defined(_WIN32) || defined(_WIN64)
+	if (localtime_s(&timeinfo, &timeraw) != 0)
+		return 0;
+#else
+	if (localtime_r(&timeraw, &timeinfo) == NULL)
 		return 0;
-	timeinfo->tm_hour = hour;
-	timeinfo->tm_min  = minute;
-	timeinfo->tm_sec  = second;
-	return result;
+#endif
+	cache->key = key + 1;
+	cache->offset = (int)(sq_days_from_civil(timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday) * 86400 +
+	                      timeinfo.tm_hour * 3600 + timeinfo.tm_min * 60 + timeinfo.tm_sec - utc);
+	return cache->offset;
+}
+
+// convert local time (seconds since 1970-01-01 in local calendar) to UTC
+static int64_t sq_time_local_to_utc(int64_t local)
+{
+	int64_t  utc;
+
+	utc = local - sq_time_local_offset(local);
+	// offset may be different near daylight saving time transition
+	return local - sq_time_local_offset(utc);
 }
 
-static int sq_tm_ymd(struct tm *timeinfo, const char *timestr)
+// parse 'count' digits. return -1 if error
+static int  sq_time_parse_digits(const char **str, int count)
 {
-	int  year, month, day;
+	const char *cur = *str;
+	int   value = 0;
 
-	if (sscanf(timestr, "%d-%d-%d", &year, &month, &day) != 3) {
-		if (sscanf(timestr, "%d/%d/%d", &year, &month, &day) != 3)
-			return 0;
+	for (;  count > 0;  count--, cur++) {
+		if (*cur < '0' || *cur > '9')
+			return -1;
+		value = value * 10 + (*cur - '0');
 	}
-	timeinfo->tm_year = year  - 1900;
-	timeinfo->tm_mon  = month - 1;
-	timeinfo->tm_mday = day;
-	return 3;
+	*str = cur;
+	return value;
 }
 
-// return UTC time
-// return -1 if error
-time_t  sq_time_from_string(const char *timestr)
+// parse 1 or more digits. return -1 if error
+static int  sq_time_parse_number(const char **str)
 {
-	struct tm  timeinfo = {0};
-	char  *cur;
+	const char *cur = *str;
+	int   value = 0;
 
-	cur = strpbrk(timestr, " T:n.");
-	if (cur == NULL)
-		cur = strpbrk(timestr, "-/");    // YYYY-MM-DD  or  YYYY/MM/DD
-	if (cur == NULL)
-		return -1;
+	int   count = 0;
 
-	switch(cur[0]) {
-	case ' ':
-	case 'T':
-		if (sq_tm_hms(&timeinfo, cur +1) == 0)
-			return -1;
-	case '-':
-	case '/':
-		if (sq_tm_ymd(&timeinfo, timestr) == 0)
+	if (*cur < '0' || *cur > '9')
+		return -1;
+	for (;  *cur >= '0' && *cur <= '9';  cur++) {
+		// avoid overflow
+		if (++count > 9)
 			return -1;
-		break;
+		value = value * 10 + (*cur - '0');
+	}
+	*str = cur;
+	return value;
+}
 
-	case ':':    // HH:MM  or  HH:MM:SS
-		// 2000-01-01
-		timeinfo.tm_year = 2000 - 1900;
-		timeinfo.tm_mon  = 1    - 1;
-		timeinfo.tm_mday = 1;
-		if (sq_tm_hms(&timeinfo, timestr) == 0)
-			return -1;
-		break;
+// parse "HH:MM", "HH:MM:SS", or "HH:MM:SS.SSS". Fractional seconds are ignored.
+// return seconds since midnight or -1 if error
+static int  sq_time_parse_hms(const char **str)
+{
+	const char *cur = *str;
+	int   hour, minute, second = 0;
 
-	case 'n':    // now
+	if ((hour = sq_time_parse_number(&cur)) < 0 || *cur++ != ':')
+		return -1;
+	if ((minute = sq_time_parse_number(&cur)) < 0)
 		return -1;
+	if (*cur == ':') {
+		cur++;
+		if ((second = sq_time_parse_number(&cur)) < 0)
+			return -1;
+		if (*cur == '.' || *cur == ',') {
+			for (cur++;  *cur >= '0' && *cur <= '9';  cur++)
+				;
+		}
+	}
+	*str = cur;
+	return hour * 3600 + minute * 60 + second;
+}
 
-	case '.':    // Julian day number
+// parse "Z", "+HH", "+HHMM", or "+HH:MM".
+// return 1 and set 'offset' if time zone exists, return 0 if no time zone.
+static int  sq_time_parse_zone(const char *cur, int *offset)
+{
+	int   sign, hour, minute = 0;
+
+	switch (*cur) {
+	case 'Z':
+	case 'z':
+		*offset = 0;
+		return 1;
+	case '+':
+		sign = 1;
+		break;
+	case '-':
+		sign = -1;
+		break;
 	default:
+		return 0;
+	}
+	cur++;
+	if ((hour = sq_time_parse_digits(&cur, 2)) < 0)
+		return 0;
+	if (*cur == ':')
+		cur++;
+	if (*cur >= '0' && *cur <= '9')
+		minute = sq_time_parse_digits(&cur, 2);
+	if (minute < 0)
+		return 0;
+	*offset = sign * (hour * 3600 + minute * 60);
+	return 1;
+}
+
+// return UTC time
+// return -1 if error
+time_t  sq_time_from_string(const char *timestr)
+{
+	const char *cur = timestr;
+	int64_t     seconds;
+	int         year, month, day;
+	int         hms, offset;
+	char        separator;
+
+	year = sq_time_parse_number(&cur);
+	if (year < 0)
 		return -1;
+
+	if (*cur == ':') {
+		// HH:MM  or  HH:MM:SS  (2000-01-01)
+		cur = timestr;
+		year  = 2000;
+		month = 1;
+		day   = 1;
+	}
+	else {
+		// YYYY-MM-DD  or  YYYY/MM/DD
+		separator = *cur;
+		if (separator != '-' && separator != '/')
+			return -1;
+		cur++;
+		if ((month = sq_time_parse_number(&cur)) < 0 || *cur++ != separator)
+			return -1;
+		if ((day = sq_time_parse_number(&cur)) < 0)
+			return -1;
+		if (month < 1 || month > 12)
+			return -1;
+		if (*cur != ' ' && *cur != 'T') {
+			seconds = sq_days_from_civil(year, month, day) * 86400;
+			return (time_t)sq_time_local_to_utc(seconds);
+		}
+		cur++;
 	}
 
-	return mktime(&timeinfo);
+	if ((hms = sq_time_parse_hms(&cur)) < 0)
+		return -1;
+	seconds = sq_days_from_civil(year, month, day) * 86400 + hms;
+	if (sq_time_parse_zone(cur, &offset))
+		return (time_t)(seconds - offset);
+	return (time_t)sq_time_local_to_utc(seconds);
 }
-// return NULL if error
-char   *sq_time_to_string(time_t timeraw, int format_type)
+
+static char *sq_time_write_digits(char *dest, int value, int count)
 {
-	const char *format;
-	struct tm  *timeinfo;
-	char       *timestr;
+	for (dest += count;  count > 0;  count--, value /= 10)
+		*--dest = (char)('0' + value % 10);
+	return dest;
+}
 
-#if SQ_CONFIG_CONVERT_TIME_TO_GMT
-	timeinfo = gmtime((time_t*) &timeraw);
-#else
-	timeinfo = localtime((time_t*) &timeraw);
+int  sq_time_to_str(char *dest, time_t timeraw, int format_type)
+{
+	int64_t  seconds = (int64_t)timeraw;
+	int64_t  days, year;
+	int      month, day, hms;
+	char    *cur = dest;
+
+#if SQ_CONFIG_CONVERT_TIME_TO_GMT == 0
+	if (format_type != 'Z')
+		seconds += sq_time_local_offset(seconds);
 #endif
-	if (timeinfo == NULL)
-		return NULL;
+	days = seconds / 86400 - (seconds % 86400 < 0);
+	hms  = (int)(seconds - days * 86400);
+	sq_civil_from_days(days, &year, &month, &day);
+
+	// year
+	if (year >= 0 && year <= 9999)
+		cur = sq_time_write_digits(cur, (int)year, 4) + 4;
+	else
+		cur += sq_int64_to_str(cur, year);
 
 	switch (format_type) {
 	case 'c':
 		// output format : "2013_02_05_212515"
-		format = "%.4d_%.2d_%.2d_%.2d%.2d%.2d";
+		cur[0] = '_';
+		sq_time_write_digits(cur + 1, month, 2);
+		cur[3] = '_';
+		sq_time_write_digits(cur + 4, day, 2);
+		cur[6] = '_';
+		sq_time_write_digits(cur + 7,  hms / 3600, 2);
+		sq_time_write_digits(cur + 9,  hms / 60 % 60, 2);
+		sq_time_write_digits(cur + 11, hms % 60, 2);
+		cur += 13;
 		break;
 
 	case 0:
+	case 'T':
+	case 'Z':
 	default:
 		// output format : "2013-02-05 21:25:15"
-		format = "%.4d-%.2d-%.2d %.2d:%.2d:%.2d";
+		// 'T' and 'Z'   : "2013-02-05T21:25:15" and "2013-02-05T21:25:15Z"
+		cur[0] = '-';
+		sq_time_write_digits(cur + 1, month, 2);
+		cur[3] = '-';
+		sq_time_write_digits(cur + 4, day, 2);
+		cur[6] = (format_type == 'T' || format_type == 'Z') ? 'T' : ' ';
+		sq_time_write_digits(cur + 7,  hms / 3600, 2);
+		cur[9] = ':';
+		sq_time_write_digits(cur + 10, hms / 60 % 60, 2);
+		cur[12] = ':';
+		sq_time_write_digits(cur + 13, hms % 60, 2);
+		cur += 15;
+		if (format_type == 'Z')
+			*cur++ = 'Z';
 		break;
 	}
 
-	timestr = malloc(32);
-	snprintf(timestr, 32, format,
-	         timeinfo->tm_year + 1900,
-	         timeinfo->tm_mon  + 1,
-	         timeinfo->tm_mday,
-	         timeinfo->tm_hour,
-	         timeinfo->tm_min,
-	         timeinfo->tm_sec);
+	*cur = 0;
+	return (int)(cur - dest);
+}
+
+// return NULL if error
+char   *sq_time_to_string(time_t timeraw, int format_type)
+{
+	char   *timestr;
+
+	timestr = malloc(SQ_TIME_STRING_SIZE);
+	sq_time_to_str(timestr, timeraw, format_type);
 	return timestr;
 }
 
 // ----------------------------------------------------------------------------
+// convert number to string
+
+static const char sq_digit_pairs[200] = {
+	'0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+	'1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+	'2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+	'3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+	'4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+	'5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+	'6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+	'7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+	'8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+	'9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
+};
+
+int  sq_uint64_to_str(char *dest, uint64_t value)
+{
+	char  buf[24];
+	char *cur = buf + sizeof(buf);
+	int   length;
+
+	// convert 2 digits at a time from the end
+	while (value >= 100) {
+		const char *pair = sq_digit_pairs + (value % 100) * 2;
+		value /= 100;
+		*--cur = pair[1];
+		*--cur = pair[0];
+	}
+	if (value >= 10) {
+		const char *pair = sq_digit_pairs + value * 2;
+		*--cur = pair[1];
+		*--cur = pair[0];
+	}
+	else
+		*--cur = (char)('0' + value);
+
+	length = (int)(buf + sizeof(buf) - cur);
+	memcpy(dest, cur, length);
+	dest[length] = 0;
+	return length;
+}
 
-#if 0
+int  sq_int64_to_str(char *dest, int64_t value)
+{
+	if (value < 0) {
+		*dest = '-';
+		// avoid overflow when value is INT64_MIN
+		return sq_uint64_to_str(dest + 1, (uint64_t)0 - (uint64_t)value) + 1;
+	}
+	return sq_uint64_to_str(dest, (uint64_t)value);
+}
+
+int  sq_double_to_str(char *dest, double value)
+{
+	int   length;
+
+	// fast path: integral value that can be represented exactly
+	if (value > -1e15 && value < 1e15 && value == (double)(int64_t)value &&
+	    (value != 0 || 1 / value > 0))
+	{
+		return sq_int64_to_str(dest, (int64_t)value);
+	}
+
+	// 15 significant digits is enough for most values, 17 digits can always round-trip.
+	length = snprintf(dest, SQ_NUMBER_STRING_SIZE, "%.15g", value);
+	if (strtod(dest, NULL) != value) {
+		length = snprintf(dest, SQ_NUMBER_STRING_SIZE, "%.16g", value);
+		if (strtod(dest, NULL) != value)
+			length = snprintf(dest, SQ_NUMBER_STRING_SIZE, "%.17g", value);
+	}
+	return length;
+}
+
+// ----------------------------------------------------------------------------
+
+/* ----------------------------------------------------------------------------
+	find characters that need escape
+
+	SIMD functions load aligned 16 or 32 bytes. Aligned load never crosses page boundary,
+	so they can read bytes after null-terminated character safely (like strlen() in C library).
+	Bytes before 'str' in the first load are ignored by mask.
+ */
+
+typedef const char *(*SqStrFindFunc)(const char *str);
+
+#if SQ_CONFIG_STRING_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SQ_STR_HAVE_SSE2    1
+#include <emmintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SQ_STR_HAVE_AVX2    1
+#include <immintrin.h>
+#endif
+#endif
+
+#ifndef SQ_STR_HAVE_SSE2
+#define SQ_STR_HAVE_SSE2    0
+#endif
+#ifndef SQ_STR_HAVE_AVX2
+#define SQ_STR_HAVE_AVX2    0
+#endif
+
+#if SQ_STR_HAVE_SSE2 == 0
+
+static const char *sq_str_find_sql_escape_c(const char *str)
+{
+	while (*str != '\'' && *str != 0)
+		str++;
+	return str;
+}
+
+static const char *sq_str_find_json_escape_c(const char *str)
+{
+	unsigned char ch;
+
+	for (;;  str++) {
+		ch = *(const unsigned char*)str;
+		if (ch < 0x20 || ch == '"' || ch == '\\')
+			return str;
+	}
+}
+
+#endif  // SQ_STR_HAVE_SSE2 == 0
+
+#if SQ_STR_HAVE_SSE2
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+static inline int  sq_str_ctz(unsigned int mask)
+{
+	unsigned long  index;
+	_BitScanForward(&index, mask);
+	return (int)index;
+}
+#else
+#define sq_str_ctz(mask)    __builtin_ctz(mask)
+#endif
+
+// AddressSanitizer, ThreadSanitizer and MemorySanitizer report reading after null-terminated character
+#if defined(__clang__)
+#define SQ_STR_NO_SANITIZE  __attribute__((no_sanitize("address", "thread", "memory")))
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define SQ_STR_NO_SANITIZE  __attribute__((no_sanitize("address", "thread")))
+#elif defined(__GNUC__)
+#define SQ_STR_NO_SANITIZE  __attribute__((no_sanitize_address, no_sanitize_thread))
+#else
+#define SQ_STR_NO_SANITIZE
+#endif
+
+SQ_STR_NO_SANITIZE
+static const char *sq_str_find_sql_escape_sse2(const char *str)
+{
+	const __m128i  zero  = _mm_setzero_si128();
+	const __m128i  quote = _mm_set1_epi8('\'');
+	const char    *cur = (const char*)((uintptr_t)str & ~(uintptr_t)15);
+	__m128i        data;
+	unsigned int   mask;
+
+	data = _mm_load_si128((const __m128i*)cur);
+	mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(data, zero), _mm_cmpeq_epi8(data, quote)));
+	mask &= 0xFFFFu << (str - cur);
+	while (mask == 0) {
+		cur += 16;
+		data = _mm_load_si128((const __m128i*)cur);
+		mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(data, zero), _mm_cmpeq_epi8(data, quote)));
+	}
+	return cur + sq_str_ctz(mask);
+}
+
+SQ_STR_NO_SANITIZE
+static const char *sq_str_find_json_escape_sse2(const char *str)
+{
+	const __m128i  ctrl  = _mm_set1_epi8(0x1F);
+	const __m128i  quote = _mm_set1_epi8('"');
+	const __m128i  slash = _mm_set1_epi8('\\');
+	const char    *cur = (const char*)((uintptr_t)str & ~(uintptr_t)15);
+	__m128i        data;
+	unsigned int   mask;
+
+	// max(data, 0x1F) == 0x1F  if  data <= 0x1F (unsigned)
+#define SQ_STR_JSON_MASK_SSE2(data)                                   \
+		_mm_movemask_epi8(_mm_or_si128(                               \
+			_mm_cmpeq_epi8(_mm_max_epu8(data, ctrl), ctrl),           \
+			_mm_or_si128(_mm_cmpeq_epi8(data, quote), _mm_cmpeq_epi8(data, slash))))
+
+	data = _mm_load_si128((const __m128i*)cur);
+	mask = SQ_STR_JSON_MASK_SSE2(data);
+	mask &= 0xFFFFu << (str - cur);
+	while (mask == 0) {
+		cur += 16;
+		data = _mm_load_si128((const __m128i*)cur);
+		mask = SQ_STR_JSON_MASK_SSE2(data);
+	}
+	return cur + sq_str_ctz(mask);
+}
+
+#endif  // SQ_STR_HAVE_SSE2
+
+#if SQ_STR_HAVE_AVX2
+
+SQ_STR_NO_SANITIZE __attribute__((target("avx2")))
+static const char *sq_str_find_sql_escape_avx2(const char *str)
+{
+	const __m256i  zero  = _mm256_setzero_si256();
+	const __m256i  quote = _mm256_set1_epi8('\'');
+	const char    *cur = (const char*)((uintptr_t)str & ~(uintptr_t)31);
+	__m256i        data;
+	unsigned int   mask;
+
+	data = _mm256_load_si256((const __m256i*)cur);
+	mask = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(data, zero),
+	                                                          _mm256_cmpeq_epi8(data, quote)));
+	mask &= 0xFFFFFFFFu << (str - cur);
+	while (mask == 0) {
+		cur += 32;
+		data = _mm256_load_si256((const __m256i*)cur);
+		mask = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(data, zero),
+		                                                          _mm256_cmpeq_epi8(data, quote)));
+	}
+	return cur + sq_str_ctz(mask);
+}
+
+SQ_STR_NO_SANITIZE __attribute__((target("avx2")))
+static const char *sq_str_find_json_escape_avx2(const char *str)
+{
+	const __m256i  ctrl  = _mm256_set1_epi8(0x1F);
+	const __m256i  quote = _mm256_set1_epi8('"');
+	const __m256i  slash = _mm256_set1_epi8('\\');
+	const char    *cur = (const char*)((uintptr_t)str & ~(uintptr_t)31);
+	__m256i        data;
+	unsigned int   mask;
+
+#define SQ_STR_JSON_MASK_AVX2(data)                                             \
+		(unsigned int)_mm256_movemask_epi8(_mm256_or_si256(                     \
+			_mm256_cmpeq_epi8(_mm256_max_epu8(data, ctrl), ctrl),               \
+			_mm256_or_si256(_mm256_cmpeq_epi8(data, quote), _mm256_cmpeq_epi8(data, slash))))
+
+	data = _mm256_load_si256((const __m256i*)cur);
+	mask = SQ_STR_JSON_MASK_AVX2(data);
+	mask &= 0xFFFFFFFFu << (str - cur);
+	while (mask == 0) {
+		cur += 32;
+		data = _mm256_load_si256((const __m256i*)cur);
+		mask = SQ_STR_JSON_MASK_AVX2(data);
+	}
+	return cur + sq_str_ctz(mask);
+}
+
+
+static const char *sq_str_find_sql_escape_init(const char *str);
+static const char *sq_str_find_json_escape_init(const char *str);
+
+// runtime dispatch. These pointers are decided when they are called first time.
+// They are loaded and stored atomically because multiple threads may call them first time.
+static SqStrFindFunc  sq_str_find_sql_escape_func  = sq_str_find_sql_escape_init;
+static SqStrFindFunc  sq_str_find_json_escape_func = sq_str_find_json_escape_init;
+
+#define sq_str_find_load(func)           __atomic_load_n(&(func), __ATOMIC_ACQUIRE)
+#define sq_str_find_store(func, value)   __atomic_store_n(&(func), value, __ATOMIC_RELEASE)
+
+static void  sq_str_find_select(void)
+{
+	if (__builtin_cpu_supports("avx2")) {
+		sq_str_find_store(sq_str_find_sql_escape_func,  sq_str_find_sql_escape_avx2);
+		sq_str_find_store(sq_str_find_json_escape_func, sq_str_find_json_escape_avx2);
+	}
+	else {
+		sq_str_find_store(sq_str_find_sql_escape_func,  sq_str_find_sql_escape_sse2);
+		sq_str_find_store(sq_str_find_json_escape_func, sq_str_find_json_escape_sse2);
+	}
+}
+
+static const char *sq_str_find_sql_escape_init(const char *str)
+{
+	sq_str_find_select();
+	return sq_str_find_load(sq_str_find_sql_escape_func)(str);
+}
+
+static const char *sq_str_find_json_escape_init(const char *str)
+{
+	sq_str_find_select();
+	return sq_str_find_load(sq_str_find_json_escape_func)(str);
+}
+
+#endif  // SQ_STR_HAVE_AVX2
+
+const char *sq_str_find_sql_escape(const char *str)
+{
+#if SQ_STR_HAVE_AVX2
+	return sq_str_find_load(sq_str_find_sql_escape_func)(str);
+#elif SQ_STR_HAVE_SSE2
+	return sq_str_find_sql_escape_sse2(str);
+#else
+	return sq_str_find_sql_escape_c(str);
+#endif
+}
+
+const char *sq_str_find_json_escape(const char *str)
+{
+#if SQ_STR_HAVE_AVX2
+	return sq_str_find_load(sq_str_find_json_escape_func)(str);
+#elif SQ_STR_HAVE_SSE2
+	return sq_str_find_json_escape_sse2(str);
+#else
+	return sq_str_find_json_escape_c(str);
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// convert string between C and SQL
 
 // C string to SQL string
 int  sq_cstr2sql(char *sql_string, const char *c_string)
 {
-	int    length = 0;
+	const char *end;
+	int         length = 1;    // '\''
 
-	if (*c_string) {
+	if (sql_string)
 		*sql_string++ = '\'';
 
-		for (;  *c_string;  c_string++) {
-			if (*c_string == '\'') {
-				if (sql_string)
-					*sql_string++ = '\'';
-				length++;
-			}
-			if (sql_string)
-				*sql_string++ = *c_string;
-			length++;
-		};
+	for (;;) {
+		// copy characters until apostrophe or null-terminated
+		end = sq_str_find_sql_escape(c_string);
+		if (sql_string) {
+			memcpy(sql_string, c_string, end - c_string);
+			sql_string += end - c_string;
+		}
+		length += (int)(end - c_string);
+		if (*end == 0)
+			break;
+		// double up on the single quotes
+		if (sql_string) {
+			*sql_string++ = '\'';
+			*sql_string++ = '\'';
+		}
+		length += 2;
+		c_string = end + 1;
+	}
 
+	if (sql_string) {
 		*sql_string++ = '\'';
 		*sql_string   = 0;
-		length += 2;
 	}
-
-	return length;
+	return length + 1;    // '\''
 }
 
 // SQL string to C string
 int  sq_sql2cstr(char *c_string, char *sql_string)
 {
-	int    length = 0;
-	int    prev_quote = 0;
+	const char *end;
+	int         length = 0;
+	int         quoted = 0;
+
+	// skip quote at beginning. Single quote that is not doubled is end of string.
+	if (*sql_string == '\'') {
+		quoted = 1;
+		sql_string++;
+	}
 
-	for (;  *sql_string;  sql_string++) {
-		if (*sql_string == '\'' && prev_quote == 0) {
-			prev_quote = 1;
-			continue;
+	for (;;) {
+		end = sq_str_find_sql_escape(sql_string);
+		// 'c_string' may be the same as 'sql_string'
+		if (c_string) {
+			memmove(c_string, sql_string, end - sql_string);
+			c_string += end - sql_string;
 		}
-		prev_quote = 0;
-		if (c_string)
-			*c_string++ = *sql_string;
-		length++;
+		length += (int)(end - sql_string);
+		if (*end == 0)
+			break;
+		sql_string = (char*)end + 1;
+		// keep one of doubled single quotes
+		if (*sql_string == '\'') {
+			if (c_string)
+				*c_string++ = '\'';
+			length++;
+			sql_string++;
+		}
+		else if (quoted)
+			break;
 	}
+
 	if (c_string)
-		*c_string++ = 0;
+		*c_string = 0;
 	return length;
 }
-
-#endif
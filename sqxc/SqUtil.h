@@ -16,6 +16,7 @@
 #define SQ_UTIL_H
 
 #include <time.h>        // time_t, struct tm
+#include <stdint.h>      // int64_t, uint64_t
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,13 +26,58 @@ extern "C" {
 	time_t convert from/to string
  */
 
+// SQ_TIME_STRING_SIZE is enough to store string of any time_t
+#define SQ_TIME_STRING_SIZE      40
+
+/* These functions are thread-safe. UTC offset of local time is cached in thread-local table.
+
+   format_type   output format
+   0             "2013-02-05 21:25:15"     local time
+   'T'           "2013-02-05T21:25:15"     local time
+   'Z'           "2013-02-05T21:25:15Z"    UTC
+   'c'           "2013_02_05_212515"       local time
+ */
+
 // return -1 if error
 time_t  sq_time_from_string(const char *timestr);
 
-// return NULL if error
+// return NULL if error. Caller must free returned string.
 char   *sq_time_to_string(time_t time, int format_type);
 
-#if 0
+// write time string to 'dest' without allocating memory.
+// 'dest' must have at least SQ_TIME_STRING_SIZE bytes. return length of string.
+int     sq_time_to_str(char *dest, time_t time, int format_type);
+
+/* ----------------------------------------------------------------------------
+	convert number to string
+
+	These functions don't allocate memory. Integer functions don't call printf().
+	'dest' must have at least SQ_NUMBER_STRING_SIZE bytes. Output is null-terminated.
+	return length of string (not include null-terminated)
+ */
+
+#define SQ_NUMBER_STRING_SIZE    32
+
+int  sq_int64_to_str(char *dest, int64_t value);
+int  sq_uint64_to_str(char *dest, uint64_t value);
+
+// output the shortest string that can be converted back to the same double
+int  sq_double_to_str(char *dest, double value);
+
+/* ----------------------------------------------------------------------------
+	find characters that need escape
+
+	These functions scan 16 or 32 bytes at a time if CPU supports SSE2 or AVX2.
+	AVX2 is detected at runtime. Other CPU use scalar code.
+	They return pointer to the first matched character or null-terminated character of 'str'.
+ */
+
+// find apostrophe (single quote)
+const char *sq_str_find_sql_escape(const char *str);
+
+// find quotation mark, reverse solidus, and control characters (< 0x20)
+const char *sq_str_find_json_escape(const char *str);
+
 /* ----------------------------------------------------------------------------
 	convert string between C and SQL
 
@@ -46,15 +92,13 @@ char   *sq_time_to_string(time_t time, int format_type);
 // return length of SQL string
 int  sq_cstr2sql(char *dest, const char *c_string);
 
-// SQL string to C string
+// SQL string to C string. If 'sql_string' begins with single quote, it ends at the closing quote.
 // parameter: 'sql_string' input
-// parameter: 'dest' output
+// parameter: 'dest' output. It can be the same as 'sql_string'.
 // pass NULL to 'dest' to calculate length
 // return length of C string
 int  sq_sql2cstr(char *dest, char *sql_string);
 
-#endif
-
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -49,6 +49,8 @@ static int  sq_entry_update(SqEntry *entry, SqEntry *entry_src, SqDestroyFunc de
 		entry->type = sq_type_copy_static(NULL, entry->type, destroy_func);
 	if ((entry->type->bit_field & SQB_TYPE_SORTED) == 0)
 		sq_type_sort_entry((SqType*)entry->type);
+	// entries will be changed in place
+	sq_type_clear_hash((SqType*)entry->type);
 	reentries = sq_type_get_ptr_array(entry->type);
 	reentries_src = sq_type_get_ptr_array(entry_src->type);
 
@@ -196,6 +198,7 @@ void sq_schema_erase_fake_type(SqSchema *schema)
 		}
 		if (n_nulls > 0) {
 			n_nulls = 0;
+			sq_type_clear_hash(table_type);
 			sq_reentries_remove_null(sq_type_get_ptr_array(table_type), 0);
 		}
 	}
@@ -19,6 +19,7 @@
 #ifndef SQDB_H
 #define SQDB_H
 
+#include <SqError.h>
 #include <SqBuffer.h>
 #include <SqSchema.h>
 #include <Sqxc.h>
@@ -29,6 +30,8 @@
 typedef struct Sqdb             Sqdb;
 typedef struct SqdbInfo         SqdbInfo;
 typedef struct SqdbConfig       SqdbConfig;
+typedef struct SqdbParam        SqdbParam;
+typedef struct SqdbToken        SqdbToken;
 
 typedef struct Sqxc             Sqxc;        // define in Sqxc.h
 
@@ -61,9 +64,40 @@ extern "C" {
 		(db)->info->migrate(db, schema_cur, schema_next)
 
 // int  sqdb_exec(Sqdb *db, const char *sql, Sqxc *xc, void *reserve);
+// 'reserve' can be pointer to SqdbToken if product supports it, otherwise it must be NULL.
 #define sqdb_exec(db, sql, xc, reserve)    \
 		(db)->info->exec(db, sql, xc, reserve)
 
+// int  sqdb_exec_params(Sqdb *db, const char *sql, Sqxc *xc, const SqdbParam *params, int n_params);
+#define sqdb_exec_params(db, sql, xc, params, n_params)    \
+		(db)->info->exec_params(db, sql, xc, params, n_params)
+
+// bool sqdb_has_params(Sqdb *db);
+#define sqdb_has_params(db)             ((db)->info->exec_params != NULL)
+
+// void *sqdb_cursor_open(Sqdb *db, const char *sql, const SqdbParam *params, int n_params);
+#define sqdb_cursor_open(db, sql, params, n_params)    \
+		(db)->info->cursor_open(db, sql, params, n_params)
+
+// int  sqdb_cursor_step(Sqdb *db, void *cursor, Sqxc *xc);
+#define sqdb_cursor_step(db, cursor, xc)    \
+		(db)->info->cursor_step(db, cursor, xc)
+
+// void sqdb_cursor_close(Sqdb *db, void *cursor);
+#define sqdb_cursor_close(db, cursor)    \
+		(db)->info->cursor_close(db, cursor)
+
+// bool sqdb_has_cursor(Sqdb *db);
+#define sqdb_has_cursor(db)             ((db)->info->cursor_open != NULL)
+
+// int  sqdb_set_timeout(Sqdb *db, int milliseconds);
+#define sqdb_set_timeout(db, milliseconds)    \
+		(((db)->info->set_timeout) ? (db)->info->set_timeout(db, milliseconds) : SQCODE_NOT_SUPPORT)
+
+// int  sqdb_interrupt(Sqdb *db, SqdbToken *token);
+#define sqdb_interrupt(db, token)    \
+		(((db)->info->interrupt) ? (db)->info->interrupt(db, token) : SQCODE_NOT_SUPPORT)
+
 /* --- C Functions --- */
 
 // if 'config' is NULL, program must set configure later
@@ -128,7 +162,11 @@ struct DbMethod
 	int  close(void);
 	int  exec(const char *sql, Sqxc *xc, void *reserve = NULL);
 	int  exec(const char *sql, Sq::XcMethod *xc, void *reserve = NULL);
+	int  exec(const char *sql, Sqxc *xc, const SqdbParam *params, int n_params);
 	int  migrate(SqSchema *schema_cur, SqSchema *schema_next);
+
+	int  setTimeout(int milliseconds);
+	int  interrupt(SqdbToken *token);
 };
 
 };  // namespace Sq
@@ -157,6 +195,16 @@ struct SqdbInfo
 		char         identifier[2];      // SQLite is "", MySQL is ``, SQL Server is []
 	} quote;
 
+	// placeholder of parameter in SQL statement. SQLite and MySQL are '?', PostgreSQL is '$' ($1, $2...)
+	// 0 is the same as '?'
+	char           placeholder;
+
+	// limits of SQL statement. 0 is unlimited.
+	struct {
+		int          n_params;           // maximum number of parameters in a SQL statement
+		int          sql_length;         // maximum length of a SQL statement
+	} limit;
+
 	// initialize derived structure of Sqdb
 	void (*init)(Sqdb *db, const SqdbConfig *config);
 	// finalize derived structure of Sqdb
@@ -170,6 +218,23 @@ struct SqdbInfo
 	int  (*exec)(Sqdb *db, const char *sql, Sqxc *xc, void *reserve);
 	// migrate schema. It apply changes of 'schema_next' to 'schema_current'
 	int  (*migrate)(Sqdb *db, SqSchema *schema_current, SqSchema *schema_next);
+	// executes the SQL statement that has parameter placeholders. It can be NULL if product doesn't support it.
+	int  (*exec_params)(Sqdb *db, const char *sql, Sqxc *xc, const SqdbParam *params, int n_params);
+
+	// cursor steps result set of SELECT statement row by row. They can be NULL if product doesn't support it.
+	// open cursor. return NULL if error occurred. 'params' can be NULL.
+	void *(*cursor_open)(Sqdb *db, const char *sql, const SqdbParam *params, int n_params);
+	// send next row to SqxcValue 'xc'. return SQCODE_OK, SQCODE_NO_DATA if no more row, or error code.
+	int   (*cursor_step)(Sqdb *db, void *cursor, Sqxc *xc);
+	// close cursor that is opened by cursor_open()
+	void  (*cursor_close)(Sqdb *db, void *cursor);
+
+	// They can be NULL if product doesn't support it.
+	// set default execution timeout of each call in milliseconds. 0 = no timeout.
+	// Call that runs longer is interrupted and returns SQCODE_TIMEOUT.
+	int   (*set_timeout)(Sqdb *db, int milliseconds);
+	// interrupt call that uses 'token'. It can be called from other threads. The call returns SQCODE_CANCELED.
+	int   (*interrupt)(Sqdb *db, SqdbToken *token);
 };
 
 /*	Sqdb - It is a base structure for database product (SQLite, MySQL...etc).
@@ -220,6 +285,26 @@ struct SqdbConfig
  */
 };
 
+/*	SqdbParam - value of parameter placeholder ('?' or '$n') in SQL statement.
+ */
+
+struct SqdbParam
+{
+	int             type;      // SqxcType. e.g. SQXC_TYPE_INT, SQXC_TYPE_STR
+	SqValue         value;
+};
+
+/*	SqdbToken - token of a call. It is passed to sqdb_exec() as 'reserve' argument.
+	            sqdb_interrupt() uses it to interrupt the call in other thread.
+	            Initialize it to 0 before each call.
+ */
+
+struct SqdbToken
+{
+	int             timeout;   // execution timeout of the call in milliseconds. 0 = use default timeout of Sqdb.
+	int             canceled;  // set by sqdb_interrupt(). The call returns SQCODE_CANCELED if it is not 0.
+};
+
 // ----------------------------------------------------------------------------
 // C++ definitions: define C++ data, function, method, and others.
 
@@ -248,9 +333,18 @@ inline int  DbMethod::exec(const char *sql, Sqxc *xc, void *reserve) {
 inline int  DbMethod::exec(const char *sql, Sq::XcMethod *xc, void *reserve) {
 	return sqdb_exec((Sqdb*)this, sql, (Sqxc*)xc, reserve);
 }
+inline int  DbMethod::exec(const char *sql, Sqxc *xc, const SqdbParam *params, int n_params) {
+	return sqdb_exec_params((Sqdb*)this, sql, xc, params, n_params);
+}
 inline int  DbMethod::migrate(SqSchema *schema_cur, SqSchema *schema_next) {
 	return sqdb_migrate((Sqdb*)this, schema_cur, schema_next);
 }
+inline int  DbMethod::setTimeout(int milliseconds) {
+	return sqdb_set_timeout((Sqdb*)this, milliseconds);
+}
+inline int  DbMethod::interrupt(SqdbToken *token) {
+	return sqdb_interrupt((Sqdb*)this, token);
+}
 
 /* All derived struct/class must be C++11 standard-layout. */
 
@@ -38,6 +38,9 @@ static int  sqdb_mysql_open(SqdbMysql *sqdb, const char *database_name);
 static int  sqdb_mysql_close(SqdbMysql *sqdb);
 static int  sqdb_mysql_exec(SqdbMysql *sqdb, const char *sql, Sqxc *xc, void *reserve);
 static int  sqdb_mysql_migrate(SqdbMysql *sqdb, SqSchema *schema, SqSchema *schema_next);
+static void *sqdb_mysql_cursor_open(SqdbMysql *sqdb, const char *sql, const SqdbParam *params, int n_params);
+static int  sqdb_mysql_cursor_step(SqdbMysql *sqdb, void *cursor, Sqxc *xc);
+static void sqdb_mysql_cursor_close(SqdbMysql *sqdb, void *cursor);
 
 static int  sqdb_mysql_schema_get_version(SqdbMysql *sqdb);
 static void sqdb_mysql_schema_set_version(SqdbMysql *sqdb, int version);
@@ -60,6 +63,11 @@ const SqdbInfo SqdbInfo_MySQL_ = {
 	.quote = {
 		.identifier = {'`', '`'}
 	},
+	.placeholder = '?',
+	.limit = {
+		.n_params   = 65535,
+		.sql_length = 4 * 1024 * 1024,    // default value of max_allowed_packet (MySQL 5.7)
+	},
 
 	.init    = (void*)sqdb_mysql_init,
 	.final   = (void*)sqdb_mysql_final,
@@ -67,6 +75,10 @@ const SqdbInfo SqdbInfo_MySQL_ = {
 	.close   = (void*)sqdb_mysql_close,
 	.exec    = (void*)sqdb_mysql_exec,
 	.migrate = (void*)sqdb_mysql_migrate,
+
+	.cursor_open  = (void*)sqdb_mysql_cursor_open,
+	.cursor_step  = (void*)sqdb_mysql_cursor_step,
+	.cursor_close = (void*)sqdb_mysql_cursor_close,
 };
 
 // ----------------------------------------------------------------------------
@@ -211,12 +223,61 @@ atExit:
 	return SQCODE_OK;
 }
 
+// send a row of result set to Sqxc elements.
+static void sqdb_mysql_send_row(MYSQL_ROW row, char **names, unsigned int n_fields, Sqxc **xc_addr)
+{
+	Sqxc *xc = *xc_addr;
+
+	// built-in types are not object
+	if (SQ_TYPE_NOT_BUILTIN(sqxc_value_element(xc))) {
+		xc->type = SQXC_TYPE_OBJECT;
+		xc->name = NULL;
+		xc->value.pointer = NULL;
+		xc = sqxc_send(xc);
+//		if (xc->code != SQCODE_OK)
+//			break;
+	}
+
+	for (unsigned int i = 0;  i < n_fields;  i++) {
+		xc->type = SQXC_TYPE_STR;
+		xc->name = names[i];
+		xc->value.str = row[i];
+		xc = sqxc_value_send_column(xc, i);
+#ifndef NDEBUG
+		switch (xc->code) {
+		case SQCODE_OK:
+			break;
+
+		case SQCODE_ENTRY_NOT_FOUND:
+			fprintf(stderr, "sqdb_mysql_exec(): column '%s' not found.\n", names[i]);
+			break;
+
+		default:
+			fprintf(stderr, "sqdb_mysql_exec(): error occurred during parsing column '%s'.\n", names[i]);
+			break;
+		}
+#endif  // NDEBUG
+	}
+
+	// built-in types are not object
+	if (SQ_TYPE_NOT_BUILTIN(sqxc_value_element(xc))) {
+		xc->type = SQXC_TYPE_OBJECT_END;
+		xc->name = NULL;
+		xc->value.pointer = NULL;
+		xc = sqxc_send(xc);
+//		if (xc->code != SQCODE_OK)
+//			break;
+	}
+	*xc_addr = xc;
+}
+
 static int  sqdb_mysql_exec(SqdbMysql *sqdb, const char *sql, Sqxc *xc, void *reserve)
 {
 	MYSQL_RES   *result;
 	MYSQL_ROW    row;
 	MYSQL_FIELD *field;
 	unsigned int n_fields;
+	Sqxc  *xc_value;
 	char **names;
 	int    rc = 0;
 	int    code = SQCODE_OK;
@@ -257,48 +318,12 @@ static int  sqdb_mysql_exec(SqdbMysql *sqdb, const char *sql, Sqxc *xc, void *re
 
 			// get result set
 			xc->code = SQCODE_NO_DATA;
-			while ((row = mysql_fetch_row(result))) {
-				// built-in types are not object
-				if (SQ_TYPE_NOT_BUILTIN(sqxc_value_element(xc))) {
-					xc->type = SQXC_TYPE_OBJECT;
-					xc->name = NULL;
-					xc->value.pointer = NULL;
-					xc = sqxc_send(xc);
-//					if (xc->code != SQCODE_OK)
-//						break;
-				}
-
-				xc->type = SQXC_TYPE_STR;
-				for (unsigned int i = 0;  i < n_fields;  i++) {
-					xc->name = names[i];
-					xc->value.str = row[i];
-					xc = sqxc_send(xc);
-#ifndef NDEBUG
-					switch (xc->code) {
-					case SQCODE_OK:
-						break;
-
-					case SQCODE_ENTRY_NOT_FOUND:
-						fprintf(stderr, "sqdb_mysql_exec(): column '%s' not found.\n", names[i]);
-						break;
-
-					default:
-						fprintf(stderr, "sqdb_mysql_exec(): error occurred during parsing column '%s'.\n", names[i]);
-						break;
-					}
-#endif  // NDEBUG
-				}
-
-				// built-in types are not object
-				if (SQ_TYPE_NOT_BUILTIN(sqxc_value_element(xc))) {
-					xc->type = SQXC_TYPE_OBJECT_END;
-					xc->name = NULL;
-					xc->value.pointer = NULL;
-					xc = sqxc_send(xc);
-//					if (xc->code != SQCODE_OK)
-//						break;
-				}
-			}
+			// 'names' are unchanged until 'result' is freed, SqxcValue can bind them to entries.
+			xc_value = xc;
+			sqxc_value_begin_binding(xc_value);
+			while ((row = mysql_fetch_row(result)))
+				sqdb_mysql_send_row(row, names, n_fields, &xc);
+			sqxc_value_end_binding(xc_value);
 			// if the result set is empty.
 			if (xc->code == SQCODE_NO_DATA)
 				code = SQCODE_NO_DATA;
@@ -329,10 +354,13 @@ static int  sqdb_mysql_exec(SqdbMysql *sqdb, const char *sql, Sqxc *xc, void *re
 //			break;
 		default:
 			rc = mysql_query(sqdb->self, sql);
-			// set the last inserted row id
-			((SqxcSql*)xc)->id = mysql_insert_id(sqdb->self);
 			// set number of rows changed
 			((SqxcSql*)xc)->changes = mysql_affected_rows(sqdb->self);
+			// set the last inserted row id.
+			// mysql_insert_id() returns id of the first row if multiple rows were inserted.
+			((SqxcSql*)xc)->id = mysql_insert_id(sqdb->self);
+			if (((SqxcSql*)xc)->id && ((SqxcSql*)xc)->changes > 1)
+				((SqxcSql*)xc)->id += ((SqxcSql*)xc)->changes - 1;
 			break;
 		}
 	}
@@ -346,6 +374,77 @@ static int  sqdb_mysql_exec(SqdbMysql *sqdb, const char *sql, Sqxc *xc, void *re
 	return code;
 }
 
+// ----------------------------------------------------------------------------
+// cursor
+
+typedef struct SqdbMysqlCursor    SqdbMysqlCursor;
+
+struct SqdbMysqlCursor
+{
+	MYSQL_RES    *result;
+	char        **names;
+	unsigned int  n_fields;
+};
+
+// MySQL doesn't support 'params' here because SqdbMysql doesn't implement exec_params().
+static void *sqdb_mysql_cursor_open(SqdbMysql *sqdb, const char *sql, const SqdbParam *params, int n_params)
+{
+	SqdbMysqlCursor *cursor;
+	MYSQL_RES   *result;
+	MYSQL_FIELD *field;
+
+#ifndef NDEBUG
+	fprintf(stderr, "SQL: %s\n", sql);
+#endif
+
+	if (params && n_params > 0)
+		return NULL;
+	// mysql_use_result() retrieves rows from server one by one.
+	if (mysql_query(sqdb->self, sql) || (result = mysql_use_result(sqdb->self)) == NULL) {
+#ifndef NDEBUG
+		fprintf(stderr, "MySQL: %s\n", mysql_error(sqdb->self));
+#endif
+		return NULL;
+	}
+
+	cursor = malloc(sizeof(SqdbMysqlCursor));
+	cursor->result = result;
+	cursor->n_fields = mysql_num_fields(result);
+	cursor->names = calloc(1, sizeof(char*) * cursor->n_fields);
+	for (unsigned int i = 0;  (field = mysql_fetch_field(result));  i++)
+		cursor->names[i] = field->name;
+	return cursor;
+}
+
+static int  sqdb_mysql_cursor_step(SqdbMysql *sqdb, void *cursor_ptr, Sqxc *xc)
+{
+	SqdbMysqlCursor *cursor = cursor_ptr;
+	MYSQL_ROW  row;
+
+	row = mysql_fetch_row(cursor->result);
+	if (row == NULL) {
+		if (mysql_errno(sqdb->self)) {
+#ifndef NDEBUG
+			fprintf(stderr, "MySQL: %s\n", mysql_error(sqdb->self));
+#endif
+			return SQCODE_EXEC_ERROR;
+		}
+		return SQCODE_NO_DATA;
+	}
+	sqdb_mysql_send_row(row, cursor->names, cursor->n_fields, &xc);
+	return SQCODE_OK;
+}
+
+static void sqdb_mysql_cursor_close(SqdbMysql *sqdb, void *cursor_ptr)
+{
+	SqdbMysqlCursor *cursor = cursor_ptr;
+
+	// mysql_free_result() fetches remaining rows
+	mysql_free_result(cursor->result);
+	free(cursor->names);
+	free(cursor);
+}
+
 // ----------------------------------------------------------------------------
 // other static functions
 
@@ -0,0 +1,334 @@
+/*
+ *   Copyright (C) 2023 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ * sqxclib is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>     // strdup()
+
+#include <SqError.h>
+#include <SqArray.h>
+#include <SqThread.h>
+#include <SqdbPool.h>
+
+#if SQ_CONFIG_HAVE_THREAD || defined(_WIN32) || defined(_WIN64)
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>    // GetTickCount64()
+#else
+#include <time.h>       // clock_gettime()
+#endif
+
+typedef struct SqdbPoolEntry    SqdbPoolEntry;
+
+struct SqdbPoolEntry
+{
+	Sqdb     *db;
+	int64_t   idle_since;     // milliseconds
+};
+
+struct SqdbPool
+{
+	const SqdbInfo   *info;
+	const SqdbConfig *config;
+	SqdbPoolConfig    setting;
+
+	// per-connection setup
+	SqdbPoolOpenFunc  on_open;
+	void             *on_open_data;
+
+	char       *name;         // database name. It is NULL if pool is not opened.
+	int         n_opened;     // number of opened connections (idle + acquired)
+
+	// idle connections. The most recently released connection is at tail.
+	SqArray     idle;         // element type is SqdbPoolEntry
+
+	SqMutex     mutex;
+	SqCond      cond;         // signaled when connection is released or slot is freed
+};
+
+static int64_t sqdb_pool_time(void);
+static Sqdb   *sqdb_pool_open_db(SqdbPool *pool, const char *name);
+static void    sqdb_pool_close_db(Sqdb *db);
+
+SqdbPool *sqdb_pool_new(const SqdbInfo *info, const SqdbConfig *config, const SqdbPoolConfig *pool_config)
+{
+	SqdbPool *pool;
+
+	pool = malloc(sizeof(SqdbPool));
+	pool->info   = info;
+	pool->config = config;
+	if (pool_config)
+		pool->setting = *pool_config;
+	else
+		memset(&pool->setting, 0, sizeof(SqdbPoolConfig));
+	if (pool->setting.min_size < 0)
+		pool->setting.min_size = 0;
+	if (pool->setting.max_size < pool->setting.min_size)
+		pool->setting.max_size = pool->setting.min_size;
+	if (pool->setting.max_size == 0)
+		pool->setting.max_size = 1;
+
+	pool->on_open = NULL;
+	pool->on_open_data = NULL;
+	pool->name = NULL;
+	pool->n_opened = 0;
+	sq_array_init(&pool->idle, sizeof(SqdbPoolEntry), pool->setting.max_size);
+	sq_mutex_init(&pool->mutex);
+	sq_cond_init(&pool->cond);
+	return pool;
+}
+
+void  sqdb_pool_free(SqdbPool *pool)
+{
+	sqdb_pool_close(pool);
+	sq_array_final(&pool->idle);
+	sq_mutex_clear(&pool->mutex);
+	sq_cond_clear(&pool->cond);
+	free(pool);
+}
+
+void  sqdb_pool_set_on_open(SqdbPool *pool, SqdbPoolOpenFunc func, void *data)
+{
+	sq_mutex_lock(&pool->mutex);
+	pool->on_open = func;
+	pool->on_open_data = data;
+	sq_mutex_unlock(&pool->mutex);
+}
+
+int   sqdb_pool_open(SqdbPool *pool, const char *database_name)
+{
+	SqdbPoolEntry *entry;
+	Sqdb          *db;
+	int            index;
+
+	if (pool->name)
+		sqdb_pool_close(pool);
+
+	for (index = 0;  index < pool->setting.min_size;  index++) {
+		db = sqdb_pool_open_db(pool, database_name);
+		if (db == NULL) {
+			sqdb_pool_close(pool);
+			return SQCODE_OPEN_FAILED;
+		}
+		sq_mutex_lock(&pool->mutex);
+		entry = sq_array_alloc(&pool->idle, 1);
+		entry->db = db;
+		entry->idle_since = sqdb_pool_time();
+		pool->n_opened++;
+		sq_mutex_unlock(&pool->mutex);
+	}
+
+	sq_mutex_lock(&pool->mutex);
+	pool->name = strdup(database_name);
+	sq_mutex_unlock(&pool->mutex);
+	return SQCODE_OK;
+}
+
+int   sqdb_pool_close(SqdbPool *pool)
+{
+	SqdbPoolEntry *entry;
+	Sqdb          *db;
+
+	sq_mutex_lock(&pool->mutex);
+	free(pool->name);
+	pool->name = NULL;
+	while (pool->idle.length > 0) {
+		entry = sq_array_addr(&pool->idle, SqdbPoolEntry, --pool->idle.length);
+		db = entry->db;
+		pool->n_opened--;
+		sq_mutex_unlock(&pool->mutex);
+		sqdb_pool_close_db(db);
+		sq_mutex_lock(&pool->mutex);
+	}
+	// wake up threads that are waiting in sqdb_pool_acquire()
+	sq_cond_broadcast(&pool->cond);
+	sq_mutex_unlock(&pool->mutex);
+	return SQCODE_OK;
+}
+
+Sqdb *sqdb_pool_acquire(SqdbPool *pool)
+{
+	Sqdb    *db = NULL;
+	char    *name;
+	int64_t  deadline = 0;
+	int64_t  remaining;
+
+	if (pool->setting.wait_timeout > 0)
+		deadline = sqdb_pool_time() + pool->setting.wait_timeout;
+
+	sq_mutex_lock(&pool->mutex);
+	while (pool->name) {
+		// reuse the most recently released connection
+		if (pool->idle.length > 0) {
+			db = sq_array_addr(&pool->idle, SqdbPoolEntry, --pool->idle.length)->db;
+			break;
+		}
+		// open new connection if pool is not full
+		if (pool->n_opened < pool->setting.max_size) {
+			pool->n_opened++;
+			name = strdup(pool->name);
+			sq_mutex_unlock(&pool->mutex);
+			db = sqdb_pool_open_db(pool, name);
+			free(name);
+			if (db)
+				return db;
+			sq_mutex_lock(&pool->mutex);
+			pool->n_opened--;
+			sq_cond_signal(&pool->cond);
+			break;
+		}
+		// wait for released connection
+		if (pool->setting.wait_timeout < 0)
+			break;
+		if (pool->setting.wait_timeout == 0)
+			sq_cond_wait(&pool->cond, &pool->mutex);
+		else {
+			remaining = deadline - sqdb_pool_time();
+			if (remaining <= 0)
+				break;
+			sq_cond_timedwait(&pool->cond, &pool->mutex, (int)remaining);
+		}
+	}
+	sq_mutex_unlock(&pool->mutex);
+	return db;
+}
+
+void  sqdb_pool_release(SqdbPool *pool, Sqdb *db)
+{
+	SqdbPoolEntry *entry;
+
+	sq_mutex_lock(&pool->mutex);
+	if (pool->name == NULL) {
+		// pool has been closed
+		pool->n_opened--;
+		sq_mutex_unlock(&pool->mutex);
+		sqdb_pool_close_db(db);
+		return;
+	}
+	entry = sq_array_alloc(&pool->idle, 1);
+	entry->db = db;
+	entry->idle_since = sqdb_pool_time();
+	sq_cond_signal(&pool->cond);
+	sq_mutex_unlock(&pool->mutex);
+
+	if (pool->setting.idle_timeout > 0)
+		sqdb_pool_evict(pool);
+}
+
+int   sqdb_pool_evict(SqdbPool *pool)
+{
+	SqdbPoolEntry *entry;
+	Sqdb          *db;
+	int64_t        expired;
+	int            count = 0;
+
+	if (pool->setting.idle_timeout <= 0)
+		return 0;
+	expired = sqdb_pool_time() - pool->setting.idle_timeout;
+
+	sq_mutex_lock(&pool->mutex);
+	// the least recently released connection is at head
+	while (pool->idle.length > 0 && pool->n_opened > pool->setting.min_size) {
+		entry = sq_array_addr(&pool->idle, SqdbPoolEntry, 0);
+		if (entry->idle_since > expired)
+			break;
+		db = entry->db;
+		SQ_ARRAY_STEAL(&pool->idle, SqdbPoolEntry, 0, 1);
+		pool->n_opened--;
+		sq_mutex_unlock(&pool->mutex);
+		sqdb_pool_close_db(db);
+		count++;
+		sq_mutex_lock(&pool->mutex);
+	}
+	sq_cond_signal(&pool->cond);
+	sq_mutex_unlock(&pool->mutex);
+	return count;
+}
+
+int   sqdb_pool_size(SqdbPool *pool)
+{
+	int  size;
+
+	sq_mutex_lock(&pool->mutex);
+	size = pool->n_opened;
+	sq_mutex_unlock(&pool->mutex);
+	return size;
+}
+
+int   sqdb_pool_n_idle(SqdbPool *pool)
+{
+	int  n_idle;
+
+	sq_mutex_lock(&pool->mutex);
+	n_idle = pool->idle.length;
+	sq_mutex_unlock(&pool->mutex);
+	return n_idle;
+}
+
+int   sqdb_pool_max_size(SqdbPool *pool)
+{
+	// 'setting' is not changed after pool is created
+	return pool->setting.max_size;
+}
+
+// ----------------------------------------------------------------------------
+// static function
+
+static int64_t sqdb_pool_time(void)
+{
+#if defined(_WIN32) || defined(_WIN64)
+	return (int64_t)GetTickCount64();
+#else
+	struct timespec  ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+static Sqdb   *sqdb_pool_open_db(SqdbPool *pool, const char *name)
+{
+	SqdbPoolOpenFunc  on_open;
+	void             *on_open_data;
+	Sqdb             *db;
+
+	db = sqdb_new(pool->info, pool->config);
+	if (sqdb_open(db, name) != SQCODE_OK) {
+		sqdb_free(db);
+		return NULL;
+	}
+
+	sq_mutex_lock(&pool->mutex);
+	on_open = pool->on_open;
+	on_open_data = pool->on_open_data;
+	sq_mutex_unlock(&pool->mutex);
+	// run per-connection setup
+	if (on_open && on_open(db, on_open_data) != SQCODE_OK) {
+		sqdb_pool_close_db(db);
+		return NULL;
+	}
+	return db;
+}
+
+static void    sqdb_pool_close_db(Sqdb *db)
+{
+	sqdb_close(db);
+	sqdb_free(db);
+}
+
+#endif  // SQ_CONFIG_HAVE_THREAD || _WIN32 || _WIN64
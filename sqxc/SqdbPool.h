@@ -0,0 +1,112 @@
+/*
+ *   Copyright (C) 2023 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ * sqxclib is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+
+/* ----------------------------------------------------------------------------
+	SqdbPool - pool of opened Sqdb instances (connections) that use the same SqdbInfo and SqdbConfig.
+	           It requires thread support.
+ */
+
+#ifndef SQDB_POOL_H
+#define SQDB_POOL_H
+
+#include <SqConfig.h>
+#if SQ_CONFIG_HAVE_THREAD || defined(_WIN32) || defined(_WIN64)
+
+#include <Sqdb.h>
+
+// ----------------------------------------------------------------------------
+// C/C++ common declarations: declare type, structure, macro, enumeration.
+
+typedef struct SqdbPool          SqdbPool;          // defined in SqdbPool.c
+typedef struct SqdbPoolConfig    SqdbPoolConfig;
+
+// SqdbPoolOpenFunc is called after connection is opened by pool. Return SQCODE_OK to use connection.
+typedef int  (*SqdbPoolOpenFunc)(Sqdb *db, void *data);
+
+// ----------------------------------------------------------------------------
+// C declarations: declare C data, function, and others.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 'config' must be alive until pool is freed. 'pool_config' can be NULL to use default setting.
+SqdbPool *sqdb_pool_new(const SqdbInfo *info, const SqdbConfig *config, const SqdbPoolConfig *pool_config);
+void      sqdb_pool_free(SqdbPool *pool);
+
+// set function that runs per-connection setup (e.g. PRAGMA) on every connection that is opened by pool.
+// Connections can be closed and reopened by pool at any time, so setup should not be done by hand.
+// If 'func' doesn't return SQCODE_OK, the connection is closed and treated as failure to open.
+// Call it before sqdb_pool_open().
+void      sqdb_pool_set_on_open(SqdbPool *pool, SqdbPoolOpenFunc func, void *data);
+
+// open 'min_size' connections to database. Other connections are opened by sqdb_pool_acquire() on demand.
+int   sqdb_pool_open(SqdbPool *pool, const char *database_name);
+// close idle connections. Acquired connections will be closed when they are released.
+int   sqdb_pool_close(SqdbPool *pool);
+
+// get an opened connection from pool. It waits if all connections are in use and pool is full.
+// return NULL if pool is closed, wait is timed out, or connection can't be opened.
+Sqdb *sqdb_pool_acquire(SqdbPool *pool);
+// return connection to pool. Connections that are idle longer than 'idle_timeout' will be closed.
+void  sqdb_pool_release(SqdbPool *pool, Sqdb *db);
+
+// close connections that are idle longer than 'idle_timeout'. return number of closed connections.
+int   sqdb_pool_evict(SqdbPool *pool);
+
+// number of opened connections (idle + acquired)
+int   sqdb_pool_size(SqdbPool *pool);
+// number of idle connections
+int   sqdb_pool_n_idle(SqdbPool *pool);
+// maximum number of connections
+int   sqdb_pool_max_size(SqdbPool *pool);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+// ----------------------------------------------------------------------------
+// C/C++ common definitions: define structure
+
+/*	SqdbPoolConfig - setting of SqdbPool
+
+	SqdbPoolConfig must have no base struct because I need use aggregate initialization with it.
+ */
+
+struct SqdbPoolConfig
+{
+	int     min_size;        // number of connections that are opened by sqdb_pool_open() and never evicted.
+	int     max_size;        // maximum number of connections. 0 is the same as 'min_size' (at least 1).
+	int     idle_timeout;    // milliseconds. Close idle connection if number of connections > 'min_size'. 0 = never.
+	int     wait_timeout;    // milliseconds. Maximum waiting time of sqdb_pool_acquire(). 0 = forever, -1 = don't wait.
+};
+
+// ----------------------------------------------------------------------------
+// C++ definitions: define C++ data, function, method, and others.
+
+#ifdef __cplusplus
+
+namespace Sq {
+
+/* define C++11 standard-layout structures */
+typedef struct SqdbPool          DbPool;
+typedef struct SqdbPoolConfig    DbPoolConfig;
+
+};  // namespace Sq
+
+#endif  // __cplusplus
+
+#endif  // SQ_CONFIG_HAVE_THREAD || _WIN32 || _WIN64
+
+#endif  // SQDB_POOL_H
@@ -18,6 +18,7 @@
 #include <stdio.h>      // snprintf
 
 #include <SqError.h>
+#include <SqUtil.h>
 #include <Sqdb-migration.h>
 #include <SqdbPostgre.h>
 #include <SqxcValue.h>
@@ -40,6 +41,10 @@ static int  sqdb_postgre_open(SqdbPostgre *sqdb, const char *database_name);
 static int  sqdb_postgre_close(SqdbPostgre *sqdb);
 static int  sqdb_postgre_exec(SqdbPostgre *sqdb, const char *sql, Sqxc *xc, void *reserve);
 static int  sqdb_postgre_migrate(SqdbPostgre *sqdb, SqSchema *schema, SqSchema *schema_next);
+static int  sqdb_postgre_exec_params(SqdbPostgre *sqdb, const char *sql, Sqxc *xc, const SqdbParam *params, int n_params);
+static void *sqdb_postgre_cursor_open(SqdbPostgre *sqdb, const char *sql, const SqdbParam *params, int n_params);
+static int  sqdb_postgre_cursor_step(SqdbPostgre *sqdb, void *cursor, Sqxc *xc);
+static void sqdb_postgre_cursor_close(SqdbPostgre *sqdb, void *cursor);
 
 static void sqdb_postgre_create_dependent(SqdbPostgre *db, SqBuffer *sql_buf, SqTable *table);
 static void sqdb_postgre_create_trigger(SqdbPostgre *db, SqBuffer *sql_buf, const char *table_name, const char *column_name);
@@ -66,6 +71,11 @@ const SqdbInfo SqdbInfo_Postgre_ = {
 	.quote = {
 		.identifier = {'"', '"'}
 	},
+	.placeholder = '$',
+	.limit = {
+		.n_params   = 65535,
+		.sql_length = 0,
+	},
 
 	.init    = (void*)sqdb_postgre_init,
 	.final   = (void*)sqdb_postgre_final,
@@ -73,6 +83,11 @@ const SqdbInfo SqdbInfo_Postgre_ = {
 	.close   = (void*)sqdb_postgre_close,
 	.exec    = (void*)sqdb_postgre_exec,
 	.migrate = (void*)sqdb_postgre_migrate,
+	.exec_params = (void*)sqdb_postgre_exec_params,
+
+	.cursor_open  = (void*)sqdb_postgre_cursor_open,
+	.cursor_step  = (void*)sqdb_postgre_cursor_step,
+	.cursor_close = (void*)sqdb_postgre_cursor_close,
 };
 
 // ----------------------------------------------------------------------------
@@ -128,9 +143,140 @@ static int  sqdb_postgre_close(SqdbPostgre *sqdb)
 	return SQCODE_OK;
 }
 
+// convert values of parameters to text format. Strings of numbers are stored in 'buf'.
+// return array of strings, caller must free it.
+static const char **sqdb_postgre_param_values(const SqdbParam *params, int n_params, SqBuffer *buf)
+{
+	const char **values;
+	intptr_t    *offsets;
+	char         num[SQ_NUMBER_STRING_SIZE];
+	int          len;
+
+	values  = malloc(sizeof(char*) * n_params);
+	offsets = malloc(sizeof(intptr_t) * n_params);
+	for (int index = 0;  index < n_params;  index++, params++) {
+		values[index] = NULL;
+		offsets[index] = -1;
+		switch (params->type) {
+		case SQXC_TYPE_BOOL:
+			len = sq_int64_to_str(num, (params->value.boolean) ? 1 : 0);
+			break;
+		case SQXC_TYPE_INT:
+			len = sq_int64_to_str(num, params->value.integer);
+			break;
+		case SQXC_TYPE_UINT:
+			len = sq_uint64_to_str(num, params->value.uinteger);
+			break;
+		case SQXC_TYPE_INT64:
+			len = sq_int64_to_str(num, params->value.int64);
+			break;
+		case SQXC_TYPE_UINT64:
+			len = sq_uint64_to_str(num, params->value.uint64);
+			break;
+		case SQXC_TYPE_DOUBLE:
+			len = sq_double_to_str(num, params->value.double_);
+			break;
+		case SQXC_TYPE_TIME:
+			offsets[index] = buf->writed;
+			sq_buffer_write_time(buf, params->value.rawtime, 0);
+			sq_buffer_write_c(buf, 0);
+			continue;
+		case SQXC_TYPE_STR:
+			values[index] = params->value.str;
+			continue;
+		default:
+			// SQXC_TYPE_NULL
+			continue;
+		}
+		offsets[index] = buf->writed;
+		sq_buffer_write_n(buf, num, len + 1);
+	}
+	// buffer may be reallocated, set address of value here.
+	for (int index = 0;  index < n_params;  index++) {
+		if (offsets[index] >= 0)
+			values[index] = buf->mem + offsets[index];
+	}
+
+	free(offsets);
+	return values;
+}
+
+// run PQexecParams() if 'params' is not NULL. Values of parameters are sent in text format.
+static PGresult *sqdb_postgre_exec_sql(SqdbPostgre *sqdb, const char *sql, const SqdbParam *params, int n_params)
+{
+	PGresult    *results;
+	SqBuffer     buf;
+	const char **values;
+
+	if (params == NULL || n_params == 0)
+		return PQexec(sqdb->conn, sql);
+
+	sq_buffer_init(&buf);
+	values = sqdb_postgre_param_values(params, n_params, &buf);
+	results = PQexecParams(sqdb->conn, sql, n_params, NULL, values, NULL, NULL, 0);
+	free(values);
+	sq_buffer_final(&buf);
+	return results;
+}
+
+// send row 'row' of 'results' to Sqxc elements.
+static void sqdb_postgre_send_row(PGresult *results, int row, Sqxc **xc_addr)
+{
+	Sqxc *xc = *xc_addr;
+	int   n_fields = PQnfields(results);
+
+	// built-in types are not object
+	if (SQ_TYPE_NOT_BUILTIN(sqxc_value_element(xc))) {
+		xc->type = SQXC_TYPE_OBJECT;
+		xc->name = NULL;
+		xc->value.pointer = NULL;
+		xc = sqxc_send(xc);
+//		if (xc->code != SQCODE_OK)
+//			break;
+	}
+
+	for (int j = 0;  j < n_fields;  j++) {
+		xc->type = SQXC_TYPE_STR;
+		xc->name = PQfname(results, j);
+		xc->value.str = PQgetvalue(results, row, j);
+		xc = sqxc_value_send_column(xc, j);
+#ifndef NDEBUG
+		switch (xc->code) {
+		case SQCODE_OK:
+			break;
+
+		case SQCODE_ENTRY_NOT_FOUND:
+			fprintf(stderr, "sqdb_postgre_exec(): column '%s' not found.\n", xc->name);
+			break;
+
+		default:
+			fprintf(stderr, "sqdb_postgre_exec(): error occurred during parsing column '%s'.\n", xc->name);
+			break;
+		}
+#endif  // NDEBUG
+	}
+
+	// built-in types are not object
+	if (SQ_TYPE_NOT_BUILTIN(sqxc_value_element(xc))) {
+		xc->type = SQXC_TYPE_OBJECT_END;
+		xc->name = NULL;
+		xc->value.pointer = NULL;
+		xc = sqxc_send(xc);
+//		if (xc->code != SQCODE_OK)
+//			break;
+	}
+	*xc_addr = xc;
+}
+
 static int  sqdb_postgre_exec(SqdbPostgre *sqdb, const char *sql, Sqxc *xc, void *reserve)
+{
+	return sqdb_postgre_exec_params(sqdb, sql, xc, NULL, 0);
+}
+
+static int  sqdb_postgre_exec_params(SqdbPostgre *sqdb, const char *sql, Sqxc *xc, const SqdbParam *params, int n_params)
 {
 	PGresult  *results;
+	Sqxc      *xc_value;
 	int        n_fields;
 	int        n_tuples;
 	int        code = SQCODE_OK;
@@ -143,7 +289,7 @@ static int  sqdb_postgre_exec(SqdbPostgre *sqdb, const char *sql, Sqxc *xc, void
 #endif
 
 	if (xc == NULL)
-		results = PQexec(sqdb->conn, sql);
+		results = sqdb_postgre_exec_sql(sqdb, sql, params, n_params);
 	else {
 		switch (sql[0]) {
 		case 'S':    // SELECT
@@ -154,7 +300,7 @@ static int  sqdb_postgre_exec(SqdbPostgre *sqdb, const char *sql, Sqxc *xc, void
 				return SQCODE_EXEC_ERROR;
 			}
 #endif
-			results = PQexec(sqdb->conn, sql);
+			results = sqdb_postgre_exec_sql(sqdb, sql, params, n_params);
 			if (PQresultStatus(results) != PGRES_TUPLES_OK)
 				break;
 
@@ -175,48 +321,12 @@ static int  sqdb_postgre_exec(SqdbPostgre *sqdb, const char *sql, Sqxc *xc, void
 				xc = sqxc_send(xc);
 			}
 
-			for (int i = 0;  i < n_tuples;  i++) {
-				// built-in types are not object
-				if (SQ_TYPE_NOT_BUILTIN(sqxc_value_element(xc))) {
-					xc->type = SQXC_TYPE_OBJECT;
-					xc->name = NULL;
-					xc->value.pointer = NULL;
-					xc = sqxc_send(xc);
-//					if (xc->code != SQCODE_OK)
-//						break;
-				}
-
-				for (int j = 0;  j < n_fields;  j++) {
-					xc->type = SQXC_TYPE_STR;
-					xc->name = PQfname(results, j);
-					xc->value.str = PQgetvalue(results, i, j);
-					xc = sqxc_send(xc);
-#ifndef NDEBUG
-					switch (xc->code) {
-					case SQCODE_OK:
-						break;
-
-					case SQCODE_ENTRY_NOT_FOUND:
-						fprintf(stderr, "sqdb_postgre_exec(): column '%s' not found.\n", xc->name);
-						break;
-
-					default:
-						fprintf(stderr, "sqdb_postgre_exec(): error occurred during parsing column '%s'.\n", xc->name);
-						break;
-					}
-#endif  // NDEBUG
-				}
-
-				// built-in types are not object
-				if (SQ_TYPE_NOT_BUILTIN(sqxc_value_element(xc))) {
-					xc->type = SQXC_TYPE_OBJECT_END;
-					xc->name = NULL;
-					xc->value.pointer = NULL;
-					xc = sqxc_send(xc);
-//					if (xc->code != SQCODE_OK)
-//						break;
-				}
-			}
+			// column names in 'results' are unchanged until it is cleared, SqxcValue can bind them to entries.
+			xc_value = xc;
+			sqxc_value_begin_binding(xc_value);
+			for (int i = 0;  i < n_tuples;  i++)
+				sqdb_postgre_send_row(results, i, &xc);
+			sqxc_value_end_binding(xc_value);
 			break;
 
 		case 'I':    // INSERT
@@ -241,11 +351,13 @@ static int  sqdb_postgre_exec(SqdbPostgre *sqdb, const char *sql, Sqxc *xc, void
 			// Don't break here
 //			break;
 		default:
-			results = PQexec(sqdb->conn, sql);
+			results = sqdb_postgre_exec_sql(sqdb, sql, params, n_params);
 			// set the last inserted row id
 			if (sql_new) {
-				if (PQntuples(results) > 0)
-					((SqxcSql*)xc)->id = strtol(PQgetvalue(results, 0, 0), NULL, 10);
+				// RETURNING id of multiple rows. The last row has the last inserted row id.
+				sql_len = PQntuples(results);
+				if (sql_len > 0)
+					((SqxcSql*)xc)->id = strtoll(PQgetvalue(results, sql_len - 1, 0), NULL, 10);
 				else
 					((SqxcSql*)xc)->id = 0;
 				free(sql_new);
@@ -268,6 +380,114 @@ static int  sqdb_postgre_exec(SqdbPostgre *sqdb, const char *sql, Sqxc *xc, void
 	return code;
 }
 
+// ----------------------------------------------------------------------------
+// cursor
+
+typedef struct SqdbPostgreCursor    SqdbPostgreCursor;
+
+struct SqdbPostgreCursor
+{
+	int   done;    // all results have been received
+};
+
+// discard remaining results of query
+static void sqdb_postgre_clear_results(SqdbPostgre *sqdb)
+{
+	PGresult *results;
+
+	while ((results = PQgetResult(sqdb->conn)) != NULL)
+		PQclear(results);
+}
+
+static void *sqdb_postgre_cursor_open(SqdbPostgre *sqdb, const char *sql, const SqdbParam *params, int n_params)
+{
+	SqdbPostgreCursor *cursor;
+	SqBuffer     buf;
+	const char **values;
+	int          rc;
+
+#ifndef NDEBUG
+	fprintf(stderr, "SQL: %s\n", sql);
+#endif
+
+	if (params == NULL || n_params == 0)
+		rc = PQsendQuery(sqdb->conn, sql);
+	else {
+		sq_buffer_init(&buf);
+		values = sqdb_postgre_param_values(params, n_params, &buf);
+		rc = PQsendQueryParams(sqdb->conn, sql, n_params, NULL, values, NULL, NULL, 0);
+		free(values);
+		sq_buffer_final(&buf);
+	}
+	// rows will be received one by one
+	if (rc == 0 || PQsetSingleRowMode(sqdb->conn) == 0) {
+#ifndef NDEBUG
+		fprintf(stderr, "PostgreSQL: %s\n", PQerrorMessage(sqdb->conn));
+#endif
+		sqdb_postgre_clear_results(sqdb);
+		return NULL;
+	}
+
+	cursor = malloc(sizeof(SqdbPostgreCursor));
+	cursor->done = 0;
+	return cursor;
+}
+
+static int  sqdb_postgre_cursor_step(SqdbPostgre *sqdb, void *cursor_ptr, Sqxc *xc)
+{
+	SqdbPostgreCursor *cursor = cursor_ptr;
+	PGresult *results;
+	int       code;
+
+	if (cursor->done)
+		return SQCODE_NO_DATA;
+
+	results = PQgetResult(sqdb->conn);
+	switch (PQresultStatus(results)) {
+	case PGRES_SINGLE_TUPLE:
+		sqdb_postgre_send_row(results, 0, &xc);
+		code = SQCODE_OK;
+		break;
+
+	case PGRES_TUPLES_OK:
+		// zero-row result indicates the end of result set
+		code = SQCODE_NO_DATA;
+		cursor->done = 1;
+		break;
+
+	default:
+#ifndef NDEBUG
+		fprintf(stderr, "PostgreSQL: %s\n", PQerrorMessage(sqdb->conn));
+#endif
+		code = SQCODE_EXEC_ERROR;
+		cursor->done = 1;
+		break;
+	}
+	PQclear(results);
+
+	if (cursor->done)
+		sqdb_postgre_clear_results(sqdb);
+	return code;
+}
+
+static void sqdb_postgre_cursor_close(SqdbPostgre *sqdb, void *cursor_ptr)
+{
+	SqdbPostgreCursor *cursor = cursor_ptr;
+	PGcancel *cancel;
+	char      errbuf[256];
+
+	if (cursor->done == 0) {
+		// cancel query that is still sending rows
+		cancel = PQgetCancel(sqdb->conn);
+		if (cancel) {
+			PQcancel(cancel, errbuf, sizeof(errbuf));
+			PQfreeCancel(cancel);
+		}
+		sqdb_postgre_clear_results(sqdb);
+	}
+	free(cursor);
+}
+
 static int  sqdb_postgre_migrate(SqdbPostgre *sqdb, SqSchema *schema, SqSchema *schema_next)
 {
 	SqBuffer    sql_buf;
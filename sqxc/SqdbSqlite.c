@@ -16,20 +16,46 @@
 #define _CRT_SECURE_NO_WARNINGS
 #endif
 #include <stdio.h>      // snprintf
+#include <ctype.h>      // isalnum()
 
+#include <SqConfig.h>
 #include <SqError.h>
+#include <SqUtil.h>
 #include <SqdbSqlite.h>
 #include <SqxcValue.h>
 #include <SqxcSql.h>
 #include <SqRelation-migration.h>
+#if SQ_CONFIG_HAVE_THREAD
+#include <SqThread.h>
+#endif
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>    // GetTickCount64()
+#else
+#include <time.h>       // clock_gettime()
+#endif
 
 #ifdef _MSC_VER
 #define snprintf     _snprintf
 #define strdup       _strdup
+#define strncasecmp  _strnicmp
+#else
+#include <strings.h>    // strncasecmp()
 #endif
 
 #define NEW_TABLE_PREFIX_NAME          "new__table__"
 #define SQLITE_VERSION_NUMBER_3_20     3020000           // 3.20.0
+// number of virtual machine instructions between two checks of deadline and token
+#define PROGRESS_HANDLER_N_OPS         1000
+
+// 'exec_timeout' and SqdbToken.canceled can be changed by other threads
+#if defined(_MSC_VER)
+#define sqdb_sqlite_atomic_load(ptr)           InterlockedCompareExchange((volatile long*)(ptr), 0, 0)
+#define sqdb_sqlite_atomic_store(ptr, value)   InterlockedExchange((volatile long*)(ptr), value)
+#else
+#define sqdb_sqlite_atomic_load(ptr)           __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define sqdb_sqlite_atomic_store(ptr, value)   __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#endif
 
 static void sqdb_sqlite_init(SqdbSqlite *sqdb, const SqdbConfigSqlite *config);
 static void sqdb_sqlite_final(SqdbSqlite *sqdb);
@@ -37,6 +63,12 @@ static int  sqdb_sqlite_open(SqdbSqlite *sqdb, const char *database_name);
 static int  sqdb_sqlite_close(SqdbSqlite *sqdb);
 static int  sqdb_sqlite_exec(SqdbSqlite *sqdb, const char *sql, Sqxc *xc, void *reserve);
 static int  sqdb_sqlite_migrate(SqdbSqlite *sqdb, SqSchema *schema, SqSchema *schema_next);
+static int  sqdb_sqlite_exec_params(SqdbSqlite *sqdb, const char *sql, Sqxc *xc, const SqdbParam *params, int n_params);
+static void *sqdb_sqlite_cursor_open(SqdbSqlite *sqdb, const char *sql, const SqdbParam *params, int n_params);
+static int  sqdb_sqlite_cursor_step(SqdbSqlite *sqdb, void *cursor, Sqxc *xc);
+static void sqdb_sqlite_cursor_close(SqdbSqlite *sqdb, void *cursor);
+static int  sqdb_sqlite_set_timeout(SqdbSqlite *sqdb, int milliseconds);
+static int  sqdb_sqlite_interrupt(SqdbSqlite *sqdb, SqdbToken *token);
 
 const SqdbInfo SqdbInfo_SQLite_ = {
 	.size    = sizeof(SqdbSqlite),
@@ -49,6 +81,11 @@ const SqdbInfo SqdbInfo_SQLite_ = {
 	.quote = {
 		.identifier = {'"', '"'}
 	},
+	.placeholder = '?',
+	.limit = {
+		.n_params   = 999,           // SQLITE_MAX_VARIABLE_NUMBER (32766 since SQLite 3.32.0)
+		.sql_length = 1000000000,    // SQLITE_MAX_SQL_LENGTH
+	},
 
 	.init    = (void*)sqdb_sqlite_init,
 	.final   = (void*)sqdb_sqlite_final,
@@ -56,6 +93,14 @@ const SqdbInfo SqdbInfo_SQLite_ = {
 	.close   = (void*)sqdb_sqlite_close,
 	.exec    = (void*)sqdb_sqlite_exec,
 	.migrate = (void*)sqdb_sqlite_migrate,
+	.exec_params = (void*)sqdb_sqlite_exec_params,
+
+	.cursor_open  = (void*)sqdb_sqlite_cursor_open,
+	.cursor_step  = (void*)sqdb_sqlite_cursor_step,
+	.cursor_close = (void*)sqdb_sqlite_cursor_close,
+
+	.set_timeout  = (void*)sqdb_sqlite_set_timeout,
+	.interrupt    = (void*)sqdb_sqlite_interrupt,
 };
 
 // ----------------------------------------------------------------------------
@@ -65,27 +110,92 @@ static void sqdb_sqlite_recreate_table(SqdbSqlite *db, SqBuffer *sql_buf, SqTabl
 static void sqdb_sqlite_create_dependent(SqdbSqlite *db, SqBuffer *sql_buf, SqTable *table);
 static void sqdb_sqlite_create_trigger(SqdbSqlite *db, SqBuffer *sql_buf, SqTable *table, SqColumn *column);
 static bool sqdb_sqlite_alter_table(SqdbSqlite *db, SqBuffer *sql_buf, SqTable *table);
-#ifndef NDEBUG
-static int  debug_callback(void *user_data, int argc, char **argv, char **columnName);
+static void sqdb_sqlite_clear_stmt_cache(SqdbSqlite *sqdb);
+static int  sqdb_sqlite_apply_pragma(SqdbSqlite *sqdb, sqlite3 *self, bool read_only);
+static int  sqdb_sqlite_open_readers(SqdbSqlite *sqdb, const char *path);
+static void sqdb_sqlite_close_readers(SqdbSqlite *sqdb);
+static int  sqdb_sqlite_begin_call(SqdbSqlite *sqdb, SqdbSqlite *conn, SqdbToken *token);
+static void sqdb_sqlite_end_call(SqdbSqlite *conn);
+static int  sqdb_sqlite_error_code(SqdbSqlite *conn, int rc);
+
+/* SqdbSqliteWal - read-only connections */
+struct SqdbSqliteWal
+{
+	SqdbSqlite   **readers;       // array of read-only SqdbSqlite
+	unsigned int   reader_next;   // next reader in round-robin order
+#if SQ_CONFIG_HAVE_THREAD
+	SqMutex       *reader_mutex;  // array of mutex for readers
+
+	// 'mutex' protects 'reader_next' and below members.
+	// Thread that opened transaction keeps writer until transaction is committed or rolled back.
+	SqMutex        mutex;
+	SqCond         writer_cond;   // signaled when writer is released
+	SqThreadData   writer_owner;  // thread that uses writer
+	int            writer_count;  // writer is locked recursively by 'writer_owner'
+	bool           writer_trans;  // 'writer_owner' is in transaction
 #endif
+};
 
 static void sqdb_sqlite_init(SqdbSqlite *sqdb, const SqdbConfigSqlite *config_src)
 {
 	if (config_src) {
 		sqdb->extension = config_src->extension ? strdup(config_src->extension) : NULL;
 		sqdb->folder    = config_src->folder    ? strdup(config_src->folder)    : NULL;
+		// PRAGMA
+		sqdb->journal_mode = config_src->journal_mode ? strdup(config_src->journal_mode) : NULL;
+		sqdb->synchronous  = config_src->synchronous  ? strdup(config_src->synchronous)  : NULL;
+		sqdb->mmap_size    = config_src->mmap_size;
+		sqdb->cache_size   = config_src->cache_size;
+		sqdb->busy_timeout = config_src->busy_timeout;
+		sqdb->n_readers    = (config_src->n_readers > 0) ? config_src->n_readers : 0;
+		sqdb->exec_timeout = (config_src->exec_timeout > 0) ? config_src->exec_timeout : 0;
 	}
 	else {
 		sqdb->extension = NULL;
 		sqdb->folder = NULL;
+		// PRAGMA
+		sqdb->journal_mode = NULL;
+		sqdb->synchronous  = NULL;
+		sqdb->mmap_size    = 0;
+		sqdb->cache_size   = 0;
+		sqdb->busy_timeout = 0;
+		sqdb->n_readers    = 0;
+		sqdb->exec_timeout = 0;
 	}
+	sqdb->exec_deadline  = 0;
+	sqdb->exec_token     = NULL;
+	sqdb->exec_timed_out = false;
+	sqdb->wal = NULL;
 	sqdb->version = 0;
+	sqdb->self = NULL;
+
+	// prepared statement cache
+	if (config_src == NULL || config_src->stmt_cache_size == 0)
+		sqdb->stmt_cache_size = SQ_CONFIG_SQLITE_STMT_CACHE_SIZE_DEFAULT;
+	else
+		sqdb->stmt_cache_size = (config_src->stmt_cache_size > 0) ? config_src->stmt_cache_size : 0;
+	sqdb->stmt_cache = NULL;
+	sqdb->stmt_cache_length = 0;
+	sqdb->stmt_cache_hits = 0;
+	sqdb->stmt_cache_misses = 0;
+	sqdb->stmt_cache_evictions = 0;
+	sq_buffer_init(&sqdb->stmt_key);
+	sqdb->stmt_params = NULL;
+	sqdb->stmt_params_size = 0;
 }
 
 static void sqdb_sqlite_final(SqdbSqlite *sqdb)
 {
+	sqdb_sqlite_close_readers(sqdb);
 	free(sqdb->extension);
 	free(sqdb->folder);
+	free(sqdb->journal_mode);
+	free(sqdb->synchronous);
+	// prepared statement cache
+	sqdb_sqlite_clear_stmt_cache(sqdb);
+	free(sqdb->stmt_cache);
+	sq_buffer_final(&sqdb->stmt_key);
+	free(sqdb->stmt_params);
 }
 
 static int int_callback(void *user_data, int argc, char **argv, char **columnName)
@@ -111,20 +221,130 @@ static int  sqdb_sqlite_open(SqdbSqlite *sqdb, const char *database_name)
 	snprintf(buf, len, "%s/%s.%s", folder, database_name, ext);
 
 	rc = sqlite3_open(buf, &sqdb->self);
+	if (rc == SQLITE_OK)
+		rc = sqdb_sqlite_apply_pragma(sqdb, sqdb->self, false);
+	// open read-only connections after 'journal_mode' is applied by writer.
+	if (rc == SQLITE_OK && sqdb->n_readers > 0)
+		rc = sqdb_sqlite_open_readers(sqdb, buf);
 	free(buf);
 
-	if (rc != SQLITE_OK)
+	if (rc != SQLITE_OK) {
+#ifndef NDEBUG
+		fprintf(stderr, "SQLite: %s\n", sqlite3_errmsg(sqdb->self));
+#endif
+		sqlite3_close(sqdb->self);
+		sqdb->self = NULL;
 		return SQCODE_OPEN_FAILED;
+	}
 	rc = sqlite3_exec(sqdb->self, "PRAGMA user_version;", int_callback, &sqdb->version, NULL);
 	return SQCODE_OK;
 }
 
 static int  sqdb_sqlite_close(SqdbSqlite *sqdb)
 {
+	sqdb_sqlite_close_readers(sqdb);
+	// cached statements must be finalized before closing connection
+	sqdb_sqlite_clear_stmt_cache(sqdb);
 	sqlite3_close(sqdb->self);
+	sqdb->self = NULL;
 	return SQCODE_OK;
 }
 
+// apply PRAGMA in configuration to connection 'self'
+static int  sqdb_sqlite_apply_pragma(SqdbSqlite *sqdb, sqlite3 *self, bool read_only)
+{
+	char  sql[128];
+	int   rc = SQLITE_OK;
+
+	if (sqdb->busy_timeout > 0)
+		sqlite3_busy_timeout(self, sqdb->busy_timeout);
+	// 'journal_mode' is persistent and 'synchronous' only affects writing. Writer applies them.
+	if (read_only == false) {
+		if (sqdb->journal_mode && rc == SQLITE_OK) {
+			snprintf(sql, sizeof(sql), "PRAGMA journal_mode=%s", sqdb->journal_mode);
+			rc = sqlite3_exec(self, sql, NULL, NULL, NULL);
+		}
+		if (sqdb->synchronous && rc == SQLITE_OK) {
+			snprintf(sql, sizeof(sql), "PRAGMA synchronous=%s", sqdb->synchronous);
+			rc = sqlite3_exec(self, sql, NULL, NULL, NULL);
+		}
+	}
+	if (sqdb->mmap_size > 0 && rc == SQLITE_OK) {
+		snprintf(sql, sizeof(sql), "PRAGMA mmap_size=%lld", (long long)sqdb->mmap_size);
+		rc = sqlite3_exec(self, sql, NULL, NULL, NULL);
+	}
+	if (sqdb->cache_size != 0 && rc == SQLITE_OK) {
+		snprintf(sql, sizeof(sql), "PRAGMA cache_size=%d", sqdb->cache_size);
+		rc = sqlite3_exec(self, sql, NULL, NULL, NULL);
+	}
+	return rc;
+}
+
+static int  sqdb_sqlite_open_readers(SqdbSqlite *sqdb, const char *path)
+{
+	SqdbSqliteWal *wal;
+	SqdbSqlite    *reader;
+	int  index;
+	int  rc = SQLITE_OK;
+
+	wal = malloc(sizeof(SqdbSqliteWal));
+	wal->readers = calloc(sqdb->n_readers, sizeof(SqdbSqlite*));
+	wal->reader_next = 0;
+#if SQ_CONFIG_HAVE_THREAD
+	sq_mutex_init(&wal->mutex);
+	sq_cond_init(&wal->writer_cond);
+	wal->writer_count = 0;
+	wal->writer_trans = false;
+	wal->reader_mutex = malloc(sizeof(SqMutex) * sqdb->n_readers);
+	for (index = 0;  index < sqdb->n_readers;  index++)
+		sq_mutex_init(&wal->reader_mutex[index]);
+#endif
+	sqdb->wal = wal;
+
+	for (index = 0;  index < sqdb->n_readers;  index++) {
+		// each reader has its prepared statement cache
+		reader = (SqdbSqlite*)sqdb_new(SQDB_INFO_SQLITE, NULL);
+		reader->stmt_cache_size = sqdb->stmt_cache_size;
+		wal->readers[index] = reader;
+		rc = sqlite3_open_v2(path, &reader->self, SQLITE_OPEN_READONLY, NULL);
+		if (rc == SQLITE_OK)
+			rc = sqdb_sqlite_apply_pragma(sqdb, reader->self, true);
+		if (rc != SQLITE_OK)
+			break;
+	}
+
+	if (rc != SQLITE_OK)
+		sqdb_sqlite_close_readers(sqdb);
+	return rc;
+}
+
+static void sqdb_sqlite_close_readers(SqdbSqlite *sqdb)
+{
+	SqdbSqliteWal *wal = sqdb->wal;
+	SqdbSqlite    *reader;
+	int  index;
+
+	if (wal == NULL)
+		return;
+	for (index = 0;  index < sqdb->n_readers;  index++) {
+		reader = wal->readers[index];
+		if (reader == NULL)
+			break;
+		sqdb_sqlite_close(reader);
+		sqdb_free((Sqdb*)reader);
+	}
+	free(wal->readers);
+#if SQ_CONFIG_HAVE_THREAD
+	sq_mutex_clear(&wal->mutex);
+	sq_cond_clear(&wal->writer_cond);
+	for (index = 0;  index < sqdb->n_readers;  index++)
+		sq_mutex_clear(&wal->reader_mutex[index]);
+	free(wal->reader_mutex);
+#endif
+	free(wal);
+	sqdb->wal = NULL;
+}
+
 // synchronize schema to database
 static int  sqdb_sqlite_migrate_sync(SqdbSqlite *sqdb, SqSchema *schema)
 {
@@ -299,9 +519,420 @@ static int  sqdb_sqlite_migrate(SqdbSqlite *sqdb, SqSchema *schema, SqSchema *sc
 	return SQCODE_OK;
 }
 
-static int query_callback(void *user_data, int argc, char **argv, char **columnName)
+// ----------------------------------------------------------------------------
+// prepared statement cache
+
+#define SQDB_SQLITE_N_PARAMS_MAX    999    // default SQLITE_MAX_VARIABLE_NUMBER before SQLite 3.32.0
+
+struct SqdbSqliteStmt
+{
+	sqlite3_stmt  *stmt;
+	char          *sql;      // normalized SQL statement
+	int            length;   // length of normalized SQL statement
+	unsigned int   hash;
+};
+
+typedef struct SqdbSqliteParam
+{
+	const char    *str;
+	int            length;   // if 'type' is 0, this is index of SqdbParam array
+	int            type;     // SQLITE_INTEGER, SQLITE_FLOAT, SQLITE_TEXT, or 0 (value is in SqdbParam array)
+	int            escaped;  // string literal has '' in it
+} SqdbSqliteParam;
+
+#define IS_IDENTIFIER_CHAR(c)    ( ((c) >= 'a' && (c) <= 'z') || ((c) >= 'A' && (c) <= 'Z') || \
+                                   ((c) >= '0' && (c) <= '9') || (c) == '_' || (unsigned char)(c) >= 0x80 )
+#define IS_DIGIT(c)              ((c) >= '0' && (c) <= '9')
+// literal that follows comparison operator or is in VALUES list can be parameter
+#define IS_PARAM_POSITION(prev, in_values)    \
+		((prev) == '=' || (prev) == '<' || (prev) == '>' || (prev) == '!' || \
+		 ((in_values) && ((prev) == '(' || (prev) == ',')))
+
+static SqdbSqliteParam *sqdb_sqlite_alloc_param(SqdbSqlite *sqdb, int index)
+{
+	if (index >= sqdb->stmt_params_size) {
+		sqdb->stmt_params_size = (sqdb->stmt_params_size) ? sqdb->stmt_params_size * 2 : 16;
+		sqdb->stmt_params = realloc(sqdb->stmt_params, sizeof(SqdbSqliteParam) * sqdb->stmt_params_size);
+	}
+	return (SqdbSqliteParam*)sqdb->stmt_params + index;
+}
+
+/*	Replace literals in INSERT, UPDATE, DELETE, and SELECT statement with '?'.
+	Only literals that follow comparison operators or are in VALUES list will be replaced, e.g.
+	SELECT * FROM "users" WHERE "id"=35   --->   SELECT * FROM "users" WHERE "id"=?
+
+	Normalized statement is written to sqdb->stmt_key and literals are stored in sqdb->stmt_params.
+	If 'sql' has 'n_values' placeholders '?', their position will be stored in sqdb->stmt_params too.
+	return number of parameters or -1 if 'sql' can't be normalized.
+ */
+static int  sqdb_sqlite_normalize(SqdbSqlite *sqdb, const char *sql, int n_values)
+{
+	SqBuffer        *key = &sqdb->stmt_key;
+	SqdbSqliteParam *param;
+	const char *beg;
+	const char *cur;
+	char  prev = 0;        // previous non-space character. 'a' for keyword and identifier
+	int   in_values = 0;
+	int   is_insert;
+	int   n_params = 0;
+	int   n_placeholders = 0;
+
+	key->writed = 0;
+	for (cur = sql;  *cur == ' ' || *cur == '\t' || *cur == '\n' || *cur == '\r';  cur++)
+		;
+	if (strncasecmp(cur, "SELECT", 6) && strncasecmp(cur, "UPDATE", 6) && strncasecmp(cur, "DELETE", 6)) {
+		if (strncasecmp(cur, "INSERT", 6) && strncasecmp(cur, "REPLACE", 7))
+			return -1;
+		is_insert = 1;
+	}
+	else
+		is_insert = 0;
+
+	while (*cur) {
+		beg = cur;
+		switch (*cur) {
+		case '\'':
+			// string literal
+			for (cur++;  ;  cur += 2) {
+				cur = sq_str_find_sql_escape(cur);
+				if (*cur == 0 || cur[1] != '\'')
+					break;
+			}
+			if (*cur++ == 0)
+				return -1;
+			if (IS_PARAM_POSITION(prev, in_values) && n_params < SQDB_SQLITE_N_PARAMS_MAX) {
+				param = sqdb_sqlite_alloc_param(sqdb, n_params++);
+				param->str = beg + 1;
+				param->length = (int)(cur - beg) - 2;
+				param->type = SQLITE_TEXT;
+				param->escaped = (memchr(param->str, '\'', param->length) != NULL);
+				sq_buffer_write_c(key, '?');
+			}
+			else
+				sq_buffer_write_n(key, beg, (int)(cur - beg));
+			prev = '0';
+			continue;
+
+		case '"':
+		case '`':
+		case '[':
+			// quoted identifier
+			for (cur++;  *cur && *cur != ((*beg == '[') ? ']' : *beg);  cur++)
+				;
+			if (*cur++ == 0)
+				return -1;
+			sq_buffer_write_n(key, beg, (int)(cur - beg));
+			prev = 'a';
+			continue;
+
+		case '?':
+			// placeholder of value in SqdbParam array
+			if (n_placeholders < n_values && IS_DIGIT(cur[1]) == 0) {
+				param = sqdb_sqlite_alloc_param(sqdb, n_params++);
+				param->type = 0;
+				param->length = n_placeholders++;
+				sq_buffer_write_c(key, *cur++);
+				prev = '0';
+				continue;
+			}
+			// Don't break here
+//			break;
+		case ':':
+		case '@':
+		case '$':
+			// statement has parameters already
+			return -1;
+
+		case '-':
+		case '/':
+			// comment
+			if (cur[1] == *cur || (*cur == '/' && cur[1] == '*'))
+				return -1;
+			// negative number
+			if (*cur == '-' && IS_PARAM_POSITION(prev, in_values) &&
+			    (IS_DIGIT(cur[1]) || (cur[1] == '.' && IS_DIGIT(cur[2]))))
+				cur++;
+			break;
+
+		case ';':
+			// multiple statements
+			for (cur++;  *cur == ' ' || *cur == '\t' || *cur == '\n' || *cur == '\r' || *cur == ';';  cur++)
+				;
+			if (*cur)
+				return -1;
+			continue;
+
+		case ' ':
+		case '\t':
+		case '\n':
+		case '\r':
+			sq_buffer_write_c(key, *cur++);
+			continue;
+		}
+
+		if (IS_DIGIT(*cur) || (*cur == '.' && IS_DIGIT(cur[1]))) {
+			// numeric literal
+			int  type = SQLITE_INTEGER;
+
+			for (;  IS_DIGIT(*cur);  cur++)
+				;
+			if (*cur == '.') {
+				type = SQLITE_FLOAT;
+				for (cur++;  IS_DIGIT(*cur);  cur++)
+					;
+			}
+			if ((*cur == 'e' || *cur == 'E') &&
+			    (IS_DIGIT(cur[1]) || ((cur[1] == '+' || cur[1] == '-') && IS_DIGIT(cur[2]))))
+			{
+				type = SQLITE_FLOAT;
+				for (cur += 2;  IS_DIGIT(*cur);  cur++)
+					;
+			}
+			// hexadecimal integer, huge integer, or something like 123abc are kept in statement
+			if (IS_IDENTIFIER_CHAR(*cur) || (type == SQLITE_INTEGER && cur - beg > 18)) {
+				for (;  IS_IDENTIFIER_CHAR(*cur);  cur++)
+					;
+			}
+			else if (IS_PARAM_POSITION(prev, in_values) && n_params < SQDB_SQLITE_N_PARAMS_MAX) {
+				param = sqdb_sqlite_alloc_param(sqdb, n_params++);
+				param->str = beg;
+				param->length = (int)(cur - beg);
+				param->type = type;
+				param->escaped = 0;
+				sq_buffer_write_c(key, '?');
+				prev = '0';
+				continue;
+			}
+			sq_buffer_write_n(key, beg, (int)(cur - beg));
+			prev = '0';
+			continue;
+		}
+
+		if (IS_IDENTIFIER_CHAR(*cur)) {
+			// keyword or identifier
+			for (cur++;  IS_IDENTIFIER_CHAR(*cur);  cur++)
+				;
+			if (is_insert && cur - beg == 6 && strncasecmp(beg, "VALUES", 6) == 0)
+				in_values = 1;
+			sq_buffer_write_n(key, beg, (int)(cur - beg));
+			prev = 'a';
+			continue;
+		}
+
+		// operator and punctuation
+		sq_buffer_write_c(key, *cur);
+		prev = *cur++;
+	}
+
+	// null-terminated (sq_buffer_alloc() reserved space for it)
+	key->mem[key->writed] = 0;
+	return n_params;
+}
+
+static int  sqdb_sqlite_bind_value(sqlite3_stmt *stmt, int index, const SqdbParam *param);
+
+static int  sqdb_sqlite_bind_params(SqdbSqlite *sqdb, sqlite3_stmt *stmt, int n_params, const SqdbParam *values)
 {
-	Sqxc *xc = *(Sqxc**)user_data;
+	SqdbSqliteParam *param = (SqdbSqliteParam*)sqdb->stmt_params;
+	char *str;
+	int   src, dest;
+	int   rc = SQLITE_OK;
+
+	for (int index = 1;  index <= n_params && rc == SQLITE_OK;  index++, param++) {
+		switch (param->type) {
+		case 0:
+			rc = sqdb_sqlite_bind_value(stmt, index, values + param->length);
+			break;
+
+		case SQLITE_INTEGER:
+			rc = sqlite3_bind_int64(stmt, index, strtoll(param->str, NULL, 10));
+			break;
+
+		case SQLITE_FLOAT:
+			rc = sqlite3_bind_double(stmt, index, strtod(param->str, NULL));
+			break;
+
+		default:
+			if (param->escaped == 0) {
+				// 'param->str' is valid until sqlite3_clear_bindings() is called.
+				rc = sqlite3_bind_text(stmt, index, param->str, param->length, SQLITE_STATIC);
+				break;
+			}
+			// replace '' with '
+			str = malloc(param->length);
+			for (src = 0, dest = 0;  src < param->length;  src++, dest++) {
+				str[dest] = param->str[src];
+				if (param->str[src] == '\'')
+					src++;
+			}
+			rc = sqlite3_bind_text(stmt, index, str, dest, free);
+			break;
+		}
+	}
+	return rc;
+}
+
+// bind value of SqdbParam to parameter of 'stmt'
+static int  sqdb_sqlite_bind_value(sqlite3_stmt *stmt, int index, const SqdbParam *param)
+{
+	char  timestr[SQ_TIME_STRING_SIZE];
+	int   len;
+
+	switch (param->type) {
+	case SQXC_TYPE_BOOL:
+		return sqlite3_bind_int(stmt, index, param->value.boolean);
+
+	case SQXC_TYPE_INT:
+		return sqlite3_bind_int(stmt, index, param->value.integer);
+
+	case SQXC_TYPE_UINT:
+		return sqlite3_bind_int64(stmt, index, param->value.uinteger);
+
+	case SQXC_TYPE_INT64:
+	case SQXC_TYPE_UINT64:
+		return sqlite3_bind_int64(stmt, index, param->value.int64);
+
+	case SQXC_TYPE_DOUBLE:
+		return sqlite3_bind_double(stmt, index, param->value.double_);
+
+	case SQXC_TYPE_TIME:
+		// SQLITE_TRANSIENT: SQLite makes its own copy of 'timestr'
+		len = sq_time_to_str(timestr, param->value.rawtime, 0);
+		return sqlite3_bind_text(stmt, index, timestr, len, SQLITE_TRANSIENT);
+
+	case SQXC_TYPE_STR:
+		// 'param->value.str' must be valid until sqlite3_clear_bindings() is called.
+		if (param->value.str)
+			return sqlite3_bind_text(stmt, index, param->value.str, -1, SQLITE_STATIC);
+		// Don't break here
+//		break;
+	default:
+		return sqlite3_bind_null(stmt, index);
+	}
+}
+
+// bind values of SqdbParam array to parameters of 'stmt'
+static int  sqdb_sqlite_bind_values(sqlite3_stmt *stmt, const SqdbParam *params, int n_params)
+{
+	int  rc = SQLITE_OK;
+
+	if (n_params > sqlite3_bind_parameter_count(stmt))
+		n_params = sqlite3_bind_parameter_count(stmt);
+	for (int index = 1;  index <= n_params && rc == SQLITE_OK;  index++)
+		rc = sqdb_sqlite_bind_value(stmt, index, params + index - 1);
+	return rc;
+}
+
+// return cached statement that parameters have been bound or NULL if 'sql' can't be cached.
+// If 'params' is NULL, literals in 'sql' will be bound to parameters after normalizing.
+static sqlite3_stmt *sqdb_sqlite_get_stmt(SqdbSqlite *sqdb, const char *sql,
+                                          const SqdbParam *params, int n_params, int *rc)
+{
+	SqdbSqliteStmt *cached;
+	const char     *key;
+	const char     *tail;
+	unsigned int    hash = 2166136261u;    // FNV-1a
+	int    length;
+	int    index;
+	int    n_normalized;
+
+	*rc = SQLITE_OK;
+	if (sqdb->stmt_cache_size <= 0)
+		return NULL;
+	n_normalized = sqdb_sqlite_normalize(sqdb, sql, (params) ? n_params : 0);
+	if (n_normalized >= 0) {
+		key = sqdb->stmt_key.mem;
+		length = sqdb->stmt_key.writed;
+	}
+	else if (params) {
+		// use statement that has parameters as key
+		key = sql;
+		length = (int)strlen(sql);
+	}
+	else
+		return NULL;
+	for (index = 0;  index < length;  index++)
+		hash = (hash ^ (unsigned char)key[index]) * 16777619u;
+
+	// search statement in cache
+	for (index = 0;  index < sqdb->stmt_cache_length;  index++) {
+		cached = sqdb->stmt_cache + index;
+		if (cached->hash == hash && cached->length == length && memcmp(cached->sql, key, length) == 0)
+			break;
+	}
+
+	if (index < sqdb->stmt_cache_length) {
+		sqdb->stmt_cache_hits++;
+	}
+	else {
+		sqlite3_stmt *stmt;
+
+		sqdb->stmt_cache_misses++;
+		// If normalized statement can't be prepared, caller will run original one.
+		if (sqlite3_prepare_v2(sqdb->self, key, length, &stmt, &tail) != SQLITE_OK || stmt == NULL)
+			return NULL;
+		// multiple statements can't be cached
+		for (;  *tail == ' ' || *tail == '\t' || *tail == '\n' || *tail == '\r' || *tail == ';';  tail++)
+			;
+		if (*tail) {
+			sqlite3_finalize(stmt);
+			return NULL;
+		}
+		// evict the least recently used statement
+		if (sqdb->stmt_cache_length == sqdb->stmt_cache_size) {
+			cached = sqdb->stmt_cache + --sqdb->stmt_cache_length;
+			sqlite3_finalize(cached->stmt);
+			free(cached->sql);
+			sqdb->stmt_cache_evictions++;
+		}
+		else if (sqdb->stmt_cache == NULL) {
+			sqdb->stmt_cache = malloc(sizeof(SqdbSqliteStmt) * sqdb->stmt_cache_size);
+		}
+		cached = sqdb->stmt_cache + sqdb->stmt_cache_length++;
+		cached->stmt = stmt;
+		cached->sql = malloc(length + 1);
+		memcpy(cached->sql, key, length + 1);
+		cached->length = length;
+		cached->hash = hash;
+		index = sqdb->stmt_cache_length - 1;
+	}
+
+	// move statement to the front of cache
+	if (index > 0) {
+		SqdbSqliteStmt  temp = sqdb->stmt_cache[index];
+		memmove(sqdb->stmt_cache + 1, sqdb->stmt_cache, sizeof(SqdbSqliteStmt) * index);
+		sqdb->stmt_cache[0] = temp;
+	}
+
+	if (n_normalized >= 0)
+		*rc = sqdb_sqlite_bind_params(sqdb, sqdb->stmt_cache[0].stmt, n_normalized, params);
+	else
+		*rc = sqdb_sqlite_bind_values(sqdb->stmt_cache[0].stmt, params, n_params);
+	if (*rc != SQLITE_OK) {
+		sqlite3_clear_bindings(sqdb->stmt_cache[0].stmt);
+		return NULL;
+	}
+	return sqdb->stmt_cache[0].stmt;
+}
+
+static void sqdb_sqlite_clear_stmt_cache(SqdbSqlite *sqdb)
+{
+	for (int index = 0;  index < sqdb->stmt_cache_length;  index++) {
+		sqlite3_finalize(sqdb->stmt_cache[index].stmt);
+		free(sqdb->stmt_cache[index].sql);
+	}
+	sqdb->stmt_cache_length = 0;
+}
+
+// ----------------------------------------------------------------------------
+// sqdb_sqlite_exec()
+
+// send a row of result set to Sqxc elements.
+// return SQCODE_OK if no problem occurred.
+static int  sqdb_sqlite_send_row(sqlite3_stmt *stmt, Sqxc **xc_addr)
+{
+	Sqxc *xc = *xc_addr;
+	int   n_columns = sqlite3_column_count(stmt);
 	int   index;
 
 	// built-in types are not object
@@ -310,16 +941,45 @@ static int query_callback(void *user_data, int argc, char **argv, char **columnN
 		xc->name = NULL;
 		xc->value.pointer = NULL;
 		xc = sqxc_send(xc);
-		// returns non-zero, the sqlite3_exec() routine returns SQLITE_ABORT
 		if (xc->code != SQCODE_OK)
-			return 1;
+			return xc->code;
 	}
 
-	for (index = 0;  index < argc;  index++) {
-		xc->type = SQXC_TYPE_STR;
-		xc->name = columnName[index];
-		xc->value.str = argv[index];
-		xc = sqxc_send(xc);
+	for (index = 0;  index < n_columns;  index++) {
+		// send value in it's storage class. SQLite doesn't need to convert it to text.
+		switch (sqlite3_column_type(stmt, index)) {
+		case SQLITE_INTEGER:
+			xc->type = SQXC_TYPE_INT64;
+			xc->value.int64 = sqlite3_column_int64(stmt, index);
+			break;
+
+		case SQLITE_FLOAT:
+			xc->type = SQXC_TYPE_DOUBLE;
+			xc->value.double_ = sqlite3_column_double(stmt, index);
+			break;
+
+		case SQLITE_NULL:
+			xc->type = SQXC_TYPE_NULL;
+			xc->value.pointer = NULL;
+			break;
+
+		default:
+			xc->type = SQXC_TYPE_STR;
+			xc->value.str = (char*)sqlite3_column_text(stmt, index);
+			break;
+		}
+		xc->name = sqlite3_column_name(stmt, index);
+		xc = sqxc_value_send_column(xc, index);
+
+		// If destination can't accept typed value, send it as text. e.g. integer in column of string.
+		if ((xc->code == SQCODE_TYPE_NOT_MATCH || xc->code == SQCODE_TYPE_NOT_SUPPORT) &&
+		    xc->type != SQXC_TYPE_STR)
+		{
+			xc->type = SQXC_TYPE_STR;
+			xc->name = sqlite3_column_name(stmt, index);
+			xc->value.str = (char*)sqlite3_column_text(stmt, index);
+			xc = sqxc_send(xc);
+		}
 
 #ifndef NDEBUG
 		switch (xc->code) {
@@ -327,13 +987,11 @@ static int query_callback(void *user_data, int argc, char **argv, char **columnN
 			break;
 
 		case SQCODE_ENTRY_NOT_FOUND:
-			fprintf(stderr, "sqdb_sqlite_exec(): column '%s' not found.\n", columnName[index]);
+			fprintf(stderr, "sqdb_sqlite_exec(): column '%s' not found.\n", sqlite3_column_name(stmt, index));
 			break;
 
 		default:
-			fprintf(stderr, "sqdb_sqlite_exec(): error occurred during parsing column '%s'.\n", columnName[index]);
-			// returns non-zero, the sqlite3_exec() routine returns SQLITE_ABORT
-//			return 1;
+			fprintf(stderr, "sqdb_sqlite_exec(): error occurred during parsing column '%s'.\n", sqlite3_column_name(stmt, index));
 			break;
 		}
 #endif  // NDEBUG
@@ -346,48 +1004,107 @@ static int query_callback(void *user_data, int argc, char **argv, char **columnN
 		xc->value.pointer = NULL;
 		xc = sqxc_send(xc);
 #ifndef NDEBUG
-		// returns non-zero, the sqlite3_exec() routine returns SQLITE_ABORT
-		if (xc->code != SQCODE_OK)
-			return 1;
+		if (xc->code != SQCODE_OK) {
+			*xc_addr = xc;
+			return xc->code;
+		}
 #endif  // NDEBUG
 	}
 
 	// xc may be changed by sqxc_send()
-	*(Sqxc**)user_data = xc;
-
-	return 0;
+	*xc_addr = xc;
+	return SQCODE_OK;
 }
 
 #ifndef NDEBUG
-static int  debug_callback(void *user_data, int argc, char **argv, char **columnName)
+static void debug_row(sqlite3_stmt *stmt)
 {
-	int i;
+	int  n_columns = sqlite3_column_count(stmt);
 
 	fprintf(stderr, "SQLite callback: ");
-	for (i=0; i<argc; i++)
-		fprintf(stderr, "%s = %s\n", columnName[i], argv[i] ? argv[i] : "NULL");
-	return 0;
+	for (int i = 0;  i < n_columns;  i++) {
+		const char *text = (const char*)sqlite3_column_text(stmt, i);
+		fprintf(stderr, "%s = %s\n", sqlite3_column_name(stmt, i), text ? text : "NULL");
+	}
 }
 #endif  // NDEBUG
 
-static int  sqdb_sqlite_exec(SqdbSqlite *sqdb, const char *sql, Sqxc *xc, void *reserve)
+// run statement until it is done. 'xc_addr' can be NULL if result set is not required.
+static int  sqdb_sqlite_step(sqlite3_stmt *stmt, Sqxc **xc_addr)
 {
+	Sqxc *xcvalue = NULL;
 	int   rc;
-	int   code = SQCODE_OK;
-	char *errorMsg = NULL;
 
+	// column names of 'stmt' are unchanged until it is finalized, SqxcValue can bind them to entries.
+	if (xc_addr) {
+		xcvalue = *xc_addr;
+		sqxc_value_begin_binding(xcvalue);
+	}
+	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+		if (xc_addr) {
+			if (sqdb_sqlite_send_row(stmt, xc_addr) != SQCODE_OK) {
+				rc = SQLITE_ABORT;
+				break;
+			}
+			// result set is not empty
+			if ((*xc_addr)->code == SQCODE_NO_DATA)
+				(*xc_addr)->code = SQCODE_OK;
+		}
 #ifndef NDEBUG
-	fprintf(stderr, "SQL: %s\n", sql);
+		else
+			debug_row(stmt);
 #endif
+	}
+	if (xcvalue)
+		sqxc_value_end_binding(xcvalue);
+	return (rc == SQLITE_DONE) ? SQLITE_OK : rc;
+}
+
+static int  sqdb_sqlite_exec_conn(SqdbSqlite *sqdb, const char *sql, Sqxc *xc, const SqdbParam *params, int n_params);
+static int  sqdb_sqlite_exec_token(SqdbSqlite *sqdb, const char *sql, Sqxc *xc,
+                                   const SqdbParam *params, int n_params, SqdbToken *token);
+static SqdbSqlite *sqdb_sqlite_lock_conn(SqdbSqlite *sqdb, const char *sql);
+static void        sqdb_sqlite_unlock_conn(SqdbSqlite *sqdb, SqdbSqlite *conn);
+
+// 'reserve' is SqdbToken of this call. It can be NULL.
+static int  sqdb_sqlite_exec(SqdbSqlite *sqdb, const char *sql, Sqxc *xc, void *reserve)
+{
+	return sqdb_sqlite_exec_token(sqdb, sql, xc, NULL, 0, reserve);
+}
+
+static int  sqdb_sqlite_exec_params(SqdbSqlite *sqdb, const char *sql, Sqxc *xc, const SqdbParam *params, int n_params)
+{
+	return sqdb_sqlite_exec_token(sqdb, sql, xc, params, n_params, NULL);
+}
+
+static int  sqdb_sqlite_exec_token(SqdbSqlite *sqdb, const char *sql, Sqxc *xc,
+                                   const SqdbParam *params, int n_params, SqdbToken *token)
+{
+	SqdbSqlite *conn;
+	int         code;
+
+	conn = sqdb_sqlite_lock_conn(sqdb, sql);
+	code = sqdb_sqlite_begin_call(sqdb, conn, token);
+	if (code == SQCODE_OK)
+		code = sqdb_sqlite_exec_conn(conn, sql, xc, params, n_params);
+	sqdb_sqlite_end_call(conn);
+	sqdb_sqlite_unlock_conn(sqdb, conn);
+	return code;
+}
+
+// execute SQL statement with connection 'sqdb->self'
+static int  sqdb_sqlite_exec_conn(SqdbSqlite *sqdb, const char *sql, Sqxc *xc, const SqdbParam *params, int n_params)
+{
+	sqlite3_stmt *stmt;
+	Sqxc **xc_addr = NULL;
+	int    rc;
+	int    code = SQCODE_OK;
 
-	if (xc == NULL) {
 #ifndef NDEBUG
-		rc = sqlite3_exec(sqdb->self, sql, debug_callback, NULL, &errorMsg);
-#else
-		rc = sqlite3_exec(sqdb->self, sql, NULL, NULL, &errorMsg);
+	fprintf(stderr, "SQL: %s\n", sql);
 #endif
-	}
-	else {
+
+	if (xc) {
 		switch (sql[0]) {
 		case 'S':    // SELECT
 		case 's':    // select
@@ -404,21 +1121,9 @@ static int  sqdb_sqlite_exec(SqdbSqlite *sqdb, const char *sql, Sqxc *xc, void *
 				xc->value.pointer = NULL;
 				xc = sqxc_send(xc);
 			}
-
-			// set xc->code and call sqlite3_exec()
+			// sqdb_sqlite_step() will set xc->code to SQCODE_OK if result set is not empty.
 			xc->code = SQCODE_NO_DATA;
-			rc = sqlite3_exec(sqdb->self, sql, query_callback, &xc, &errorMsg);
-			// if the result set is empty.
-			if(xc->code == SQCODE_NO_DATA)
-				code = SQCODE_NO_DATA;
-
-			// if Sqxc element prepare for multiple row
-			if (sqxc_value_container(xc)) {
-				xc->type = SQXC_TYPE_ARRAY_END;
-				xc->name = NULL;
-//				xc->value.pointer = NULL;
-				xc = sqxc_send(xc);
-			}
+			xc_addr = &xc;
 			break;
 
 		case 'I':    // INSERT
@@ -434,26 +1139,354 @@ static int  sqdb_sqlite_exec(SqdbSqlite *sqdb, const char *sql, Sqxc *xc, void *
 			// Don't break here
 //			break;
 		default:
-			rc = sqlite3_exec(sqdb->self, sql, NULL, NULL, &errorMsg);
-			// set the last inserted row id
-			((SqxcSql*)xc)->id = sqlite3_last_insert_rowid(sqdb->self);
-			// set number of rows changed
-			((SqxcSql*)xc)->changes = sqlite3_changes(sqdb->self);
 			break;
 		}
 	}
 
-	// check return value of sqlite3_exec()
+	stmt = sqdb_sqlite_get_stmt(sqdb, sql, params, n_params, &rc);
+	if (stmt) {
+		// use cached statement
+		rc = sqdb_sqlite_step(stmt, xc_addr);
+		sqlite3_reset(stmt);
+		sqlite3_clear_bindings(stmt);
+	}
+	else if (rc == SQLITE_OK) {
+		// statement can't be cached. It may have multiple statements.
+		while (*sql) {
+			rc = sqlite3_prepare_v2(sqdb->self, sql, -1, &stmt, &sql);
+			if (rc != SQLITE_OK)
+				break;
+			// 'stmt' is NULL if 'sql' is whitespace or comment
+			if (stmt == NULL)
+				continue;
+			if (params)
+				rc = sqdb_sqlite_bind_values(stmt, params, n_params);
+			if (rc == SQLITE_OK)
+				rc = sqdb_sqlite_step(stmt, xc_addr);
+			sqlite3_finalize(stmt);
+			if (rc != SQLITE_OK)
+				break;
+		}
+	}
+
+	if (xc_addr) {
+		// if the result set is empty.
+		if (xc->code == SQCODE_NO_DATA)
+			code = SQCODE_NO_DATA;
+		// if Sqxc element prepare for multiple row
+		if (sqxc_value_container(xc)) {
+			xc->type = SQXC_TYPE_ARRAY_END;
+			xc->name = NULL;
+//			xc->value.pointer = NULL;
+			xc = sqxc_send(xc);
+		}
+	}
+	else if (xc) {
+		// set the last inserted row id
+		((SqxcSql*)xc)->id = sqlite3_last_insert_rowid(sqdb->self);
+		// set number of rows changed
+		((SqxcSql*)xc)->changes = sqlite3_changes(sqdb->self);
+	}
+
+	// check return value of sqlite3_step()
 	if (rc != SQLITE_OK) {
 #ifndef NDEBUG
-		fprintf(stderr, "SQLite: %s\n", errorMsg);
+		fprintf(stderr, "SQLite: %s\n", sqlite3_errmsg(sqdb->self));
 #endif
-		sqlite3_free(errorMsg);
-		return SQCODE_EXEC_ERROR;
+		return sqdb_sqlite_error_code(sqdb, rc);
 	}
 	return code;
 }
 
+// ----------------------------------------------------------------------------
+// connection that runs SQL statement
+
+// return true if 'sql' is SELECT statement. Other statements (e.g. SAVEPOINT, WITH ... INSERT) are run by writer.
+static bool sqdb_sqlite_is_select(const char *sql)
+{
+	while (*sql == ' ' || *sql == '\t' || *sql == '\r' || *sql == '\n' || *sql == '(')
+		sql++;
+	if (strncasecmp(sql, "SELECT", 6) != 0)
+		return false;
+	return (isalnum((unsigned char)sql[6]) || sql[6] == '_') == false;
+}
+
+#if SQ_CONFIG_HAVE_THREAD
+// return index of reader 'conn'
+static int  sqdb_sqlite_reader_index(SqdbSqlite *sqdb, SqdbSqlite *conn)
+{
+	for (int index = 0;  index < sqdb->n_readers;  index++) {
+		if (sqdb->wal->readers[index] == conn)
+			return index;
+	}
+	return -1;
+}
+#endif
+
+// lock writer connection. It waits until other thread releases writer and ends its transaction.
+static void sqdb_sqlite_lock_writer(SqdbSqlite *sqdb)
+{
+#if SQ_CONFIG_HAVE_THREAD
+	SqdbSqliteWal *wal = sqdb->wal;
+	SqThreadData   self = sq_thread_self();
+
+	sq_mutex_lock(&wal->mutex);
+	while ((wal->writer_count > 0 || wal->writer_trans) && wal->writer_owner != self)
+		sq_cond_wait(&wal->writer_cond, &wal->mutex);
+	wal->writer_owner = self;
+	wal->writer_count++;
+	sq_mutex_unlock(&wal->mutex);
+#endif
+}
+
+static void sqdb_sqlite_unlock_writer(SqdbSqlite *sqdb)
+{
+#if SQ_CONFIG_HAVE_THREAD
+	SqdbSqliteWal *wal = sqdb->wal;
+	bool           in_trans;
+
+	// only owner of writer runs here, so it can check state of writer.
+	in_trans = (sqlite3_get_autocommit(sqdb->self) == 0);
+	sq_mutex_lock(&wal->mutex);
+	wal->writer_count--;
+	wal->writer_trans = in_trans;
+	if (wal->writer_count == 0 && in_trans == false)
+		sq_cond_signal(&wal->writer_cond);
+	sq_mutex_unlock(&wal->mutex);
+#endif
+}
+
+// return connection that runs 'sql'. It must be unlocked by sqdb_sqlite_unlock_conn().
+// SELECT statement is run by reader in round-robin order unless the calling thread is in transaction.
+static SqdbSqlite *sqdb_sqlite_lock_conn(SqdbSqlite *sqdb, const char *sql)
+{
+	SqdbSqliteWal *wal = sqdb->wal;
+	unsigned int   index;
+	bool           in_trans;
+#if SQ_CONFIG_HAVE_THREAD
+	int            count;
+#endif
+
+	if (wal == NULL)
+		return sqdb;
+
+	if (sqdb_sqlite_is_select(sql)) {
+#if SQ_CONFIG_HAVE_THREAD
+		sq_mutex_lock(&wal->mutex);
+		in_trans = wal->writer_trans && wal->writer_owner == sq_thread_self();
+		index = wal->reader_next++ % sqdb->n_readers;
+		sq_mutex_unlock(&wal->mutex);
+#else
+		in_trans = (sqlite3_get_autocommit(sqdb->self) == 0);
+		index = wal->reader_next++ % sqdb->n_readers;
+#endif
+		// statement in transaction must see uncommitted changes of writer
+		if (in_trans == false) {
+#if SQ_CONFIG_HAVE_THREAD
+			// skip readers that are in use
+			for (count = 0;  count < sqdb->n_readers;  count++) {
+				if (sq_mutex_trylock(&wal->reader_mutex[index]) == 0)
+					break;
+				index = (index + 1) % sqdb->n_readers;
+			}
+			if (count == sqdb->n_readers)
+				sq_mutex_lock(&wal->reader_mutex[index]);
+#endif
+			return wal->readers[index];
+		}
+	}
+
+	sqdb_sqlite_lock_writer(sqdb);
+	return sqdb;
+}
+
+#if SQ_CONFIG_HAVE_THREAD
+// lock 'conn' that is returned by sqdb_sqlite_lock_conn() again
+static void sqdb_sqlite_relock_conn(SqdbSqlite *sqdb, SqdbSqlite *conn)
+{
+	if (sqdb->wal) {
+		if (conn == sqdb)
+			sqdb_sqlite_lock_writer(sqdb);
+		else
+			sq_mutex_lock(&sqdb->wal->reader_mutex[sqdb_sqlite_reader_index(sqdb, conn)]);
+	}
+}
+#endif
+
+static void sqdb_sqlite_unlock_conn(SqdbSqlite *sqdb, SqdbSqlite *conn)
+{
+#if SQ_CONFIG_HAVE_THREAD
+	if (sqdb->wal) {
+		if (conn == sqdb)
+			sqdb_sqlite_unlock_writer(sqdb);
+		else
+			sq_mutex_unlock(&sqdb->wal->reader_mutex[sqdb_sqlite_reader_index(sqdb, conn)]);
+	}
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// cursor
+
+typedef struct SqdbSqliteCursor    SqdbSqliteCursor;
+
+struct SqdbSqliteCursor
+{
+	sqlite3_stmt *stmt;
+	SqdbSqlite   *conn;    // connection that prepared 'stmt'
+};
+
+static void *sqdb_sqlite_cursor_open(SqdbSqlite *sqdb, const char *sql, const SqdbParam *params, int n_params)
+{
+	SqdbSqliteCursor *cursor;
+	sqlite3_stmt     *stmt;
+	SqdbSqlite       *conn;
+	int               rc;
+
+#ifndef NDEBUG
+	fprintf(stderr, "SQL: %s\n", sql);
+#endif
+
+	// cursor doesn't use statement cache because cached statement may be reset by other calls.
+	conn = sqdb_sqlite_lock_conn(sqdb, sql);
+	rc = sqlite3_prepare_v2(conn->self, sql, -1, &stmt, NULL);
+	if (rc == SQLITE_OK && stmt && params)
+		rc = sqdb_sqlite_bind_values(stmt, params, n_params);
+	if (rc != SQLITE_OK || stmt == NULL) {
+#ifndef NDEBUG
+		fprintf(stderr, "SQLite: %s\n", sqlite3_errmsg(conn->self));
+#endif
+		sqlite3_finalize(stmt);
+		sqdb_sqlite_unlock_conn(sqdb, conn);
+		return NULL;
+	}
+	sqdb_sqlite_unlock_conn(sqdb, conn);
+
+	cursor = malloc(sizeof(SqdbSqliteCursor));
+	cursor->stmt = stmt;
+	cursor->conn = conn;
+	return cursor;
+}
+
+static int  sqdb_sqlite_cursor_step(SqdbSqlite *sqdb, void *cursor_ptr, Sqxc *xc)
+{
+	SqdbSqliteCursor *cursor = cursor_ptr;
+	int  rc;
+	int  code;
+
+#if SQ_CONFIG_HAVE_THREAD
+	// connection is locked only while stepping, user can run other statements between steps.
+	sqdb_sqlite_relock_conn(sqdb, cursor->conn);
+#endif
+	// each step has its deadline
+	sqdb_sqlite_begin_call(sqdb, cursor->conn, NULL);
+	rc = sqlite3_step(cursor->stmt);
+	if (rc == SQLITE_ROW)
+		code = sqdb_sqlite_send_row(cursor->stmt, &xc);
+	else if (rc == SQLITE_DONE)
+		code = SQCODE_NO_DATA;
+	else {
+#ifndef NDEBUG
+		fprintf(stderr, "SQLite: %s\n", sqlite3_errmsg(cursor->conn->self));
+#endif
+		code = sqdb_sqlite_error_code(cursor->conn, rc);
+	}
+	sqdb_sqlite_end_call(cursor->conn);
+	sqdb_sqlite_unlock_conn(sqdb, cursor->conn);
+	return code;
+}
+
+static void sqdb_sqlite_cursor_close(SqdbSqlite *sqdb, void *cursor_ptr)
+{
+	SqdbSqliteCursor *cursor = cursor_ptr;
+	sqlite3_finalize(cursor->stmt);
+	free(cursor);
+}
+
+// ----------------------------------------------------------------------------
+// timeout and interruption
+
+// It only changes default timeout. Running calls are not affected.
+static int  sqdb_sqlite_set_timeout(SqdbSqlite *sqdb, int milliseconds)
+{
+	if (milliseconds < 0)
+		milliseconds = 0;
+	sqdb_sqlite_atomic_store(&sqdb->exec_timeout, milliseconds);
+	return SQCODE_OK;
+}
+
+// It can be called from other threads. Only the call that uses 'token' is interrupted.
+static int  sqdb_sqlite_interrupt(SqdbSqlite *sqdb, SqdbToken *token)
+{
+	if (token == NULL)
+		return SQCODE_ERROR;
+	sqdb_sqlite_atomic_store(&token->canceled, 1);
+	return SQCODE_OK;
+}
+
+static int64_t sqdb_sqlite_time(void)
+{
+#if defined(_WIN32) || defined(_WIN64)
+	return (int64_t)GetTickCount64();
+#else
+	struct timespec  ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+// SQLite calls this periodically while statement is running. Returning non-zero interrupts statement.
+static int  sqdb_sqlite_progress(void *conn_ptr)
+{
+	SqdbSqlite *conn = conn_ptr;
+
+	if (conn->exec_token && sqdb_sqlite_atomic_load(&conn->exec_token->canceled))
+		return 1;
+	if (conn->exec_deadline == 0 || sqdb_sqlite_time() < conn->exec_deadline)
+		return 0;
+	conn->exec_timed_out = true;
+	return 1;
+}
+
+// start deadline of call with locked 'conn'. return SQCODE_CANCELED if 'token' has been interrupted.
+// progress handler is installed only if call has deadline or token, so statement runs at full speed without them.
+static int  sqdb_sqlite_begin_call(SqdbSqlite *sqdb, SqdbSqlite *conn, SqdbToken *token)
+{
+	int  timeout;
+
+	if (token && token->timeout > 0)
+		timeout = token->timeout;
+	else
+		timeout = sqdb_sqlite_atomic_load(&sqdb->exec_timeout);
+
+	conn->exec_timed_out = false;
+	conn->exec_deadline = (timeout > 0) ? sqdb_sqlite_time() + timeout : 0;
+	conn->exec_token = token;
+	if (conn->exec_deadline || conn->exec_token)
+		sqlite3_progress_handler(conn->self, PROGRESS_HANDLER_N_OPS, sqdb_sqlite_progress, conn);
+
+	if (token && sqdb_sqlite_atomic_load(&token->canceled))
+		return SQCODE_CANCELED;
+	return SQCODE_OK;
+}
+
+static void sqdb_sqlite_end_call(SqdbSqlite *conn)
+{
+	if (conn->exec_deadline || conn->exec_token)
+		sqlite3_progress_handler(conn->self, 0, NULL, NULL);
+	conn->exec_deadline = 0;
+	conn->exec_token = NULL;
+}
+
+// convert SQLite result code to SQCODE
+static int  sqdb_sqlite_error_code(SqdbSqlite *conn, int rc)
+{
+	if (rc == SQLITE_INTERRUPT)
+		return (conn->exec_timed_out) ? SQCODE_TIMEOUT : SQCODE_CANCELED;
+	return SQCODE_EXEC_ERROR;
+}
+
 // ----------------------------------------------------------------------------
 
 // write exist columns
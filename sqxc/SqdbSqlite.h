@@ -24,6 +24,8 @@
 
 typedef struct SqdbSqlite          SqdbSqlite;
 typedef struct SqdbConfigSqlite    SqdbConfigSqlite;
+typedef struct SqdbSqliteStmt      SqdbSqliteStmt;    // used by prepared statement cache
+typedef struct SqdbSqliteWal       SqdbSqliteWal;     // used by read-only connections, defined in SqdbSqlite.c
 
 // ----------------------------------------------------------------------------
 // C declarations: declare C data, function, and others.
@@ -75,6 +77,43 @@ struct SqdbSqlite
 	sqlite3        *self;
 	char           *folder;
 	char           *extension;   // optional
+
+	// prepared statement cache (LRU). stmt_cache[0] is the most recently used one.
+	SqdbSqliteStmt *stmt_cache;
+	int             stmt_cache_length;
+	int             stmt_cache_size;       // maximum number of cached statements. 0 = disabled
+
+	// statistics of prepared statement cache
+	unsigned int    stmt_cache_hits;
+	unsigned int    stmt_cache_misses;
+	unsigned int    stmt_cache_evictions;
+
+	// These are used to normalize SQL statement before searching cache.
+	SqBuffer        stmt_key;
+	void           *stmt_params;
+	int             stmt_params_size;
+
+	// PRAGMA that are applied by sqdb_sqlite_open(). NULL or 0 = don't change.
+	char           *journal_mode;
+	char           *synchronous;
+	int64_t         mmap_size;
+	int             cache_size;
+	int             busy_timeout;
+
+	// number of read-only connections. 'self' is writer connection.
+	int             n_readers;
+	// read-only connections. It is NULL if database is not opened or 'n_readers' is 0.
+	SqdbSqliteWal  *wal;
+
+	// default execution timeout of each call in milliseconds. 0 = no timeout.
+	int             exec_timeout;
+	// Below members are used by the thread that is running call with this connection.
+	// deadline of running call in milliseconds of monotonic clock. 0 = no deadline.
+	int64_t         exec_deadline;
+	// token of running call. It can be NULL.
+	SqdbToken      *exec_token;
+	// running call is interrupted by timeout (not by sqdb_interrupt()).
+	bool            exec_timed_out;
 };
 
 /*	SqdbConfigSqlite - SqdbSqlite use this to configure database connection
@@ -98,6 +137,23 @@ struct SqdbConfigSqlite
 	// ------ SqdbConfigSqlite members ------
 	const char     *folder;
 	const char     *extension;   // optional
+
+	// size of prepared statement cache. 0 = default size, -1 = disable cache.
+	int             stmt_cache_size;   // optional
+
+	// PRAGMA that are applied when database is opened. NULL or 0 = don't change.
+	const char     *journal_mode;      // optional. e.g. "WAL"
+	const char     *synchronous;       // optional. e.g. "NORMAL"
+	int64_t         mmap_size;         // optional. bytes
+	int             cache_size;        // optional. pages if positive, KiB if negative.
+	int             busy_timeout;      // optional. milliseconds
+
+	// number of read-only connections. SELECT statements are run by them in round-robin order.
+	// Other statements are run by the only writer connection. It should be used with WAL mode.
+	int             n_readers;         // optional
+
+	// default execution timeout of each call in milliseconds. 0 = no timeout.
+	int             exec_timeout;      // optional
 };
 
 // ----------------------------------------------------------------------------
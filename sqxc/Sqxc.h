@@ -103,6 +103,10 @@ typedef enum {
 	SQXC_TYPE_STREAM_END = SQXC_TYPE_END | SQXC_TYPE_STREAM,    // reserve (unused now)
 #endif
 
+	// binary data. It is not in SQXC_TYPE_ALL, Sqxc element must support it explicitly.
+	// Sqxc.value.pointer = (SqBuffer*), data is SqBuffer.mem, length of data is SqBuffer.writed
+	SQXC_TYPE_RAW      = (1 << 12),   // 0x1000
+
 	// End of SQXC_TYPE_OBJECT, SQXC_TYPE_ARRAY.
 	SQXC_TYPE_END      = (1 << 15),   // 0x8000
 
@@ -0,0 +1,535 @@
+/*
+ *   Copyright (C) 2023 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ * sqxclib is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include <stdlib.h>
+#include <string.h>     // strcspn(), memmove()
+
+#include <SqError.h>
+#include <SqxcCsv.h>
+
+enum {
+	SQXC_CSV_FIELD_START,     // start of field
+	SQXC_CSV_UNQUOTED,        // in field without quotes
+	SQXC_CSV_QUOTED,          // in field with quotes
+	SQXC_CSV_QUOTE,           // quote in quoted field. It may be escaped quote or end of field.
+};
+
+/* ----------------------------------------------------------------------------
+	SqxcInfo functions - Middleware of input chain
+
+	(CSV text)
+	SQXC_TYPE_STR ---> SqxcCsv Parser ---> SQXC_TYPE_xxxx
+ */
+
+static void sqxc_csv_parser_reset(SqxcCsvParser *xccsv)
+{
+	xccsv->state = SQXC_CSV_FIELD_START;
+	xccsv->started = 0;
+	xccsv->field_index = 0;
+	xccsv->header_done = 0;
+	xccsv->n_columns = 0;
+	xccsv->names.writed = 0;
+	xccsv->buf_writed = 0;
+}
+
+// send data(arguments) from SqxcCsvParser(source) to destination
+static void sqxc_csv_parser_emit(SqxcCsvParser *xccsv, int type, const char *name)
+{
+	Sqxc *xcdest = xccsv->dest;
+	Sqxc *xcnext;
+
+	xccsv->type = type;
+	xccsv->name = name;
+	xcdest->info->send(xcdest, (Sqxc*)xccsv);
+
+	// field may be JSON array/object (e.g. written by SqxcJsonWriter). Send it to the next parser.
+	if (xccsv->code == SQCODE_TYPE_NOT_MATCH && type == SQXC_TYPE_STR) {
+		xcnext = xccsv->peer;
+		if (xcnext && xcnext->supported_type & SQXC_TYPE_STR) {
+			xcnext->dest = xcdest;
+			xcnext->info->send(xcnext, (Sqxc*)xccsv);
+		}
+	}
+}
+
+static int  sqxc_csv_parser_field_end(SqxcCsvParser *xccsv, int is_null)
+{
+	if (xccsv->header_done == 0) {
+		// name of column
+		if (xccsv->n_columns == xccsv->columns_size) {
+			xccsv->columns_size = (xccsv->columns_size) ? xccsv->columns_size * 2 : 16;
+			xccsv->columns = realloc(xccsv->columns, sizeof(int) * xccsv->columns_size);
+		}
+		xccsv->columns[xccsv->n_columns++] = xccsv->names.writed;
+		sq_buffer_write_n(&xccsv->names, xccsv->buf, xccsv->buf_writed);
+		sq_buffer_write_c(&xccsv->names, 0);    // null-terminated
+	}
+	else {
+		if (xccsv->field_index >= xccsv->n_columns)
+			return SQCODE_CSV_ERROR;
+		// Start of row
+		if (xccsv->field_index == 0) {
+			xccsv->value.pointer = NULL;
+			sqxc_csv_parser_emit(xccsv, SQXC_TYPE_OBJECT, NULL);
+		}
+		if (is_null)
+			xccsv->value.str = NULL;
+		else {
+			*sq_buffer_alloc(sqxc_get_buffer(xccsv), 0) = 0;    // null-terminated
+			xccsv->value.str = xccsv->buf;
+		}
+		sqxc_csv_parser_emit(xccsv, (is_null) ? SQXC_TYPE_NULL : SQXC_TYPE_STR,
+		                     xccsv->names.mem + xccsv->columns[xccsv->field_index]);
+	}
+
+	xccsv->field_index++;
+	xccsv->buf_writed = 0;
+	xccsv->state = SQXC_CSV_FIELD_START;
+	return SQCODE_OK;
+}
+
+static int  sqxc_csv_parser_line_end(SqxcCsvParser *xccsv)
+{
+	if (xccsv->header_done == 0)
+		xccsv->header_done = 1;
+	else {
+		// all rows must have the same number of fields as header
+		if (xccsv->field_index != xccsv->n_columns)
+			return SQCODE_CSV_ERROR;
+		// End of row
+		xccsv->value.pointer = NULL;
+		sqxc_csv_parser_emit(xccsv, SQXC_TYPE_OBJECT_END, NULL);
+	}
+	xccsv->field_index = 0;
+	return SQCODE_OK;
+}
+
+static int  sqxc_csv_parser_parse(SqxcCsvParser *xccsv, const char *cur)
+{
+	const char *end;
+	int   delimiter = xccsv->delimiter;
+	int   code = SQCODE_OK;
+
+	for (;  *cur && code == SQCODE_OK;  cur++) {
+		switch (xccsv->state) {
+		case SQXC_CSV_FIELD_START:
+			if (*cur == '"')
+				xccsv->state = SQXC_CSV_QUOTED;
+			else if (*cur == delimiter)
+				code = sqxc_csv_parser_field_end(xccsv, 1);
+			else if (*cur == '\n') {
+				// skip empty line
+				if (xccsv->field_index == 0)
+					break;
+				code = sqxc_csv_parser_field_end(xccsv, 1);
+				if (code == SQCODE_OK)
+					code = sqxc_csv_parser_line_end(xccsv);
+			}
+			else if (*cur != '\r') {
+				xccsv->state = SQXC_CSV_UNQUOTED;
+				cur--;
+			}
+			break;
+
+		case SQXC_CSV_UNQUOTED:
+			// write characters until special character
+			for (end = cur;  *end && *end != delimiter && *end != '\n' && *end != '\r';  end++)
+				;
+			if (end > cur)
+				sq_buffer_write_n(sqxc_get_buffer(xccsv), cur, (int)(end - cur));
+			cur = end;
+			if (*cur == 0)
+				cur--;
+			else if (*cur == delimiter)
+				code = sqxc_csv_parser_field_end(xccsv, 0);
+			else if (*cur == '\n') {
+				code = sqxc_csv_parser_field_end(xccsv, 0);
+				if (code == SQCODE_OK)
+					code = sqxc_csv_parser_line_end(xccsv);
+			}
+			// '\r' is ignored
+			break;
+
+		case SQXC_CSV_QUOTED:
+			// write characters until quote
+			end = strchr(cur, '"');
+			if (end == NULL)
+				end = cur + strlen(cur);
+			if (end > cur)
+				sq_buffer_write_n(sqxc_get_buffer(xccsv), cur, (int)(end - cur));
+			cur = end;
+			if (*cur == 0)
+				cur--;
+			else
+				xccsv->state = SQXC_CSV_QUOTE;
+			break;
+
+		case SQXC_CSV_QUOTE:
+			if (*cur == '"') {
+				// escaped quote
+				sq_buffer_write_c(sqxc_get_buffer(xccsv), '"');
+				xccsv->state = SQXC_CSV_QUOTED;
+			}
+			else if (*cur == delimiter)
+				code = sqxc_csv_parser_field_end(xccsv, 0);
+			else if (*cur == '\n') {
+				code = sqxc_csv_parser_field_end(xccsv, 0);
+				if (code == SQCODE_OK)
+					code = sqxc_csv_parser_line_end(xccsv);
+			}
+			else if (*cur != '\r')
+				code = SQCODE_CSV_ERROR;
+			break;
+		}
+	}
+
+	return code;
+}
+
+// complete the last row and array
+static int  sqxc_csv_parser_end(SqxcCsvParser *xccsv)
+{
+	int  code = SQCODE_OK;
+
+	switch (xccsv->state) {
+	case SQXC_CSV_QUOTED:
+		// quoted field is not closed
+		return SQCODE_CSV_ERROR;
+
+	case SQXC_CSV_FIELD_START:
+		// field after the last delimiter is empty
+		if (xccsv->field_index == 0)
+			break;
+		// fall through
+	default:
+		code = sqxc_csv_parser_field_end(xccsv, xccsv->state == SQXC_CSV_FIELD_START);
+		if (code == SQCODE_OK)
+			code = sqxc_csv_parser_line_end(xccsv);
+		break;
+	}
+
+	if (code == SQCODE_OK) {
+		xccsv->value.pointer = NULL;
+		sqxc_csv_parser_emit(xccsv, SQXC_TYPE_ARRAY_END, NULL);
+	}
+	return code;
+}
+
+static int  sqxc_csv_parser_send(SqxcCsvParser *xccsv, Sqxc *src)
+{
+	const char *str = (src->type == SQXC_TYPE_STR) ? src->value.str : NULL;
+	int   code;
+
+	// Start of array
+	if (xccsv->started == 0) {
+		xccsv->started = 1;
+		xccsv->value.pointer = NULL;
+		sqxc_csv_parser_emit(xccsv, SQXC_TYPE_ARRAY, src->name);
+	}
+
+	if (str) {
+		code = sqxc_csv_parser_parse(xccsv, str);
+		if (code == SQCODE_OK)
+			code = SQCODE_CSV_CONTINUE;
+	}
+	else {
+		// End of data
+		code = sqxc_csv_parser_end(xccsv);
+		if (code == SQCODE_OK)
+			sqxc_csv_parser_reset(xccsv);
+	}
+
+	if (code == SQCODE_CSV_ERROR)
+		sqxc_csv_parser_reset(xccsv);
+	return (src->code = code);
+}
+
+static int  sqxc_csv_parser_ctrl(SqxcCsvParser *xccsv, int id, void *data)
+{
+	switch(id) {
+	case SQXC_CTRL_READY:
+		sqxc_csv_parser_reset(xccsv);
+		break;
+
+	case SQXC_CTRL_FINISH:
+		sqxc_csv_parser_reset(xccsv);
+		// clear SqxcNested if problem occurred during processing
+		sqxc_clear_nested((Sqxc*)xccsv);
+		break;
+
+	default:
+		return SQCODE_NOT_SUPPORT;
+	}
+
+	return SQCODE_OK;
+}
+
+static void  sqxc_csv_parser_init(SqxcCsvParser *xccsv)
+{
+//	memset(xccsv, 0, sizeof(SqxcCsvParser));
+	xccsv->supported_type = SQXC_TYPE_STR | SQXC_TYPE_NULL;
+	xccsv->delimiter = ',';
+	sq_buffer_init(&xccsv->names);
+}
+
+static void  sqxc_csv_parser_final(SqxcCsvParser *xccsv)
+{
+	sq_buffer_final(&xccsv->names);
+	free(xccsv->columns);
+}
+
+/* ----------------------------------------------------------------------------
+	SqxcInfo functions - Middleware of output chain
+
+	SQXC_TYPE_xxxx ---> SqxcCsv Writer ---> SQXC_TYPE_STR
+	                                        (CSV text)
+ */
+
+// write field to tail of 'buffer'. Field is quoted if it has quote, delimiter, or line break.
+static void sqxc_csv_write_field(SqBuffer *buffer, const char *str, char delimiter)
+{
+	const char  special[] = {'"', delimiter, '\r', '\n', 0};
+	int   len;
+
+	len = (int)strcspn(str, special);
+	if (str[len] == 0 && len > 0) {
+		sq_buffer_write_n(buffer, str, len);
+		return;
+	}
+
+	// empty string is quoted to distinguish it from NULL
+	sq_buffer_write_c(buffer, '"');
+	for (;;) {
+		len = (int)strcspn(str, "\"");
+		if (len)
+			sq_buffer_write_n(buffer, str, len);
+		if (str[len] == 0)
+			break;
+		// double up on the quotes
+		sq_buffer_alloc(buffer, 2);
+		sq_buffer_r_at(buffer, 1) = '"';
+		sq_buffer_r_at(buffer, 0) = '"';
+		str += len + 1;
+	}
+	sq_buffer_write_c(buffer, '"');
+}
+
+static void sqxc_csv_writer_flush(SqxcCsvWriter *xccsv)
+{
+	Sqxc *xcdest = xccsv->dest;
+
+	if (xcdest == NULL || xccsv->buf_writed == 0)
+		return;
+	*sq_buffer_alloc(sqxc_get_buffer(xccsv), 0) = 0;    // null-terminated
+	xccsv->type = SQXC_TYPE_STR;
+	xccsv->name = xccsv->root_name;
+	xccsv->entry = xccsv->root_entry;
+	xccsv->value.str = xccsv->buf;
+	xcdest->info->send(xcdest, (Sqxc*)xccsv);
+	xccsv->buf_writed = 0;
+}
+
+static int  sqxc_csv_writer_send(SqxcCsvWriter *xccsv, Sqxc *src)
+{
+	SqBuffer *buffer = sqxc_get_buffer(xccsv);
+	char     *mem;
+	int       len;
+
+	if (xccsv->nested_count == 0) {
+		xccsv->root_name = src->name;
+		xccsv->root_entry = src->entry;
+	}
+
+	switch (src->type) {
+	case SQXC_TYPE_ARRAY:
+		if (xccsv->outer_type & (SQXC_TYPE_ARRAY | SQXC_TYPE_OBJECT))
+			return (src->code = SQCODE_TYPE_NOT_MATCH);
+		xccsv->outer_type |= SQXC_TYPE_ARRAY;
+		xccsv->supported_type &= ~SQXC_TYPE_ARRAY;
+		xccsv->supported_type |= SQXC_TYPE_END;
+		sqxc_push_nested((Sqxc*)xccsv);
+		// --- Begin of Array ---
+		return (src->code = SQCODE_OK);
+
+	case SQXC_TYPE_OBJECT:
+		if (xccsv->outer_type & SQXC_TYPE_OBJECT)
+			return (src->code = SQCODE_TYPE_NOT_MATCH);
+		xccsv->outer_type |= SQXC_TYPE_OBJECT;
+		// object or array in row is sent to the next Sqxc element
+		xccsv->supported_type &= ~(SQXC_TYPE_OBJECT | SQXC_TYPE_ARRAY);
+		xccsv->supported_type |= SQXC_TYPE_END;
+		sqxc_push_nested((Sqxc*)xccsv);
+		// --- Begin of row ---
+		xccsv->row_start = xccsv->buf_writed;
+		xccsv->col_count = 0;
+		return (src->code = SQCODE_OK);
+
+	case SQXC_TYPE_OBJECT_END:
+		if ((xccsv->outer_type & SQXC_TYPE_OBJECT) == 0)
+			return (src->code = SQCODE_TYPE_END_ERROR);
+		xccsv->outer_type &= ~SQXC_TYPE_OBJECT;
+		xccsv->supported_type |= SQXC_TYPE_OBJECT;
+		if ((xccsv->outer_type & SQXC_TYPE_ARRAY) == 0)
+			xccsv->supported_type |= SQXC_TYPE_ARRAY;
+		sqxc_pop_nested((Sqxc*)xccsv);
+		// --- End of row ---
+		sq_buffer_alloc(buffer, 2);
+		sq_buffer_r_at(buffer, 1) = '\r';
+		sq_buffer_r_at(buffer, 0) = '\n';
+		// the first row writes header before itself
+		if (xccsv->row_count++ == 0) {
+			sq_buffer_write_c(&xccsv->header, '\r');
+			sq_buffer_write_c(&xccsv->header, '\n');
+			len = xccsv->header.writed;
+			sq_buffer_alloc(buffer, len);
+			mem = buffer->mem + xccsv->row_start;
+			memmove(mem + len, mem, buffer->writed - len - xccsv->row_start);
+			memcpy(mem, xccsv->header.mem, len);
+		}
+		if (xccsv->nested_count == 0)
+			sqxc_csv_writer_flush(xccsv);
+		else if (xccsv->flush_size > 0 && xccsv->buf_writed >= xccsv->flush_size)
+			sqxc_csv_writer_flush(xccsv);
+		return (src->code = SQCODE_OK);
+
+	case SQXC_TYPE_ARRAY_END:
+		if ((xccsv->outer_type & SQXC_TYPE_ARRAY) == 0)
+			return (src->code = SQCODE_TYPE_END_ERROR);
+		xccsv->outer_type &= ~SQXC_TYPE_ARRAY;
+		xccsv->supported_type |= SQXC_TYPE_ARRAY;
+		sqxc_pop_nested((Sqxc*)xccsv);
+		// --- End of Array ---
+		sqxc_csv_writer_flush(xccsv);
+		return (src->code = SQCODE_OK);
+
+	default:
+		break;
+	}
+
+	// field must be in row
+	if ((xccsv->outer_type & SQXC_TYPE_OBJECT) == 0)
+		return (src->code = SQCODE_TYPE_NOT_MATCH);
+
+	// the first row writes names of fields to header
+	if (xccsv->row_count == 0) {
+		if (xccsv->col_count)
+			sq_buffer_write_c(&xccsv->header, xccsv->delimiter);
+		sqxc_csv_write_field(&xccsv->header, (src->name) ? src->name : "", xccsv->delimiter);
+	}
+	if (xccsv->col_count)
+		sq_buffer_write_c(buffer, xccsv->delimiter);
+	xccsv->col_count++;
+
+	switch (src->type) {
+	case SQXC_TYPE_NULL:
+		break;
+
+	case SQXC_TYPE_BOOL:
+		sq_buffer_write_c(buffer, (src->value.boolean) ? '1' : '0');
+		break;
+
+	case SQXC_TYPE_INT:
+		sq_buffer_write_int64(buffer, src->value.integer);
+		break;
+
+	case SQXC_TYPE_UINT:
+		sq_buffer_write_uint64(buffer, src->value.uint);
+		break;
+
+	case SQXC_TYPE_INT64:
+		sq_buffer_write_int64(buffer, src->value.int64);
+		break;
+
+	case SQXC_TYPE_UINT64:
+		sq_buffer_write_uint64(buffer, src->value.uint64);
+		break;
+
+	case SQXC_TYPE_TIME:
+		sq_buffer_write_time(buffer, src->value.rawtime, 0);
+		break;
+
+	case SQXC_TYPE_DOUBLE:
+		sq_buffer_write_double(buffer, src->value.double_);
+		break;
+
+	case SQXC_TYPE_STR:
+		if (src->value.str)
+			sqxc_csv_write_field(buffer, src->value.str, xccsv->delimiter);
+		break;
+
+	default:
+		return (src->code = SQCODE_TYPE_NOT_SUPPORT);
+	}
+
+	return (src->code = SQCODE_OK);
+}
+
+static int  sqxc_csv_writer_ctrl(SqxcCsvWriter *xccsv, int id, void *data)
+{
+	switch(id) {
+	case SQXC_CTRL_READY:
+		xccsv->supported_type = SQXC_TYPE_ALL;
+		xccsv->outer_type = SQXC_TYPE_UNKNOWN;
+		xccsv->row_count = 0;
+		xccsv->header.writed = 0;
+		xccsv->buf_writed = 0;
+		break;
+
+	case SQXC_CTRL_FINISH:
+		xccsv->supported_type = SQXC_TYPE_ALL;
+		xccsv->outer_type = SQXC_TYPE_UNKNOWN;
+		// clear SqxcNested if problem occurred during processing
+		sqxc_clear_nested((Sqxc*)xccsv);
+		break;
+
+	default:
+		return SQCODE_NOT_SUPPORT;
+	}
+
+	return SQCODE_OK;
+}
+
+static void  sqxc_csv_writer_init(SqxcCsvWriter *xccsv)
+{
+//	memset(xccsv, 0, sizeof(SqxcCsvWriter));
+	xccsv->supported_type = SQXC_TYPE_ALL;
+	xccsv->delimiter = ',';
+	sq_buffer_init(&xccsv->header);
+}
+
+static void  sqxc_csv_writer_final(SqxcCsvWriter *xccsv)
+{
+	sq_buffer_final(&xccsv->header);
+}
+
+// ----------------------------------------------------------------------------
+// SqxcInfo
+
+const SqxcInfo SqxcInfo_CsvParser_ =
+{
+	sizeof(SqxcCsvParser),
+	(SqInitFunc)sqxc_csv_parser_init,
+	(SqFinalFunc)sqxc_csv_parser_final,
+	(SqxcCtrlFunc)sqxc_csv_parser_ctrl,
+	(SqxcSendFunc)sqxc_csv_parser_send,
+};
+
+const SqxcInfo SqxcInfo_CsvWriter_ =
+{
+	sizeof(SqxcCsvWriter),
+	(SqInitFunc)sqxc_csv_writer_init,
+	(SqFinalFunc)sqxc_csv_writer_final,
+	(SqxcCtrlFunc)sqxc_csv_writer_ctrl,
+	(SqxcSendFunc)sqxc_csv_writer_send,
+};
@@ -0,0 +1,177 @@
+/*
+ *   Copyright (C) 2023 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ * sqxclib is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+
+#ifndef SQXC_CSV_H
+#define SQXC_CSV_H
+
+#include <SqBuffer.h>
+#include <Sqxc.h>
+
+// ----------------------------------------------------------------------------
+// C/C++ common declarations: declare type, structure, macro, enumeration.
+
+typedef struct SqxcCsvParser    SqxcCsvParser;
+typedef struct SqxcCsvWriter    SqxcCsvWriter;
+
+// ----------------------------------------------------------------------------
+// C declarations: declare C data, function, and others.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const SqxcInfo               SqxcInfo_CsvParser_;
+extern const SqxcInfo               SqxcInfo_CsvWriter_;
+#define SQXC_INFO_CSV_PARSER      (&SqxcInfo_CsvParser_)
+#define SQXC_INFO_CSV_WRITER      (&SqxcInfo_CsvWriter_)
+
+#define sqxc_csv_parser_new()          sqxc_new(SQXC_INFO_CSV_PARSER)
+#define sqxc_csv_writer_new()          sqxc_new(SQXC_INFO_CSV_WRITER)
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+// ----------------------------------------------------------------------------
+// C/C++ common definitions: define structure
+
+/*	SqxcCsvParser - CSV (RFC 4180) parser in input chain.
+
+	Sqxc
+	|
+	`--- SqxcCsvParser
+
+	*** In input chain:
+	SQXC_TYPE_STR ---> SqxcCsvParser ---> SQXC_TYPE_xxxx
+	(CSV text)
+
+	The first line is header, it has names of columns.
+	SqxcCsvParser sends CSV as array of objects, each line is an object (row):
+	  SQXC_TYPE_ARRAY, SQXC_TYPE_OBJECT, SQXC_TYPE_STR..., SQXC_TYPE_OBJECT_END, ..., SQXC_TYPE_ARRAY_END
+	Field is sent as SQXC_TYPE_STR. Empty field without quotes is sent as SQXC_TYPE_NULL.
+
+	CSV text can be sent in several pieces and pieces can be split at any position.
+	SqxcCsvParser returns SQCODE_CSV_CONTINUE until the end of data is sent.
+	The end of data is SQXC_TYPE_NULL (or SQXC_TYPE_STR with NULL), it completes the last row and the array.
+	sqxc_ready() and sqxc_finish() reset state of parser.
+ */
+
+#ifdef __cplusplus
+struct SqxcCsvParser : Sq::XcMethod      // <-- 1. inherit C++ member function(method)
+#else
+struct SqxcCsvParser
+#endif
+{
+	SQXC_MEMBERS;                        // <-- 2. inherit member variable
+
+	// ------ SqxcCsvParser members ------  // <-- 3. Add variable and non-virtual function in derived struct.
+
+	// Sqxc.buf stores current field.
+	char         delimiter;       // default is ','
+
+	// names of columns in header. 'names' stores null-terminated names.
+	SqBuffer     names;
+	int         *columns;         // offset of names
+	int          columns_size;
+	int          n_columns;
+	int          header_done;
+
+	// state of tokenizer
+	int          state;
+	int          started;         // SQXC_TYPE_ARRAY has been sent
+	int          field_index;     // index of current field in current line
+};
+
+/*	SqxcCsvWriter - CSV (RFC 4180) writer in output chain.
+
+	Sqxc
+	|
+	`--- SqxcCsvWriter
+
+	*** In output chain:
+	SQXC_TYPE_xxxx ---> SqxcCsvWriter ---> SQXC_TYPE_STR
+	                                       (CSV text)
+
+	Each SQXC_TYPE_OBJECT is a row and its members are fields. Array of rows is optional.
+	Names of members (SqEntry.name) in the first row are written as header.
+	Header is written once between sqxc_ready() and sqxc_finish().
+	NULL is written as empty field, empty string is written as "".
+
+	Object or array in row is not supported by SqxcCsvWriter, it is sent to the next element.
+	e.g. append SqxcJsonWriter to Sqxc chain to write array in row as JSON text.
+
+	SqxcCsvWriter appends CSV text to Sqxc.buf and sends it to destination
+	after array of rows (or row without array) is completed.
+	If 'flush_size' > 0, it sends CSV text after a row when length of text in Sqxc.buf >= 'flush_size'.
+	If SqxcCsvWriter doesn't have destination, CSV text is kept in Sqxc.buf until sqxc_ready().
+ */
+
+#ifdef __cplusplus
+struct SqxcCsvWriter : Sq::XcMethod      // <-- 1. inherit C++ member function(method)
+#else
+struct SqxcCsvWriter
+#endif
+{
+	SQXC_MEMBERS;                        // <-- 2. inherit member variable
+
+	// ------ SqxcCsvWriter members ------  // <-- 3. Add variable and non-virtual function in derived struct.
+
+	// Sqxc.buf stores CSV text.
+	char         delimiter;       // default is ','
+	int          flush_size;      // 0 = send CSV text after it is completed.
+
+	const char  *root_name;
+	SqEntry     *root_entry;
+	uint16_t     outer_type;      // SQXC_TYPE_ARRAY and SQXC_TYPE_OBJECT that writer is in.
+
+	int          row_count;
+	int          row_start;       // position of current row in Sqxc.buf
+	int          col_count;
+	SqBuffer     header;          // header is written by the first row
+};
+
+// ----------------------------------------------------------------------------
+// C++ definitions: define C++ data, function, method, and others.
+
+#ifdef __cplusplus
+
+namespace Sq {
+
+/* All derived struct/class must be C++11 standard-layout. */
+
+struct XcCsvParser : SqxcCsvParser
+{
+	XcCsvParser() {
+		sqxc_init((Sqxc*)this, SQXC_INFO_CSV_PARSER);
+	}
+	~XcCsvParser() {
+		sqxc_final((Sqxc*)this);
+	}
+};
+
+struct XcCsvWriter : SqxcCsvWriter
+{
+	XcCsvWriter() {
+		sqxc_init((Sqxc*)this, SQXC_INFO_CSV_WRITER);
+	}
+	~XcCsvWriter() {
+		sqxc_final((Sqxc*)this);
+	}
+};
+
+};  // namespace Sq
+
+#endif  // __cplusplus
+
+#endif  // SQXC_CSV_H
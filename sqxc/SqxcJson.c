@@ -0,0 +1,856 @@
+/*
+ *   Copyright (C) 2023 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ * sqxclib is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include <errno.h>
+#include <limits.h>     // INT_MIN, INT_MAX
+#include <math.h>       // isfinite()
+#include <stdint.h>     // uintptr_t
+#include <stdlib.h>     // strtoll(), strtod()
+#include <string.h>     // memset()
+
+#include <SqError.h>
+#include <SqEntry.h>
+#include <SqUtil.h>
+#include <SqxcJson.h>
+
+#ifdef _MSC_VER
+#define strtoll      _strtoi64
+#endif
+
+/* ----------------------------------------------------------------------------
+	SqxcInfo functions - Middleware of input chain
+
+	(JSON string)
+	SQXC_TYPE_STR ---> SqxcJsonParser ---> SQXC_TYPE_xxxx
+ */
+
+// state of tokenizer
+enum {
+	SQXC_JSON_VALUE,          // expect value
+	SQXC_JSON_VALUE_OR_END,   // expect value or ']'
+	SQXC_JSON_KEY,            // expect key
+	SQXC_JSON_KEY_OR_END,     // expect key or '}'
+	SQXC_JSON_COLON,          // expect ':'
+	SQXC_JSON_NEXT,           // expect ',' or end of object/array
+	SQXC_JSON_STRING,
+	SQXC_JSON_ESCAPE,         // after '\'
+	SQXC_JSON_UNICODE,        // after '\u'
+	SQXC_JSON_NUMBER,
+	SQXC_JSON_LITERAL,        // true, false, null
+};
+
+#define SQXC_JSON_IS_SPACE(c)    ((c) == ' ' || (c) == '\n' || (c) == '\r' || (c) == '\t')
+#define SQXC_JSON_IS_NUMBER(c)   (((c) >= '0' && (c) <= '9') || (c) == '-' || (c) == '+' || (c) == '.' || (c) == 'e' || (c) == 'E')
+
+static void sqxc_json_parser_reset(SqxcJsonParser *xcjson)
+{
+	xcjson->state = SQXC_JSON_VALUE;
+	xcjson->depth = 0;
+	xcjson->surrogate = 0;
+	xcjson->buf_writed = 0;
+	xcjson->names.writed = 0;
+	xcjson->name_offset = -1;
+}
+
+// send data(arguments) from SqxcJsonParser(source) to destination
+static void sqxc_json_parser_emit(SqxcJsonParser *xcjson, int type, int name_offset)
+{
+	Sqxc *xcdest = xcjson->dest;
+
+	xcjson->type = type;
+	xcjson->name = (name_offset < 0) ? NULL : xcjson->names.mem + name_offset;
+	xcdest->info->send(xcdest, (Sqxc*)xcjson);
+}
+
+// current value has been completed. decide next state.
+static void sqxc_json_parser_value_end(SqxcJsonParser *xcjson)
+{
+	// discard name of value
+	if (xcjson->name_offset >= 0)
+		xcjson->names.writed = xcjson->name_offset;
+	xcjson->name_offset = -1;
+	xcjson->state = (xcjson->depth > 0) ? SQXC_JSON_NEXT : SQXC_JSON_VALUE;
+}
+
+static void sqxc_json_parser_push(SqxcJsonParser *xcjson, int is_array)
+{
+	if (xcjson->depth == xcjson->stack_size) {
+		xcjson->stack_size = (xcjson->stack_size) ? xcjson->stack_size * 2 : 16;
+		xcjson->stack = realloc(xcjson->stack, sizeof(int) * xcjson->stack_size);
+	}
+	// name_offset is -1 if it has no name
+	xcjson->stack[xcjson->depth++] = xcjson->name_offset * 2 | is_array;
+	xcjson->name_offset = -1;
+
+	sqxc_json_parser_emit(xcjson, (is_array) ? SQXC_TYPE_ARRAY : SQXC_TYPE_OBJECT,
+	                      (xcjson->stack[xcjson->depth -1] - is_array) / 2);
+	xcjson->value.pointer = NULL;
+	xcjson->state = (is_array) ? SQXC_JSON_VALUE_OR_END : SQXC_JSON_KEY_OR_END;
+}
+
+static int  sqxc_json_parser_pop(SqxcJsonParser *xcjson, int is_array)
+{
+	int  top;
+
+	top = xcjson->stack[xcjson->depth -1];
+	if ((top & 1) != is_array)
+		return SQCODE_JSON_ERROR;
+	xcjson->depth--;
+
+	xcjson->value.pointer = NULL;
+	sqxc_json_parser_emit(xcjson, (is_array) ? SQXC_TYPE_ARRAY_END : SQXC_TYPE_OBJECT_END, (top - is_array) / 2);
+	// object/array is value of outer object/array
+	xcjson->name_offset = (top - is_array) / 2;
+	sqxc_json_parser_value_end(xcjson);
+	return SQCODE_OK;
+}
+
+static int  sqxc_json_parser_number(SqxcJsonParser *xcjson)
+{
+	char      *end;
+	long long  number;
+	int        is_integer = 1;
+
+	xcjson->buf[xcjson->buf_writed] = 0;
+	for (end = xcjson->buf;  *end;  end++) {
+		if (*end == '.' || *end == 'e' || *end == 'E') {
+			is_integer = 0;
+			break;
+		}
+	}
+
+	if (is_integer) {
+		errno = 0;
+		number = strtoll(xcjson->buf, &end, 10);
+		if (*end != 0)
+			return SQCODE_JSON_ERROR;
+		if (errno == 0) {
+			if (number >= INT_MIN && number <= INT_MAX) {
+				xcjson->value.integer = (int)number;
+				sqxc_json_parser_emit(xcjson, SQXC_TYPE_INT, xcjson->name_offset);
+			}
+			else {
+				xcjson->value.int64 = number;
+				sqxc_json_parser_emit(xcjson, SQXC_TYPE_INT64, xcjson->name_offset);
+			}
+			goto done;
+		}
+		// out of range of int64_t, use double
+	}
+
+	xcjson->value.double_ = strtod(xcjson->buf, &end);
+	if (*end != 0)
+		return SQCODE_JSON_ERROR;
+	sqxc_json_parser_emit(xcjson, SQXC_TYPE_DOUBLE, xcjson->name_offset);
+
+done:
+	xcjson->buf_writed = 0;
+	sqxc_json_parser_value_end(xcjson);
+	return SQCODE_OK;
+}
+
+// write Unicode code point as UTF-8
+static void sqxc_json_parser_utf8(SqBuffer *buffer, int code)
+{
+	char *mem;
+
+	if (code < 0x80)
+		sq_buffer_write_c(buffer, (char)code);
+	else if (code < 0x800) {
+		mem = sq_buffer_alloc(buffer, 2);
+		mem[0] = (char)(0xC0 | (code >> 6));
+		mem[1] = (char)(0x80 | (code & 0x3F));
+	}
+	else if (code < 0x10000) {
+		mem = sq_buffer_alloc(buffer, 3);
+		mem[0] = (char)(0xE0 | (code >> 12));
+		mem[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+		mem[2] = (char)(0x80 | (code & 0x3F));
+	}
+	else {
+		mem = sq_buffer_alloc(buffer, 4);
+		mem[0] = (char)(0xF0 | (code >> 18));
+		mem[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+		mem[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+		mem[3] = (char)(0x80 | (code & 0x3F));
+	}
+}
+
+// return SQCODE_OK, SQCODE_JSON_CONTINUE, or SQCODE_JSON_ERROR
+static int  sqxc_json_parser_parse(SqxcJsonParser *xcjson, const char *cur)
+{
+	SqBuffer   *buffer;
+	const char *beg;
+	int         ch;
+
+	for (;;) {
+		switch (xcjson->state) {
+		case SQXC_JSON_VALUE:
+		case SQXC_JSON_VALUE_OR_END:
+			while (SQXC_JSON_IS_SPACE(*cur))
+				cur++;
+			ch = *cur++;
+			switch (ch) {
+			case 0:
+				if (xcjson->depth == 0 && xcjson->state == SQXC_JSON_VALUE)
+					return SQCODE_OK;
+				return SQCODE_JSON_CONTINUE;
+			case '{':
+				sqxc_json_parser_push(xcjson, 0);
+				break;
+			case '[':
+				sqxc_json_parser_push(xcjson, 1);
+				break;
+			case ']':
+				if (xcjson->state != SQXC_JSON_VALUE_OR_END)
+					return SQCODE_JSON_ERROR;
+				if (sqxc_json_parser_pop(xcjson, 1) != SQCODE_OK)
+					return SQCODE_JSON_ERROR;
+				break;
+			case '"':
+				xcjson->state_key = 0;
+				xcjson->state = SQXC_JSON_STRING;
+				break;
+			case 't':
+				xcjson->literal = "true";
+				goto literal;
+			case 'f':
+				xcjson->literal = "false";
+				goto literal;
+			case 'n':
+				xcjson->literal = "null";
+			literal:
+				xcjson->literal_index = 1;
+				xcjson->state = SQXC_JSON_LITERAL;
+				break;
+			default:
+				if ((ch >= '0' && ch <= '9') || ch == '-') {
+					xcjson->buf_writed = 0;
+					sq_buffer_write_c(sqxc_get_buffer(xcjson), (char)ch);
+					xcjson->state = SQXC_JSON_NUMBER;
+					break;
+				}
+				return SQCODE_JSON_ERROR;
+			}
+			break;
+
+		case SQXC_JSON_KEY:
+		case SQXC_JSON_KEY_OR_END:
+			while (SQXC_JSON_IS_SPACE(*cur))
+				cur++;
+			ch = *cur++;
+			if (ch == '"') {
+				xcjson->state_key = 1;
+				xcjson->name_offset = xcjson->names.writed;
+				xcjson->state = SQXC_JSON_STRING;
+			}
+			else if (ch == '}' && xcjson->state == SQXC_JSON_KEY_OR_END) {
+				if (sqxc_json_parser_pop(xcjson, 0) != SQCODE_OK)
+					return SQCODE_JSON_ERROR;
+			}
+			else if (ch == 0)
+				return SQCODE_JSON_CONTINUE;
+			else
+				return SQCODE_JSON_ERROR;
+			break;
+
+		case SQXC_JSON_COLON:
+			while (SQXC_JSON_IS_SPACE(*cur))
+				cur++;
+			ch = *cur++;
+			if (ch == ':')
+				xcjson->state = SQXC_JSON_VALUE;
+			else if (ch == 0)
+				return SQCODE_JSON_CONTINUE;
+			else
+				return SQCODE_JSON_ERROR;
+			break;
+
+		case SQXC_JSON_NEXT:
+			while (SQXC_JSON_IS_SPACE(*cur))
+				cur++;
+			ch = *cur++;
+			switch (ch) {
+			case 0:
+				return SQCODE_JSON_CONTINUE;
+			case ',':
+				if (xcjson->stack[xcjson->depth -1] & 1)
+					xcjson->state = SQXC_JSON_VALUE;
+				else
+					xcjson->state = SQXC_JSON_KEY;
+				break;
+			case ']':
+			case '}':
+				if (sqxc_json_parser_pop(xcjson, ch == ']') != SQCODE_OK)
+					return SQCODE_JSON_ERROR;
+				break;
+			default:
+				return SQCODE_JSON_ERROR;
+			}
+			break;
+
+		case SQXC_JSON_STRING:
+			buffer = (xcjson->state_key) ? &xcjson->names : sqxc_get_buffer(xcjson);
+			// high surrogate without low surrogate
+			if (xcjson->surrogate && *cur != '\\' && *cur != 0) {
+				sqxc_json_parser_utf8(buffer, 0xFFFD);
+				xcjson->surrogate = 0;
+			}
+			// copy characters until quotation mark or reverse solidus
+			for (beg = cur;  *cur != '"' && *cur != '\\' && *cur != 0;  cur++) {
+				if ((unsigned char)*cur < 0x20)
+					return SQCODE_JSON_ERROR;
+			}
+			if (cur > beg)
+				sq_buffer_write_n(buffer, beg, (int)(cur - beg));
+			ch = *cur++;
+			if (ch == 0)
+				return SQCODE_JSON_CONTINUE;
+			if (ch == '\\') {
+				xcjson->state = SQXC_JSON_ESCAPE;
+				break;
+			}
+			// end of string. sq_buffer_alloc(buffer, 0) reserves space for null-terminated.
+			*sq_buffer_alloc(buffer, 0) = 0;
+			if (xcjson->state_key) {
+				buffer->writed++;    // keep null-terminated in 'names'
+				xcjson->state = SQXC_JSON_COLON;
+				break;
+			}
+			xcjson->value.str = buffer->mem;
+			sqxc_json_parser_emit(xcjson, SQXC_TYPE_STR, xcjson->name_offset);
+			buffer->writed = 0;
+			sqxc_json_parser_value_end(xcjson);
+			break;
+
+		case SQXC_JSON_ESCAPE:
+			buffer = (xcjson->state_key) ? &xcjson->names : sqxc_get_buffer(xcjson);
+			ch = *cur++;
+			switch (ch) {
+			case 0:
+				return SQCODE_JSON_CONTINUE;
+			case '"':
+			case '\\':
+			case '/':
+				break;
+			case 'b':
+				ch = '\b';
+				break;
+			case 'f':
+				ch = '\f';
+				break;
+			case 'n':
+				ch = '\n';
+				break;
+			case 'r':
+				ch = '\r';
+				break;
+			case 't':
+				ch = '\t';
+				break;
+			case 'u':
+				xcjson->unicode = 0;
+				xcjson->unicode_count = 0;
+				xcjson->state = SQXC_JSON_UNICODE;
+				continue;
+			default:
+				return SQCODE_JSON_ERROR;
+			}
+			if (xcjson->surrogate) {
+				sqxc_json_parser_utf8(buffer, 0xFFFD);
+				xcjson->surrogate = 0;
+			}
+			sq_buffer_write_c(buffer, (char)ch);
+			xcjson->state = SQXC_JSON_STRING;
+			break;
+
+		case SQXC_JSON_UNICODE:
+			for (;  xcjson->unicode_count < 4;  xcjson->unicode_count++) {
+				ch = *cur++;
+				if (ch >= '0' && ch <= '9')
+					ch = ch - '0';
+				else if (ch >= 'a' && ch <= 'f')
+					ch = ch - 'a' + 10;
+				else if (ch >= 'A' && ch <= 'F')
+					ch = ch - 'A' + 10;
+				else if (ch == 0)
+					return SQCODE_JSON_CONTINUE;
+				else
+					return SQCODE_JSON_ERROR;
+				xcjson->unicode = (xcjson->unicode << 4) | ch;
+			}
+			buffer = (xcjson->state_key) ? &xcjson->names : sqxc_get_buffer(xcjson);
+			ch = xcjson->unicode;
+			if (ch >= 0xD800 && ch <= 0xDBFF) {
+				// high surrogate, wait for low surrogate
+				if (xcjson->surrogate)
+					sqxc_json_parser_utf8(buffer, 0xFFFD);
+				xcjson->surrogate = ch;
+			}
+			else if (ch >= 0xDC00 && ch <= 0xDFFF && xcjson->surrogate) {
+				ch = 0x10000 + ((xcjson->surrogate - 0xD800) << 10) + (ch - 0xDC00);
+				sqxc_json_parser_utf8(buffer, ch);
+				xcjson->surrogate = 0;
+			}
+			else {
+				if (xcjson->surrogate)
+					sqxc_json_parser_utf8(buffer, 0xFFFD);
+				xcjson->surrogate = 0;
+				sqxc_json_parser_utf8(buffer, ch);
+			}
+			xcjson->state = SQXC_JSON_STRING;
+			break;
+
+		case SQXC_JSON_NUMBER:
+			for (beg = cur;  SQXC_JSON_IS_NUMBER(*cur);  cur++)
+				;
+			if (cur > beg)
+				sq_buffer_write_n(sqxc_get_buffer(xcjson), beg, (int)(cur - beg));
+			// number at top level is completed at the end of string
+			if (*cur == 0 && xcjson->depth > 0)
+				return SQCODE_JSON_CONTINUE;
+			if (sqxc_json_parser_number(xcjson) != SQCODE_OK)
+				return SQCODE_JSON_ERROR;
+			break;
+
+		case SQXC_JSON_LITERAL:
+			for (;  xcjson->literal[xcjson->literal_index];  xcjson->literal_index++, cur++) {
+				if (*cur == 0)
+					return SQCODE_JSON_CONTINUE;
+				if (*cur != xcjson->literal[xcjson->literal_index])
+					return SQCODE_JSON_ERROR;
+			}
+			switch (xcjson->literal[0]) {
+			case 't':
+			case 'f':
+				xcjson->value.boolean = (xcjson->literal[0] == 't');
+				sqxc_json_parser_emit(xcjson, SQXC_TYPE_BOOL, xcjson->name_offset);
+				break;
+			default:
+				xcjson->value.pointer = NULL;
+				sqxc_json_parser_emit(xcjson, SQXC_TYPE_NULL, xcjson->name_offset);
+				break;
+			}
+			sqxc_json_parser_value_end(xcjson);
+			break;
+		}
+	}
+}
+
+static int  sqxc_json_parser_send(SqxcJsonParser *xcjson, Sqxc *src)
+{
+	int  code;
+
+	// end of data. It is incomplete if object/array, string, or literal is not closed.
+	if (src->value.str == NULL) {
+		if (xcjson->state == SQXC_JSON_NUMBER && xcjson->depth == 0) {
+			if (sqxc_json_parser_number(xcjson) != SQCODE_OK) {
+				sqxc_json_parser_reset(xcjson);
+				return (src->code = SQCODE_JSON_ERROR);
+			}
+		}
+		if (xcjson->depth > 0 || xcjson->state != SQXC_JSON_VALUE)
+			return (src->code = SQCODE_JSON_CONTINUE);
+		return (src->code = SQCODE_OK);
+	}
+
+	// start of new JSON document. keep name of top level value in 'names'.
+	if (xcjson->depth == 0 && xcjson->state == SQXC_JSON_VALUE) {
+		xcjson->names.writed = 0;
+		if (src->name) {
+			xcjson->name_offset = 0;
+			sq_buffer_write(&xcjson->names, src->name);
+			xcjson->names.writed++;    // keep null-terminated
+		}
+		else
+			xcjson->name_offset = -1;
+	}
+
+	code = sqxc_json_parser_parse(xcjson, src->value.str);
+	if (code == SQCODE_JSON_ERROR)
+		sqxc_json_parser_reset(xcjson);
+	return (src->code = code);
+}
+
+static int  sqxc_json_parser_ctrl(SqxcJsonParser *xcjson, int id, void *data)
+{
+	switch(id) {
+	case SQXC_CTRL_READY:
+		sqxc_json_parser_reset(xcjson);
+		break;
+
+	case SQXC_CTRL_FINISH:
+		sqxc_json_parser_reset(xcjson);
+		// clear SqxcNested if problem occurred during processing
+		sqxc_clear_nested((Sqxc*)xcjson);
+		break;
+
+	default:
+		return SQCODE_NOT_SUPPORT;
+	}
+
+	return SQCODE_OK;
+}
+
+static void  sqxc_json_parser_init(SqxcJsonParser *xcjson)
+{
+//	memset(xcjson, 0, sizeof(SqxcJsonParser));
+	xcjson->supported_type = SQXC_TYPE_STR;
+	sq_buffer_init(&xcjson->names);
+	xcjson->name_offset = -1;
+}
+
+static void  sqxc_json_parser_final(SqxcJsonParser *xcjson)
+{
+	sq_buffer_final(&xcjson->names);
+	free(xcjson->stack);
+}
+
+/* ----------------------------------------------------------------------------
+	SqxcInfo functions - Middleware of output chain
+
+	SQXC_TYPE_xxxx ---> SqxcJsonWriter ---> SQXC_TYPE_STR
+	                                        (JSON string)
+ */
+
+struct SqxcJsonKey
+{
+	const SqEntry *entry;
+	const char    *name;
+	int            offset;        // offset of quoted key in 'keys_buf'
+	int            length;
+};
+
+static const char  sqxc_json_hex[] = "0123456789abcdef";
+
+void  sqxc_json_write_string(SqBuffer *buffer, const char *string)
+{
+	const char *beg;
+	char       *mem;
+	int         ch;
+
+	if (string == NULL) {
+		sq_buffer_write_n(buffer, "null", 4);
+		return;
+	}
+
+	sq_buffer_write_c(buffer, '"');
+	for (;;) {
+		// copy characters that don't need escape
+		beg = string;
+		string = sq_str_find_json_escape(string);
+		ch = *(unsigned char*)string;
+		if (string > beg)
+			sq_buffer_write_n(buffer, beg, (int)(string - beg));
+		if (ch == 0)
+			break;
+
+		switch (ch) {
+		case '"':
+		case '\\':
+			break;
+		case '\b':
+			ch = 'b';
+			break;
+		case '\f':
+			ch = 'f';
+			break;
+		case '\n':
+			ch = 'n';
+			break;
+		case '\r':
+			ch = 'r';
+			break;
+		case '\t':
+			ch = 't';
+			break;
+		default:
+			mem = sq_buffer_alloc(buffer, 6);
+			mem[0] = '\\';
+			mem[1] = 'u';
+			mem[2] = '0';
+			mem[3] = '0';
+			mem[4] = sqxc_json_hex[ch >> 4];
+			mem[5] = sqxc_json_hex[ch & 0xF];
+			string++;
+			continue;
+		}
+		mem = sq_buffer_alloc(buffer, 2);
+		mem[0] = '\\';
+		mem[1] = (char)ch;
+		string++;
+	}
+	sq_buffer_write_c(buffer, '"');
+}
+
+// write "name": to tail of buffer
+static void sqxc_json_writer_key(SqxcJsonWriter *xcjson, Sqxc *src)
+{
+	SqBuffer    *buffer = sqxc_get_buffer(xcjson);
+	SqxcJsonKey *key;
+	SqxcJsonKey *old_keys;
+	int          old_size;
+	int          index;
+	int          len;
+
+	// key can be cached if src->name is name of src->entry
+	if (src->entry == NULL || src->entry->name != src->name) {
+		sqxc_json_write_string(buffer, src->name ? src->name : "");
+		sq_buffer_write_c(buffer, ':');
+		return;
+	}
+
+	for (;;) {
+		if (xcjson->keys_size) {
+			index = (int)(((uintptr_t)src->entry >> 3) * 2654435761u) & (xcjson->keys_size - 1);
+			for (;;  index = (index + 1) & (xcjson->keys_size - 1)) {
+				key = xcjson->keys + index;
+				if (key->entry == NULL)
+					break;
+				if (key->entry == src->entry && key->name == src->name) {
+					// write cached key
+					memcpy(sq_buffer_alloc(buffer, key->length),
+					       xcjson->keys_buf.mem + key->offset, key->length);
+					return;
+				}
+			}
+			if (xcjson->keys_count * 4 < xcjson->keys_size * 3)
+				break;
+		}
+		// grow hash table and insert old keys again
+		old_keys = xcjson->keys;
+		old_size = xcjson->keys_size;
+		xcjson->keys_size = (old_size) ? old_size * 2 : 64;
+		xcjson->keys = calloc(xcjson->keys_size, sizeof(SqxcJsonKey));
+		for (index = 0;  index < old_size;  index++) {
+			if (old_keys[index].entry == NULL)
+				continue;
+			len = (int)(((uintptr_t)old_keys[index].entry >> 3) * 2654435761u) & (xcjson->keys_size - 1);
+			while (xcjson->keys[len].entry)
+				len = (len + 1) & (xcjson->keys_size - 1);
+			xcjson->keys[len] = old_keys[index];
+		}
+		free(old_keys);
+	}
+
+	// add new key to cache
+	len = xcjson->keys_buf.writed;
+	sqxc_json_write_string(&xcjson->keys_buf, src->name);
+	sq_buffer_write_c(&xcjson->keys_buf, ':');
+	key->entry  = src->entry;
+	key->name   = src->name;
+	key->offset = len;
+	key->length = xcjson->keys_buf.writed - len;
+	xcjson->keys_count++;
+	memcpy(sq_buffer_alloc(buffer, key->length), xcjson->keys_buf.mem + len, key->length);
+}
+
+// send JSON string in Sqxc.buf to destination
+static void sqxc_json_writer_flush(SqxcJsonWriter *xcjson)
+{
+	Sqxc *xcdest = xcjson->dest;
+
+	if (xcdest == NULL)
+		return;
+	*sq_buffer_alloc(sqxc_get_buffer(xcjson), 0) = 0;    // null-terminated
+	xcjson->type = SQXC_TYPE_STR;
+	xcjson->name = xcjson->root_name;
+	xcjson->entry = xcjson->root_entry;
+	xcjson->value.str = xcjson->buf;
+	xcdest->info->send(xcdest, (Sqxc*)xcjson);
+	xcjson->buf_writed = 0;
+}
+
+static int  sqxc_json_writer_send(SqxcJsonWriter *xcjson, Sqxc *src)
+{
+	SqBuffer *buffer = sqxc_get_buffer(xcjson);
+	int       type = src->type;
+
+	if (xcjson->nested_count == 0) {
+		if (type & SQXC_TYPE_END)
+			return (src->code = SQCODE_TYPE_END_ERROR);
+		// start of new JSON string
+		xcjson->buf_writed = 0;
+		xcjson->comma = 0;
+		xcjson->root_name = src->name;
+		xcjson->root_entry = src->entry;
+	}
+	else {
+		// skip hidden object/array and all of its members
+		if (xcjson->skip) {
+			if (type == SQXC_TYPE_OBJECT || type == SQXC_TYPE_ARRAY) {
+				sqxc_push_nested((Sqxc*)xcjson);
+				xcjson->skip++;
+			}
+			else if (type & SQXC_TYPE_END) {
+				sqxc_pop_nested((Sqxc*)xcjson);
+				xcjson->skip--;
+			}
+			return (src->code = SQCODE_OK);
+		}
+		// SQB_HIDDEN and SQB_HIDDEN_NULL are applied to members only.
+		// Top level value may be JSON column in SQL output chain.
+		if (src->entry && (type & SQXC_TYPE_END) == 0) {
+			if (src->entry->bit_field & SQB_HIDDEN ||
+			    (src->entry->bit_field & SQB_HIDDEN_NULL &&
+			     (type == SQXC_TYPE_NULL || (type == SQXC_TYPE_STR && src->value.str == NULL))))
+			{
+				if (type == SQXC_TYPE_OBJECT || type == SQXC_TYPE_ARRAY) {
+					sqxc_push_nested((Sqxc*)xcjson);
+					xcjson->skip = 1;
+				}
+				return (src->code = SQCODE_OK);
+			}
+		}
+	}
+
+	if (type & SQXC_TYPE_END) {
+		sqxc_pop_nested((Sqxc*)xcjson);
+		sq_buffer_write_c(buffer, (type == SQXC_TYPE_OBJECT_END) ? '}' : ']');
+		xcjson->comma = 1;
+	}
+	else {
+		if (xcjson->comma)
+			sq_buffer_write_c(buffer, ',');
+		xcjson->comma = 1;
+		// member of object has name. element of array doesn't have name.
+		if (xcjson->nested_count > 0 && xcjson->nested->data2 == (void*)(intptr_t)SQXC_TYPE_OBJECT)
+			sqxc_json_writer_key(xcjson, src);
+
+		switch (type) {
+		case SQXC_TYPE_NULL:
+			sq_buffer_write_n(buffer, "null", 4);
+			break;
+
+		case SQXC_TYPE_BOOL:
+			if (src->value.boolean)
+				sq_buffer_write_n(buffer, "true", 4);
+			else
+				sq_buffer_write_n(buffer, "false", 5);
+			break;
+
+		case SQXC_TYPE_INT:
+			sq_buffer_write_int64(buffer, src->value.integer);
+			break;
+
+		case SQXC_TYPE_UINT:
+			sq_buffer_write_uint64(buffer, src->value.uinteger);
+			break;
+
+		case SQXC_TYPE_INT64:
+			sq_buffer_write_int64(buffer, src->value.int64);
+			break;
+
+		case SQXC_TYPE_UINT64:
+			sq_buffer_write_uint64(buffer, src->value.uint64);
+			break;
+
+		case SQXC_TYPE_TIME:
+			sq_buffer_write_int64(buffer, (int64_t)src->value.rawtime);
+			break;
+
+		case SQXC_TYPE_DOUBLE:
+			// JSON doesn't support NaN and Infinity
+			if (isfinite(src->value.double_))
+				sq_buffer_write_double(buffer, src->value.double_);
+			else
+				sq_buffer_write_n(buffer, "null", 4);
+			break;
+
+		case SQXC_TYPE_STR:
+			sqxc_json_write_string(buffer, src->value.str);
+			break;
+
+		case SQXC_TYPE_OBJECT:
+		case SQXC_TYPE_ARRAY:
+			sqxc_push_nested((Sqxc*)xcjson)->data2 = (void*)(intptr_t)type;
+			sq_buffer_write_c(buffer, (type == SQXC_TYPE_OBJECT) ? '{' : '[');
+			xcjson->comma = 0;
+			break;
+
+		default:
+			xcjson->comma = 0;
+			return (src->code = SQCODE_TYPE_NOT_SUPPORT);
+		}
+	}
+
+	// End of JSON string
+	if (xcjson->nested_count == 0)
+		sqxc_json_writer_flush(xcjson);
+	else if (xcjson->flush_size > 0 && xcjson->buf_writed >= xcjson->flush_size)
+		sqxc_json_writer_flush(xcjson);
+
+	return (src->code = SQCODE_OK);
+}
+
+static int  sqxc_json_writer_ctrl(SqxcJsonWriter *xcjson, int id, void *data)
+{
+	switch(id) {
+	case SQXC_CTRL_READY:
+		xcjson->comma = 0;
+		xcjson->skip = 0;
+		// clear cache of quoted key because SqEntry may be freed after sqxc_finish()
+		if (xcjson->keys_count) {
+			memset(xcjson->keys, 0, sizeof(SqxcJsonKey) * xcjson->keys_size);
+			xcjson->keys_count = 0;
+			xcjson->keys_buf.writed = 0;
+		}
+		break;
+
+	case SQXC_CTRL_FINISH:
+		xcjson->skip = 0;
+		// clear SqxcNested if problem occurred during processing
+		sqxc_clear_nested((Sqxc*)xcjson);
+		break;
+
+	default:
+		return SQCODE_NOT_SUPPORT;
+	}
+
+	return SQCODE_OK;
+}
+
+static void  sqxc_json_writer_init(SqxcJsonWriter *xcjson)
+{
+//	memset(xcjson, 0, sizeof(SqxcJsonWriter));
+	xcjson->supported_type = SQXC_TYPE_ALL;
+	sq_buffer_init(&xcjson->keys_buf);
+}
+
+static void  sqxc_json_writer_final(SqxcJsonWriter *xcjson)
+{
+	sq_buffer_final(&xcjson->keys_buf);
+	free(xcjson->keys);
+}
+
+// ----------------------------------------------------------------------------
+// SqxcInfo
+
+const SqxcInfo SqxcInfo_JsonParser_ =
+{
+	sizeof(SqxcJsonParser),
+	(SqInitFunc)sqxc_json_parser_init,
+	(SqFinalFunc)sqxc_json_parser_final,
+	(SqxcCtrlFunc)sqxc_json_parser_ctrl,
+	(SqxcSendFunc)sqxc_json_parser_send,
+};
+
+const SqxcInfo SqxcInfo_JsonWriter_ =
+{
+	sizeof(SqxcJsonWriter),
+	(SqInitFunc)sqxc_json_writer_init,
+	(SqFinalFunc)sqxc_json_writer_final,
+	(SqxcCtrlFunc)sqxc_json_writer_ctrl,
+	(SqxcSendFunc)sqxc_json_writer_send,
+};
@@ -0,0 +1,232 @@
+/*
+ *   Copyright (C) 2023 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ * sqxclib is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+
+#ifndef SQXC_JSON_H
+#define SQXC_JSON_H
+
+#include <SqBuffer.h>
+#include <Sqxc.h>
+
+// ----------------------------------------------------------------------------
+// C/C++ common declarations: declare type, structure, macro, enumeration.
+
+typedef struct SqxcJsonParser   SqxcJsonParser;
+typedef struct SqxcJsonWriter   SqxcJsonWriter;
+typedef struct SqxcJsonKey      SqxcJsonKey;       // defined in SqxcJson.c
+
+// ----------------------------------------------------------------------------
+// C declarations: declare C data, function, and others.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const SqxcInfo               SqxcInfo_JsonParser_;
+extern const SqxcInfo               SqxcInfo_JsonWriter_;
+#define SQXC_INFO_JSON_PARSER     (&SqxcInfo_JsonParser_)
+#define SQXC_INFO_JSON_WRITER     (&SqxcInfo_JsonWriter_)
+
+#define sqxc_json_parser_new()         sqxc_new(SQXC_INFO_JSON_PARSER)
+#define sqxc_json_writer_new()         sqxc_new(SQXC_INFO_JSON_WRITER)
+
+// write JSON string (with quotation marks) to tail of 'buffer'. If 'string' is NULL, write null.
+void  sqxc_json_write_string(SqBuffer *buffer, const char *string);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+// ----------------------------------------------------------------------------
+// C/C++ common definitions: define structure
+
+/*	SqxcJsonParser - JSON parser in input chain. It doesn't depend on json-c.
+
+	Sqxc
+	|
+	`--- SqxcJsonParser
+
+	*** In input chain:
+	SQXC_TYPE_STR ---> SqxcJsonParser ---> SQXC_TYPE_xxxx
+	(JSON string)
+
+	SqxcJsonParser tokenizes JSON string and sends SQXC_TYPE_xxxx to destination directly.
+	It doesn't build JSON tree in memory.
+
+	JSON string can be sent in several pieces. If JSON is incomplete,
+	SqxcJsonParser returns SQCODE_JSON_CONTINUE and keeps its state until next piece arrives.
+	Number at top level is completed at the end of each piece.
+	Sending NULL string means end of data. It returns SQCODE_JSON_CONTINUE if JSON is still incomplete.
+	sqxc_ready() and sqxc_finish() reset state of parser.
+
+
+   The correct way to derive Sqxc:  (conforming C++11 standard-layout)
+   1. Use Sq::XcMethod to inherit member function(method).
+   2. Use SQXC_MEMBERS to inherit member variable.
+   3. Add variable and non-virtual function in derived struct.
+   ** This can keep std::is_standard_layout<>::value == true
+ */
+
+#ifdef __cplusplus
+struct SqxcJsonParser : Sq::XcMethod     // <-- 1. inherit C++ member function(method)
+#else
+struct SqxcJsonParser
+#endif
+{
+	SQXC_MEMBERS;                        // <-- 2. inherit member variable
+/*	// ------ Sqxc members ------
+	const SqxcInfo  *info;
+
+	// Sqxc chain
+	Sqxc        *peer;     // pointer to other Sqxc elements (single linked list)
+	Sqxc        *dest;     // pointer to current destination in Sqxc chain (data flow)
+
+	// stack of SqxcNested
+	SqxcNested  *nested;          // current nested object/array
+	int          nested_count;
+
+	// ------------------------------------------
+	// Buffer - common buffer for type conversion. To resize this buf:
+	// buf = realloc(buf, buf_size);
+
+//	SQ_BUFFER_MEMBERS(buf, buf_size, buf_writed);
+	char        *buf;
+	int          buf_size;
+	int          buf_writed;
+
+	// ------------------------------------------
+	// properties
+
+	uint16_t     supported_type;  // supported SqxcType (bit field) for inputting, it can change at runtime.
+//	uint16_t     outputable_type; // supported SqxcType (bit field) for outputting, it can change at runtime.
+
+	// ------------------------------------------
+	// arguments that used by SqxcInfo->send()
+
+	// output arguments
+//	uint16_t     required_type;   // required SqxcType (bit field) if 'code' == SQCODE_TYPE_NOT_MATCH
+	uint16_t     code;            // error code (SQCODE_xxxx)
+
+	// input arguments
+	uint16_t     type;            // input SqxcType
+	const char  *name;
+	SqValue      value;           // union SqValue defined in SqDefine.h
+
+	// special input arguments
+	SqEntry     *entry;           // SqxcJsonc and SqxcSql use it to decide output. this can be NULL (optional).
+
+	// input / output arguments
+	void       **error;
+ */
+
+	// ------ SqxcJsonParser members ------  // <-- 3. Add variable and non-virtual function in derived struct.
+
+	// Sqxc.buf stores current string or number token.
+	// 'names' stores names of nested objects/arrays and current key.
+	SqBuffer     names;
+	int          name_offset;     // offset of name of current value in 'names', -1 if no name.
+
+	// stack of nested objects/arrays. element = offset of name * 2 + is_array
+	int         *stack;
+	int          stack_size;
+	int          depth;
+
+	// state of tokenizer
+	int          state;
+	int          state_key;       // current string is key
+	const char  *literal;         // "true", "false", or "null"
+	int          literal_index;
+	int          unicode;         // \uXXXX
+	int          unicode_count;
+	int          surrogate;       // high surrogate of UTF-16
+};
+
+/*	SqxcJsonWriter - JSON writer in output chain. It doesn't depend on json-c.
+
+	Sqxc
+	|
+	`--- SqxcJsonWriter
+
+	*** In output chain:
+	SQXC_TYPE_xxxx ---> SqxcJsonWriter ---> SQXC_TYPE_STR
+	                                        (JSON string)
+
+	SqxcJsonWriter appends JSON text to Sqxc.buf directly. It doesn't build JSON tree in memory.
+	When JSON is completed, it sends JSON string to destination.
+	If 'flush_size' > 0, it sends JSON string in pieces when length of text in Sqxc.buf >= 'flush_size'.
+	  e.g. send pieces to SqxcFile while writing big container.
+
+	Quoted key ("name":) of SqEntry is cached between sqxc_ready() and sqxc_finish().
+	Members of object that have SQB_HIDDEN are skipped. They are skipped if
+	they have SQB_HIDDEN_NULL and their value is NULL.
+ */
+
+#ifdef __cplusplus
+struct SqxcJsonWriter : Sq::XcMethod     // <-- 1. inherit C++ member function(method)
+#else
+struct SqxcJsonWriter
+#endif
+{
+	SQXC_MEMBERS;                        // <-- 2. inherit member variable
+
+	// ------ SqxcJsonWriter members ------  // <-- 3. Add variable and non-virtual function in derived struct.
+
+	// Sqxc.buf stores JSON text.
+	int          flush_size;      // 0 = send JSON string after it is completed.
+
+	const char  *root_name;
+	SqEntry     *root_entry;
+	int          comma;           // write ',' before next value
+	int          skip;            // depth of skipped (hidden) object/array
+
+	// cache of quoted key. It is cleared by sqxc_ready()
+	SqxcJsonKey *keys;
+	int          keys_size;       // power of 2
+	int          keys_count;
+	SqBuffer     keys_buf;
+};
+
+// ----------------------------------------------------------------------------
+// C++ definitions: define C++ data, function, method, and others.
+
+#ifdef __cplusplus
+
+namespace Sq {
+
+/* All derived struct/class must be C++11 standard-layout. */
+
+struct XcJsonParser : SqxcJsonParser
+{
+	XcJsonParser() {
+		sqxc_init((Sqxc*)this, SQXC_INFO_JSON_PARSER);
+	}
+	~XcJsonParser() {
+		sqxc_final((Sqxc*)this);
+	}
+};
+
+struct XcJsonWriter : SqxcJsonWriter
+{
+	XcJsonWriter() {
+		sqxc_init((Sqxc*)this, SQXC_INFO_JSON_WRITER);
+	}
+	~XcJsonWriter() {
+		sqxc_final((Sqxc*)this);
+	}
+};
+
+};  // namespace Sq
+
+#endif  // __cplusplus
+
+#endif  // SQXC_JSON_H
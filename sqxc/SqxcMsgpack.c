@@ -0,0 +1,907 @@
+/*
+ *   Copyright (C) 2023 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ * sqxclib is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+
+#include <limits.h>     // INT_MIN, INT_MAX
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>     // memcpy(), memmove()
+
+#include <SqError.h>
+#include <SqEntry.h>
+#include <SqxcMsgpack.h>
+
+struct SqxcMsgpackLevel
+{
+	int64_t  count;           // number of remaining items. map has 2 items (key and value) for each entry.
+	int      is_map;
+	int      name_offset;     // offset of name in 'names', -1 if no name.
+};
+
+// read big-endian integer
+#define SQ_MP_READ16(p)    (((uint32_t)(p)[0] << 8)  |  (uint32_t)(p)[1])
+#define SQ_MP_READ32(p)    (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) |  \
+                            ((uint32_t)(p)[2] << 8)  |  (uint32_t)(p)[3])
+#define SQ_MP_READ64(p)    (((uint64_t)SQ_MP_READ32(p) << 32) | (uint64_t)SQ_MP_READ32((p)+4))
+
+/* ----------------------------------------------------------------------------
+	SqxcInfo functions - Middleware of input chain
+
+	(MessagePack data)
+	SQXC_TYPE_RAW ---> SqxcMsgpack Parser ---> SQXC_TYPE_xxxx
+ */
+
+static void sqxc_msgpack_parser_reset(SqxcMsgpack *xcmp)
+{
+	xcmp->depth = 0;
+	xcmp->left.writed = 0;
+	xcmp->names.writed = 0;
+	xcmp->name_offset = -1;
+}
+
+// send data(arguments) from SqxcMsgpack(source) to destination
+static void sqxc_msgpack_parser_emit(SqxcMsgpack *xcmp, int type, int name_offset)
+{
+	Sqxc *xcdest = xcmp->dest;
+
+	xcmp->type = type;
+	xcmp->name = (name_offset < 0) ? NULL : xcmp->names.mem + name_offset;
+	xcdest->info->send(xcdest, (Sqxc*)xcmp);
+}
+
+// current value has been completed. Send end of map/array if they are completed.
+static void sqxc_msgpack_parser_value_end(SqxcMsgpack *xcmp)
+{
+	SqxcMsgpackLevel *level;
+
+	// discard name of value
+	if (xcmp->name_offset >= 0)
+		xcmp->names.writed = xcmp->name_offset;
+	xcmp->name_offset = -1;
+
+	while (xcmp->depth > 0) {
+		level = xcmp->stack + xcmp->depth -1;
+		if (--level->count > 0)
+			return;
+		xcmp->depth--;
+		xcmp->value.pointer = NULL;
+		sqxc_msgpack_parser_emit(xcmp, (level->is_map) ? SQXC_TYPE_OBJECT_END : SQXC_TYPE_ARRAY_END,
+		                         level->name_offset);
+		if (level->name_offset >= 0)
+			xcmp->names.writed = level->name_offset;
+	}
+}
+
+static void sqxc_msgpack_parser_scalar(SqxcMsgpack *xcmp, int type)
+{
+	sqxc_msgpack_parser_emit(xcmp, type, xcmp->name_offset);
+	sqxc_msgpack_parser_value_end(xcmp);
+}
+
+static void sqxc_msgpack_parser_int64(SqxcMsgpack *xcmp, int64_t value)
+{
+	if (value >= INT_MIN && value <= INT_MAX) {
+		xcmp->value.integer = (int)value;
+		sqxc_msgpack_parser_scalar(xcmp, SQXC_TYPE_INT);
+	}
+	else {
+		xcmp->value.int64 = value;
+		sqxc_msgpack_parser_scalar(xcmp, SQXC_TYPE_INT64);
+	}
+}
+
+static void sqxc_msgpack_parser_uint64(SqxcMsgpack *xcmp, uint64_t value)
+{
+	if (value > INT64_MAX) {
+		xcmp->value.uint64 = value;
+		sqxc_msgpack_parser_scalar(xcmp, SQXC_TYPE_UINT64);
+	}
+	else
+		sqxc_msgpack_parser_int64(xcmp, (int64_t)value);
+}
+
+static void sqxc_msgpack_parser_container(SqxcMsgpack *xcmp, int is_map, uint32_t n)
+{
+	SqxcMsgpackLevel *level;
+
+	xcmp->value.pointer = NULL;
+	sqxc_msgpack_parser_emit(xcmp, (is_map) ? SQXC_TYPE_OBJECT : SQXC_TYPE_ARRAY, xcmp->name_offset);
+	if (n == 0) {
+		sqxc_msgpack_parser_emit(xcmp, (is_map) ? SQXC_TYPE_OBJECT_END : SQXC_TYPE_ARRAY_END, xcmp->name_offset);
+		sqxc_msgpack_parser_value_end(xcmp);
+		return;
+	}
+
+	if (xcmp->depth == xcmp->stack_size) {
+		xcmp->stack_size = (xcmp->stack_size) ? xcmp->stack_size * 2 : 16;
+		xcmp->stack = realloc(xcmp->stack, sizeof(SqxcMsgpackLevel) * xcmp->stack_size);
+	}
+	level = xcmp->stack + xcmp->depth++;
+	level->count = (is_map) ? (int64_t)n * 2 : (int64_t)n;
+	level->is_map = is_map;
+	level->name_offset = xcmp->name_offset;
+	xcmp->name_offset = -1;
+}
+
+// get size of item. If header of item is incomplete, return size of header. return -1 if error.
+static int64_t  sqxc_msgpack_item_size(const uint8_t *p, size_t avail)
+{
+	uint32_t  length;
+	int       header;
+	int       ch = p[0];
+
+	// positive fixint, fixmap, fixarray, negative fixint
+	if (ch <= 0x9F || ch >= 0xE0)
+		return 1;
+	// fixstr
+	if ((ch & 0xE0) == 0xA0)
+		return 1 + (ch & 0x1F);
+
+	switch (ch) {
+	case 0xC0:    // nil
+	case 0xC2:    // false
+	case 0xC3:    // true
+		return 1;
+
+	case 0xCC:    // uint 8
+	case 0xD0:    // int 8
+		return 2;
+
+	case 0xCD:    // uint 16
+	case 0xD1:    // int 16
+	case 0xDC:    // array 16
+	case 0xDE:    // map 16
+		return 3;
+
+	case 0xCA:    // float 32
+	case 0xCE:    // uint 32
+	case 0xD2:    // int 32
+	case 0xDD:    // array 32
+	case 0xDF:    // map 32
+		return 5;
+
+	case 0xCB:    // float 64
+	case 0xCF:    // uint 64
+	case 0xD3:    // int 64
+		return 9;
+
+	case 0xD4:    // fixext 1
+	case 0xD5:    // fixext 2
+	case 0xD6:    // fixext 4
+	case 0xD7:    // fixext 8
+	case 0xD8:    // fixext 16
+		return 2 + (1 << (ch - 0xD4));
+
+	case 0xC4:    // bin 8
+	case 0xD9:    // str 8
+	case 0xC7:    // ext 8 (header has type of extension)
+		header = (ch == 0xC7) ? 3 : 2;
+		if (avail < (size_t)header)
+			return header;
+		length = p[1];
+		break;
+
+	case 0xC5:    // bin 16
+	case 0xDA:    // str 16
+	case 0xC8:    // ext 16
+		header = (ch == 0xC8) ? 4 : 3;
+		if (avail < (size_t)header)
+			return header;
+		length = SQ_MP_READ16(p + 1);
+		break;
+
+	case 0xC6:    // bin 32
+	case 0xDB:    // str 32
+	case 0xC9:    // ext 32
+		header = (ch == 0xC9) ? 6 : 5;
+		if (avail < (size_t)header)
+			return header;
+		length = SQ_MP_READ32(p + 1);
+		break;
+
+	default:
+		// 0xC1 is never used
+		return -1;
+	}
+
+	return (int64_t)header + length;
+}
+
+// parse one item. return number of bytes, 0 if data is incomplete, -1 if error.
+static int  sqxc_msgpack_parser_item(SqxcMsgpack *xcmp, const uint8_t *p, const uint8_t *end)
+{
+	SqxcMsgpackLevel *level;
+	int64_t   size;
+	uint32_t  length;
+	int       header;
+	int       ch = p[0];
+
+	size = sqxc_msgpack_item_size(p, end - p);
+	if (size < 0)
+		return -1;
+	if (size > end - p)
+		return 0;
+
+	// key of map must be string
+	if (xcmp->depth > 0) {
+		level = xcmp->stack + xcmp->depth -1;
+		if (level->is_map && (level->count & 1) == 0 &&
+		    (ch & 0xE0) != 0xA0 && ch != 0xD9 && ch != 0xDA && ch != 0xDB)
+			return -1;
+	}
+
+	// fixed size types
+	if (ch <= 0x7F) {
+		sqxc_msgpack_parser_int64(xcmp, ch);
+		return 1;
+	}
+	if (ch >= 0xE0) {
+		sqxc_msgpack_parser_int64(xcmp, (int8_t)ch);
+		return 1;
+	}
+	if (ch <= 0x8F) {
+		sqxc_msgpack_parser_container(xcmp, 1, ch & 0x0F);
+		return 1;
+	}
+	if (ch <= 0x9F) {
+		sqxc_msgpack_parser_container(xcmp, 0, ch & 0x0F);
+		return 1;
+	}
+
+	switch (ch) {
+	case 0xC0:    // nil
+		xcmp->value.pointer = NULL;
+		sqxc_msgpack_parser_scalar(xcmp, SQXC_TYPE_NULL);
+		return 1;
+
+	case 0xC2:    // false
+	case 0xC3:    // true
+		xcmp->value.boolean = (ch == 0xC3);
+		sqxc_msgpack_parser_scalar(xcmp, SQXC_TYPE_BOOL);
+		return 1;
+
+	case 0xCA:    // float 32
+		{
+			uint32_t  bits = SQ_MP_READ32(p + 1);
+			float     value;
+			memcpy(&value, &bits, 4);
+			xcmp->value.double_ = value;
+		}
+		sqxc_msgpack_parser_scalar(xcmp, SQXC_TYPE_DOUBLE);
+		return 5;
+
+	case 0xCB:    // float 64
+		{
+			uint64_t  bits = SQ_MP_READ64(p + 1);
+			memcpy(&xcmp->value.double_, &bits, 8);
+		}
+		sqxc_msgpack_parser_scalar(xcmp, SQXC_TYPE_DOUBLE);
+		return 9;
+
+	case 0xCC:    // uint 8
+		sqxc_msgpack_parser_int64(xcmp, p[1]);
+		return 2;
+
+	case 0xCD:    // uint 16
+		sqxc_msgpack_parser_int64(xcmp, SQ_MP_READ16(p + 1));
+		return 3;
+
+	case 0xCE:    // uint 32
+		sqxc_msgpack_parser_int64(xcmp, SQ_MP_READ32(p + 1));
+		return 5;
+
+	case 0xCF:    // uint 64
+		sqxc_msgpack_parser_uint64(xcmp, SQ_MP_READ64(p + 1));
+		return 9;
+
+	case 0xD0:    // int 8
+		sqxc_msgpack_parser_int64(xcmp, (int8_t)p[1]);
+		return 2;
+
+	case 0xD1:    // int 16
+		sqxc_msgpack_parser_int64(xcmp, (int16_t)SQ_MP_READ16(p + 1));
+		return 3;
+
+	case 0xD2:    // int 32
+		sqxc_msgpack_parser_int64(xcmp, (int32_t)SQ_MP_READ32(p + 1));
+		return 5;
+
+	case 0xD3:    // int 64
+		sqxc_msgpack_parser_int64(xcmp, (int64_t)SQ_MP_READ64(p + 1));
+		return 9;
+
+	case 0xDC:    // array 16
+	case 0xDE:    // map 16
+		sqxc_msgpack_parser_container(xcmp, ch == 0xDE, SQ_MP_READ16(p + 1));
+		return 3;
+
+	case 0xDD:    // array 32
+	case 0xDF:    // map 32
+		sqxc_msgpack_parser_container(xcmp, ch == 0xDF, SQ_MP_READ32(p + 1));
+		return 5;
+
+	// --- extension ---
+	case 0xD4:    // fixext 1
+	case 0xD5:    // fixext 2
+	case 0xD6:    // fixext 4
+	case 0xD7:    // fixext 8
+	case 0xD8:    // fixext 16
+		header = 2;
+		goto extension;
+
+	case 0xC7:    // ext 8
+		header = 3;
+		goto extension;
+
+	case 0xC8:    // ext 16
+		header = 4;
+		goto extension;
+
+	case 0xC9:    // ext 32
+		header = 6;
+	extension:
+		length = (uint32_t)(size - header);
+		// timestamp extension type is -1
+		if ((int8_t)p[header -1] == -1 && (length == 4 || length == 8 || length == 12)) {
+			p += header;
+			if (length == 4)
+				xcmp->value.rawtime = (time_t)SQ_MP_READ32(p);
+			else if (length == 8)
+				xcmp->value.rawtime = (time_t)(SQ_MP_READ64(p) & 0x3FFFFFFFFull);
+			else
+				xcmp->value.rawtime = (time_t)(int64_t)SQ_MP_READ64(p + 4);
+			sqxc_msgpack_parser_scalar(xcmp, SQXC_TYPE_TIME);
+		}
+		else {
+			xcmp->value.pointer = NULL;
+			sqxc_msgpack_parser_scalar(xcmp, SQXC_TYPE_NULL);
+		}
+		return header + length;
+
+	// --- string and binary ---
+	case 0xC4:    // bin 8
+	case 0xD9:    // str 8
+		header = 2;
+		break;
+
+	case 0xC5:    // bin 16
+	case 0xDA:    // str 16
+		header = 3;
+		break;
+
+	case 0xC6:    // bin 32
+	case 0xDB:    // str 32
+		header = 5;
+		break;
+
+	default:
+		// fixstr
+		header = 1;
+		break;
+	}
+
+	length = (uint32_t)(size - header);
+	p += header;
+
+	// key of map
+	if (xcmp->depth > 0) {
+		level = xcmp->stack + xcmp->depth -1;
+		if (level->is_map && (level->count & 1) == 0) {
+			xcmp->name_offset = xcmp->names.writed;
+			sq_buffer_write_n(&xcmp->names, (const char*)p, length);
+			sq_buffer_write_c(&xcmp->names, 0);    // keep null-terminated
+			level->count--;
+			return header + length;
+		}
+	}
+
+	xcmp->buf_writed = 0;
+	if (length)
+		sq_buffer_write_n(sqxc_get_buffer(xcmp), (const char*)p, length);
+	*sq_buffer_alloc(sqxc_get_buffer(xcmp), 0) = 0;    // null-terminated
+	if (ch == 0xC4 || ch == 0xC5 || ch == 0xC6) {
+		// bin may contain null character. length of data is SqBuffer.writed
+		xcmp->value.pointer = sqxc_get_buffer(xcmp);
+		sqxc_msgpack_parser_scalar(xcmp, SQXC_TYPE_RAW);
+	}
+	else {
+		xcmp->value.str = xcmp->buf;
+		sqxc_msgpack_parser_scalar(xcmp, SQXC_TYPE_STR);
+	}
+	return header + length;
+}
+
+static int  sqxc_msgpack_parser_send(SqxcMsgpack *xcmp, Sqxc *src)
+{
+	SqBuffer      *data = (SqBuffer*)src->value.pointer;
+	const uint8_t *cur;
+	const uint8_t *end;
+	int64_t        size;
+	int            n;
+
+	if (data == NULL || data->writed == 0)
+		return (src->code = (xcmp->depth || xcmp->left.writed) ? SQCODE_MSGPACK_CONTINUE : SQCODE_OK);
+
+	// start of new MessagePack data. keep name of top level value in 'names'.
+	if (xcmp->depth == 0 && xcmp->left.writed == 0) {
+		xcmp->names.writed = 0;
+		if (src->name) {
+			xcmp->name_offset = 0;
+			sq_buffer_write(&xcmp->names, src->name);
+			xcmp->names.writed++;    // keep null-terminated
+		}
+		else
+			xcmp->name_offset = -1;
+	}
+
+	cur = (const uint8_t*)data->mem;
+	end = cur + data->writed;
+
+	// complete item of previous piece. Append only bytes that the item needs.
+	if (xcmp->left.writed) {
+		for (;;) {
+			size = sqxc_msgpack_item_size((const uint8_t*)xcmp->left.mem, xcmp->left.writed);
+			if (size < 0)
+				break;
+			if (size <= xcmp->left.writed)
+				break;
+			if (cur == end)
+				return (src->code = SQCODE_MSGPACK_CONTINUE);
+			n = (size - xcmp->left.writed < end - cur) ? (int)(size - xcmp->left.writed) : (int)(end - cur);
+			sq_buffer_write_n(&xcmp->left, (const char*)cur, n);
+			cur += n;
+		}
+		n = sqxc_msgpack_parser_item(xcmp, (const uint8_t*)xcmp->left.mem,
+		                             (const uint8_t*)xcmp->left.mem + xcmp->left.writed);
+		if (n < 0) {
+			sqxc_msgpack_parser_reset(xcmp);
+			return (src->code = SQCODE_MSGPACK_ERROR);
+		}
+		xcmp->left.writed = 0;
+	}
+
+	// parse data in place
+	while (cur < end) {
+		n = sqxc_msgpack_parser_item(xcmp, cur, end);
+		if (n == 0)
+			break;
+		if (n < 0) {
+			sqxc_msgpack_parser_reset(xcmp);
+			return (src->code = SQCODE_MSGPACK_ERROR);
+		}
+		cur += n;
+	}
+
+	// keep incomplete item for next piece
+	if (cur < end)
+		sq_buffer_write_n(&xcmp->left, (const char*)cur, end - cur);
+
+	if (xcmp->depth == 0 && xcmp->left.writed == 0)
+		return (src->code = SQCODE_OK);
+	return (src->code = SQCODE_MSGPACK_CONTINUE);
+}
+
+static int  sqxc_msgpack_parser_ctrl(SqxcMsgpack *xcmp, int id, void *data)
+{
+	switch(id) {
+	case SQXC_CTRL_READY:
+		sqxc_msgpack_parser_reset(xcmp);
+		break;
+
+	case SQXC_CTRL_FINISH:
+		sqxc_msgpack_parser_reset(xcmp);
+		// clear SqxcNested if problem occurred during processing
+		sqxc_clear_nested((Sqxc*)xcmp);
+		break;
+
+	default:
+		return SQCODE_NOT_SUPPORT;
+	}
+
+	return SQCODE_OK;
+}
+
+static void  sqxc_msgpack_parser_init(SqxcMsgpack *xcmp)
+{
+//	memset(xcmp, 0, sizeof(SqxcMsgpack));
+	xcmp->supported_type = SQXC_TYPE_RAW;
+	sq_buffer_init(&xcmp->names);
+	sq_buffer_init(&xcmp->left);
+	xcmp->name_offset = -1;
+}
+
+static void  sqxc_msgpack_parser_final(SqxcMsgpack *xcmp)
+{
+	sq_buffer_final(&xcmp->names);
+	sq_buffer_final(&xcmp->left);
+	free(xcmp->stack);
+}
+
+/* ----------------------------------------------------------------------------
+	SqxcInfo functions - Middleware of output chain
+
+	SQXC_TYPE_xxxx ---> SqxcMsgpack Writer ---> SQXC_TYPE_RAW
+	                                            (MessagePack data)
+ */
+
+// size of header of map 32 and array 32. It is reserved before count of items is known.
+#define SQ_MP_HEADER_SIZE    5
+
+static void sq_mp_write16(char *mem, uint32_t value)
+{
+	mem[0] = (char)(value >> 8);
+	mem[1] = (char)value;
+}
+
+static void sq_mp_write32(char *mem, uint32_t value)
+{
+	mem[0] = (char)(value >> 24);
+	mem[1] = (char)(value >> 16);
+	mem[2] = (char)(value >> 8);
+	mem[3] = (char)value;
+}
+
+static void sq_mp_write64(char *mem, uint64_t value)
+{
+	sq_mp_write32(mem,     (uint32_t)(value >> 32));
+	sq_mp_write32(mem + 4, (uint32_t)value);
+}
+
+static void sqxc_msgpack_write_uint64(SqBuffer *buffer, uint64_t value)
+{
+	char *mem;
+
+	if (value <= 0x7F)
+		sq_buffer_write_c(buffer, (char)value);
+	else if (value <= 0xFF) {
+		mem = sq_buffer_alloc(buffer, 2);
+		mem[0] = (char)0xCC;
+		mem[1] = (char)value;
+	}
+	else if (value <= 0xFFFF) {
+		mem = sq_buffer_alloc(buffer, 3);
+		mem[0] = (char)0xCD;
+		sq_mp_write16(mem + 1, (uint32_t)value);
+	}
+	else if (value <= 0xFFFFFFFF) {
+		mem = sq_buffer_alloc(buffer, 5);
+		mem[0] = (char)0xCE;
+		sq_mp_write32(mem + 1, (uint32_t)value);
+	}
+	else {
+		mem = sq_buffer_alloc(buffer, 9);
+		mem[0] = (char)0xCF;
+		sq_mp_write64(mem + 1, value);
+	}
+}
+
+static void sqxc_msgpack_write_int64(SqBuffer *buffer, int64_t value)
+{
+	char *mem;
+
+	if (value >= 0)
+		sqxc_msgpack_write_uint64(buffer, (uint64_t)value);
+	else if (value >= -32)
+		sq_buffer_write_c(buffer, (char)value);    // negative fixint
+	else if (value >= INT8_MIN) {
+		mem = sq_buffer_alloc(buffer, 2);
+		mem[0] = (char)0xD0;
+		mem[1] = (char)value;
+	}
+	else if (value >= INT16_MIN) {
+		mem = sq_buffer_alloc(buffer, 3);
+		mem[0] = (char)0xD1;
+		sq_mp_write16(mem + 1, (uint32_t)value);
+	}
+	else if (value >= INT32_MIN) {
+		mem = sq_buffer_alloc(buffer, 5);
+		mem[0] = (char)0xD2;
+		sq_mp_write32(mem + 1, (uint32_t)value);
+	}
+	else {
+		mem = sq_buffer_alloc(buffer, 9);
+		mem[0] = (char)0xD3;
+		sq_mp_write64(mem + 1, (uint64_t)value);
+	}
+}
+
+static void sqxc_msgpack_write_str(SqBuffer *buffer, const char *str)
+{
+	uint32_t  length = (uint32_t)strlen(str);
+	char     *mem;
+
+	if (length <= 31) {
+		mem = sq_buffer_alloc(buffer, 1 + length);
+		mem[0] = (char)(0xA0 | length);
+		mem += 1;
+	}
+	else if (length <= 0xFF) {
+		mem = sq_buffer_alloc(buffer, 2 + length);
+		mem[0] = (char)0xD9;
+		mem[1] = (char)length;
+		mem += 2;
+	}
+	else if (length <= 0xFFFF) {
+		mem = sq_buffer_alloc(buffer, 3 + length);
+		mem[0] = (char)0xDA;
+		sq_mp_write16(mem + 1, length);
+		mem += 3;
+	}
+	else {
+		mem = sq_buffer_alloc(buffer, 5 + length);
+		mem[0] = (char)0xDB;
+		sq_mp_write32(mem + 1, length);
+		mem += 5;
+	}
+	memcpy(mem, str, length);
+}
+
+static void sqxc_msgpack_write_bin(SqBuffer *buffer, const char *data, uint32_t length)
+{
+	char     *mem;
+
+	if (length <= 0xFF) {
+		mem = sq_buffer_alloc(buffer, 2 + length);
+		mem[0] = (char)0xC4;
+		mem[1] = (char)length;
+		mem += 2;
+	}
+	else if (length <= 0xFFFF) {
+		mem = sq_buffer_alloc(buffer, 3 + length);
+		mem[0] = (char)0xC5;
+		sq_mp_write16(mem + 1, length);
+		mem += 3;
+	}
+	else {
+		mem = sq_buffer_alloc(buffer, 5 + length);
+		mem[0] = (char)0xC6;
+		sq_mp_write32(mem + 1, length);
+		mem += 5;
+	}
+	if (length)
+		memcpy(mem, data, length);
+}
+
+static void sqxc_msgpack_write_time(SqBuffer *buffer, time_t time)
+{
+	char *mem;
+
+	if (time >= 0 && (uint64_t)time <= 0xFFFFFFFF) {
+		// timestamp 32
+		mem = sq_buffer_alloc(buffer, 6);
+		mem[0] = (char)0xD6;
+		mem[1] = (char)-1;
+		sq_mp_write32(mem + 2, (uint32_t)time);
+	}
+	else {
+		// timestamp 96
+		mem = sq_buffer_alloc(buffer, 15);
+		mem[0] = (char)0xC7;
+		mem[1] = 12;
+		mem[2] = (char)-1;
+		sq_mp_write32(mem + 3, 0);
+		sq_mp_write64(mem + 7, (uint64_t)(int64_t)time);
+	}
+}
+
+// write count of items to reserved header of map/array
+static void sqxc_msgpack_writer_end(SqxcMsgpack *xcmp, int is_map)
+{
+	SqBuffer   *buffer = sqxc_get_buffer(xcmp);
+	SqxcNested *nested = xcmp->nested;
+	int         offset = (int)(intptr_t)nested->data;
+	uint32_t    count  = (uint32_t)(intptr_t)nested->data3;
+	char       *mem    = buffer->mem + offset;
+
+	if (count <= 15) {
+		// fixmap or fixarray. Move items to the end of 1 byte header.
+		mem[0] = (char)(((is_map) ? 0x80 : 0x90) | count);
+		memmove(mem + 1, mem + SQ_MP_HEADER_SIZE, buffer->writed - offset - SQ_MP_HEADER_SIZE);
+		buffer->writed -= SQ_MP_HEADER_SIZE - 1;
+	}
+	else {
+		mem[0] = (char)((is_map) ? 0xDF : 0xDD);
+		sq_mp_write32(mem + 1, count);
+	}
+	sqxc_pop_nested((Sqxc*)xcmp);
+}
+
+static int  sqxc_msgpack_writer_send(SqxcMsgpack *xcmp, Sqxc *src)
+{
+	SqBuffer   *buffer = sqxc_get_buffer(xcmp);
+	SqxcNested *nested;
+	Sqxc       *xcdest;
+	char       *mem;
+	int         type = src->type;
+
+	if (xcmp->nested_count == 0) {
+		if (type & SQXC_TYPE_END)
+			return (src->code = SQCODE_TYPE_END_ERROR);
+		// start of new MessagePack data
+		xcmp->buf_writed = 0;
+		xcmp->root_name = src->name;
+		xcmp->root_entry = src->entry;
+	}
+	else {
+		// skip hidden object/array and all of its members
+		if (xcmp->skip) {
+			if (type == SQXC_TYPE_OBJECT || type == SQXC_TYPE_ARRAY) {
+				sqxc_push_nested((Sqxc*)xcmp);
+				xcmp->skip++;
+			}
+			else if (type & SQXC_TYPE_END) {
+				sqxc_pop_nested((Sqxc*)xcmp);
+				xcmp->skip--;
+			}
+			return (src->code = SQCODE_OK);
+		}
+		// SQB_HIDDEN and SQB_HIDDEN_NULL are applied to members only.
+		if (src->entry && (type & SQXC_TYPE_END) == 0) {
+			if (src->entry->bit_field & SQB_HIDDEN ||
+			    (src->entry->bit_field & SQB_HIDDEN_NULL &&
+			     (type == SQXC_TYPE_NULL || (type == SQXC_TYPE_STR && src->value.str == NULL))))
+			{
+				if (type == SQXC_TYPE_OBJECT || type == SQXC_TYPE_ARRAY) {
+					sqxc_push_nested((Sqxc*)xcmp);
+					xcmp->skip = 1;
+				}
+				return (src->code = SQCODE_OK);
+			}
+		}
+	}
+
+	if (type & SQXC_TYPE_END)
+		sqxc_msgpack_writer_end(xcmp, type == SQXC_TYPE_OBJECT_END);
+	else {
+		if ((type & (SQXC_TYPE_BASIC | SQXC_TYPE_RAW)) == 0 || type == SQXC_TYPE_UNKNOWN)
+			return (src->code = SQCODE_TYPE_NOT_SUPPORT);
+		nested = xcmp->nested;
+		if (xcmp->nested_count > 0) {
+			// count items of map/array
+			nested->data3 = (void*)((intptr_t)nested->data3 + 1);
+			// member of map has key. element of array doesn't have key.
+			if (nested->data2 == (void*)(intptr_t)SQXC_TYPE_OBJECT)
+				sqxc_msgpack_write_str(buffer, (src->name) ? src->name : "");
+		}
+
+		switch (type) {
+		case SQXC_TYPE_NULL:
+			sq_buffer_write_c(buffer, (char)0xC0);
+			break;
+
+		case SQXC_TYPE_BOOL:
+			sq_buffer_write_c(buffer, (char)((src->value.boolean) ? 0xC3 : 0xC2));
+			break;
+
+		case SQXC_TYPE_INT:
+			sqxc_msgpack_write_int64(buffer, src->value.integer);
+			break;
+
+		case SQXC_TYPE_UINT:
+			sqxc_msgpack_write_uint64(buffer, src->value.uinteger);
+			break;
+
+		case SQXC_TYPE_INT64:
+			sqxc_msgpack_write_int64(buffer, src->value.int64);
+			break;
+
+		case SQXC_TYPE_UINT64:
+			sqxc_msgpack_write_uint64(buffer, src->value.uint64);
+			break;
+
+		case SQXC_TYPE_TIME:
+			sqxc_msgpack_write_time(buffer, src->value.rawtime);
+			break;
+
+		case SQXC_TYPE_DOUBLE:
+			mem = sq_buffer_alloc(buffer, 9);
+			mem[0] = (char)0xCB;
+			{
+				uint64_t  bits;
+				memcpy(&bits, &src->value.double_, 8);
+				sq_mp_write64(mem + 1, bits);
+			}
+			break;
+
+		case SQXC_TYPE_STR:
+			if (src->value.str)
+				sqxc_msgpack_write_str(buffer, src->value.str);
+			else
+				sq_buffer_write_c(buffer, (char)0xC0);
+			break;
+
+		case SQXC_TYPE_RAW:
+			// Sqxc.value.pointer points to SqBuffer
+			if (src->value.pointer)
+				sqxc_msgpack_write_bin(buffer, ((SqBuffer*)src->value.pointer)->mem,
+				                       ((SqBuffer*)src->value.pointer)->writed);
+			else
+				sq_buffer_write_c(buffer, (char)0xC0);
+			break;
+
+		case SQXC_TYPE_OBJECT:
+		case SQXC_TYPE_ARRAY:
+			// reserve header. count of items is written at the end of map/array.
+			nested = sqxc_push_nested((Sqxc*)xcmp);
+			nested->data  = (void*)(intptr_t)buffer->writed;
+			nested->data2 = (void*)(intptr_t)type;
+			nested->data3 = (void*)(intptr_t)0;
+			sq_buffer_alloc(buffer, SQ_MP_HEADER_SIZE);
+			break;
+		}
+	}
+
+	// End of MessagePack data
+	if (xcmp->nested_count == 0 && xcmp->dest) {
+		xcdest = xcmp->dest;
+		xcmp->type = SQXC_TYPE_RAW;
+		xcmp->name = xcmp->root_name;
+		xcmp->entry = xcmp->root_entry;
+		xcmp->value.pointer = buffer;
+		xcdest->info->send(xcdest, (Sqxc*)xcmp);
+	}
+
+	return (src->code = SQCODE_OK);
+}
+
+static int  sqxc_msgpack_writer_ctrl(SqxcMsgpack *xcmp, int id, void *data)
+{
+	switch(id) {
+	case SQXC_CTRL_READY:
+		xcmp->skip = 0;
+		break;
+
+	case SQXC_CTRL_FINISH:
+		xcmp->skip = 0;
+		// clear SqxcNested if problem occurred during processing
+		sqxc_clear_nested((Sqxc*)xcmp);
+		break;
+
+	default:
+		return SQCODE_NOT_SUPPORT;
+	}
+
+	return SQCODE_OK;
+}
+
+static void  sqxc_msgpack_writer_init(SqxcMsgpack *xcmp)
+{
+//	memset(xcmp, 0, sizeof(SqxcMsgpack));
+	xcmp->supported_type = SQXC_TYPE_ALL | SQXC_TYPE_RAW;
+}
+
+static void  sqxc_msgpack_writer_final(SqxcMsgpack *xcmp)
+{
+
+}
+
+// ----------------------------------------------------------------------------
+// SqxcInfo
+
+const SqxcInfo SqxcInfo_MsgpackParser_ =
+{
+	sizeof(SqxcMsgpack),
+	(SqInitFunc)sqxc_msgpack_parser_init,
+	(SqFinalFunc)sqxc_msgpack_parser_final,
+	(SqxcCtrlFunc)sqxc_msgpack_parser_ctrl,
+	(SqxcSendFunc)sqxc_msgpack_parser_send,
+};
+
+const SqxcInfo SqxcInfo_MsgpackWriter_ =
+{
+	sizeof(SqxcMsgpack),
+	(SqInitFunc)sqxc_msgpack_writer_init,
+	(SqFinalFunc)sqxc_msgpack_writer_final,
+	(SqxcCtrlFunc)sqxc_msgpack_writer_ctrl,
+	(SqxcSendFunc)sqxc_msgpack_writer_send,
+};
@@ -0,0 +1,197 @@
+/*
+ *   Copyright (C) 2023 by C.H. Huang
+ *   plushuang.tw@gmail.com
+ *
+ * sqxclib is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ */
+
+#ifndef SQXC_MSGPACK_H
+#define SQXC_MSGPACK_H
+
+#include <SqBuffer.h>
+#include <Sqxc.h>
+
+// ----------------------------------------------------------------------------
+// C/C++ common declarations: declare type, structure, macro, enumeration.
+
+typedef struct SqxcMsgpack        SqxcMsgpack;
+typedef struct SqxcMsgpackLevel   SqxcMsgpackLevel;    // defined in SqxcMsgpack.c
+
+// ----------------------------------------------------------------------------
+// C declarations: declare C data, function, and others.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const SqxcInfo               SqxcInfo_MsgpackParser_;
+extern const SqxcInfo               SqxcInfo_MsgpackWriter_;
+#define SQXC_INFO_MSGPACK_PARSER    (&SqxcInfo_MsgpackParser_)
+#define SQXC_INFO_MSGPACK_WRITER    (&SqxcInfo_MsgpackWriter_)
+
+#define sqxc_msgpack_parser_new()        sqxc_new(SQXC_INFO_MSGPACK_PARSER)
+#define sqxc_msgpack_writer_new()        sqxc_new(SQXC_INFO_MSGPACK_WRITER)
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+// ----------------------------------------------------------------------------
+// C/C++ common definitions: define structure
+
+/*	SqxcMsgpack - MessagePack parser and writer. It doesn't depend on other library.
+
+	Sqxc
+	|
+	`--- SqxcMsgpack
+
+	*** In input chain:
+	SQXC_TYPE_RAW ---> SqxcMsgpack Parser ---> SQXC_TYPE_xxxx
+	(MessagePack data)
+
+	*** In output chain:
+	SQXC_TYPE_xxxx ---> SqxcMsgpack Writer ---> SQXC_TYPE_RAW
+	                                            (MessagePack data)
+
+	MessagePack data is binary, it is sent as SQXC_TYPE_RAW.
+	Sqxc.value.pointer points to SqBuffer, data is SqBuffer.mem and length of data is SqBuffer.writed.
+
+	Parser:
+	MessagePack data can be sent in several pieces. If data is incomplete,
+	parser returns SQCODE_MSGPACK_CONTINUE and keeps its state until next piece arrives.
+	Key of map must be string. bin is sent as SQXC_TYPE_RAW because it may contain null character,
+	Sqxc.value.pointer points to SqBuffer that has data and length of bin.
+	If item is split between pieces, parser copies only bytes of that item and parses others in place.
+	Timestamp extension (type -1) is sent as SQXC_TYPE_TIME. Other extension types are sent as SQXC_TYPE_NULL.
+
+	Writer:
+	Writer appends data to Sqxc.buf and sends it to destination when top level value is completed.
+	If writer doesn't have destination, user can get data by sqxc_get_buffer().
+	SQXC_TYPE_TIME is written as timestamp extension (type -1). SQXC_TYPE_RAW is written as bin.
+	Members of object that have SQB_HIDDEN are skipped. They are skipped if
+	they have SQB_HIDDEN_NULL and their value is NULL.
+
+
+   The correct way to derive Sqxc:  (conforming C++11 standard-layout)
+   1. Use Sq::XcMethod to inherit member function(method).
+   2. Use SQXC_MEMBERS to inherit member variable.
+   3. Add variable and non-virtual function in derived struct.
+   ** This can keep std::is_standard_layout<>::value == true
+ */
+
+#ifdef __cplusplus
+struct SqxcMsgpack : Sq::XcMethod        // <-- 1. inherit C++ member function(method)
+#else
+struct SqxcMsgpack
+#endif
+{
+	SQXC_MEMBERS;                        // <-- 2. inherit member variable
+/*	// ------ Sqxc members ------
+	const SqxcInfo  *info;
+
+	// Sqxc chain
+	Sqxc        *peer;     // pointer to other Sqxc elements (single linked list)
+	Sqxc        *dest;     // pointer to current destination in Sqxc chain (data flow)
+
+	// stack of SqxcNested
+	SqxcNested  *nested;          // current nested object/array
+	int          nested_count;
+
+	// ------------------------------------------
+	// Buffer - common buffer for type conversion. To resize this buf:
+	// buf = realloc(buf, buf_size);
+
+//	SQ_BUFFER_MEMBERS(buf, buf_size, buf_writed);
+	char        *buf;
+	int          buf_size;
+	int          buf_writed;
+
+	// ------------------------------------------
+	// properties
+
+	uint16_t     supported_type;  // supported SqxcType (bit field) for inputting, it can change at runtime.
+//	uint16_t     outputable_type; // supported SqxcType (bit field) for outputting, it can change at runtime.
+
+	// ------------------------------------------
+	// arguments that used by SqxcInfo->send()
+
+	// output arguments
+//	uint16_t     required_type;   // required SqxcType (bit field) if 'code' == SQCODE_TYPE_NOT_MATCH
+	uint16_t     code;            // error code (SQCODE_xxxx)
+
+	// input arguments
+	uint16_t     type;            // input SqxcType
+	const char  *name;
+	SqValue      value;           // union SqValue defined in SqDefine.h
+
+	// special input arguments
+	SqEntry     *entry;           // SqxcJsonc and SqxcSql use it to decide output. this can be NULL (optional).
+
+	// input / output arguments
+	void       **error;
+ */
+
+	// ------ SqxcMsgpack members ------  // <-- 3. Add variable and non-virtual function in derived struct.
+
+	// --- parser ---
+	// Sqxc.buf stores current string.
+	// 'names' stores names of nested maps/arrays and current key.
+	SqBuffer     names;
+	int          name_offset;     // offset of name of current value in 'names', -1 if no name.
+
+	// incomplete data of previous piece
+	SqBuffer     left;
+
+	// stack of nested maps/arrays
+	SqxcMsgpackLevel *stack;
+	int          stack_size;
+	int          depth;
+
+	// --- writer ---
+	// Sqxc.buf stores MessagePack data.
+	const char  *root_name;
+	SqEntry     *root_entry;
+	int          skip;            // depth of skipped (hidden) object/array
+};
+
+// ----------------------------------------------------------------------------
+// C++ definitions: define C++ data, function, method, and others.
+
+#ifdef __cplusplus
+
+namespace Sq {
+
+/* All derived struct/class must be C++11 standard-layout. */
+
+struct XcMsgpackParser : SqxcMsgpack
+{
+	XcMsgpackParser() {
+		sqxc_init((Sqxc*)this, SQXC_INFO_MSGPACK_PARSER);
+	}
+	~XcMsgpackParser() {
+		sqxc_final((Sqxc*)this);
+	}
+};
+
+struct XcMsgpackWriter : SqxcMsgpack
+{
+	XcMsgpackWriter() {
+		sqxc_init((Sqxc*)this, SQXC_INFO_MSGPACK_WRITER);
+	}
+	~XcMsgpackWriter() {
+		sqxc_final((Sqxc*)this);
+	}
+};
+
+};  // namespace Sq
+
+#endif  // __cplusplus
+
+#endif  // SQXC_MSGPACK_H
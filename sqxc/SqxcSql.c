@@ -51,6 +51,10 @@
 static void sqxc_sql_use_insert_command(SqxcSql *xcsql, const char *table_name);
 static void sqxc_sql_use_update_command(SqxcSql *xcsql, const char *table_name);
 static int  sqxc_sql_write_value(SqxcSql *xcsql, Sqxc *src, SqBuffer *buffer);
+static int  sqxc_sql_write_param(SqxcSql *xcsql, Sqxc *src, SqBuffer *buffer);
+static int  sqxc_sql_exec(SqxcSql *xcsql);
+static int  sqxc_sql_exec_insert(SqxcSql *xcsql);
+static bool sqxc_sql_is_full(SqxcSql *xcsql);
 
 /* ----------------------------------------------------------------------------
 	SqxcInfo functions - destination of output chain
@@ -76,6 +80,7 @@ static int  sqxc_sql_send_insert_command(SqxcSql *xcsql, Sqxc *src)
 		xcsql->supported_type |= SQXC_TYPE_END;
 		// --- Begin of Array ---
 		xcsql->row_count = 0;
+		xcsql->row_length = 0;
 		return (src->code = SQCODE_OK);
 
 	case SQXC_TYPE_OBJECT:
@@ -88,8 +93,16 @@ static int  sqxc_sql_send_insert_command(SqxcSql *xcsql, Sqxc *src)
 		xcsql->supported_type &= ~(SQXC_TYPE_OBJECT | SQXC_TYPE_ARRAY);
 		xcsql->supported_type |= SQXC_TYPE_END;
 		// --- Begin of row ---
-		if (xcsql->row_count)
-			sq_buffer_write_c(values_buf, ',');
+		if (xcsql->row_count) {
+			// execute written rows if the next row may exceed limits of SQL statement
+			if (sqxc_sql_is_full(xcsql)) {
+				if (sqxc_sql_exec_insert(xcsql) != SQCODE_OK)
+					return (src->code = SQCODE_EXEC_ERROR);
+			}
+			else
+				sq_buffer_write_c(values_buf, ',');
+		}
+		xcsql->row_start = values_buf->writed;
 		sq_buffer_write_c(values_buf, '(');
 		xcsql->row_count++;
 		xcsql->col_count = 0;
@@ -102,10 +115,19 @@ static int  sqxc_sql_send_insert_command(SqxcSql *xcsql, Sqxc *src)
 		xcsql->supported_type |= SQXC_TYPE_OBJECT;
 		// --- End of row ---
 		sq_buffer_write_c(values_buf, ')');
-		if ((xcsql->outer_type & SQXC_TYPE_ARRAY) == 0) {
-			sq_buffer_write_c(values_buf, 0);    // null-terminated
-			// SQL INSERT VALUES has written in xcsql->values_buf
+		// column names are written by the first row. All rows must have the same columns.
+		if (xcsql->n_columns == -1)
+			xcsql->n_columns = xcsql->col_count;
+		else if (xcsql->n_columns != xcsql->col_count) {
+#ifndef NDEBUG
+			fprintf(stderr, "SqxcSql: number of columns in row %d is not the same as the first row.\n",
+			        xcsql->row_count);
+#endif
+			return (src->code = SQCODE_TYPE_NOT_MATCH);
 		}
+		if (xcsql->row_length < values_buf->writed - xcsql->row_start)
+			xcsql->row_length = values_buf->writed - xcsql->row_start;
+		// SQL INSERT VALUES has written in xcsql->values_buf
 		return (src->code = SQCODE_OK);
 
 	case SQXC_TYPE_ARRAY_END:
@@ -114,7 +136,6 @@ static int  sqxc_sql_send_insert_command(SqxcSql *xcsql, Sqxc *src)
 		xcsql->outer_type &= ~SQXC_TYPE_ARRAY;
 		xcsql->supported_type |= SQXC_TYPE_ARRAY;
 		// --- End of Array ---
-		sq_buffer_write_c(values_buf, 0);    // null-terminated
 		// SQL INSERT VALUES has written in xcsql->values_buf
 		return (src->code = SQCODE_OK);
 
@@ -141,24 +162,23 @@ static int  sqxc_sql_send_insert_command(SqxcSql *xcsql, Sqxc *src)
 	}
 
 	// SQL statement multiple columns
-	if (xcsql->col_count) {
-		sq_buffer_write_c(names_buf, ',');
+	if (xcsql->col_count)
 		sq_buffer_write_c(values_buf, ',');
-	}
 
 	// value
 	if (sqxc_sql_write_value(xcsql, src, values_buf) != SQCODE_OK) {
-		if (xcsql->col_count) {
-			names_buf->writed--;     // remove ',' from names_buf
+		if (xcsql->col_count)
 			values_buf->writed--;    // remove ',' form values_buf
-		}
 	}
-	// "name"
+	// "name" - only the first row writes column names
 	else {
-		sq_buffer_write_c(names_buf, xcsql->quote[0]);
-		sq_buffer_write(names_buf, src->name);
-		sq_buffer_write_c(names_buf, xcsql->quote[1]);
-
+		if (xcsql->n_columns == -1) {
+			if (xcsql->col_count)
+				sq_buffer_write_c(names_buf, ',');
+			sq_buffer_write_c(names_buf, xcsql->quote[0]);
+			sq_buffer_write(names_buf, src->name);
+			sq_buffer_write_c(names_buf, xcsql->quote[1]);
+		}
 		xcsql->col_count++;
 	}
 
@@ -273,41 +293,45 @@ static int  sqxc_sql_ctrl(SqxcSql *xcsql, int id, void *data)
 		xcsql->outer_type = SQXC_TYPE_UNKNOWN;
 		// reset Sqdb result variable
 		xcsql->id = 0;
+		xcsql->id_first = 0;
 		xcsql->changes = 0;
+		// reset parameters
+		xcsql->params_length = 0;
+		xcsql->params_buf.writed = 0;
 		break;
 
 	case SQXC_CTRL_FINISH:
-		// write INSERT VALUES to xcsql->buf
-		if (xcsql->mode == 1) {
-			SqBuffer *buffer = sqxc_get_buffer(xcsql);
-			SqBuffer *values = &xcsql->values_buf;
-	
-			// length of ") VALUES " is 9
-			sq_buffer_resize(buffer, buffer->writed + 9 + values->writed + 1);
-			sq_buffer_write(buffer, ") VALUES ");
-			sq_buffer_write_n(buffer, values->mem, values->writed);
-			// reset values buffer
-			values->writed = 0;
-		}
-		// SQL statement has written in xcsql->buf
+		code = SQCODE_OK;
 		if (xcsql->db && xcsql->buf_writed > 0) {
-			code = sqdb_exec(xcsql->db, xcsql->buf, (Sqxc*)xcsql, NULL);
-			if (code != SQCODE_OK)
-				return (xcsql->code = SQCODE_EXEC_ERROR);
+			// INSERT: write VALUES to xcsql->buf and execute it
+			if (xcsql->mode == 1) {
+				// Don't execute it if row is incomplete (problem occurred during processing).
+				if (xcsql->row_count > 0 && (xcsql->outer_type & SQXC_TYPE_OBJECT) == 0)
+					code = sqxc_sql_exec_insert(xcsql);
+			}
+			// UPDATE: SQL statement has written in xcsql->buf
+			else
+				code = sqxc_sql_exec(xcsql);
 		}
 		// clear SqxcNested if problem occurred during processing
 		sqxc_clear_nested((Sqxc*)xcsql);
 		// reset buffer
 		xcsql->buf_writed = 0;
+		xcsql->values_buf.writed = 0;
+		xcsql->params_length = 0;
+		xcsql->params_buf.writed = 0;
 		// reset UPDATE command variable
 		xcsql->condition = NULL;
 		xcsql->columns.length = 0;
 		xcsql->columns_sorted = false;
+		if (code != SQCODE_OK)
+			return (xcsql->code = SQCODE_EXEC_ERROR);
 		break;
 
 	case SQXC_SQL_CTRL_INSERT:
 		xcsql->mode = 1;
 		xcsql->row_count = 0;
+		xcsql->n_columns = -1;
 //		xcsql->col_count = 0;
 		sqxc_sql_use_insert_command(xcsql, data);
 		break;
@@ -342,8 +366,15 @@ static void  sqxc_sql_init(SqxcSql *xcsql)
 //	xcsql->condition = NULL;
 	xcsql->columns.data = NULL;
 	xcsql->columns_sorted = false;
+	// parameter placeholder
+	xcsql->use_params = false;
+	xcsql->params = NULL;
+	xcsql->params_length = 0;
+	xcsql->params_size = 0;
+	sq_buffer_init(&xcsql->params_buf);
 	// Sqdb result variable
 	xcsql->id = 0;
+	xcsql->id_first = 0;
 	xcsql->changes = 0;
 }
 
@@ -351,6 +382,8 @@ static void  sqxc_sql_final(SqxcSql *xcsql)
 {
 	sq_buffer_final(&xcsql->values_buf);
 	sq_ptr_array_final(&xcsql->columns);
+	sq_buffer_final(&xcsql->params_buf);
+	free(xcsql->params);
 }
 
 // ----------------------------------------------------------------------------
@@ -397,11 +430,12 @@ static void sqxc_sql_use_update_command(SqxcSql *xcsql, const char *table_name)
 
 static int  sqxc_sql_write_value(SqxcSql *xcsql, Sqxc *src, SqBuffer *buffer)
 {
-	int   len, idx;
-	char *tempstr;
+	const char *str, *end;
 
 	if (buffer == NULL)
 		buffer = sqxc_get_buffer(xcsql);
+	if (xcsql->use_params && xcsql->db)
+		return sqxc_sql_write_param(xcsql, src, buffer);
 
 	switch (src->type) {
 	case SQXC_TYPE_NULL:
@@ -423,58 +457,29 @@ static int  sqxc_sql_write_value(SqxcSql *xcsql, Sqxc *src, SqBuffer *buffer)
 		break;
 
 	case SQXC_TYPE_INT:
-		len = snprintf(NULL, 0, "%d", src->value.integer);
-		sprintf(sq_buffer_alloc(buffer, len), "%d", src->value.integer);
+		sq_buffer_write_int64(buffer, src->value.integer);
 		break;
 
 	case SQXC_TYPE_UINT:
-		len = snprintf(NULL, 0, "%u", src->value.uint);
-		sprintf(sq_buffer_alloc(buffer, len), "%u", src->value.uint);
+		sq_buffer_write_uint64(buffer, src->value.uint);
 		break;
 
 	case SQXC_TYPE_INT64:
-#if defined (_MSC_VER)  // || defined (__MINGW32__) || defined (__MINGW64__)
-		len = snprintf(NULL, 0, "%I64d", src->value.int64);
-		sprintf(sq_buffer_alloc(buffer, len), "%I64d", src->value.int64);
-#elif defined(__WORDSIZE) && (__WORDSIZE == 64) && !defined(__APPLE__)
-		len = snprintf(NULL, 0, "%ld", src->value.int64);
-		sprintf(sq_buffer_alloc(buffer, len), "%ld", src->value.int64);
-#elif defined(__GNUC__)
-		len = snprintf(NULL, 0, "%lld", src->value.int64);
-		sprintf(sq_buffer_alloc(buffer, len), "%lld", src->value.int64);
-#else // C99
-		len = snprintf(NULL, 0, "%" PRId64, src->value.int64);
-		sprintf(sq_buffer_alloc(buffer, len), "%" PRId64, src->value.int64);
-#endif
+		sq_buffer_write_int64(buffer, src->value.int64);
 		break;
 
 	case SQXC_TYPE_UINT64:
-#if defined (_MSC_VER)  // || defined (__MINGW32__) || defined (__MINGW64__)
-		len = snprintf(NULL, 0, "%I64u", src->value.uint64);
-		sprintf(sq_buffer_alloc(buffer, len), "%I64u", src->value.uint64);
-#elif defined(__WORDSIZE) && (__WORDSIZE == 64) && !defined(__APPLE__)
-		len = snprintf(NULL, 0, "%lu", src->value.uint64);
-		sprintf(sq_buffer_alloc(buffer, len), "%lu", src->value.uint64);
-#elif defined(__GNUC__)
-		len = snprintf(NULL, 0, "%llu", src->value.uint64);
-		sprintf(sq_buffer_alloc(buffer, len), "%llu", src->value.uint64);
-#else // C99
-		len = snprintf(NULL, 0, "%" PRIu64, src->value.uint64);
-		sprintf(sq_buffer_alloc(buffer, len), "%" PRIu64, src->value.uint64);
-#endif
+		sq_buffer_write_uint64(buffer, src->value.uint64);
 		break;
 
 	case SQXC_TYPE_TIME:
-		tempstr = sq_time_to_string(src->value.rawtime, 0);
 		sq_buffer_write_c(buffer, '\'');
-		sq_buffer_write(buffer, tempstr);
+		sq_buffer_write_time(buffer, src->value.rawtime, 0);
 		sq_buffer_write_c(buffer, '\'');
-		free(tempstr);
 		break;
 
 	case SQXC_TYPE_DOUBLE:
-		len = snprintf(NULL, 0, "%lf", src->value.double_);
-		sprintf(sq_buffer_alloc(buffer, len), "%lf", src->value.double_);
+		sq_buffer_write_double(buffer, src->value.double_);
 		break;
 
 	case SQXC_TYPE_STR:
@@ -482,22 +487,20 @@ static int  sqxc_sql_write_value(SqxcSql *xcsql, Sqxc *src, SqBuffer *buffer)
 			sq_buffer_write(buffer, "NULL");
 			break;
 		}
-		// handle SQL string apostrophe (single quotes)
-		for (len = 0, idx = 0;  src->value.str[idx];  idx++, len++) {
-			// double up on the single quotes
-			if (src->value.str[idx] == '\'')
-				len++;
-		}
-		idx = buffer->writed;
-		sq_buffer_alloc(buffer, len +2);    // + '\'' x 2
-		buffer->mem[idx++] = '\'';
-		buffer->mem[idx +len] = '\'';
-		for (len = idx, idx = 0;  src->value.str[idx];  idx++, len++) {
+		// handle SQL string apostrophe (single quotes) in one pass
+		sq_buffer_write_c(buffer, '\'');
+		for (str = src->value.str;  ;  str = end + 1) {
+			end = sq_str_find_sql_escape(str);
+			if (end > str)
+				sq_buffer_write_n(buffer, str, (int)(end - str));
+			if (*end == 0)
+				break;
 			// double up on the single quotes
-			if (src->value.str[idx] == '\'')
-				buffer->mem[len++] = '\'';
-			buffer->mem[len] = src->value.str[idx];
+			sq_buffer_alloc(buffer, 2);
+			sq_buffer_r_at(buffer, 1) = '\'';
+			sq_buffer_r_at(buffer, 0) = '\'';
 		}
+		sq_buffer_write_c(buffer, '\'');
 		break;
 
 	default:
@@ -507,6 +510,138 @@ static int  sqxc_sql_write_value(SqxcSql *xcsql, Sqxc *src, SqBuffer *buffer)
 	return (src->code = SQCODE_OK);
 }
 
+// write placeholder to 'buffer' and append value to xcsql->params
+static int  sqxc_sql_write_param(SqxcSql *xcsql, Sqxc *src, SqBuffer *buffer)
+{
+	SqdbParam *param;
+	char      *mem;
+	int        len, num;
+
+	switch (src->type) {
+	case SQXC_TYPE_NULL:
+	case SQXC_TYPE_BOOL:
+	case SQXC_TYPE_INT:
+	case SQXC_TYPE_UINT:
+	case SQXC_TYPE_INT64:
+	case SQXC_TYPE_UINT64:
+	case SQXC_TYPE_TIME:
+	case SQXC_TYPE_DOUBLE:
+	case SQXC_TYPE_STR:
+		break;
+
+	default:
+		return (src->code = SQCODE_TYPE_NOT_SUPPORT);
+	}
+
+	if (xcsql->params_length == xcsql->params_size) {
+		xcsql->params_size = (xcsql->params_size) ? xcsql->params_size * 2 : 16;
+		xcsql->params = realloc(xcsql->params, sizeof(SqdbParam) * xcsql->params_size);
+	}
+	param = xcsql->params + xcsql->params_length++;
+	param->type  = src->type;
+	param->value = src->value;
+	if (src->type == SQXC_TYPE_STR) {
+		if (src->value.str == NULL)
+			param->type = SQXC_TYPE_NULL;
+		else {
+			// string may be freed after sending, copy it to 'params_buf'.
+			// Because 'params_buf' may be reallocated, store offset here and set address before executing.
+			len = (int)strlen(src->value.str) + 1;
+			param->value.int64 = xcsql->params_buf.writed;
+			sq_buffer_write_n(&xcsql->params_buf, src->value.str, len);
+		}
+	}
+
+	// placeholder
+	if (xcsql->db->info->placeholder == '$') {
+		// count number of digits
+		for (len = 1, num = xcsql->params_length;  num >= 10;  num /= 10)
+			len++;
+		mem = sq_buffer_alloc(buffer, len + 1);
+		mem[0] = '$';
+		for (num = xcsql->params_length;  len > 0;  num /= 10)
+			mem[len--] = '0' + num % 10;
+	}
+	else
+		sq_buffer_write_c(buffer, '?');
+
+	return (src->code = SQCODE_OK);
+}
+
+// execute SQL statement in xcsql->buf
+static int  sqxc_sql_exec(SqxcSql *xcsql)
+{
+	SqdbParam *param;
+	int        code;
+
+	if (xcsql->params_length > 0) {
+		// string values were copied to 'params_buf', set their address here.
+		for (param = xcsql->params;  param < xcsql->params + xcsql->params_length;  param++) {
+			if (param->type == SQXC_TYPE_STR)
+				param->value.str = xcsql->params_buf.mem + (intptr_t)param->value.int64;
+		}
+		code = sqdb_exec_params(xcsql->db, xcsql->buf, (Sqxc*)xcsql,
+		                        xcsql->params, xcsql->params_length);
+		xcsql->params_length = 0;
+		xcsql->params_buf.writed = 0;
+	}
+	else
+		code = sqdb_exec(xcsql->db, xcsql->buf, (Sqxc*)xcsql, NULL);
+	return code;
+}
+
+// write INSERT VALUES to xcsql->buf and execute it.
+// column names in xcsql->buf will be kept for the next rows.
+static int  sqxc_sql_exec_insert(SqxcSql *xcsql)
+{
+	SqBuffer *buffer = sqxc_get_buffer(xcsql);
+	SqBuffer *values = &xcsql->values_buf;
+	int64_t   changes = xcsql->changes;
+	int       names_len = buffer->writed;
+	int       code;
+
+	// length of ") VALUES " is 9
+	sq_buffer_resize(buffer, buffer->writed + 9 + values->writed + 1);
+	sq_buffer_write(buffer, ") VALUES ");
+	sq_buffer_write_n(buffer, values->mem, values->writed);
+	sq_buffer_write_c(buffer, 0);    // null-terminated
+
+	code = sqxc_sql_exec(xcsql);
+	// reset values buffer and keep "INSERT INTO table (columns" in buffer
+	buffer->writed = names_len;
+	values->writed = 0;
+	xcsql->row_count = 0;
+
+	if (code == SQCODE_OK) {
+		// Sqdb set id to the last inserted row id and changes to number of inserted rows.
+		if (changes == 0 && xcsql->id)
+			xcsql->id_first = xcsql->id - xcsql->changes + 1;
+		xcsql->changes += changes;
+	}
+	return code;
+}
+
+// return true if the next row may exceed limits of SQL statement
+static bool sqxc_sql_is_full(SqxcSql *xcsql)
+{
+	const SqdbInfo *info;
+
+	if ((xcsql->outer_type & SQXC_TYPE_ARRAY) == 0 || xcsql->db == NULL)
+		return false;
+	info = xcsql->db->info;
+	if (info->limit.n_params && xcsql->use_params) {
+		// each column uses one parameter
+		if (xcsql->params_length + xcsql->n_columns > info->limit.n_params)
+			return true;
+	}
+	if (info->limit.sql_length) {
+		// length of ") VALUES " is 9, ',' + null-terminated is 2
+		if (xcsql->buf_writed + 9 + xcsql->values_buf.writed + xcsql->row_length + 2 > info->limit.sql_length)
+			return true;
+	}
+	return false;
+}
+
 // ----------------------------------------------------------------------------
 // SqxcInfo
 
@@ -41,14 +41,20 @@ extern const SqxcInfo      SqxcInfo_SQL_;
 // macro for accessing variable of SqxcSqlite
 
 #define sqxc_sql_id(xcsql)         ( ((SqxcSql*)xcsql)->id )
+#define sqxc_sql_id_first(xcsql)   ( ((SqxcSql*)xcsql)->id_first )
 #define sqxc_sql_changes(xcsql)    ( ((SqxcSql*)xcsql)->changes )
 #define sqxc_sql_condition(xcsql)  ( ((SqxcSql*)xcsql)->condition )
 #define sqxc_sql_set_db(xcsql, sqdb)         \
 		{	((SqxcSql*)xcsql)->db = sqdb;    \
 			((SqxcSql*)xcsql)->quote[0] = (sqdb)->info->quote.identifier[0];   \
 			((SqxcSql*)xcsql)->quote[1] = (sqdb)->info->quote.identifier[1];   \
+			((SqxcSql*)xcsql)->use_params = sqdb_has_params(sqdb);             \
 		}
 
+// bool sqxc_sql_use_params(SqxcSql *xcsql);
+// set it to false if you want to write values into SQL statement.
+#define sqxc_sql_use_params(xcsql)    ( ((SqxcSql*)xcsql)->use_params )
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -144,8 +150,16 @@ struct SqxcSql
 	SqPtrArray   columns;     // UPDATE column list
 	bool         columns_sorted;
 
+	// variable for parameter placeholder. Values are collected in 'params' if 'use_params' is true.
+	bool         use_params;
+	SqdbParam   *params;
+	int          params_length;
+	int          params_size;
+	SqBuffer     params_buf;  // copy of string values
+
 	// Sqdb result variable
 	int64_t      id;          // the last inserted row id.
+	int64_t      id_first;    // the first inserted row id. It is used if multiple rows were inserted.
 	int64_t      changes;     // number of rows changed, deleted, or inserted.
 
 	// runtime variable
@@ -154,6 +168,11 @@ struct SqxcSql
 	int          col_count;   // used by INSERT and UPDATE
 	int          buf_reuse;   // used by INSERT and UPDATE
 
+	// variable for INSERT multiple rows. Rows will be split into multiple statements by SqdbInfo.limit
+	int          n_columns;   // number of columns in the first row
+	int          row_start;   // start position of current row in values_buf
+	int          row_length;  // maximum length of row in values_buf
+
 	SqBuffer     values_buf;  // used by INSERT INTO VALUES
 };
 
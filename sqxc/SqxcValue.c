@@ -12,6 +12,7 @@
  * See the Mulan PSL v2 for more details.
  */
 
+#include <SqConfig.h>
 #include <SqError.h>
 #include <SqType.h>
 #include <SqxcValue.h>
@@ -73,11 +74,14 @@ static int  sqxc_value_ctrl(SqxcValue *xcvalue, int id, void *data)
 		if (type == NULL)
 			type = xcvalue->element;
 		xcvalue->instance = sq_type_init_instance(type, &xcvalue->instance, true);
+		if (xcvalue->instance == NULL)
+			return SQCODE_ERROR;
 		break;
 
 	case SQXC_CTRL_FINISH:
 		// clear SqxcNested if problem occurred during processing
 		sqxc_clear_nested((Sqxc*)xcvalue);
+		sqxc_value_end_binding((Sqxc*)xcvalue);
 		break;
 
 	default:
@@ -93,15 +97,138 @@ static void  sqxc_value_init(SqxcValue *xcvalue)
 	xcvalue->supported_type = SQXC_TYPE_ALL;
 	// SqTypeParseFunc like sq_type_object_parse(), sq_type_xxx_array_parse() need this line
 	xcvalue->dest = (Sqxc*)xcvalue;
+	sq_array_init(&xcvalue->bindings, sizeof(SqxcValueBinding), 16);
+	sq_array_init(&xcvalue->columns, sizeof(SqxcValueColumn), 16);
 }
 
 static void  sqxc_value_final(SqxcValue *xcvalue)
 {
+	sq_array_final(&xcvalue->bindings);
+	sq_array_final(&xcvalue->columns);
 //	if (xcvalue->instance)
 //		sq_type_final_instance(xcvalue->current, &xcvalue->instance, true);
 //	sqxc_final(xcvalue);
 }
 
+// ----------------------------------------------------------------------------
+// binding of result set
+
+void  sqxc_value_begin_binding(Sqxc *xc)
+{
+	SqxcValue *xcvalue = (SqxcValue*)xc;
+
+	if (xc->info != SQXC_INFO_VALUE)
+		return;
+	xcvalue->binding_src = xc;
+	xcvalue->bindings.length = 0;
+	xcvalue->binding_next = 0;
+	xcvalue->columns.length = 0;
+}
+
+void  sqxc_value_end_binding(Sqxc *xc)
+{
+	SqxcValue *xcvalue = (SqxcValue*)xc;
+
+	if (xc->info != SQXC_INFO_VALUE)
+		return;
+	xcvalue->binding_src = NULL;
+	xcvalue->bindings.length = 0;
+	xcvalue->columns.length = 0;
+}
+
+SqxcValueBinding *sqxc_value_get_binding(SqxcValue *xcvalue, Sqxc *src, const SqType *type)
+{
+	SqxcValueBinding *binding;
+	int  length = xcvalue->bindings.length;
+	int  index;
+
+	if (xcvalue->binding_src != src || src == NULL)
+		return NULL;
+
+	// columns of every row are sent in the same order, so the next binding is checked first.
+	index = xcvalue->binding_next;
+	for (int count = 0;  count < length;  count++, index++) {
+		if (index >= length)
+			index = 0;
+		binding = sq_array_addr(&xcvalue->bindings, SqxcValueBinding, index);
+		if (binding->name == src->name && binding->type == type) {
+			xcvalue->binding_next = index + 1;
+			return binding;
+		}
+	}
+	return NULL;
+}
+
+SqxcValueBinding *sqxc_value_add_binding(SqxcValue *xcvalue, Sqxc *src, const SqType *type, void **addr)
+{
+	SqxcValueBinding *binding;
+
+	if (xcvalue->binding_src != src || src == NULL)
+		return NULL;
+
+	binding = sq_array_alloc(&xcvalue->bindings, 1);
+	binding->name = src->name;
+	binding->type = type;
+	binding->addr = addr;
+	binding->data = 0;
+	xcvalue->binding_next = xcvalue->bindings.length;
+	return binding;
+}
+
+void **sqxc_value_find_entry(SqxcValue *xcvalue, Sqxc *src, const SqType *type)
+{
+	SqxcValueBinding *binding;
+	void **addr;
+
+	binding = sqxc_value_get_binding(xcvalue, src, type);
+	if (binding)
+		return binding->addr;
+	addr = sq_type_find_entry(type, src->name, NULL);
+	sqxc_value_add_binding(xcvalue, src, type, addr);
+	return addr;
+}
+
+Sqxc *sqxc_value_send_column(Sqxc *xc, int index)
+{
+	SqxcValue       *xcvalue = (SqxcValue*)xc;
+	SqxcValueColumn *column;
+	SqxcNested      *nested;
+	SqEntry        **addr;
+
+	if (xc->info != SQXC_INFO_VALUE || xcvalue->binding_src != xc || xcvalue->nested_count == 0)
+		return sqxc_send(xc);
+	// current object must be instance of element type and it is ready to parse.
+	nested = xcvalue->nested;
+	if (nested->data2 != xcvalue->element)
+		return sqxc_send(xc);
+#if SQ_CONFIG_SQXC_NESTED_FAST_TYPE_MATCH
+	if (nested->data3 != nested->data)
+		return sqxc_send(xc);
+#endif
+
+	// decide how to write columns when parsing the first row
+	if (index >= xcvalue->columns.length) {
+		if (index != xcvalue->columns.length)
+			return sqxc_send(xc);
+		column = sq_array_alloc(&xcvalue->columns, 1);
+		column->type = NULL;
+		if (xcvalue->element->parse == sq_type_object_parse) {
+			addr = (SqEntry**)sq_type_find_entry(xcvalue->element, xc->name, NULL);
+			if (addr && SQ_TYPE_IS_BUILTIN((*addr)->type) && ((*addr)->bit_field & SQB_POINTER) == 0) {
+				column->type   = (*addr)->type;
+				column->offset = (*addr)->offset;
+			}
+		}
+	}
+
+	column = sq_array_addr(&xcvalue->columns, SqxcValueColumn, index);
+	if (column->type) {
+		if (column->type->parse((char*)nested->data + column->offset, column->type, xc) == SQCODE_OK)
+			return xc;
+	}
+	return sqxc_send(xc);
+}
+
 // ----------------------------------------------------------------------------
 // SqxcInfo
 
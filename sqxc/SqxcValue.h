@@ -15,6 +15,8 @@
 #ifndef SQXC_VALUE_H
 #define SQXC_VALUE_H
 
+#include <SqArray.h>
+#include <SqArena.h>
 #include <Sqxc.h>
 #include <SqEntry.h>
 
@@ -22,6 +24,8 @@
 // C/C++ common declarations: declare type, structure, macro, enumeration.
 
 typedef struct SqxcValue        SqxcValue;
+typedef struct SqxcValueBinding SqxcValueBinding;
+typedef struct SqxcValueColumn  SqxcValueColumn;
 
 // ----------------------------------------------------------------------------
 // C declarations: declare C data, function, and others.
@@ -44,6 +48,38 @@ extern const SqxcInfo        SqxcInfo_Value_;
 // instance of container (or element)
 #define sqxc_value_instance(xcvalue)      ( ((SqxcValue*)xcvalue)->instance )
 
+// SqArena that elements, their pointer members and strings are allocated from. It can be NULL.
+#define sqxc_value_arena(xcvalue)         ( ((SqxcValue*)xcvalue)->arena )
+
+// SqArena of SqxcValue that 'src' sends data to. It is NULL if destination of 'src' is not SqxcValue.
+#define sqxc_value_src_arena(src)         \
+		( ((src)->dest && (src)->dest->info == SQXC_INFO_VALUE) ? ((SqxcValue*)(src)->dest)->arena : NULL )
+
+/* binding of result set
+	Sqdb calls sqxc_value_begin_binding() before sending rows of a result set.
+	Column names (pointers) that are sent by Sqdb must be unchanged until sqxc_value_end_binding() is called.
+	SqTypeParseFunc binds column name to entry when parsing the first row, other rows use these bindings
+	instead of searching entry by name.
+	These do nothing if 'xcvalue' is not SqxcValue.
+ */
+void  sqxc_value_begin_binding(Sqxc *xcvalue);
+void  sqxc_value_end_binding(Sqxc *xcvalue);
+
+// These are used by SqTypeParseFunc. They use 'src->name' as column name.
+// They return NULL if binding is disabled or 'src' is not Sqxc that Sqdb sends rows through.
+SqxcValueBinding *sqxc_value_get_binding(SqxcValue *xcvalue, Sqxc *src, const SqType *type);
+SqxcValueBinding *sqxc_value_add_binding(SqxcValue *xcvalue, Sqxc *src, const SqType *type, void **addr);
+
+// find entry in 'type' by 'src->name'. It uses binding if binding is enabled.
+void **sqxc_value_find_entry(SqxcValue *xcvalue, Sqxc *src, const SqType *type);
+
+/* Sqdb uses this to send column 'index' of current row during binding.
+	If element type is parsed by sq_type_object_parse() and column is bound to entry of built-in type,
+	it writes value of 'xc' to member of instance directly and returns 'xc'.
+	Otherwise it calls sqxc_send(xc) and returns it's result.
+ */
+Sqxc *sqxc_value_send_column(Sqxc *xc, int index);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -130,6 +166,34 @@ struct SqxcValue
 	// instance type = element when calling get(id)
 	const SqType *element;    // type of table (or entry)
 	const SqType *container;  // type of array (or list)
+
+	// bindings of result set. see sqxc_value_begin_binding()
+	Sqxc         *binding_src;    // Sqdb sends rows through it. NULL if binding is disabled.
+	SqArray       bindings;       // element type is SqxcValueBinding
+	int           binding_next;   // index of binding that is expected to be used next
+	SqArray       columns;        // element type is SqxcValueColumn. It is indexed by column index.
+
+	// If 'arena' is not NULL, elements, their pointer members and strings are allocated from it.
+	// Container is still allocated by malloc(). Type of element must be checked by sq_type_can_use_arena().
+	SqArena      *arena;
+};
+
+/*	SqxcValueBinding - bind column name to entry
+ */
+struct SqxcValueBinding
+{
+	const char    *name;     // column name that is sent by Sqdb
+	const SqType  *type;     // type that is parsing column
+	void         **addr;     // address of entry in 'type'. It is NULL if entry is not found.
+	int            data;     // extra data of SqTypeParseFunc
+};
+
+/*	SqxcValueColumn - member of element instance that column is written to directly
+ */
+struct SqxcValueColumn
+{
+	const SqType  *type;     // built-in type of member. It is NULL if column must be sent by sqxc_send().
+	size_t         offset;   // offset of member in element instance
 };
 
 // ----------------------------------------------------------------------------
@@ -20,6 +20,9 @@
 #include <SqPtrArray.h>
 #include <SqStrArray.h>
 #include <SqBuffer.h>
+#include <SqArena.h>
+#include <SqSlab.h>
+#include <SqThread.h>
 
 #include <SqType.h>
 #include <SqEntry.h>
@@ -34,6 +37,7 @@
 
 // ------------------------------------
 #include <Sqdb.h>
+#include <SqdbPool.h>
 
 #if SQ_CONFIG_HAVE_SQLITE
 #include <SqdbSqlite.h>
@@ -52,6 +56,9 @@
 
 #include <SqxcSql.h>
 #include <SqxcValue.h>
+#include <SqxcJson.h>
+#include <SqxcMsgpack.h>
+#include <SqxcCsv.h>
 
 #if SQ_CONFIG_HAVE_JSONC
 #include <SqxcJsonc.h>
@@ -63,6 +63,7 @@ typedef struct SqCommandValue    SqCommandValue;
 	(SqEntry**) command_options,                                   \
 	sizeof(command_options) / sizeof(SqOption*),                   \
 	bit_value,                                                     \
+	NULL,                                                          \
 	NULL,                                                          \
 	                                                               \
 	(SqCommandFunc) handle_func,                                   \
@@ -199,6 +200,9 @@ struct SqCommand
 	// Instance of SqType will be passed to SqType.on_destroy
 	SqDestroyFunc  on_destroy;     // destroy notifier for SqType. It can be NULL.
 
+	// hash table of entry names. It is built by sq_type_sort_entry() if SqType is dynamic.
+	SqTypeHash    *entry_hash;     // It must be NULL in constant SqType.
+
 	// ------ SqCommand members ------
 	SqCommandFunc  handle;
 	const char    *parameter;
@@ -226,6 +226,9 @@ static int  sq_type_row_parse(void *instance, const SqType *type, Sqxc *src)
 	SqxcValue  *xc_value = (SqxcValue*)src->dest;
 	SqxcNested *nested;
 	SqBuffer   *buf;
+	SqRow      *row = instance;
+	int         code;
+	SqxcValueBinding *binding;
 	union {
 		void       **addr;
 		SqEntry     *entry;
@@ -289,38 +292,45 @@ static int  sq_type_row_parse(void *instance, const SqType *type, Sqxc *src)
 		return (src->code = SQCODE_OK);
 	}
 
-	// get table name from "table.column" string
-	temp.dot = strchr(src->name, '.');
-	if (type->n_entry == 1 && temp.dot == NULL) {
-		// There is only 1 table in SqTypeRow and no table name in 'src->name'
-		p.addr = (void**)type->entry;
-		temp.len = 0;
-	}
+	// Rows of result set use binding instead of searching table and column.
+	binding = sqxc_value_get_binding(xc_value, src, type);
+	if (binding)
+		p.addr = binding->addr;
 	else {
-		// There are multiple tables in SqTypeRow
-		if (temp.dot == NULL || temp.dot == src->name) {
-			sq_type_row_parse_unknown(instance, src);
-			return (src->code = SQCODE_ENTRY_NOT_FOUND);
+		// get table name from "table.column" string
+		temp.dot = strchr(src->name, '.');
+		if (type->n_entry == 1 && temp.dot == NULL) {
+			// There is only 1 table in SqTypeRow and no table name in 'src->name'
+			p.addr = (void**)type->entry;
+			temp.len = 0;
+		}
+		else if (temp.dot == NULL || temp.dot == src->name) {
+			// There are multiple tables in SqTypeRow, but no table name in 'src->name'
+			p.addr = NULL;
 		}
-		temp.len = (int)(temp.dot - src->name);
-		// use SqxcValue.buf to find entry
-		buf = sqxc_get_buffer(xc_value);
-		buf->writed = 0;
-		strncpy(sq_buffer_alloc(buf, temp.len*2), src->name, temp.len);   // alloc(buf, (temp.len+1)*2)
-		buf->mem[temp.len] = 0;    // null-terminated
-		temp.len++;                // + '.'
-		// find table by it's name in SqTypeRow.entry
-		p.addr = sq_type_find_entry(type, buf->mem, NULL);
-		if (p.addr == NULL) {
-			sq_type_row_parse_unknown(instance, src);
-			return (src->code = SQCODE_ENTRY_NOT_FOUND);
+		else {
+			// There are multiple tables in SqTypeRow
+			temp.len = (int)(temp.dot - src->name);
+			// use SqxcValue.buf to find entry
+			buf = sqxc_get_buffer(xc_value);
+			buf->writed = 0;
+			strncpy(sq_buffer_alloc(buf, temp.len*2), src->name, temp.len);   // alloc(buf, (temp.len+1)*2)
+			buf->mem[temp.len] = 0;    // null-terminated
+			temp.len++;                // + '.'
+			// find table by it's name in SqTypeRow.entry
+			p.addr = sq_type_find_entry(type, buf->mem, NULL);
 		}
+
+		if (p.addr) {
+			// 'p.entry' pointer to element of SqTypeRow.entry
+			p.entry = *p.addr;
+			// find column by it's name in 'p.entry->type' ('p.entry->type' pointer to SqTable.type)
+			p.addr = sq_type_find_entry(p.entry->type, src->name + temp.len, NULL);
+		}
+		// bind column name to SqColumn
+		sqxc_value_add_binding(xc_value, src, type, p.addr);
 	}
 
-	// 'p.entry' pointer to element of SqTypeRow.entry
-	p.entry = *p.addr;
-	// find column by it's name in 'p.entry->type' ('p.entry->type' pointer to SqTable.type)
-	p.addr = sq_type_find_entry(p.entry->type, src->name + temp.len, NULL);
 	if (p.addr == NULL) {
 		sq_type_row_parse_unknown(instance, src);
 		return (src->code = SQCODE_ENTRY_NOT_FOUND);
@@ -341,7 +351,16 @@ static int  sq_type_row_parse(void *instance, const SqType *type, Sqxc *src)
 	temp.val = sq_row_alloc(instance, 1);
 	if (SQ_TYPE_NOT_BUILTIN(type))
 		temp.val = sq_type_init_instance(type, temp.val, true);
-	return type->parse(temp.val, type, src);
+	code = type->parse(temp.val, type, src);
+	// If built-in type can't parse value, caller may send it again in other type (e.g. SQXC_TYPE_STR).
+	// Remove SqRowColumn and SqValue to avoid duplicate column.
+	// Other types keep them because SqxcNested that is doing type match points to the instance.
+	if (code != SQCODE_OK && SQ_TYPE_IS_BUILTIN(type)) {
+		row->length--;
+		row->cols_length--;
+		free((char*)row->cols[row->cols_length].name);
+	}
+	return code;
 }
 
 static Sqxc *sq_type_row_write(void *instance, const SqType *type, Sqxc *dest)
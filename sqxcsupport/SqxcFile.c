@@ -15,24 +15,208 @@
 #ifdef _MSC_VER
 #define _CRT_SECURE_NO_WARNINGS
 #endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SQXC_FILE_HAVE_MMAP    1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include <string.h>     // strlen(), memcpy()
+
 #include <SqError.h>
 #include <SqxcFile.h>
 
+/* ----------------------------------------------------------------------------
+	*** In input chain:
+	SqxcFile Reader ---> SQXC_TYPE_STR or SQXC_TYPE_RAW ---> parser
+ */
+
+// send a piece of file from SqxcFile Reader(source) to next element (parser)
+static int  sqxc_file_reader_emit(SqxcFile *xcfile, int type, char *data, int length)
+{
+	Sqxc     *xcparser = xcfile->peer;
+	SqBuffer  piece;
+
+	xcfile->type = type;
+	if (type == SQXC_TYPE_RAW) {
+		piece.mem = data;
+		piece.size = length;
+		piece.writed = length;
+		xcfile->value.pointer = &piece;
+	}
+	else
+		xcfile->value.str = data;
+	xcparser->info->send(xcparser, (Sqxc*)xcfile);
+	return xcfile->code;
+}
+
+#if SQXC_FILE_HAVE_MMAP
+// return -1 if file can't be mapped
+static int  sqxc_file_reader_map(SqxcFile *xcfile)
+{
+	struct stat  st;
+	char   *mem;
+	size_t  size;
+	size_t  offset;
+	int     length;
+	int     code = SQCODE_OK;
+
+	if (fstat(fileno(xcfile->file), &st) == -1 || S_ISREG(st.st_mode) == 0)
+		return -1;
+	if (st.st_size <= 0 || (unsigned long long)st.st_size > (size_t)-1)
+		return -1;
+	size = (size_t)st.st_size;
+	mem = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(xcfile->file), 0);
+	if (mem == MAP_FAILED)
+		return -1;
+#ifdef MADV_SEQUENTIAL
+	madvise(mem, size, MADV_SEQUENTIAL);
+#endif
+
+	for (offset = 0;  offset < size;  offset += length) {
+		length = (size - offset < (size_t)xcfile->buffer_size) ? (int)(size - offset) : xcfile->buffer_size;
+		code = sqxc_file_reader_emit(xcfile, SQXC_TYPE_RAW, mem + offset, length);
+		if (code >= SQCODE_ERROR)
+			break;
+	}
+
+	munmap(mem, size);
+	return code;
+}
+#endif  // SQXC_FILE_HAVE_MMAP
+
+static int  sqxc_file_reader_send(SqxcFile *xcfile, Sqxc *src)
+{
+	int   type;
+	int   length;
+	int   code = -1;
+
+	if (xcfile->peer == NULL)
+		return (src->code = SQCODE_NOT_SUPPORT);
+	if (xcfile->file == NULL)
+		return (src->code = SQCODE_OPEN_FAILED);
+
+	xcfile->name = src->name;
+	xcfile->entry = src->entry;
+	if (xcfile->peer->supported_type & SQXC_TYPE_RAW) {
+		type = SQXC_TYPE_RAW;
+#if SQXC_FILE_HAVE_MMAP
+		code = sqxc_file_reader_map(xcfile);
+#endif
+	}
+	else
+		type = SQXC_TYPE_STR;
+
+	// file can't be mapped. read it in blocks.
+	if (code == -1) {
+		code = SQCODE_OK;
+		for (;;) {
+			length = (int)fread(xcfile->buf, 1, xcfile->buffer_size, xcfile->file);
+			if (length == 0)
+				break;
+			xcfile->buf[length] = 0;    // null-terminated for SQXC_TYPE_STR
+			code = sqxc_file_reader_emit(xcfile, type, xcfile->buf, length);
+			if (code >= SQCODE_ERROR)
+				return (src->code = code);
+		}
+	}
+	else if (code >= SQCODE_ERROR)
+		return (src->code = code);
+
+	// end of data
+	code = sqxc_file_reader_emit(xcfile, SQXC_TYPE_NULL, NULL, 0);
+	return (src->code = code);
+}
+
+static int  sqxc_file_reader_ctrl(SqxcFile *xcfile, int id, void *data)
+{
+	switch(id) {
+	case SQXC_CTRL_READY:
+		if (xcfile->file)
+			fclose(xcfile->file);
+		xcfile->file = NULL;
+		if (xcfile->filename)
+			xcfile->file = fopen(xcfile->filename, "rb");
+		if (xcfile->buffer_size <= 0)
+			xcfile->buffer_size = SQXC_FILE_BUFFER_SIZE;
+		// 1 extra byte for null-terminated
+		sq_buffer_resize(sqxc_get_buffer(xcfile), xcfile->buffer_size + 1);
+		break;
+
+	case SQXC_CTRL_FINISH:
+		if (xcfile->file)
+			fclose(xcfile->file);
+		xcfile->file = NULL;
+		break;
+
+	default:
+		return SQCODE_NOT_SUPPORT;
+	}
+
+	return SQCODE_OK;
+}
+
+static void  sqxc_file_reader_init(SqxcFile *xcfile)
+{
+	xcfile->file = NULL;
+	xcfile->filename = NULL;
+	xcfile->buffer_size = SQXC_FILE_BUFFER_SIZE;
+}
+
+static void  sqxc_file_reader_final(SqxcFile *xcfile)
+{
+	if (xcfile->file)
+		fclose(xcfile->file);
+}
+
 /* ----------------------------------------------------------------------------
 	*** In output chain:
-	SQXC_TYPE_STR ---> SqxcFile Writer
+	SQXC_TYPE_STR or SQXC_TYPE_RAW ---> SqxcFile Writer
  */
 
+static void  sqxc_file_writer_flush(SqxcFile *xcfile)
+{
+	if (xcfile->buf_writed > 0) {
+		fwrite(xcfile->buf, 1, xcfile->buf_writed, xcfile->file);
+		xcfile->buf_writed = 0;
+	}
+}
+
 static int  sqxc_file_writer_send(SqxcFile *xcfile, Sqxc *src)
 {
-	if (src->type != SQXC_TYPE_STR) {
+	const char *data;
+	size_t      length;
+
+	switch (src->type) {
+	case SQXC_TYPE_STR:
+		data = src->value.str;
+		length = (data) ? strlen(data) : 0;
+		break;
+
+	case SQXC_TYPE_RAW:
+		data = ((SqBuffer*)src->value.pointer)->mem;
+		length = ((SqBuffer*)src->value.pointer)->writed;
+		break;
+
+	default:
 		/* set required type if return SQCODE_TYPE_NOT_MATCH
 		src->required_type = SQXC_TYPE_STR;
 		*/
 		return (src->code = SQCODE_TYPE_NOT_MATCH);
 	}
 
-	fputs(src->value.str, xcfile->file);
+	if (xcfile->file == NULL)
+		return (src->code = SQCODE_OPEN_FAILED);
+
+	if (xcfile->buf_writed + length > (size_t)xcfile->buffer_size)
+		sqxc_file_writer_flush(xcfile);
+	if (length >= (size_t)xcfile->buffer_size)
+		fwrite(data, 1, length, xcfile->file);
+	else {
+		memcpy(xcfile->buf + xcfile->buf_writed, data, length);
+		xcfile->buf_writed += (int)length;
+	}
 	return (src->code = SQCODE_OK);
 }
 
@@ -40,13 +224,22 @@ static int  sqxc_file_writer_ctrl(SqxcFile *xcfile, int id, void *data)
 {
 	switch(id) {
 	case SQXC_CTRL_READY:
+		if (xcfile->file)
+			fclose(xcfile->file);
+		xcfile->file = NULL;
 		if (xcfile->filename)
-			xcfile->file = fopen(xcfile->filename, "w");
+			xcfile->file = fopen(xcfile->filename, "wb");
+		if (xcfile->buffer_size <= 0)
+			xcfile->buffer_size = SQXC_FILE_BUFFER_SIZE;
+		sq_buffer_resize(sqxc_get_buffer(xcfile), xcfile->buffer_size);
+		xcfile->buf_writed = 0;
 		break;
 
 	case SQXC_CTRL_FINISH:
-		if (xcfile->file)
+		if (xcfile->file) {
+			sqxc_file_writer_flush(xcfile);
 			fclose(xcfile->file);
+		}
 		xcfile->file = NULL;
 		// Because SqxcFile never use SqxcNested, it doesn't need to clear SqxcNested stack.
 //		sqxc_clear_nested((Sqxc*)xcfile);
@@ -61,20 +254,32 @@ static int  sqxc_file_writer_ctrl(SqxcFile *xcfile, int id, void *data)
 
 static void  sqxc_file_writer_init(SqxcFile *xcfile)
 {
-	sq_buffer_resize(sqxc_get_buffer(xcfile), 4096);
+	xcfile->supported_type = SQXC_TYPE_STR | SQXC_TYPE_RAW;
 	xcfile->file = NULL;
 	xcfile->filename = NULL;
+	xcfile->buffer_size = SQXC_FILE_BUFFER_SIZE;
 }
 
 static void  sqxc_file_writer_final(SqxcFile *xcfile)
 {
-	if (xcfile->file)
+	if (xcfile->file) {
+		sqxc_file_writer_flush(xcfile);
 		fclose(xcfile->file);
+	}
 }
 
 // ----------------------------------------------------------------------------
 // SqxcInfo
 
+const SqxcInfo SqxcInfo_FileReader_ =
+{
+	sizeof(SqxcFile),
+	(SqInitFunc)sqxc_file_reader_init,
+	(SqFinalFunc)sqxc_file_reader_final,
+	(SqxcCtrlFunc)sqxc_file_reader_ctrl,
+	(SqxcSendFunc)sqxc_file_reader_send,
+};
+
 const SqxcInfo SqxcInfo_FileWriter_ =
 {
 	sizeof(SqxcFile),
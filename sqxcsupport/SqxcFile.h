@@ -16,6 +16,7 @@
 #define SQXC_FILE_H
 
 #include <stdio.h>
+#include <SqBuffer.h>
 #include <Sqxc.h>
 
 // ----------------------------------------------------------------------------
@@ -23,6 +24,11 @@
 
 typedef struct SqxcFile        SqxcFile;
 
+// default size of buffer for reading and writing
+#ifndef SQXC_FILE_BUFFER_SIZE
+#define SQXC_FILE_BUFFER_SIZE    65536
+#endif
+
 // ----------------------------------------------------------------------------
 // C declarations: declare C data, function, and others.
 
@@ -30,9 +36,12 @@ typedef struct SqxcFile        SqxcFile;
 extern "C" {
 #endif
 
+extern const SqxcInfo              SqxcInfo_FileReader_;
 extern const SqxcInfo              SqxcInfo_FileWriter_;
+#define SQXC_INFO_FILE_READER    (&SqxcInfo_FileReader_)
 #define SQXC_INFO_FILE_WRITER    (&SqxcInfo_FileWriter_)
 
+#define sqxc_file_reader_new()        sqxc_new(SQXC_INFO_FILE_READER)
 #define sqxc_file_writer_new()        sqxc_new(SQXC_INFO_FILE_WRITER)
 
 #ifdef __cplusplus
@@ -42,14 +51,32 @@ extern const SqxcInfo              SqxcInfo_FileWriter_;
 // ----------------------------------------------------------------------------
 // C/C++ common definitions: define structure
 
-/*	SqxcFile - output to a file.
+/*	SqxcFile - input from a file or output to a file.
 
 	Sqxc
 	|
 	`--- SqxcFile
 
+	*** In input chain:
+	SqxcFile Reader ---> SQXC_TYPE_STR or SQXC_TYPE_RAW ---> parser ---> SQXC_TYPE_xxxx
+	                     (pieces of file)                    (SqxcJsonParser, SqxcCsvParser...)
+
 	*** In output chain:
-	SQXC_TYPE_STR ---> SqxcFile Writer
+	SQXC_TYPE_STR or SQXC_TYPE_RAW ---> SqxcFile Writer
+
+	Reader:
+	Reader must be followed by parser in Sqxc chain. e.g. SqxcValue -> SqxcFile Reader -> SqxcJsonParser
+	Reader opens 'filename' in sqxc_ready(). Sending any arguments to reader starts reading,
+	reader sends whole file piece by piece to the next element, then sends SQXC_TYPE_NULL as end of data.
+	It returns code of the last sending. Name of top level value is taken from arguments.
+	If next element supports SQXC_TYPE_RAW (e.g. SqxcMsgpackParser), file is sent as SQXC_TYPE_RAW and
+	it is mapped into memory if platform supports mmap(). Otherwise file is read in blocks of 'buffer_size'
+	bytes and each block is sent as null-terminated SQXC_TYPE_STR.
+
+	Writer:
+	Writer opens 'filename' in sqxc_ready(). It copies small data to Sqxc.buf and
+	writes Sqxc.buf to file when it is full or in sqxc_finish().
+	Data that is not smaller than 'buffer_size' is written to file directly.
 
    The correct way to derive Sqxc:  (conforming C++11 standard-layout)
    1. Use Sq::XcMethod to inherit member function(method).
@@ -114,6 +141,10 @@ struct SqxcFile
 
 	const char  *filename;
 	FILE        *file;
+
+	// size of Sqxc.buf. default is SQXC_FILE_BUFFER_SIZE.
+	// Reader uses it as block size, writer uses it as size of write buffer.
+	int          buffer_size;
 };
 
 // ----------------------------------------------------------------------------
@@ -125,6 +156,16 @@ namespace Sq {
 
 /* All derived struct/class must be C++11 standard-layout. */
 
+struct XcFileReader : SqxcFile
+{
+	XcFileReader() {
+		sqxc_init((Sqxc*)this, SQXC_INFO_FILE_READER);
+	}
+	~XcFileReader() {
+		sqxc_final((Sqxc*)this);
+	}
+};
+
 struct XcFileWriter : SqxcFile
 {
 	XcFileWriter() {
@@ -29,6 +29,7 @@
 #include <SqdbEmpty.h>
 #include <SqxcEmpty.h>
 #include <SqStorage.h>
+#include <SqdbPool.h>
 
 #include <SqPairs.h>
 
@@ -370,6 +371,46 @@ void test_storage()
 
 	storage->insert<Company>(NULL);
 	storage->get<Company>(1);
+
+	// SqdbEmpty doesn't support cursor
+	Sq::Cursor<Company> cursor = storage->cursor<Company>("WHERE id > 0");
+	assert((bool)cursor == false);
+	for (Company &company : cursor)
+		assert(company.id > 0);
+
+#if SQ_CONFIG_HAVE_THREAD
+	// future throws exception because workers are not started
+	std::future<int> future = storage->runAsync([](SqStorage *storage) { return 1; });
+	bool  thrown = false;
+	try {
+		future.get();
+	}
+	catch (std::runtime_error &) {
+		thrown = true;
+	}
+	assert(thrown == true);
+
+	// workers require pool that has enough connections
+	assert(storage->startWorkers(2) == SQCODE_NOT_SUPPORT);
+	SqdbConfigEmpty  configEmpty = {0};
+	SqdbPoolConfig   poolConfig = {0};
+	poolConfig.max_size = 2;
+	SqdbPool *pool = sqdb_pool_new(SQDB_INFO_EMPTY, (SqdbConfig*)&configEmpty, &poolConfig);
+	sqdb_pool_open(pool, "test-cxx");
+	storage->setPool(pool);
+	assert(storage->startWorkers(3) == SQCODE_ERROR);
+
+	assert(storage->startWorkers(2) == SQCODE_OK);
+	future = storage->runAsync([](SqStorage *storage) { return (storage->thread) ? 2 : 0; });
+	std::future<Company*> futureCompany = storage->getAsync<Company>(1);
+	storage->removeAsync<Company>(1).get();
+	assert(future.get() == 2);
+	assert(futureCompany.get() == NULL);
+	storage->stopWorkers();
+	storage->setPool(NULL);
+	storage->setThreadSafe(false);
+	sqdb_pool_free(pool);
+#endif
 }
 
 // ----------------------------------------------------------------------------
@@ -416,6 +457,24 @@ void test_type()
 
 	assert(type->size == type_size);
 	delete type;
+
+	// Sq::TypeStl doesn't have hash table of entry names
+	Sq::TypeStl<std::vector<int>> *typeStl = new Sq::TypeStl<std::vector<int>>(SQ_TYPE_INT);
+	assert(typeStl->entry_hash == NULL);
+	delete typeStl;
+
+#ifdef SQ_ARENA_HAVE_MEMORY_RESOURCE
+	// std::pmr container allocates memory from resource of Sq::TypeStl
+	Sq::Arena          arena;
+	Sq::ArenaResource  resource(&arena);
+	Sq::TypeStl<std::pmr::vector<int>>  typePmr(SQ_TYPE_INT, &resource);
+	std::pmr::vector<int> *vec = (std::pmr::vector<int>*)malloc(typePmr.size);
+	sq_type_init_instance(&typePmr, vec, false);
+	assert(vec->get_allocator().resource() == &resource);
+	vec->push_back(1);
+	sq_type_final_instance(&typePmr, vec, false);
+	free(vec);
+#endif
 }
 
 void test_pairs()
@@ -12,6 +12,7 @@
  * See the Mulan PSL v2 for more details.
  */
 
+#include <assert.h>
 #include <stdio.h>
 
 #include <sqxclib.h>
@@ -423,6 +424,50 @@ void test_sqdb_migrate_sqlite_sync(Sqdb *db)
 	sq_schema_free(schema_v4);
 }
 
+// find columns after renaming column. hash table of entry names must be rebuilt.
+void test_sqdb_migrate_rename_find(Sqdb *db)
+{
+	SqSchema   *schema;
+	SqSchema   *schema_v1;
+	SqSchema   *schema_v2;
+	SqTable    *table;
+
+	schema  = sq_schema_new("current");
+	schema->version = 0;
+
+	schema_v1  = sq_schema_new("ver1");
+	schema_v1->version = 1;
+	table = sq_schema_create(schema_v1, "letters", NULL);
+	sq_table_add_int(table, "a", 0);
+	sq_table_add_int(table, "b", sizeof(int));
+	sq_table_add_int(table, "c", sizeof(int) * 2);
+	sq_table_add_int(table, "d", sizeof(int) * 3);
+
+	schema_v2 = sq_schema_new("ver2");
+	schema_v2->version = 2;
+	table = sq_schema_alter(schema_v2, "letters", NULL);
+	sq_table_rename_column(table, "a", "z");
+
+	sqdb_migrate(db, schema, schema_v1);
+	table = sq_schema_find(schema, "letters");
+	assert(sq_table_find_column(table, "a") != NULL);
+	assert(sq_table_find_column(table, "d") != NULL);
+
+	sqdb_migrate(db, schema, schema_v2);
+	sqdb_migrate(db, schema, NULL);
+	table = sq_schema_find(schema, "letters");
+	assert(table != NULL);
+	assert(sq_table_find_column(table, "a") == NULL);
+	assert(sq_table_find_column(table, "z") != NULL);
+	assert(sq_table_find_column(table, "b") != NULL);
+	assert(sq_table_find_column(table, "c") != NULL);
+	assert(sq_table_find_column(table, "d") != NULL);
+
+	sq_schema_free(schema);
+	sq_schema_free(schema_v1);
+	sq_schema_free(schema_v2);
+}
+
 // ----------------------------------------------------------------------------
 
 #if   SQ_CONFIG_HAVE_SQLITE && USE_SQLITE_IF_POSSIBLE
@@ -491,6 +536,11 @@ int  main(void)
 
 	sqdb_close(db);
 
+	if (sqdb_open(db, "test-migration-rename") == SQCODE_OK) {
+		test_sqdb_migrate_rename_find(db);
+		sqdb_close(db);
+	}
+
 	sqdb_free(db);
 	return EXIT_SUCCESS;
 }
@@ -14,16 +14,23 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <SqConfig.h>
+#include <SqError.h>
 #include <SqPtrArray.h>
 #include <SqStrArray.h>
+#include <SqSlab.h>
 #include <SqSchema-macro.h>
 #include <SqJoint.h>
 #include <SqRow.h>
 #include <SqxcSql.h>
 #include <SqxcValue.h>
 #include <SqxcEmpty.h>
+#include <SqxcJson.h>
+#include <SqxcMsgpack.h>
+#include <SqxcCsv.h>
+#include <SqxcFile.h>
 #if SQ_CONFIG_HAVE_JSONC
 #include <SqxcJsonc.h>
 #endif
@@ -94,6 +101,126 @@ SqTable *create_user_table_by_type(SqSchema *schema)
 //	return sq_schema_create_full(schema, "users", NULL, &UserType, 0);
 }
 
+// ----------------------------------------------------------------------------
+// SqType
+
+void test_type_final_instance_str(void)
+{
+	SqType      type;
+	User       *user;
+	SqArray    *array;
+	SqPtrArray *ptrarray;
+	char      **cell;
+
+	assert(SQ_TYPE_IS_ARITHMETIC(SQ_TYPE_INT));
+	assert(SQ_TYPE_IS_ARITHMETIC(SQ_TYPE_DOUBLE));
+	assert(SQ_TYPE_NOT_ARITHMETIC(SQ_TYPE_STR));
+	assert(SQ_TYPE_NOT_ARITHMETIC(SQ_TYPE_CHAR));
+
+	// string members of structure are freed by sq_type_final_instance()
+	sq_type_init_instance(&UserType, &user, true);
+	user->name  = strdup("Alice");
+	user->email = strdup("alice@");
+	sq_str_array_push(&user->strs, "first");
+	sq_int_array_push(&user->ints, 1);
+	sq_type_final_instance(&UserType, &user, true);
+
+	// SqArray of strings
+	type = *SQ_TYPE_ARRAY;
+	type.entry = (SqEntry**) SQ_TYPE_STR;
+	type.n_entry = -1;
+	sq_type_init_instance(&type, &array, true);
+	sq_array_push(array, char*, strdup("first"));
+	sq_array_push(array, char*, strdup("second"));
+	assert(sq_array_length(array) == 2);
+	sq_type_final_instance(&type, &array, true);
+
+	// SqPtrArray of strings. Each element points to allocated (char*)
+	type = *SQ_TYPE_PTR_ARRAY;
+	type.entry = (SqEntry**) SQ_TYPE_STR;
+	type.n_entry = -1;
+	sq_type_init_instance(&type, &ptrarray, true);
+	cell = malloc(sizeof(char*));
+	*cell = strdup("first");
+	sq_ptr_array_push(ptrarray, cell);
+	sq_type_final_instance(&type, &ptrarray, true);
+}
+
+void test_type_entry_hash()
+{
+	SqType   *type;
+	SqEntry **addr;
+	SqColumn  column = {SQ_TYPE_STR, "address", offsetof(User, email), 0};
+
+	type = sq_type_copy_static(NULL, &UserType, NULL);
+	sq_type_sort_entry(type);
+	assert(type->entry_hash != NULL);
+
+	for (int index = 0;  index < UserType.n_entry;  index++) {
+		addr = (SqEntry**)sq_type_find_entry(type, UserType.entry[index]->name, NULL);
+		assert(addr != NULL);
+		assert(*addr == UserType.entry[index]);
+	}
+	assert(sq_type_find_entry(type, "unknown", NULL) == NULL);
+#if SQ_CONFIG_ENTRY_NAME_CASE_SENSITIVE == 0
+	assert(sq_type_find_entry(type, "EMAIL", NULL) != NULL);
+#endif
+
+	// adding entry frees hash table
+	sq_type_add_entry(type, (SqEntry*)&column, 1, 0);
+	assert(type->entry_hash == NULL);
+	assert(sq_type_find_entry(type, "address", NULL) != NULL);
+	sq_type_sort_entry(type);
+	assert(type->entry_hash != NULL);
+	addr = (SqEntry**)sq_type_find_entry(type, "address", NULL);
+	assert(addr != NULL && *addr == (SqEntry*)&column);
+
+	// erasing entry frees hash table
+	sq_type_erase_entry_addr(type, addr, 1);
+	assert(type->entry_hash == NULL);
+	assert(sq_type_find_entry(type, "address", NULL) == NULL);
+	assert(sq_type_find_entry(type, "name", NULL) != NULL);
+
+	sq_type_free(type);
+}
+
+void test_type_slab()
+{
+	SqSlab    slab;
+	SqType   *type;
+	User     *user;
+	User     *user_prev;
+	void     *chunk[3];
+
+	// SqSlab reuses freed chunk
+	sq_slab_init(&slab, sizeof(User), 256);
+	chunk[0] = sq_slab_alloc(&slab);
+	chunk[1] = sq_slab_alloc(&slab);
+	assert(chunk[0] != chunk[1]);
+	sq_slab_free(&slab, chunk[0]);
+	chunk[2] = sq_slab_alloc(&slab);
+	assert(chunk[2] == chunk[0]);
+	sq_slab_final(&slab);
+
+	// SqType that has SQB_TYPE_SLAB
+	type = sq_type_copy_static(NULL, &UserType, NULL);
+	type->bit_field |= SQB_TYPE_SLAB;
+
+	sq_type_init_instance(type, &user, true);
+	assert(user->id == 0 && user->name == NULL);
+	assert(user->strs.data != NULL);
+	user->id = 5;
+	user_prev = user;
+	sq_type_final_instance(type, &user, true);
+
+	sq_type_init_instance(type, &user, true);
+	assert(user == user_prev);
+	assert(user->id == 0);
+	sq_type_final_instance(type, &user, true);
+
+	sq_type_free(type);
+}
+
 // ----------------------------------------------------------------------------
 // Sqxc - Input
 
@@ -156,7 +283,7 @@ void test_sqxc_joint_input()
 	user = instance[0];
 	printf("tb1.id = %d\n", user->id);
 	assert(user->id == 183);
-	free(user);
+	sq_type_final_instance(&UserType, &instance[0], true);
 
 	user = instance[1];
 	printf("tb2.id = %d\n", user->id);
@@ -167,7 +294,7 @@ void test_sqxc_joint_input()
 	// program can't parse JSON array string if no JSON parser in sqxc chain
 	assert(user->strs.length == 0);
 #endif
-	free(user);
+	sq_type_final_instance(&UserType, &instance[1], true);
 	free(instance);
 
 	sqxc_free_chain(xc);
@@ -175,6 +302,182 @@ void test_sqxc_joint_input()
 	sq_table_free(table);
 }
 
+void test_sqxc_value_binding()
+{
+	SqTypeJoint  *type;
+	SqTable  *table;
+	SqPtrArray *array;
+	SqxcValue  *xcvalue;
+	Sqxc     *xc;
+	User     *user;
+	void    **instance;
+	// column names are unchanged during binding
+	const char *names[] = {"tb1.id", "tb1.name", "tb2.id", "tb2.unknown"};
+
+	table = sq_table_new("users", &UserType);
+	type  = sq_type_joint_new();
+	sq_type_joint_add(type, table, "tb1");
+	sq_type_joint_add(type, table, "tb2");
+
+	xc = sqxc_new(SQXC_INFO_VALUE);
+	xcvalue = (SqxcValue*)xc;
+	sqxc_value_element(xc) = type;
+	sqxc_value_container(xc) = SQ_TYPE_PTR_ARRAY;
+
+	sqxc_ready(xc, NULL);
+
+	xc->name = NULL;
+	xc->type = SQXC_TYPE_ARRAY;
+	xc->value.pointer = NULL;
+	sqxc_send(xc);
+
+	sqxc_value_begin_binding(xc);
+	for (int row = 0;  row < 3;  row++) {
+		xc->name = NULL;
+		xc->type = SQXC_TYPE_OBJECT;
+		xc->value.pointer = NULL;
+		sqxc_send(xc);
+
+		xc->name = names[0];
+		xc->type = SQXC_TYPE_INT;
+		xc->value.int_ = row;
+		sqxc_send(xc);
+
+		xc->name = names[1];
+		xc->type = SQXC_TYPE_STR;
+		xc->value.str = "Bob";
+		sqxc_send(xc);
+
+		xc->name = names[2];
+		xc->type = SQXC_TYPE_INT;
+		xc->value.int_ = row + 100;
+		sqxc_send(xc);
+
+		// entry not found
+		xc->name = names[3];
+		xc->type = SQXC_TYPE_INT;
+		xc->value.int_ = 0;
+		sqxc_send(xc);
+
+		xc->name = NULL;
+		xc->type = SQXC_TYPE_OBJECT_END;
+		xc->value.pointer = NULL;
+		sqxc_send(xc);
+	}
+	// every column is bound once by SqTypeJoint and once by UserType when parsing the first row
+	assert(xcvalue->bindings.length == 4 * 2);
+	sqxc_value_end_binding(xc);
+	assert(xcvalue->bindings.length == 0);
+
+	xc->name = NULL;
+	xc->type = SQXC_TYPE_ARRAY_END;
+	xc->value.pointer = NULL;
+	sqxc_send(xc);
+
+	sqxc_finish(xc, NULL);
+
+	array = sqxc_value_instance(xc);
+	assert(array->length == 3);
+	for (int row = 0;  row < 3;  row++) {
+		instance = array->data[row];
+		user = instance[0];
+		assert(user->id == row);
+		assert(strcmp(user->name, "Bob") == 0);
+		user = instance[1];
+		assert(user->id == row + 100);
+		sq_type_final_instance(&UserType, &instance[0], true);
+		sq_type_final_instance(&UserType, &instance[1], true);
+		free(instance);
+	}
+	sq_ptr_array_free(array);
+
+	sqxc_free_chain(xc);
+	sq_type_joint_free(type);
+	sq_table_free(table);
+}
+
+void test_sqxc_value_send_column()
+{
+	SqPtrArray *array;
+	SqxcValue  *xcvalue;
+	Sqxc     *xc;
+	User     *user;
+	const char *names[] = {"id", "name", "ints"};
+
+	xc = sqxc_new(SQXC_INFO_VALUE);
+#if SQ_CONFIG_HAVE_JSONC
+	sqxc_insert(xc, sqxc_new(SQXC_INFO_JSONC_PARSER), -1);
+#endif
+	xcvalue = (SqxcValue*)xc;
+	sqxc_value_element(xc) = &UserType;
+	sqxc_value_container(xc) = SQ_TYPE_PTR_ARRAY;
+
+	sqxc_ready(xc, NULL);
+
+	xc->name = NULL;
+	xc->type = SQXC_TYPE_ARRAY;
+	xc->value.pointer = NULL;
+	xc = sqxc_send(xc);
+
+	sqxc_value_begin_binding(xc);
+	for (int row = 0;  row < 2;  row++) {
+		xc->name = NULL;
+		xc->type = SQXC_TYPE_OBJECT;
+		xc->value.pointer = NULL;
+		xc = sqxc_send(xc);
+
+		xc->name = names[0];
+		xc->type = SQXC_TYPE_INT64;
+		xc->value.int64 = row + 1;
+		xc = sqxc_value_send_column(xc, 0);
+		assert(xc->code == SQCODE_OK);
+
+		xc->name = names[1];
+		xc->type = SQXC_TYPE_STR;
+		xc->value.str = "Alice";
+		xc = sqxc_value_send_column(xc, 1);
+		assert(xc->code == SQCODE_OK);
+
+		// SQ_TYPE_INT_ARRAY is not built-in type, it is sent by sqxc_send()
+		xc->name = names[2];
+		xc->type = SQXC_TYPE_STR;
+		xc->value.str = "[1, 2]";
+		xc = sqxc_value_send_column(xc, 2);
+
+		xc->name = NULL;
+		xc->type = SQXC_TYPE_OBJECT_END;
+		xc->value.pointer = NULL;
+		xc = sqxc_send(xc);
+	}
+	assert(xcvalue->columns.length == 3);
+	assert(sq_array_addr(&xcvalue->columns, SqxcValueColumn, 0)->type == SQ_TYPE_INT);
+	assert(sq_array_addr(&xcvalue->columns, SqxcValueColumn, 1)->type == SQ_TYPE_STR);
+	assert(sq_array_addr(&xcvalue->columns, SqxcValueColumn, 2)->type == NULL);
+	sqxc_value_end_binding(xc);
+
+	xc->name = NULL;
+	xc->type = SQXC_TYPE_ARRAY_END;
+	xc->value.pointer = NULL;
+	xc = sqxc_send(xc);
+
+	sqxc_finish(xc, NULL);
+
+	array = sqxc_value_instance(xc);
+	assert(array->length == 2);
+	for (int row = 0;  row < 2;  row++) {
+		user = array->data[row];
+		assert(user->id == row + 1);
+		assert(strcmp(user->name, "Alice") == 0);
+#if SQ_CONFIG_HAVE_JSONC
+		assert(user->ints.length == 2);
+#endif
+		sq_type_final_instance(&UserType, &user, true);
+	}
+	sq_ptr_array_free(array);
+
+	sqxc_free_chain(xc);
+}
+
 void test_sqxc_row_input_output()
 {
 	SqTypeRow *type;
@@ -256,6 +559,921 @@ void test_sqxc_row_input_output()
 	sq_type_row_free(type);
 }
 
+// value is sent again as string if column can't parse it. SqRow doesn't keep duplicate column.
+void test_sqxc_row_type_not_match()
+{
+	SqTypeRow *type;
+	SqTable   *table;
+	Sqxc      *xc;
+	SqRow     *row;
+
+	table = sq_table_new("users", &UserType);
+	type  = sq_type_row_new();
+	sq_type_row_add(type, table, NULL);
+
+	xc = sqxc_new(SQXC_INFO_VALUE);
+	sqxc_value_element(xc) = type;
+	sqxc_ready(xc, NULL);
+
+	xc->name = NULL;
+	xc->type = SQXC_TYPE_OBJECT;
+	xc->value.pointer = NULL;
+	sqxc_send(xc);
+
+	// column "name" is SQ_TYPE_STR, it can't parse SQXC_TYPE_INT64
+	xc->name = "name";
+	xc->type = SQXC_TYPE_INT64;
+	xc->value.int64 = 123;
+	xc = sqxc_send(xc);
+	assert(xc->code == SQCODE_TYPE_NOT_MATCH);
+	row = sqxc_value_instance(xc);
+	assert(row->length == 0 && row->cols_length == 0);
+
+	xc->name = "name";
+	xc->type = SQXC_TYPE_STR;
+	xc->value.str = "123";
+	xc = sqxc_send(xc);
+	assert(xc->code == SQCODE_OK);
+
+	xc->name = NULL;
+	xc->type = SQXC_TYPE_OBJECT_END;
+	xc->value.pointer = NULL;
+	sqxc_send(xc);
+	sqxc_finish(xc, NULL);
+
+	row = sqxc_value_instance(xc);
+	assert(row->length == 1 && row->cols_length == 1);
+	assert(row->cols[0].type == SQ_TYPE_STR);
+	assert(strcmp(row->cols[0].name, "name") == 0);
+	assert(strcmp(row->data[0].str, "123") == 0);
+
+	sq_row_free(row);
+	sqxc_free_chain(xc);
+	sq_table_free(table);
+	sq_type_row_free(type);
+}
+
+// ----------------------------------------------------------------------------
+// SqxcSql with parameter placeholder
+
+static char       *test_params_sql;
+static SqdbParam   test_params[8];
+static int         test_params_n;
+
+static int  test_params_exec(Sqdb *db, const char *sql, Sqxc *xc, const SqdbParam *params, int n_params)
+{
+	free(test_params_sql);
+	test_params_sql = strdup(sql);
+	test_params_n = n_params;
+	for (int i = 0;  i < n_params && i < 8;  i++) {
+		test_params[i] = params[i];
+		if (params[i].type == SQXC_TYPE_STR)
+			test_params[i].value.str = strdup(params[i].value.str);
+	}
+	return SQCODE_OK;
+}
+
+static int  test_params_exec_sql(Sqdb *db, const char *sql, Sqxc *xc, void *reserve)
+{
+	return test_params_exec(db, sql, xc, NULL, 0);
+}
+
+void test_sqxc_sql_params(char placeholder)
+{
+	SqdbInfo  info = {
+		.size        = sizeof(Sqdb),
+		.product     = SQDB_PRODUCT_CUSTOM,
+		.quote.identifier = {'"', '"'},
+		.placeholder = placeholder,
+		.exec        = test_params_exec_sql,
+		.exec_params = test_params_exec,
+	};
+	Sqdb  db = {.info = &info};
+	Sqxc *xcsql;
+	Sqxc *xccur;
+	char *str;
+
+	xcsql = sqxc_new(SQXC_INFO_SQL);
+	sqxc_sql_set_db((SqxcSql*)xcsql, &db);
+	assert(sqxc_sql_use_params(xcsql) == true);
+	sqxc_ctrl(xcsql, SQXC_SQL_CTRL_INSERT, "User");
+	sqxc_ready(xcsql, NULL);
+
+	xccur = xcsql;
+	xccur->type = SQXC_TYPE_OBJECT;
+	xccur->name = NULL;
+	xccur->value.pointer = NULL;
+	xccur = sqxc_send(xccur);
+
+	// SqxcSql must copy string because it may be released after sending
+	str = strdup("O'Neil");
+	xccur->type = SQXC_TYPE_STR;
+	xccur->name = "name";
+	xccur->value.str = str;
+	xccur = sqxc_send(xccur);
+	free(str);
+
+	xccur->type = SQXC_TYPE_INT;
+	xccur->name = "id";
+	xccur->value.integer = 2333;
+	xccur = sqxc_send(xccur);
+
+	xccur->type = SQXC_TYPE_STR;
+	xccur->name = "email";
+	xccur->value.str = NULL;
+	xccur = sqxc_send(xccur);
+
+	xccur->type = SQXC_TYPE_OBJECT_END;
+	xccur->name = NULL;
+	xccur->value.pointer = NULL;
+	xccur = sqxc_send(xccur);
+
+	sqxc_finish(xcsql, NULL);
+
+	puts(test_params_sql);
+	if (placeholder == '$')
+		assert(strstr(test_params_sql, "VALUES ($1,$2,$3)") != NULL);
+	else
+		assert(strstr(test_params_sql, "VALUES (?,?,?)") != NULL);
+	assert(test_params_n == 3);
+	assert(test_params[0].type == SQXC_TYPE_STR);
+	assert(strcmp(test_params[0].value.str, "O'Neil") == 0);
+	assert(test_params[1].type == SQXC_TYPE_INT);
+	assert(test_params[1].value.integer == 2333);
+	assert(test_params[2].type == SQXC_TYPE_NULL);
+
+	free((char*)test_params[0].value.str);
+	free(test_params_sql);
+	test_params_sql = NULL;
+	sqxc_free(xcsql);
+}
+
+const char *json_object_string_native =
+"{\"id\": 10, \"email\": \"guest@\", \"ints\": [1, 2]}";
+
+// ----------------------------------------------------------------------------
+// SqxcJsonParser - Input
+
+void test_sqxc_json_input_user()
+{
+	Sqxc *xcvalue;
+	Sqxc *xcjson;
+	User *user;
+	// JSON string is sent in several pieces. Pieces are split in key, string, escape, and number.
+	const char *pieces[] = {
+		" { \"i",
+		"d\": 1",
+		"0, \"name\": \"B\\",
+		"u00e9b \\ud83d",
+		"\\ude00\\t\", \"email\": nu",
+		"ll, \"unknown\": {\"obj\": [true, -1.5e2, 12345678901]}, ",
+		"\"strs\": [\"first\", \"sec\\\"ond\"], \"ints\": [1, -2]}  ",
+	};
+
+	xcvalue = sqxc_new_chain(SQXC_INFO_VALUE, SQXC_INFO_JSON_PARSER, NULL);
+	xcjson = sqxc_find(xcvalue, SQXC_INFO_JSON_PARSER);
+	sqxc_value_element(xcvalue) = &UserType;
+	sqxc_value_container(xcvalue) = NULL;
+
+	sqxc_ready(xcvalue, NULL);
+	for (int index = 0;  index < 7;  index++) {
+		xcjson->type = SQXC_TYPE_STR;
+		xcjson->name = NULL;
+		xcjson->value.str = (char*)pieces[index];
+		xcjson->info->send(xcjson, xcjson);
+		if (index < 6)
+			assert(xcjson->code == SQCODE_JSON_CONTINUE);
+		else
+			assert(xcjson->code == SQCODE_OK);
+	}
+	sqxc_finish(xcvalue, NULL);
+
+	user = (User*)sqxc_value_instance(xcvalue);
+	assert(user->id == 10);
+	assert(strcmp(user->name, "B\xC3\xA9" "b \xF0\x9F\x98\x80\t") == 0);
+	assert(user->email == NULL);
+	assert(user->strs.length == 2);
+	assert(strcmp(user->strs.data[1], "sec\"ond") == 0);
+	assert(user->ints.length == 2);
+	assert(user->ints.data[1] == -2);
+
+	print_user(user);
+	sq_type_final_instance(&UserType, &user, true);
+	sqxc_free_chain(xcvalue);
+}
+
+void test_sqxc_json_input_column()
+{
+	Sqxc *xc;
+	User *user;
+
+	// SqxcValue forwards JSON string of column to SqxcJsonParser
+	xc = sqxc_new_chain(SQXC_INFO_VALUE, SQXC_INFO_JSON_PARSER, NULL);
+	sqxc_value_element(xc) = &UserType;
+	sqxc_value_container(xc) = NULL;
+
+	sqxc_ready(xc, NULL);
+
+	xc->name = NULL;
+	xc->type = SQXC_TYPE_OBJECT;
+	xc->value.pointer = NULL;
+	xc = sqxc_send(xc);
+
+	xc->name = "strs";
+	xc->type = SQXC_TYPE_STR;
+	xc->value.str = "[ \"str0\", \"str1\", \"str2\" ]";
+	xc = sqxc_send(xc);
+	assert(xc->code == SQCODE_OK);
+
+	xc->name = "ints";
+	xc->type = SQXC_TYPE_STR;
+	xc->value.str = "[3,4]";
+	xc = sqxc_send(xc);
+	assert(xc->code == SQCODE_OK);
+
+	xc->name = NULL;
+	xc->type = SQXC_TYPE_OBJECT_END;
+	xc->value.pointer = NULL;
+	xc = sqxc_send(xc);
+
+	sqxc_finish(xc, NULL);
+
+	user = (User*)sqxc_value_instance(xc);
+	assert(user->strs.length == 3);
+	assert(strcmp(user->strs.data[2], "str2") == 0);
+	assert(user->ints.length == 2);
+	assert(user->ints.data[0] == 3);
+
+	sq_type_final_instance(&UserType, &user, true);
+	sqxc_free_chain(xc);
+}
+
+void test_sqxc_json_input_error()
+{
+	Sqxc *xcchain;
+	Sqxc *xcjson;
+	const char *errors[] = {
+		"{\"id\" 1}",
+		"[1, 2}",
+		"[1,, 2]",
+		"{\"id\": tru }",
+		"\"tab\tin string\"",
+		"[\"\\x\"]",
+	};
+
+	xcchain = sqxc_new_chain(SQXC_INFO_EMPTY, SQXC_INFO_JSON_PARSER, NULL);
+	xcjson = sqxc_find(xcchain, SQXC_INFO_JSON_PARSER);
+	sqxc_ready(xcchain, NULL);
+
+	for (int index = 0;  index < 6;  index++) {
+		xcjson->type = SQXC_TYPE_STR;
+		xcjson->name = NULL;
+		xcjson->value.str = (char*)errors[index];
+		xcjson->info->send(xcjson, xcjson);
+		assert(xcjson->code == SQCODE_JSON_ERROR);
+	}
+
+	// parser is reset after error
+	xcjson->value.str = (char*)json_object_string_native;
+	xcjson->info->send(xcjson, xcjson);
+	assert(xcjson->code == SQCODE_OK);
+
+	sqxc_finish(xcchain, NULL);
+	sqxc_free_chain(xcchain);
+}
+
+// ----------------------------------------------------------------------------
+// SqxcJsonWriter - Output
+
+static SqBuffer  test_json_output;
+static int       test_json_n_pieces;
+
+// destination of SqxcJsonWriter. It collects pieces of JSON string.
+static int  test_json_collect_send(Sqxc *xc, Sqxc *src)
+{
+	sq_buffer_write(&test_json_output, src->value.str);
+	test_json_n_pieces++;
+	return (src->code = SQCODE_OK);
+}
+
+static const SqxcInfo  test_json_collect_info = {
+	.size = sizeof(Sqxc),
+	.send = test_json_collect_send,
+};
+
+static void test_sqxc_json_write_user(Sqxc *xc, User *user)
+{
+	xc->type = SQXC_TYPE_OBJECT;
+	xc->name = NULL;
+	xc->entry = NULL;
+	xc->value.pointer = NULL;
+	xc = sqxc_send(xc);
+
+	// SQB_HIDDEN
+	xc->type = SQXC_TYPE_INT;
+	xc->name = UserColumns[1]->name;
+	xc->entry = (SqEntry*)UserColumns[1];
+	xc->value.integer = user->id;
+	xc = sqxc_send(xc);
+
+	xc->type = SQXC_TYPE_STR;
+	xc->name = UserColumns[3]->name;
+	xc->entry = (SqEntry*)UserColumns[3];
+	xc->value.str = user->name;
+	xc = sqxc_send(xc);
+
+	xc->type = SQXC_TYPE_STR;
+	xc->name = UserColumns[0]->name;
+	xc->entry = (SqEntry*)UserColumns[0];
+	xc->value.str = user->email;
+	xc = sqxc_send(xc);
+
+	xc->type = SQXC_TYPE_ARRAY;
+	xc->name = UserColumns[2]->name;
+	xc->entry = (SqEntry*)UserColumns[2];
+	xc->value.pointer = NULL;
+	xc = sqxc_send(xc);
+	for (int index = 0;  index < user->ints.length;  index++) {
+		xc->type = SQXC_TYPE_INT;
+		xc->name = NULL;
+		xc->entry = NULL;
+		xc->value.integer = (int)user->ints.data[index];
+		xc = sqxc_send(xc);
+	}
+	xc->type = SQXC_TYPE_ARRAY_END;
+	xc->name = UserColumns[2]->name;
+	xc->entry = (SqEntry*)UserColumns[2];
+	xc = sqxc_send(xc);
+
+	xc->type = SQXC_TYPE_DOUBLE;
+	xc->name = "ratio";
+	xc->entry = NULL;
+	xc->value.double_ = 0.5;
+	xc = sqxc_send(xc);
+
+	xc->type = SQXC_TYPE_OBJECT_END;
+	xc->name = NULL;
+	xc->entry = NULL;
+	xc = sqxc_send(xc);
+}
+
+void test_sqxc_json_output(User *instance)
+{
+	SqxcJsonWriter *xcjson;
+	Sqxc *xcchain;
+	Sqxc *xc;
+	User  user = *instance;
+	const char *expect;
+
+	sq_buffer_init(&test_json_output);
+	user.name = "B\"o\\b\n\x01";
+	user.email = NULL;
+
+	xcchain = sqxc_new(&test_json_collect_info);
+	xcjson  = (SqxcJsonWriter*)sqxc_new(SQXC_INFO_JSON_WRITER);
+	sqxc_insert(xcchain, (Sqxc*)xcjson, -1);
+	xcjson->dest = xcchain;
+
+	// send 2 objects in array. keys are cached in the 2nd object.
+	sqxc_ready(xcchain, NULL);
+	xc = (Sqxc*)xcjson;
+	xc->type = SQXC_TYPE_ARRAY;
+	xc->name = NULL;
+	xc->entry = NULL;
+	xc->value.pointer = NULL;
+	xc->info->send(xc, xc);
+	test_sqxc_json_write_user(xc, &user);
+	test_sqxc_json_write_user(xc, &user);
+	xc->type = SQXC_TYPE_ARRAY_END;
+	xc->info->send(xc, xc);
+	sqxc_finish(xcchain, NULL);
+
+	expect = "{\"name\":\"B\\\"o\\\\b\\n\\u0001\",\"email\":null,\"ints\":[1],\"ratio\":0.5}";
+	puts(test_json_output.mem);
+	assert(test_json_n_pieces == 1);
+	assert(test_json_output.writed == (int)strlen(expect) * 2 + 3);
+	assert(strncmp(test_json_output.mem + 1, expect, strlen(expect)) == 0);
+	assert(strncmp(test_json_output.mem + 2 + strlen(expect), expect, strlen(expect)) == 0);
+
+	// send JSON string in pieces
+	test_json_output.writed = 0;
+	test_json_n_pieces = 0;
+	xcjson->flush_size = 16;
+	sqxc_ready(xcchain, NULL);
+	test_sqxc_json_write_user(xc, &user);
+	sqxc_finish(xcchain, NULL);
+	*sq_buffer_alloc(&test_json_output, 0) = 0;
+	assert(test_json_n_pieces > 1);
+	assert(strcmp(test_json_output.mem, expect) == 0);
+
+	sq_buffer_final(&test_json_output);
+	sqxc_free_chain(xcchain);
+}
+
+void test_sqxc_json_sql_output()
+{
+	static const SqColumn  hidden_ints = {SQ_TYPE_INT_ARRAY, "ints", offsetof(User, ints), SQB_HIDDEN};
+	SqTable *table;
+	Sqxc *xcchain;
+	Sqxc *xcsql;
+	Sqxc *xccur;
+
+	table = sq_table_new("User", &UserType);
+
+	// SqxcSql forwards array of column to SqxcJsonWriter
+	xcchain = sqxc_new_chain(SQXC_INFO_SQL, SQXC_INFO_JSON_WRITER, NULL);
+	xcsql = sqxc_find(xcchain, SQXC_INFO_SQL);
+	sqxc_sql_id(xcsql) = 2333;
+	sqxc_ctrl(xcsql, SQXC_SQL_CTRL_UPDATE, table->name);
+
+	sqxc_ready(xcchain, NULL);
+
+	xccur = xcchain;
+	xccur->type = SQXC_TYPE_OBJECT;
+	xccur->name = NULL;
+	xccur->entry = NULL;
+	xccur->value.pointer = NULL;
+	xccur = sqxc_send(xccur);
+
+	xccur->type = SQXC_TYPE_STR;
+	xccur->name = "name";
+	xccur->value.str = (char*)"Bob";
+	xccur = sqxc_send(xccur);
+
+	// column has SQB_HIDDEN. It must be output to SQL.
+	xccur->type = SQXC_TYPE_ARRAY;
+	xccur->name = "ints";
+	xccur->entry = (SqEntry*)&hidden_ints;
+	xccur->value.pointer = NULL;
+	xccur = sqxc_send(xccur);
+	xccur->type = SQXC_TYPE_INT;
+	xccur->name = NULL;
+	xccur->entry = NULL;
+	xccur->value.integer = 3;
+	xccur = sqxc_send(xccur);
+	xccur->type = SQXC_TYPE_STR;
+	xccur->value.str = (char*)"'4'";
+	xccur = sqxc_send(xccur);
+	xccur->type = SQXC_TYPE_ARRAY_END;
+	xccur->name = "ints";
+	xccur->value.pointer = NULL;
+	xccur = sqxc_send(xccur);
+
+	xccur->type = SQXC_TYPE_OBJECT_END;
+	xccur->name = NULL;
+	xccur->entry = NULL;
+	xccur->value.pointer = NULL;
+	xccur = sqxc_send(xccur);
+
+	puts(xcsql->buf);
+	assert(strstr(xcsql->buf, "'[3,\"''4''\"]'") != NULL);
+	sqxc_finish(xcchain, NULL);
+
+	sqxc_free_chain(xcchain);
+	sq_table_free(table);
+}
+
+// ----------------------------------------------------------------------------
+// SqxcMsgpack - Output and Input
+
+void test_sqxc_msgpack_user()
+{
+	Sqxc *xcwriter;
+	Sqxc *xcvalue;
+	Sqxc *xcmp;
+	User *result;
+	User  user = {0};
+	SqBuffer  piece;
+
+	user.id = 10;
+	user.name = "Bob";
+	user.email = NULL;
+	// array that has more than 15 elements doesn't use fixarray.
+	sq_int_array_init(&user.ints, 20);
+	for (int index = 0;  index < 20;  index++)
+		sq_int_array_push(&user.ints, index * 1000 - 5000);
+
+	// writer doesn't have destination. Data is kept in Sqxc.buf
+	xcwriter = sqxc_msgpack_writer_new();
+	sqxc_ready(xcwriter, NULL);
+	test_sqxc_json_write_user(xcwriter, &user);
+	sqxc_finish(xcwriter, NULL);
+	// fixmap that has 4 members (id is hidden)
+	assert(xcwriter->buf[0] == (char)0x84);
+	assert(xcwriter->buf[1] == (char)0xA4 && strncmp(xcwriter->buf + 2, "name", 4) == 0);
+
+	// send MessagePack data byte by byte
+	xcvalue = sqxc_new_chain(SQXC_INFO_VALUE, SQXC_INFO_MSGPACK_PARSER, NULL);
+	xcmp = sqxc_find(xcvalue, SQXC_INFO_MSGPACK_PARSER);
+	sqxc_value_element(xcvalue) = &UserType;
+	sqxc_value_container(xcvalue) = NULL;
+
+	sqxc_ready(xcvalue, NULL);
+	for (int index = 0;  index < xcwriter->buf_writed;  index++) {
+		piece.mem = xcwriter->buf + index;
+		piece.writed = 1;
+		xcmp->type = SQXC_TYPE_RAW;
+		xcmp->name = NULL;
+		xcmp->value.pointer = &piece;
+		xcmp->info->send(xcmp, xcmp);
+		if (index < xcwriter->buf_writed -1)
+			assert(xcmp->code == SQCODE_MSGPACK_CONTINUE);
+		else
+			assert(xcmp->code == SQCODE_OK);
+	}
+	sqxc_finish(xcvalue, NULL);
+
+	result = (User*)sqxc_value_instance(xcvalue);
+	assert(strcmp(result->name, "Bob") == 0);
+	assert(result->email == NULL);
+	assert(result->ints.length == 20);
+	assert(result->ints.data[0] == -5000);
+	assert(result->ints.data[19] == 14000);
+
+	print_user(result);
+	sq_type_final_instance(&UserType, &result, true);
+	sqxc_free_chain(xcvalue);
+	sqxc_free(xcwriter);
+	sq_int_array_final(&user.ints);
+}
+
+static int      test_msgpack_types[16];
+static SqValue  test_msgpack_values[16];
+static int      test_msgpack_count;
+static char     test_msgpack_bin[8];
+static int      test_msgpack_bin_length;
+
+// destination of SqxcMsgpackParser. It collects types and values.
+static int  test_msgpack_collect_send(Sqxc *xc, Sqxc *src)
+{
+	SqBuffer *bin;
+
+	test_msgpack_types[test_msgpack_count] = src->type;
+	test_msgpack_values[test_msgpack_count] = src->value;
+	test_msgpack_count++;
+	if (src->type == SQXC_TYPE_RAW) {
+		bin = (SqBuffer*)src->value.pointer;
+		test_msgpack_bin_length = bin->writed;
+		memcpy(test_msgpack_bin, bin->mem, (bin->writed < 8) ? bin->writed : 8);
+	}
+	return (src->code = SQCODE_OK);
+}
+
+static const SqxcInfo  test_msgpack_collect_info = {
+	.size = sizeof(Sqxc),
+	.send = test_msgpack_collect_send,
+};
+
+void test_sqxc_msgpack_scalar()
+{
+	Sqxc *xcchain;
+	Sqxc *xcwriter;
+	Sqxc *xcmp;
+	Sqxc *xc;
+	SqBuffer  data;
+	SqBuffer  bin = {(char*)"a\0b", 0, 3};
+	const char  errors[][3] = {
+		{(char)0xC1},                         // never used
+		{(char)0x81, 0x01, 0x02},             // key of map is not string
+	};
+
+	// parser sends data to collector
+	xcchain = sqxc_new(&test_msgpack_collect_info);
+	xcmp = sqxc_msgpack_parser_new();
+	sqxc_insert(xcchain, xcmp, -1);
+	// writer sends data to parser
+	xcwriter = sqxc_msgpack_writer_new();
+	sqxc_insert(xcchain, xcwriter, -1);
+	xcwriter->dest = xcmp;
+	sqxc_ready(xcchain, NULL);
+
+	xc = xcwriter;
+	xc->type = SQXC_TYPE_ARRAY;
+	xc->name = NULL;
+	xc->entry = NULL;
+	xc->value.pointer = NULL;
+	xc->info->send(xc, xc);
+	xc->type = SQXC_TYPE_INT64;
+	xc->value.int64 = -12345678901;
+	xc->info->send(xc, xc);
+	xc->type = SQXC_TYPE_UINT64;
+	xc->value.uint64 = UINT64_MAX;
+	xc->info->send(xc, xc);
+	xc->type = SQXC_TYPE_INT;
+	xc->value.integer = -100;
+	xc->info->send(xc, xc);
+	xc->type = SQXC_TYPE_DOUBLE;
+	xc->value.double_ = 1.5;
+	xc->info->send(xc, xc);
+	xc->type = SQXC_TYPE_TIME;
+	xc->value.rawtime = 1700000000;
+	xc->info->send(xc, xc);
+	xc->type = SQXC_TYPE_TIME;
+	xc->value.rawtime = -1;
+	xc->info->send(xc, xc);
+	xc->type = SQXC_TYPE_BOOL;
+	xc->value.boolean = true;
+	xc->info->send(xc, xc);
+	xc->type = SQXC_TYPE_STR;
+	xc->value.str = NULL;
+	xc->info->send(xc, xc);
+	// bin that contains null character
+	xc->type = SQXC_TYPE_RAW;
+	xc->value.pointer = &bin;
+	xc->info->send(xc, xc);
+	xc->type = SQXC_TYPE_ARRAY_END;
+	xc->info->send(xc, xc);
+
+	assert(test_msgpack_count == 11);
+	assert(test_msgpack_types[0] == SQXC_TYPE_ARRAY);
+	assert(test_msgpack_types[1] == SQXC_TYPE_INT64 && test_msgpack_values[1].int64 == -12345678901);
+	assert(test_msgpack_types[2] == SQXC_TYPE_UINT64 && test_msgpack_values[2].uint64 == UINT64_MAX);
+	assert(test_msgpack_types[3] == SQXC_TYPE_INT && test_msgpack_values[3].integer == -100);
+	assert(test_msgpack_types[4] == SQXC_TYPE_DOUBLE && test_msgpack_values[4].double_ == 1.5);
+	assert(test_msgpack_types[5] == SQXC_TYPE_TIME && test_msgpack_values[5].rawtime == 1700000000);
+	assert(test_msgpack_types[6] == SQXC_TYPE_TIME && test_msgpack_values[6].rawtime == -1);
+	assert(test_msgpack_types[7] == SQXC_TYPE_BOOL && test_msgpack_values[7].boolean == true);
+	assert(test_msgpack_types[8] == SQXC_TYPE_NULL);
+	assert(test_msgpack_types[9] == SQXC_TYPE_RAW);
+	assert(test_msgpack_bin_length == 3 && memcmp(test_msgpack_bin, "a\0b", 3) == 0);
+	assert(test_msgpack_types[10] == SQXC_TYPE_ARRAY_END);
+
+	// send data in pieces of 4 bytes. Items are split between pieces.
+	test_msgpack_count = 0;
+	test_msgpack_bin_length = 0;
+	for (int index = 0;  index < xcwriter->buf_writed;  index += 4) {
+		data.mem = xcwriter->buf + index;
+		data.writed = (xcwriter->buf_writed - index < 4) ? xcwriter->buf_writed - index : 4;
+		xcmp->type = SQXC_TYPE_RAW;
+		xcmp->name = NULL;
+		xcmp->value.pointer = &data;
+		xcmp->info->send(xcmp, xcmp);
+		if (index + 4 < xcwriter->buf_writed)
+			assert(xcmp->code == SQCODE_MSGPACK_CONTINUE);
+		else
+			assert(xcmp->code == SQCODE_OK);
+	}
+	assert(test_msgpack_count == 11);
+	assert(test_msgpack_types[1] == SQXC_TYPE_INT64 && test_msgpack_values[1].int64 == -12345678901);
+	assert(test_msgpack_types[4] == SQXC_TYPE_DOUBLE && test_msgpack_values[4].double_ == 1.5);
+	assert(test_msgpack_types[9] == SQXC_TYPE_RAW);
+	assert(test_msgpack_bin_length == 3 && memcmp(test_msgpack_bin, "a\0b", 3) == 0);
+
+	// error
+	for (int index = 0;  index < 2;  index++) {
+		data.mem = (char*)errors[index];
+		data.writed = (index == 0) ? 1 : 3;
+		xcmp->type = SQXC_TYPE_RAW;
+		xcmp->name = NULL;
+		xcmp->value.pointer = &data;
+		xcmp->info->send(xcmp, xcmp);
+		assert(xcmp->code == SQCODE_MSGPACK_ERROR);
+	}
+
+	sqxc_finish(xcchain, NULL);
+	sqxc_free_chain(xcchain);
+}
+
+// ----------------------------------------------------------------------------
+// SqxcCsv - Output and Input
+
+const char *csv_users_string =
+"id,name,email,ints,ratio\r\n"
+"10,\"B\"\"o,b\",,\"[1,2]\",0.5\r\n"
+"10,\"line\nbreak\",\"\",\"[1,2]\",0.5\r\n";
+
+void test_sqxc_csv_output()
+{
+	Sqxc *xcchain;
+	Sqxc *xc;
+	User  user = {0};
+
+	user.id = 10;
+	sq_int_array_init(&user.ints, 2);
+	sq_int_array_push(&user.ints, 1);
+	sq_int_array_push(&user.ints, 2);
+
+	// SqxcCsvWriter sends array in row to SqxcJsonWriter
+	xcchain = sqxc_new_chain(SQXC_INFO_CSV_WRITER, SQXC_INFO_JSON_WRITER, NULL);
+	sqxc_ready(xcchain, NULL);
+
+	xc = xcchain;
+	xc->type = SQXC_TYPE_ARRAY;
+	xc->name = NULL;
+	xc->entry = NULL;
+	xc->value.pointer = NULL;
+	xc = sqxc_send(xc);
+	user.name = "B\"o,b";
+	user.email = NULL;
+	test_sqxc_json_write_user(xc, &user);
+	user.name = "line\nbreak";
+	user.email = "";
+	test_sqxc_json_write_user(xc, &user);
+	xc->type = SQXC_TYPE_ARRAY_END;
+	xc->name = NULL;
+	xc->entry = NULL;
+	xc = sqxc_send(xc);
+	sqxc_finish(xcchain, NULL);
+
+	// writer doesn't have destination. CSV text is kept in Sqxc.buf
+	assert(xcchain->buf_writed == (int)strlen(csv_users_string));
+	assert(strncmp(xcchain->buf, csv_users_string, xcchain->buf_writed) == 0);
+
+	sqxc_free_chain(xcchain);
+	sq_int_array_final(&user.ints);
+}
+
+void test_sqxc_csv_input()
+{
+	SqPtrArray *array;
+	Sqxc *xcvalue;
+	Sqxc *xccsv;
+	User *user;
+	char  piece[6];
+	int   length = (int)strlen(csv_users_string);
+	const char *errors[] = {
+		"a,b\n1,2,3\n",           // too many fields
+		"a,b\n\"1\"x,2\n",        // character after closing quote
+		"a,b\n\"1,2",             // quoted field is not closed
+	};
+
+	// SqxcCsvParser sends JSON array in field to SqxcJsonParser
+	xcvalue = sqxc_new_chain(SQXC_INFO_VALUE, SQXC_INFO_CSV_PARSER, SQXC_INFO_JSON_PARSER, NULL);
+	xccsv = sqxc_find(xcvalue, SQXC_INFO_CSV_PARSER);
+	sqxc_value_element(xcvalue) = &UserType;
+	sqxc_value_container(xcvalue) = SQ_TYPE_PTR_ARRAY;
+
+	// CSV text is split in quoted field and line break
+	sqxc_ready(xcvalue, NULL);
+	for (int index = 0;  index < length;  index += 5) {
+		strncpy(piece, csv_users_string + index, 5);
+		piece[5] = 0;
+		xccsv->type = SQXC_TYPE_STR;
+		xccsv->name = NULL;
+		xccsv->value.str = piece;
+		xccsv->info->send(xccsv, xccsv);
+		assert(xccsv->code == SQCODE_CSV_CONTINUE);
+	}
+	// end of data
+	xccsv->type = SQXC_TYPE_NULL;
+	xccsv->value.str = NULL;
+	xccsv->info->send(xccsv, xccsv);
+	assert(xccsv->code == SQCODE_OK);
+	sqxc_finish(xcvalue, NULL);
+
+	array = sqxc_value_instance(xcvalue);
+	assert(array->length == 2);
+	user = array->data[0];
+	assert(user->id == 10);
+	assert(strcmp(user->name, "B\"o,b") == 0);
+	assert(user->email == NULL);
+	assert(user->ints.length == 2 && user->ints.data[1] == 2);
+	sq_type_final_instance(&UserType, &user, true);
+	user = array->data[1];
+	assert(strcmp(user->name, "line\nbreak") == 0);
+	assert(user->email != NULL && user->email[0] == 0);
+	sq_type_final_instance(&UserType, &user, true);
+	sq_ptr_array_free(array);
+	sqxc_free_chain(xcvalue);
+
+	// error
+	xcvalue = sqxc_new_chain(SQXC_INFO_EMPTY, SQXC_INFO_CSV_PARSER, NULL);
+	xccsv = sqxc_find(xcvalue, SQXC_INFO_CSV_PARSER);
+	sqxc_ready(xcvalue, NULL);
+	for (int index = 0;  index < 3;  index++) {
+		xccsv->type = SQXC_TYPE_STR;
+		xccsv->name = NULL;
+		xccsv->value.str = errors[index];
+		xccsv->info->send(xccsv, xccsv);
+		if (xccsv->code != SQCODE_CSV_ERROR) {
+			xccsv->type = SQXC_TYPE_NULL;
+			xccsv->value.str = NULL;
+			xccsv->info->send(xccsv, xccsv);
+		}
+		assert(xccsv->code == SQCODE_CSV_ERROR);
+	}
+	sqxc_finish(xcvalue, NULL);
+	sqxc_free_chain(xcvalue);
+}
+
+// ------------------------------------------------------------------------------------------------
+// SqxcFile
+
+static void test_sqxc_file_read_user(const SqxcInfo *parser_info, const char *filename, int buffer_size)
+{
+	Sqxc     *xcvalue;
+	SqxcFile *xcfile;
+	User     *result;
+
+	xcvalue = sqxc_new_chain(SQXC_INFO_VALUE, SQXC_INFO_FILE_READER, parser_info, NULL);
+	xcfile  = (SqxcFile*)sqxc_find(xcvalue, SQXC_INFO_FILE_READER);
+	xcfile->filename = filename;
+	xcfile->buffer_size = buffer_size;
+	sqxc_value_element(xcvalue) = &UserType;
+	sqxc_value_container(xcvalue) = NULL;
+
+	sqxc_ready(xcvalue, NULL);
+	xcfile->info->send((Sqxc*)xcfile, (Sqxc*)xcvalue);
+	assert(xcvalue->code == SQCODE_OK);
+	sqxc_finish(xcvalue, NULL);
+
+	result = (User*)sqxc_value_instance(xcvalue);
+	assert(strcmp(result->name, "Bob") == 0);
+	assert(strcmp(result->email, "bob@server") == 0);
+	assert(result->ints.length == 100);
+	assert(result->ints.data[0] == 0);
+	assert(result->ints.data[99] == 99000);
+
+	sq_type_final_instance(&UserType, &result, true);
+	sqxc_free_chain(xcvalue);
+}
+
+void test_sqxc_file()
+{
+	const char *filename_json = "test-sqxc-file.json";
+	const char *filename_mp   = "test-sqxc-file.msgpack";
+	const char *filename_trunc = "test-sqxc-file-truncated.json";
+	SqxcFile   *xcfile;
+	Sqxc       *xcchain;
+	User        user = {0};
+	FILE       *file;
+	char        buf[2048];
+	int         length;
+
+	user.id = 10;
+	user.name = "Bob";
+	user.email = "bob@server";
+	sq_int_array_init(&user.ints, 100);
+	for (int index = 0;  index < 100;  index++)
+		sq_int_array_push(&user.ints, index * 1000);
+
+	// small write buffer. SqxcJsonWriter sends big pieces that are written to file directly.
+	xcchain = sqxc_new_chain(SQXC_INFO_FILE_WRITER, SQXC_INFO_JSON_WRITER, NULL);
+	xcfile  = (SqxcFile*)xcchain;
+	xcfile->filename = filename_json;
+	xcfile->buffer_size = 64;
+	((SqxcJsonWriter*)sqxc_find(xcchain, SQXC_INFO_JSON_WRITER))->flush_size = 48;
+	sqxc_ready(xcchain, NULL);
+	test_sqxc_json_write_user(xcchain, &user);
+	sqxc_finish(xcchain, NULL);
+	sqxc_free_chain(xcchain);
+
+	// SqxcJsonParser accepts SQXC_TYPE_STR. file is read in blocks.
+	test_sqxc_file_read_user(SQXC_INFO_JSON_PARSER, filename_json, 7);
+	test_sqxc_file_read_user(SQXC_INFO_JSON_PARSER, filename_json, SQXC_FILE_BUFFER_SIZE);
+
+	// truncated JSON file is incomplete
+	file = fopen(filename_json, "rb");
+	length = (int)fread(buf, 1, sizeof(buf), file);
+	fclose(file);
+	file = fopen(filename_trunc, "wb");
+	fwrite(buf, 1, length / 2, file);
+	fclose(file);
+	xcchain = sqxc_new_chain(SQXC_INFO_VALUE, SQXC_INFO_FILE_READER, SQXC_INFO_JSON_PARSER, NULL);
+	xcfile  = (SqxcFile*)sqxc_find(xcchain, SQXC_INFO_FILE_READER);
+	xcfile->filename = filename_trunc;
+	xcfile->buffer_size = 16;
+	sqxc_value_element(xcchain) = &UserType;
+	sqxc_value_container(xcchain) = NULL;
+	sqxc_ready(xcchain, NULL);
+	xcfile->info->send((Sqxc*)xcfile, xcchain);
+	assert(xcchain->code == SQCODE_JSON_CONTINUE);
+	sqxc_finish(xcchain, NULL);
+	sq_type_final_instance(&UserType, &sqxc_value_instance(xcchain), true);
+	sqxc_free_chain(xcchain);
+
+	// SqxcMsgpackWriter sends SQXC_TYPE_RAW
+	xcchain = sqxc_new_chain(SQXC_INFO_FILE_WRITER, SQXC_INFO_MSGPACK_WRITER, NULL);
+	xcfile  = (SqxcFile*)xcchain;
+	xcfile->filename = filename_mp;
+	sqxc_ready(xcchain, NULL);
+	test_sqxc_json_write_user(xcchain, &user);
+	sqxc_finish(xcchain, NULL);
+	sqxc_free_chain(xcchain);
+
+	// SqxcMsgpackParser accepts SQXC_TYPE_RAW. file is mapped into memory if possible.
+	test_sqxc_file_read_user(SQXC_INFO_MSGPACK_PARSER, filename_mp, 5);
+	test_sqxc_file_read_user(SQXC_INFO_MSGPACK_PARSER, filename_mp, SQXC_FILE_BUFFER_SIZE);
+
+	// file doesn't exist
+	xcchain = sqxc_new_chain(SQXC_INFO_VALUE, SQXC_INFO_FILE_READER, SQXC_INFO_JSON_PARSER, NULL);
+	xcfile  = (SqxcFile*)sqxc_find(xcchain, SQXC_INFO_FILE_READER);
+	xcfile->filename = "test-sqxc-file-not-exist.json";
+	sqxc_value_element(xcchain) = &UserType;
+	sqxc_value_container(xcchain) = NULL;
+	sqxc_ready(xcchain, NULL);
+	xcfile->info->send((Sqxc*)xcfile, xcchain);
+	assert(xcchain->code == SQCODE_OPEN_FAILED);
+	sqxc_finish(xcchain, NULL);
+	sq_type_final_instance(&UserType, &sqxc_value_instance(xcchain), true);
+	sqxc_free_chain(xcchain);
+
+	remove(filename_json);
+	remove(filename_mp);
+	remove(filename_trunc);
+	sq_int_array_final(&user.ints);
+}
+
 #if SQ_CONFIG_HAVE_JSONC
 
 const char *json_array_string =
@@ -318,7 +1536,7 @@ void test_sqxc_jsonc_input_user()
 	assert(user->id == 10);
 
 	print_user(user);
-	free(user);
+	sq_type_final_instance(&UserType, &user, true);
 	sqxc_free_chain(xcvalue);
 }
 
@@ -377,7 +1595,7 @@ void test_sqxc_jsonc_input_unknown()
 	assert(user->id == 99);
 
 	print_user(user);
-	free(user);
+	sq_type_final_instance(&UserType, &user, true);
 	sqxc_free_chain(xcvalue);
 }
 
@@ -514,8 +1732,26 @@ int  main(void)
 	sq_int_array_init(&user->ints, 8);
 	sq_int_array_push(&user->ints, 1);
 
+	test_type_final_instance_str();
+	test_type_entry_hash();
+	test_type_slab();
 	test_sqxc_joint_input();
+	test_sqxc_value_binding();
+	test_sqxc_value_send_column();
 	test_sqxc_row_input_output();
+	test_sqxc_row_type_not_match();
+	test_sqxc_sql_params('?');
+	test_sqxc_sql_params('$');
+	test_sqxc_json_input_user();
+	test_sqxc_json_input_column();
+	test_sqxc_json_input_error();
+	test_sqxc_json_output(user);
+	test_sqxc_json_sql_output();
+	test_sqxc_msgpack_user();
+	test_sqxc_msgpack_scalar();
+	test_sqxc_csv_output();
+	test_sqxc_csv_input();
+	test_sqxc_file();
 #if SQ_CONFIG_HAVE_JSONC
 	test_sqxc_jsonc_input();
 	test_sqxc_jsonc_input_user();
@@ -524,6 +1760,12 @@ int  main(void)
 	test_sqxc_sql_output(true);
 #endif  // SQ_CONFIG_HAVE_JSONC
 
+	// User.name and User.email are not allocated
+	sq_str_array_final(&user->strs);
+	sq_int_array_final(&user->ints);
+	free(user);
+	sq_schema_free(schema);
+
 //	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
 	return EXIT_SUCCESS;
 }
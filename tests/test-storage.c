@@ -220,6 +220,752 @@ void test_storage_xxx_all(SqStorage *storage)
 	fprintf(stderr, "remove_all(): ok.\n");
 }
 
+void test_storage_insert_all(SqStorage *storage)
+{
+	SqArray  *array;
+	Company  *company;
+	int64_t   id_range[2];
+	int64_t   n_rows;
+	int       index;
+
+	// 4 parameters per row, 600 rows may be split into multiple INSERT statements.
+	array = sq_array_new(sizeof(Company), 600);
+	for (index = 0;  index < 600;  index++) {
+		company = sq_array_alloc(array, 1);
+		company->id = 0;    // for auto increment
+		company->name = "Inserted";
+		company->age = index;
+		company->address = "Texas";
+		company->salary = index * 0.5;
+	}
+
+	n_rows = sq_storage_insert_all(storage, "companies", NULL, array, SQ_TYPE_ARRAY, id_range);
+	fprintf(stderr, "insert_all(): inserted %"PRId64" rows, id = %"PRId64" ~ %"PRId64"\n",
+	        n_rows, id_range[0], id_range[1]);
+	assert(n_rows == 600);
+	assert(id_range[1] - id_range[0] + 1 == 600);
+
+	company = sq_storage_get(storage, "companies", NULL, id_range[0]);
+	assert(company != NULL);
+	assert(company->age == 0);
+	company_free(company);
+
+	company = sq_storage_get(storage, "companies", NULL, id_range[1]);
+	assert(company != NULL);
+	assert(company->age == 599);
+	assert(company->salary == 299.5);
+	company_free(company);
+
+	// empty container
+	sq_array_length(array) = 0;
+	n_rows = sq_storage_insert_all(storage, "companies", NULL, array, SQ_TYPE_ARRAY, NULL);
+	assert(n_rows == 0);
+	sq_array_free(array);
+
+	sq_storage_remove_all(storage, "companies", NULL);
+	fprintf(stderr, "insert_all(): ok.\n");
+}
+
+void test_storage_arena(SqStorage *storage)
+{
+	SqArena     arena;
+	SqPtrArray *array;
+	Company    *company_ptr;
+	Company     company = {0, "Arena", 30, "Taipei", 1000.5};
+	int         count;
+
+	for (count = 0;  count < 100;  count++)
+		sq_storage_insert(storage, "companies", NULL, &company);
+
+	// small block size to test multiple blocks
+	sq_arena_init(&arena, 256);
+	array = sq_storage_get_all_arena(storage, "companies", NULL, NULL, NULL, &arena);
+	assert(array != NULL);
+	assert(array->length == 100);
+	for (count = 0;  count < array->length;  count++) {
+		company_ptr = array->data[count];
+		assert(company_ptr->age == 30);
+		assert(company_ptr->salary == 1000.5);
+		assert(strcmp(company_ptr->name, "Arena") == 0);
+		assert(strcmp(company_ptr->address, "Taipei") == 0);
+	}
+	// elements are released by arena
+	sq_ptr_array_free(array);
+	sq_arena_clear(&arena);
+
+	// reuse the first block
+	array = sq_storage_get_all_arena(storage, "companies", NULL, NULL, "WHERE age = 30", &arena);
+	assert(array != NULL);
+	assert(array->length == 100);
+	sq_ptr_array_free(array);
+	sq_arena_final(&arena);
+
+	// type that can NOT be allocated from arena
+	assert(sq_type_can_use_arena(SQ_TYPE_INT_ARRAY) == false);
+	assert(sq_type_can_use_arena(SQ_TYPE_STR) == true);
+
+	sq_storage_remove_all(storage, "companies", NULL);
+	fprintf(stderr, "get_all_arena(): ok.\n");
+}
+
+void test_storage_cursor(SqStorage *storage)
+{
+	SqStorageCursor *cursor;
+	SqQuery  *query;
+	Company  *company;
+	Company  *instance = NULL;
+	int64_t   id;
+	int       index;
+	int       count;
+
+	company = calloc(1, sizeof(Company));
+	company->name = "Cursor";
+	company->address = "Texas";
+	for (index = 0;  index < 100;  index++) {
+		company->id = 0;    // for auto increment
+		company->age = index;
+		id = sq_storage_insert(storage, "companies", NULL, company);
+		assert(id > 0);
+	}
+	free(company);
+
+	// cursor reuses one instance for every row
+	cursor = sq_storage_get_all_cursor(storage, "companies", NULL, "WHERE name = 'Cursor' ORDER BY age");
+	assert(cursor != NULL);
+	for (count = 0;  (company = sq_storage_cursor_next(cursor));  count++) {
+		if (instance == NULL)
+			instance = company;
+		assert(company == instance);
+		assert(company->age == count);
+		assert(strcmp(company->name, "Cursor") == 0);
+	}
+	assert(count == 100);
+	assert(sq_storage_cursor_next(cursor) == NULL);
+	sq_storage_cursor_free(cursor);
+
+	// free cursor before the end of result set. Other functions can be called between steps.
+	query = sq_query_new("companies");
+	sq_query_where(query, "age", ">=", "%d", 50);
+	cursor = sq_storage_query_cursor(storage, query, NULL);
+	assert(cursor != NULL);
+	company = sq_storage_cursor_next(cursor);
+	assert(company != NULL && company->age >= 50);
+	id = company->id;
+	company = sq_storage_get(storage, "companies", NULL, id);
+	assert(company != NULL);
+	company_free(company);
+	company = sq_storage_cursor_next(cursor);
+	assert(company != NULL && company->age >= 50);
+	sq_storage_cursor_free(cursor);
+	sq_query_free(query);
+
+	// empty result set
+	cursor = sq_storage_get_all_cursor(storage, "companies", NULL, "WHERE age < 0");
+	assert(cursor != NULL);
+	assert(sq_storage_cursor_next(cursor) == NULL);
+	sq_storage_cursor_free(cursor);
+
+	sq_storage_remove_all(storage, "companies", NULL);
+	fprintf(stderr, "cursor: ok.\n");
+}
+
+void test_storage_xc(SqStorage *storage)
+{
+	Sqxc     *xcjson;
+	SqQuery  *query;
+	Company   company = {0, "Json \"Q\"", 40, "Taipei", 1000.5};
+	int       code;
+	int64_t   id;
+	char      json[64];
+
+	id = sq_storage_insert(storage, "companies", NULL, &company);
+	company.name = "Xc";
+	company.age = 41;
+	company.address = "Texas";
+	sq_storage_insert(storage, "companies", NULL, &company);
+
+	// SqxcJsonWriter doesn't have destination. JSON text is kept in Sqxc.buf
+	xcjson = sqxc_new(SQXC_INFO_JSON_WRITER);
+	code = sq_storage_get_all_xc(storage, "companies", NULL, "ORDER BY age", xcjson);
+	assert(code == SQCODE_OK);
+	sq_buffer_write_c(sqxc_get_buffer(xcjson), 0);
+	fprintf(stderr, "get_all_xc(): %s\n", xcjson->buf);
+	snprintf(json, sizeof(json), "[{\"id\":%"PRId64",\"name\":\"Json \\\"Q\\\"\",\"age\":40,", id);
+	assert(strncmp(xcjson->buf, json, strlen(json)) == 0);
+	assert(strstr(xcjson->buf, "\"address\":\"Taipei\",\"salary\":1000.5}") != NULL);
+	assert(strstr(xcjson->buf, "\"name\":\"Xc\",\"age\":41,\"address\":\"Texas\",\"salary\":1000.5}]") != NULL);
+
+	// query with selected columns
+	query = sq_query_new("companies");
+	sq_query_select(query, "name", "age", NULL);
+	sq_query_where(query, "age", ">", "%d", 40);
+	code = sq_storage_query_xc(storage, query, NULL, xcjson);
+	assert(code == SQCODE_OK);
+	sq_buffer_write_c(sqxc_get_buffer(xcjson), 0);
+	assert(strcmp(xcjson->buf, "[{\"name\":\"Xc\",\"age\":41}]") == 0);
+	sq_query_free(query);
+
+	// empty result set
+	code = sq_storage_get_all_xc(storage, "companies", NULL, "WHERE age < 0", xcjson);
+	assert(code == SQCODE_NO_DATA);
+	sq_buffer_write_c(sqxc_get_buffer(xcjson), 0);
+	assert(strcmp(xcjson->buf, "[]") == 0);
+
+	sqxc_free(xcjson);
+	sq_storage_remove_all(storage, "companies", NULL);
+	fprintf(stderr, "get_all_xc(), query_xc(): ok.\n");
+}
+
+void test_storage_import(SqStorage *storage)
+{
+	SqStorageImport *import;
+	SqPtrArray *array;
+	Company    *company;
+	SqBuffer    buf;
+	char        piece[101];
+	int64_t     n_rows;
+	int         code;
+	int         index;
+
+	// members are in different order, number is converted to type of column.
+	n_rows = sq_storage_insert_json(storage, "companies", NULL,
+			"[{\"name\":\"Json\",\"age\":30,\"address\":\"Taipei\",\"salary\":100},"
+			" {\"salary\":200.5,\"address\":\"Texas\",\"age\":\"31\",\"name\":\"Import\"}]");
+	assert(n_rows == 2);
+	array = sq_storage_get_all(storage, "companies", NULL, NULL, "ORDER BY age");
+	assert(array != NULL);
+	assert(array->length == 2);
+	company = array->data[0];
+	assert(company->age == 30 && company->salary == 100);
+	assert(strcmp(company->name, "Json") == 0);
+	company_free(company);
+	company = array->data[1];
+	assert(company->age == 31 && company->salary == 200.5);
+	assert(strcmp(company->address, "Texas") == 0);
+	company_free(company);
+	sq_ptr_array_free(array);
+
+	// errors roll back transaction
+	// column is not found
+	n_rows = sq_storage_insert_json(storage, "companies", NULL,
+			"[{\"name\":\"Error\",\"age\":1,\"address\":\"Texas\",\"salary\":1,\"unknown\":1}]");
+	assert(n_rows == -1);
+	// rows don't have the same columns
+	n_rows = sq_storage_insert_json(storage, "companies", NULL,
+			"[{\"name\":\"Error\",\"age\":1,\"address\":\"Texas\",\"salary\":1},"
+			" {\"name\":\"Error\",\"address\":\"Texas\",\"salary\":1}]");
+	assert(n_rows == -1);
+	// top level isn't array, array is incomplete
+	assert(sq_storage_insert_json(storage, "companies", NULL, "{\"name\":\"Error\"}") == -1);
+	assert(sq_storage_insert_json(storage, "companies", NULL, "[{\"name\":\"Error\"}") == -1);
+	array = sq_storage_get_all(storage, "companies", NULL, NULL, "WHERE name = 'Error'");
+	assert(array == NULL || array->length == 0);
+	if (array)
+		sq_ptr_array_free(array);
+
+	// send JSON in pieces. 700 rows may be split into multiple INSERT statements.
+	sq_buffer_init(&buf);
+	sq_buffer_write_c(&buf, '[');
+	for (index = 0;  index < 700;  index++) {
+		snprintf(piece, sizeof(piece), "%s{\"name\":\"Piece\",\"age\":%d,\"address\":\"Texas\",\"salary\":%d.5}",
+		         (index) ? "," : "", index + 100, index);
+		sq_buffer_write(&buf, piece);
+	}
+	sq_buffer_write_c(&buf, ']');
+
+	import = sq_storage_import_new(storage, "companies", NULL);
+	assert(import != NULL);
+	for (index = 0;  index < buf.writed;  index += 100) {
+		snprintf(piece, sizeof(piece), "%.*s", 100, buf.mem + index);
+		code = sq_storage_import_json(import, piece);
+		assert(code == SQCODE_OK || code == SQCODE_JSON_CONTINUE);
+	}
+	assert(code == SQCODE_OK);
+	n_rows = sq_storage_import_end(import);
+	fprintf(stderr, "import_json(): inserted %"PRId64" rows\n", n_rows);
+	assert(n_rows == 700);
+	sq_buffer_final(&buf);
+
+	array = sq_storage_get_all(storage, "companies", NULL, NULL, "WHERE name = 'Piece' ORDER BY age");
+	assert(array != NULL);
+	assert(array->length == 700);
+	company = array->data[699];
+	assert(company->age == 799 && company->salary == 699.5);
+	for (index = 0;  index < array->length;  index++)
+		company_free(array->data[index]);
+	sq_ptr_array_free(array);
+
+	sq_storage_remove_all(storage, "companies", NULL);
+	fprintf(stderr, "insert_json(), import_json(): ok.\n");
+}
+
+#if SQ_CONFIG_HAVE_THREAD
+#define N_THREADS     4
+#define N_INSERTS     50
+
+static SqThreadResult test_storage_thread_func(void *data)
+{
+	SqStorage *storage = data;
+	Company   *company_ptr;
+	Company    company;
+	int64_t    id;
+	int        index;
+
+	company.name = "Thread";
+	company.address = "Texas";
+	company.salary = 0;
+	for (index = 0;  index < N_INSERTS;  index++) {
+		company.id = 0;    // for auto increment
+		company.age = index;
+		id = sq_storage_insert(storage, "companies", NULL, &company);
+		assert(id != 0);
+
+		company_ptr = sq_storage_get(storage, "companies", NULL, id);
+		assert(company_ptr != NULL);
+		assert(company_ptr->age == index);
+		company_free(company_ptr);
+	}
+	return SQ_THREAD_RESULT;
+}
+
+void test_storage_thread_safe(SqStorage *storage)
+{
+	SqThread    threads[N_THREADS];
+	SqPtrArray *array;
+	int         index;
+
+	sq_storage_set_thread_safe(storage, true);
+	for (index = 0;  index < N_THREADS;  index++)
+		sq_thread_create(&threads[index], test_storage_thread_func, storage);
+	for (index = 0;  index < N_THREADS;  index++)
+		sq_thread_join(&threads[index]);
+
+	array = sq_storage_get_all(storage, "companies", NULL, NULL, "WHERE name = 'Thread'");
+	assert(array != NULL);
+	fprintf(stderr, "thread-safe: %d threads inserted %d rows\n", N_THREADS, array->length);
+	assert(array->length == N_THREADS * N_INSERTS);
+	for (index = 0;  index < array->length;  index++)
+		company_free(array->data[index]);
+	sq_ptr_array_free(array);
+
+	sq_storage_remove_all(storage, "companies", NULL);
+	sq_storage_set_thread_safe(storage, false);
+	fprintf(stderr, "thread-safe: ok.\n");
+}
+
+static int  test_storage_pool_on_open(Sqdb *db, void *data)
+{
+	int *n_opened = data;
+
+	(*n_opened)++;
+#if SQ_CONFIG_HAVE_SQLITE && USE_SQLITE_IF_POSSIBLE
+	// multiple SQLite connections write to the same WAL database file
+	if (db->info == SQDB_INFO_SQLITE)
+		return sqdb_exec(db, "PRAGMA journal_mode = WAL", NULL, NULL);
+#endif
+	return SQCODE_OK;
+}
+
+void test_storage_async(SqStorage *storage, SqdbPool *pool);
+
+void test_storage_pool(SqStorage *storage, const SqdbInfo *dbinfo, SqdbConfig *config)
+{
+	SqdbPoolConfig  pool_config = {
+		.min_size     = 2,
+		.max_size     = N_THREADS,
+		.idle_timeout = 60000,
+		.wait_timeout = 20,
+	};
+#if SQ_CONFIG_HAVE_SQLITE && USE_SQLITE_IF_POSSIBLE
+	SqdbConfigSqlite  config_sqlite;
+#endif
+	SqdbPool   *pool;
+	SqThread    threads[N_THREADS];
+	Sqdb       *dbs[N_THREADS];
+	SqPtrArray *array;
+	int         n_opened = 0;
+	int         index;
+
+#if SQ_CONFIG_HAVE_SQLITE && USE_SQLITE_IF_POSSIBLE
+	// every connection that is opened by pool waits for locked database
+	if (dbinfo == SQDB_INFO_SQLITE) {
+		config_sqlite = *(SqdbConfigSqlite*)config;
+		config_sqlite.busy_timeout = 5000;
+		config = (SqdbConfig*)&config_sqlite;
+	}
+#endif
+
+	pool = sqdb_pool_new(dbinfo, config, &pool_config);
+	sqdb_pool_set_on_open(pool, test_storage_pool_on_open, &n_opened);
+	if (sqdb_pool_open(pool, "test-storage") != SQCODE_OK) {
+		sqdb_pool_free(pool);
+		return;
+	}
+	assert(sqdb_pool_size(pool) == 2);
+	assert(sqdb_pool_n_idle(pool) == 2);
+	assert(n_opened == 2);
+
+	// pool is full
+	for (index = 0;  index < N_THREADS;  index++) {
+		dbs[index] = sqdb_pool_acquire(pool);
+		assert(dbs[index] != NULL);
+	}
+	assert(sqdb_pool_size(pool) == N_THREADS);
+	// setup runs on every opened connection
+	assert(n_opened == N_THREADS);
+	// wait is timed out
+	assert(sqdb_pool_acquire(pool) == NULL);
+	for (index = 0;  index < N_THREADS;  index++)
+		sqdb_pool_release(pool, dbs[index]);
+	assert(sqdb_pool_n_idle(pool) == sqdb_pool_size(pool));
+
+	sq_storage_set_pool(storage, pool);
+	for (index = 0;  index < N_THREADS;  index++)
+		sq_thread_create(&threads[index], test_storage_thread_func, storage);
+	for (index = 0;  index < N_THREADS;  index++)
+		sq_thread_join(&threads[index]);
+
+	array = sq_storage_get_all(storage, "companies", NULL, NULL, "WHERE name = 'Thread'");
+	assert(array != NULL);
+	fprintf(stderr, "pool: %d threads inserted %d rows with %d connections\n",
+	        N_THREADS, array->length, sqdb_pool_size(pool));
+	assert(array->length == N_THREADS * N_INSERTS);
+	for (index = 0;  index < array->length;  index++)
+		company_free(array->data[index]);
+	sq_ptr_array_free(array);
+	sq_storage_remove_all(storage, "companies", NULL);
+	sq_storage_set_pool(storage, NULL);
+	sq_storage_set_thread_safe(storage, false);
+	// test asynchronous CRUD functions in worker threads
+	test_storage_async(storage, pool);
+	// connections are not idle long enough to be closed
+	assert(sqdb_pool_evict(pool) == 0);
+	sqdb_pool_free(pool);
+
+	// idle connections are closed until number of connections == min_size
+	pool_config.idle_timeout = 1;
+	pool = sqdb_pool_new(dbinfo, config, &pool_config);
+	sqdb_pool_set_on_open(pool, test_storage_pool_on_open, &n_opened);
+	sqdb_pool_open(pool, "test-storage");
+	for (index = 0;  index < N_THREADS;  index++)
+		dbs[index] = sqdb_pool_acquire(pool);
+	for (index = 0;  index < N_THREADS;  index++)
+		sqdb_pool_release(pool, dbs[index]);
+	while (sqdb_pool_size(pool) > pool_config.min_size)
+		sqdb_pool_evict(pool);
+	assert(sqdb_pool_n_idle(pool) == pool_config.min_size);
+	// closed connections are opened again with setup
+	n_opened = 0;
+	for (index = 0;  index < N_THREADS;  index++)
+		dbs[index] = sqdb_pool_acquire(pool);
+	assert(n_opened == N_THREADS - pool_config.min_size);
+	for (index = 0;  index < N_THREADS;  index++)
+		sqdb_pool_release(pool, dbs[index]);
+
+	sqdb_pool_free(pool);
+	fprintf(stderr, "pool: ok.\n");
+}
+
+typedef struct AsyncCounter    AsyncCounter;
+
+struct AsyncCounter
+{
+	SqMutex  mutex;
+	int      n_done;
+	int      n_error;
+	int      age_sum;
+};
+
+static void test_storage_async_callback(SqStorageResult *result, void *data)
+{
+	AsyncCounter *counter = data;
+	Company      *company = result->instance;
+
+	sq_mutex_lock(&counter->mutex);
+	counter->n_done++;
+	if (result->code != SQCODE_OK)
+		counter->n_error++;
+	else if (result->value == 0)
+		counter->age_sum += company->age;    // result of sq_storage_get_async()
+	sq_mutex_unlock(&counter->mutex);
+	if (result->value == 0 && company)
+		company_free(company);
+}
+
+void test_storage_async(SqStorage *storage, SqdbPool *pool)
+{
+	AsyncCounter  counter = {0};
+	Company       companies[N_INSERTS];
+	SqPtrArray   *array;
+	int           index;
+
+	// workers are not started
+	assert(sq_storage_get_async(storage, "companies", NULL, 1, NULL, NULL) == SQCODE_NOT_SUPPORT);
+
+	// workers require SqdbPool that has enough connections
+	assert(sq_storage_start_workers(storage, 2) == SQCODE_NOT_SUPPORT);
+	sq_storage_set_pool(storage, pool);
+	assert(sq_storage_start_workers(storage, sqdb_pool_max_size(pool) + 1) == SQCODE_ERROR);
+
+	sq_mutex_init(&counter.mutex);
+	assert(sq_storage_start_workers(storage, 2) == SQCODE_OK);
+	assert(storage->thread != NULL);
+	for (index = 0;  index < N_INSERTS;  index++) {
+		companies[index].id = index + 1000;
+		companies[index].name = "Async";
+		companies[index].age = index;
+		companies[index].address = "Texas";
+		companies[index].salary = 0;
+		sq_storage_insert_async(storage, "companies", NULL, &companies[index],
+		                        test_storage_async_callback, &counter);
+	}
+	// stop workers after all inserts are done
+	sq_storage_stop_workers(storage);
+	assert(counter.n_done == N_INSERTS);
+	assert(counter.n_error == 0);
+
+	counter.n_done = 0;
+	sq_storage_start_workers(storage, 2);
+	for (index = 0;  index < N_INSERTS;  index++) {
+		sq_storage_get_async(storage, "companies", NULL, index + 1000,
+		                     test_storage_async_callback, &counter);
+	}
+	sq_storage_remove_all_async(storage, "companies", "WHERE name = 'Async' AND age < 10", NULL, NULL);
+	sq_storage_stop_workers(storage);
+	assert(counter.n_done == N_INSERTS);
+	assert(counter.n_error == 0);
+	assert(counter.age_sum == N_INSERTS * (N_INSERTS - 1) / 2);
+
+	array = sq_storage_get_all(storage, "companies", NULL, NULL, "WHERE name = 'Async'");
+	assert(array != NULL);
+	assert(array->length == N_INSERTS - 10);
+	for (index = 0;  index < array->length;  index++)
+		company_free(array->data[index]);
+	sq_ptr_array_free(array);
+
+	sq_storage_remove_all(storage, "companies", NULL);
+	sq_storage_set_pool(storage, NULL);
+	sq_storage_set_thread_safe(storage, false);
+	sq_mutex_clear(&counter.mutex);
+	fprintf(stderr, "async: ok.\n");
+}
+#endif  // SQ_CONFIG_HAVE_THREAD
+
+#if SQ_CONFIG_HAVE_SQLITE && USE_SQLITE_IF_POSSIBLE
+void test_storage_sqlite_stmt_cache(SqStorage *storage)
+{
+	SqdbSqlite *db = (SqdbSqlite*)storage->db;
+	Company    *company_ptr;
+	Company     company;
+	int64_t     id[2];
+	unsigned int  misses;
+
+	company.id = 0;    // for auto increment
+	company.name = "O'Neil";
+	company.salary = 10.5;
+	company.age = -3;
+	company.address = "it's ''quoted''";
+
+	id[0] = sq_storage_insert(storage, "companies", NULL, &company);
+	company.name = "Bob";
+	id[1] = sq_storage_insert(storage, "companies", NULL, &company);
+
+	// SQL statements that differ only in literals use the same cached statement
+	misses = db->stmt_cache_misses;
+	company_ptr = sq_storage_get(storage, "companies", NULL, id[0]);
+	assert(company_ptr != NULL);
+	assert(strcmp(company_ptr->name, "O'Neil") == 0);
+	assert(strcmp(company_ptr->address, "it's ''quoted''") == 0);
+	assert(company_ptr->age == -3);
+	assert(company_ptr->salary == 10.5);
+	company_free(company_ptr);
+
+	company_ptr = sq_storage_get(storage, "companies", NULL, id[1]);
+	assert(company_ptr != NULL);
+	assert(strcmp(company_ptr->name, "Bob") == 0);
+	company_free(company_ptr);
+	assert(db->stmt_cache_misses - misses <= 1);
+	assert(db->stmt_cache_hits > 0);
+
+	sq_storage_remove_all(storage, "companies", NULL);
+	fprintf(stderr, "statement cache: hits = %u, misses = %u, evictions = %u\n",
+	        db->stmt_cache_hits, db->stmt_cache_misses, db->stmt_cache_evictions);
+}
+
+void test_storage_sqlite_wal(void)
+{
+	SqdbConfigSqlite  config = {
+		.folder       = ".",
+		.extension    = "db",
+		.journal_mode = "WAL",
+		.synchronous  = "NORMAL",
+		.busy_timeout = 5000,
+		.n_readers    = 2,
+	};
+	SqdbSqlite *db;
+	SqStorage  *storage;
+	SqSchema   *schema;
+	Company    *company_ptr;
+	Company     company;
+	int64_t     id;
+	unsigned int  misses;
+	sqlite3_stmt *stmt;
+
+	db = (SqdbSqlite*)sqdb_new(SQDB_INFO_SQLITE, (SqdbConfig*)&config);
+	storage = sq_storage_new((Sqdb*)db);
+	if (sq_storage_open(storage, "test-storage") != SQCODE_OK) {
+		sq_storage_free(storage);
+		sqdb_free((Sqdb*)db);
+		return;
+	}
+	schema = sq_schema_new(NULL);
+	create_company_table(schema);
+	sq_storage_migrate(storage, schema);
+	sq_storage_migrate(storage, NULL);
+	sq_schema_free(schema);
+
+	// PRAGMA are applied when database is opened
+	sqlite3_prepare_v2(db->self, "PRAGMA journal_mode", -1, &stmt, NULL);
+	assert(sqlite3_step(stmt) == SQLITE_ROW);
+	assert(strcmp((const char*)sqlite3_column_text(stmt, 0), "wal") == 0);
+	sqlite3_finalize(stmt);
+	misses = db->stmt_cache_misses;
+
+	company.id = 0;    // for auto increment
+	company.name = "Reader";
+	company.salary = 1.5;
+	company.age = 30;
+	company.address = "Read-only";
+	id = sq_storage_insert(storage, "companies", NULL, &company);
+
+	// committed row is read by read-only connection. Writer doesn't prepare SELECT statement.
+	company_ptr = sq_storage_get(storage, "companies", NULL, id);
+	assert(company_ptr != NULL);
+	assert(strcmp(company_ptr->name, "Reader") == 0);
+	company_free(company_ptr);
+	assert(db->stmt_cache_misses - misses == 1);
+
+	// SELECT statement in transaction is run by writer, it can see uncommitted row.
+	sq_storage_begin_trans(storage);
+	company.name = "Uncommitted";
+	id = sq_storage_insert(storage, "companies", NULL, &company);
+	misses = db->stmt_cache_misses;
+	company_ptr = sq_storage_get(storage, "companies", NULL, id);
+	assert(company_ptr != NULL);
+	assert(strcmp(company_ptr->name, "Uncommitted") == 0);
+	company_free(company_ptr);
+	assert(db->stmt_cache_misses - misses == 1);
+	sq_storage_rollback_trans(storage);
+
+	company_ptr = sq_storage_get(storage, "companies", NULL, id);
+	assert(company_ptr == NULL);
+
+	// SAVEPOINT is run by writer and starts transaction.
+	assert(sqdb_exec((Sqdb*)db, "SAVEPOINT sp1", NULL, NULL) == SQCODE_OK);
+	assert(sqlite3_get_autocommit(db->self) == 0);
+	company.name = "Savepoint";
+	id = sq_storage_insert(storage, "companies", NULL, &company);
+	company_ptr = sq_storage_get(storage, "companies", NULL, id);
+	assert(company_ptr != NULL);
+	company_free(company_ptr);
+	assert(sqdb_exec((Sqdb*)db, "ROLLBACK TO sp1", NULL, NULL) == SQCODE_OK);
+	assert(sqdb_exec((Sqdb*)db, "RELEASE sp1", NULL, NULL) == SQCODE_OK);
+	assert(sqlite3_get_autocommit(db->self) != 0);
+	company_ptr = sq_storage_get(storage, "companies", NULL, id);
+	assert(company_ptr == NULL);
+
+	sq_storage_remove_all(storage, "companies", NULL);
+	sq_storage_close(storage);
+	sq_storage_free(storage);
+	sqdb_free((Sqdb*)db);
+	fprintf(stderr, "WAL: writer and %d readers ok.\n", config.n_readers);
+}
+
+// this statement never ends
+#define SQL_RUNAWAY    "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x+1 FROM c) SELECT count(*) FROM c"
+
+#if SQ_CONFIG_HAVE_THREAD
+typedef struct RunawayCall    RunawayCall;
+
+struct RunawayCall
+{
+	Sqdb      *db;
+	SqdbToken  token;
+	int        code;
+};
+
+static SqThreadResult test_storage_sqlite_runaway(void *data)
+{
+	RunawayCall *call = data;
+
+	// it never ends until it is interrupted by token
+	call->code = sqdb_exec(call->db, SQL_RUNAWAY, NULL, &call->token);
+	return SQ_THREAD_RESULT;
+}
+#endif
+
+void test_storage_sqlite_timeout(void)
+{
+	SqdbConfigSqlite  config = {
+		.folder       = ".",
+		.extension    = "db",
+		.n_readers    = 1,
+		.exec_timeout = 50,
+	};
+	SqdbToken  token = {0};
+	Sqdb      *db;
+	int        code;
+#if SQ_CONFIG_HAVE_THREAD
+	RunawayCall  call = {0};
+	SqThread     thread;
+#endif
+
+	db = sqdb_new(SQDB_INFO_SQLITE, (SqdbConfig*)&config);
+	if (sqdb_open(db, "test-storage") != SQCODE_OK) {
+		sqdb_free(db);
+		return;
+	}
+
+	// SELECT is run by read-only connection
+	code = sqdb_exec(db, SQL_RUNAWAY, NULL, NULL);
+	assert(code == SQCODE_TIMEOUT);
+	// statement in writer connection
+	code = sqdb_exec(db, "CREATE TEMP TABLE t AS " SQL_RUNAWAY, NULL, NULL);
+	assert(code == SQCODE_TIMEOUT);
+	// other statements are not affected
+	code = sqdb_exec(db, "SELECT 1", NULL, NULL);
+	assert(code == SQCODE_OK);
+
+	// timeout of this call overrides default timeout
+	sqdb_set_timeout(db, 0);
+	token.timeout = 1;
+	code = sqdb_exec(db, SQL_RUNAWAY, NULL, &token);
+	assert(code == SQCODE_TIMEOUT);
+
+	// interrupted token cancels its call
+	token.timeout = 0;
+	sqdb_interrupt(db, &token);
+	code = sqdb_exec(db, "SELECT 1", NULL, &token);
+	assert(code == SQCODE_CANCELED);
+	// other calls are not affected
+	code = sqdb_exec(db, "SELECT 1", NULL, NULL);
+	assert(code == SQCODE_OK);
+
+#if SQ_CONFIG_HAVE_THREAD
+	// interrupt call in other thread. The call is canceled whether it has started or not.
+	call.db = db;
+	sq_thread_create(&thread, test_storage_sqlite_runaway, &call);
+	sqdb_interrupt(db, &call.token);
+	sq_thread_join(&thread);
+	assert(call.code == SQCODE_CANCELED);
+#endif
+
+	sqdb_close(db);
+	sqdb_free(db);
+	fprintf(stderr, "timeout: ok.\n");
+}
+#endif
+
 void test_storage(const SqdbInfo *dbinfo, SqdbConfig *config)
 {
 	Sqdb      *db;
@@ -245,8 +991,39 @@ void test_storage(const SqdbInfo *dbinfo, SqdbConfig *config)
 	test_storage_crud(storage);
 	// test update_all(), get_all(), and remove_all()
 	test_storage_xxx_all(storage);
+	// test insert_all()
+	test_storage_insert_all(storage);
+	// test get_all_arena()
+	test_storage_arena(storage);
+	// test get_all_cursor(), query_cursor()
+	test_storage_cursor(storage);
+	// test get_all_xc(), query_xc()
+	test_storage_xc(storage);
+	// test insert_json(), import_json()
+	test_storage_import(storage);
+#if SQ_CONFIG_HAVE_THREAD
+	// test CRUD functions in multiple threads
+	test_storage_thread_safe(storage);
+	// test CRUD functions with SqdbPool
+	// and asynchronous CRUD functions in worker threads
+	test_storage_pool(storage, dbinfo, config);
+#endif
+#if SQ_CONFIG_HAVE_SQLITE && USE_SQLITE_IF_POSSIBLE
+	// test prepared statement cache of SQLite
+	if (dbinfo == SQDB_INFO_SQLITE)
+		test_storage_sqlite_stmt_cache(storage);
+#endif
 
 	sq_storage_close(storage);
+
+#if SQ_CONFIG_HAVE_SQLITE && USE_SQLITE_IF_POSSIBLE
+	// test writer and read-only connections of SQLite
+	if (dbinfo == SQDB_INFO_SQLITE)
+		test_storage_sqlite_wal();
+	// test execution timeout and interruption of SQLite
+	if (dbinfo == SQDB_INFO_SQLITE)
+		test_storage_sqlite_timeout();
+#endif
 }
 
 // ----------------------------------------------------------------------------
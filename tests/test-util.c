@@ -127,10 +127,138 @@ void test_time_string()
 		puts(str);
 }
 
+void test_number_string()
+{
+	char  str[SQ_NUMBER_STRING_SIZE];
+	int   len;
+
+	len = sq_int64_to_str(str, 0);
+	assert(len == 1 && strcmp(str, "0") == 0);
+	len = sq_int64_to_str(str, -1234567);
+	assert(len == 8 && strcmp(str, "-1234567") == 0);
+	len = sq_int64_to_str(str, INT64_MIN);
+	assert(strcmp(str, "-9223372036854775808") == 0);
+	len = sq_uint64_to_str(str, UINT64_MAX);
+	assert(len == 20 && strcmp(str, "18446744073709551615") == 0);
+
+	len = sq_double_to_str(str, 25.0);
+	assert(len == 2 && strcmp(str, "25") == 0);
+	len = sq_double_to_str(str, -0.5);
+	assert(strcmp(str, "-0.5") == 0);
+	len = sq_double_to_str(str, 0.1);
+	assert(strcmp(str, "0.1") == 0);
+	// value that needs 17 significant digits
+	sq_double_to_str(str, 0.1 + 0.2);
+	assert(strtod(str, NULL) == 0.1 + 0.2);
+	sq_double_to_str(str, 1.0 / 3.0);
+	assert(strtod(str, NULL) == 1.0 / 3.0);
+}
+
+void test_time_codec()
+{
+	char       str[SQ_TIME_STRING_SIZE];
+	struct tm  timeinfo = {0};
+	time_t     time;
+
+	// UTC
+	time = sq_time_from_string("2002-11-10T15:23:59Z");
+	assert(time == 1036941839);
+	sq_time_to_str(str, time, 'Z');
+	assert(strcmp(str, "2002-11-10T15:23:59Z") == 0);
+	// fractional seconds and UTC offset
+	assert(sq_time_from_string("2002-11-10T23:23:59.125+08:00") == 1036941839);
+	assert(sq_time_from_string("2002-11-10T10:23:59-0500") == 1036941839);
+	assert(sq_time_from_string("1969-12-31T23:59:59Z") == -1);
+
+	// local time is the same as mktime()
+	timeinfo.tm_year  = 2002 - 1900;
+	timeinfo.tm_mon   = 7 - 1;
+	timeinfo.tm_mday  = 10;
+	timeinfo.tm_hour  = 15;
+	timeinfo.tm_min   = 23;
+	timeinfo.tm_sec   = 59;
+	timeinfo.tm_isdst = -1;
+	time = sq_time_from_string("2002/07/10 15:23:59");
+	assert(time == mktime(&timeinfo));
+	sq_time_to_str(str, time, 0);
+	assert(strcmp(str, "2002-07-10 15:23:59") == 0);
+	sq_time_to_str(str, time, 'T');
+	assert(strcmp(str, "2002-07-10T15:23:59") == 0);
+	sq_time_to_str(str, time, 'c');
+	assert(strcmp(str, "2002_07_10_152359") == 0);
+
+	// time only, date is 2000-01-01
+	time = sq_time_from_string("08:30");
+	sq_time_to_str(str, time, 0);
+	assert(strcmp(str, "2000-01-01 08:30:00") == 0);
+	// date only
+	time = sq_time_from_string("2020-02-29");
+	sq_time_to_str(str, time, 0);
+	assert(strcmp(str, "2020-02-29 00:00:00") == 0);
+
+	// error
+	assert(sq_time_from_string("now") == -1);
+	assert(sq_time_from_string("2020-13-01") == -1);
+	assert(sq_time_from_string("2020-01-01 08") == -1);
+}
+
+void test_escape_string()
+{
+	char   buf[160];
+	char   sql[340];
+	char  *str;
+	int    len;
+
+	// special character at every position and alignment of SIMD functions
+	for (int offset = 0;  offset < 32;  offset++) {
+		str = buf + offset;
+		for (int pos = 0;  pos < 100;  pos++) {
+			memset(str, 'a', 100);
+			str[100] = 0;
+			str[pos] = '\'';
+			assert(sq_str_find_sql_escape(str) == str + pos);
+			assert(sq_str_find_json_escape(str) == str + 100);
+			str[pos] = '\\';
+			assert(sq_str_find_json_escape(str) == str + pos);
+			str[pos] = '\x1F';
+			assert(sq_str_find_json_escape(str) == str + pos);
+			// UTF-8 bytes (>= 0x80) don't need escape
+			str[pos] = '\xE4';
+			assert(sq_str_find_json_escape(str) == str + 100);
+			str[pos] = 0;
+			assert(sq_str_find_sql_escape(str) == str + pos);
+			assert(sq_str_find_json_escape(str) == str + pos);
+		}
+	}
+
+	// C string <-> SQL string
+	len = sq_cstr2sql(NULL, "I'm worker.");
+	assert(len == 14);
+	len = sq_cstr2sql(sql, "I'm worker.");
+	assert(len == 14 && strcmp(sql, "'I''m worker.'") == 0);
+	len = sq_sql2cstr(NULL, sql);
+	assert(len == 11);
+	len = sq_sql2cstr(buf, sql);
+	assert(len == 11 && strcmp(buf, "I'm worker.") == 0);
+	len = sq_cstr2sql(sql, "");
+	assert(len == 2 && strcmp(sql, "''") == 0);
+
+	memset(buf, '\'', 150);
+	buf[150] = 0;
+	len = sq_cstr2sql(sql, buf);
+	assert(len == 302);
+	// convert in place
+	len = sq_sql2cstr(sql, sql);
+	assert(len == 150 && strcmp(sql, buf) == 0);
+}
+
 void test_util()
 {
 	test_name_convention();
 	test_time_string();
+	test_number_string();
+	test_time_codec();
+	test_escape_string();
 }
 
 // ----------------------------------------------------------------------------